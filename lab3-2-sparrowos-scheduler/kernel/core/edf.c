@@ -0,0 +1,160 @@
+/**
+ * edf.c - 最早截止时间优先（EDF）实时调度类实现
+ * 位于: kernel/core/edf.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/edf.h"
+
+void edf_rq_init(edf_rq_t *rq, uint32_t util_limit) {
+    memset(rq, 0, sizeof(edf_rq_t));
+    rq->util_limit = util_limit ? util_limit : EDF_UTIL_DEFAULT;
+}
+
+/* ========== 最小堆 ========== */
+
+/* 截止时间用回绕安全的比较；相同时按入堆顺序 */
+static inline bool node_before(const edf_node_t *a, const edf_node_t *b) {
+    int32_t diff = (int32_t)(a->deadline - b->deadline);
+    return diff < 0 || (diff == 0 && (int32_t)(a->seq - b->seq) < 0);
+}
+
+static void sift_up(edf_rq_t *rq, uint32_t i) {
+    edf_node_t node = rq->heap[i];
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (!node_before(&node, &rq->heap[parent])) {
+            break;
+        }
+        rq->heap[i] = rq->heap[parent];
+        i = parent;
+    }
+    rq->heap[i] = node;
+}
+
+static void sift_down(edf_rq_t *rq, uint32_t i) {
+    edf_node_t node = rq->heap[i];
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= rq->count) {
+            break;
+        }
+        if (child + 1 < rq->count && node_before(&rq->heap[child + 1], &rq->heap[child])) {
+            child++;
+        }
+        if (!node_before(&rq->heap[child], &node)) {
+            break;
+        }
+        rq->heap[i] = rq->heap[child];
+        i = child;
+    }
+    rq->heap[i] = node;
+}
+
+void edf_enqueue(edf_rq_t *rq, pcb_t *pcb) {
+    if (!rq || !pcb || pcb->queue || rq->count >= EDF_MAX_TASKS) {
+        return;
+    }
+
+    edf_node_t *node = &rq->heap[rq->count];
+    node->deadline = pcb->deadline;
+    node->seq = rq->seq++;
+    node->pcb = pcb;
+    pcb->queue = rq;
+    sift_up(rq, rq->count++);
+}
+
+pcb_t* edf_dequeue(edf_rq_t *rq) {
+    if (!rq || rq->count == 0) {
+        return NULL;
+    }
+
+    pcb_t *pcb = rq->heap[0].pcb;
+    pcb->queue = NULL;
+    if (--rq->count > 0) {
+        rq->heap[0] = rq->heap[rq->count];
+        sift_down(rq, 0);
+    }
+    return pcb;
+}
+
+pcb_t* edf_peek(const edf_rq_t *rq) {
+    return rq && rq->count ? rq->heap[0].pcb : NULL;
+}
+
+void edf_remove(edf_rq_t *rq, pcb_t *pcb) {
+    if (!rq || !pcb || pcb->queue != rq) {
+        return;
+    }
+
+    // 实时进程数很少，线性查找即可，免得在PCB中再维护堆下标
+    uint32_t i = 0;
+    while (i < rq->count && rq->heap[i].pcb != pcb) {
+        i++;
+    }
+    if (i == rq->count) {
+        return;
+    }
+
+    pcb->queue = NULL;
+    if (--rq->count > i) {
+        rq->heap[i] = rq->heap[rq->count];
+        sift_down(rq, i);
+        sift_up(rq, i);
+    }
+}
+
+/* ========== 接纳控制 ========== */
+
+static inline uint32_t density(uint32_t runtime, uint32_t rel_deadline) {
+    // 向上取整，宁可多算不可少算
+    return (uint32_t)(((uint64_t)runtime * EDF_UTIL_SCALE + rel_deadline - 1) / rel_deadline);
+}
+
+bool edf_admit(edf_rq_t *rq, uint32_t runtime, uint32_t rel_deadline,
+               const rt_params_t *old) {
+    uint32_t d = density(runtime, rel_deadline);
+    uint32_t d_old = old ? density(old->runtime, old->rel_deadline) : 0;
+
+    if ((!old && rq->tasks >= EDF_MAX_TASKS) ||
+        rq->utilization - d_old + d > rq->util_limit) {
+        rq->stats.rejected++;
+        return false;
+    }
+
+    rq->utilization = rq->utilization - d_old + d;
+    if (!old) {
+        rq->tasks++;
+    }
+    rq->stats.admitted++;
+    return true;
+}
+
+void edf_release(edf_rq_t *rq, uint32_t runtime, uint32_t rel_deadline) {
+    uint32_t d = density(runtime, rel_deadline);
+
+    rq->utilization = rq->utilization > d ? rq->utilization - d : 0;
+    if (rq->tasks > 0) {
+        rq->tasks--;
+    }
+}
+
+/* ========== 统计 ========== */
+
+void edf_job_complete(edf_rq_t *rq, pcb_t *pcb, uint32_t now) {
+    rt_params_t *rt = &pcb->cold->rt;
+    uint32_t response = now - rt->release;
+
+    rt->jobs++;
+    rq->stats.jobs++;
+    if (response > rt->rel_deadline) {
+        rt->deadline_misses++;
+        rq->stats.deadline_misses++;
+    }
+    if (response > rt->max_response) {
+        rt->max_response = response;
+    }
+    lat_hist_add(&rq->stats.response_hist, response);
+}
@@ -0,0 +1,90 @@
+/**
+ * fpu.c - 惰性FPU/SSE上下文切换实现
+ * 位于: kernel/core/fpu.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/fpu.h"
+#include "kernel/include/scheduler.h"
+#include "kernel/include/interrupt.h"
+
+static fpu_cpu_state_t fpu_cpus[MAX_CPUS];
+
+void fpu_init(void) {
+    memset(fpu_cpus, 0, sizeof(fpu_cpus));
+
+    enable_sse();
+    fpu_set_ts();
+    interrupt_register_exception(EXC_DEVICE_NOT_AVAILABLE, fpu_handle_nm);
+}
+
+void fpu_switch(pcb_t *next) {
+    fpu_cpu_state_t *cpu = &fpu_cpus[this_cpu_id()];
+
+    if (next && next == cpu->owner) {
+        // 寄存器中仍是next自己的状态，直接放行
+        fpu_clear_ts();
+        cpu->owner_returns++;
+    } else {
+        fpu_set_ts();
+    }
+}
+
+void fpu_handle_nm(void) {
+    fpu_cpu_state_t *cpu = &fpu_cpus[this_cpu_id()];
+    pcb_t *current = scheduler_get_current_process();
+
+    fpu_clear_ts();
+    cpu->nm_traps++;
+
+    if (!current || current == cpu->owner) {
+        return;
+    }
+
+    // 把上一个属主的状态写回它的PCB
+    if (cpu->owner) {
+        save_fpu_state(cpu->owner->cold->context.fpu_state);
+        cpu->saves++;
+    }
+
+    // 装载当前进程的状态；从未用过FPU则给一个干净的初始状态
+    if (PCB_HAS_FLAG(current, PROCESS_FLAG_FPU_USED)) {
+        restore_fpu_state(current->cold->context.fpu_state);
+        cpu->restores++;
+    } else {
+        fpu_reset_state();
+        PCB_SET_FLAG(current, PROCESS_FLAG_FPU_USED);
+        cpu->inits++;
+    }
+
+    cpu->owner = current;
+}
+
+void fpu_release(pcb_t *pcb) {
+    for (uint32_t i = 0; i < MAX_CPUS; i++) {
+        if (fpu_cpus[i].owner == pcb) {
+            fpu_cpus[i].owner = NULL;
+        }
+    }
+}
+
+void fpu_flush(pcb_t *pcb) {
+    fpu_cpu_state_t *cpu = &fpu_cpus[this_cpu_id()];
+
+    if (!pcb || cpu->owner != pcb) {
+        return;
+    }
+
+    // FXSAVE本身也受TS控制，先清除
+    fpu_clear_ts();
+    save_fpu_state(pcb->cold->context.fpu_state);
+    cpu->saves++;
+    cpu->owner = NULL;
+    fpu_set_ts();
+}
+
+const fpu_cpu_state_t* fpu_get_state(uint32_t cpu) {
+    return cpu < MAX_CPUS ? &fpu_cpus[cpu] : NULL;
+}
@@ -0,0 +1,316 @@
+/**
+ * group.c - 调度组实现
+ * 位于: kernel/core/group.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/group.h"
+
+void group_sched_init(group_sched_t *gs) {
+    memset(gs, 0, sizeof(group_sched_t));
+    gs->root.shares = GROUP_DEFAULT_SHARES;
+    gs->root.vtime_inc = GROUP_VTIME_SCALE / GROUP_DEFAULT_SHARES;
+    gs->next_pgid = 1;
+}
+
+/* ========== 组的创建与配置 ========== */
+
+process_group_t* group_create(group_sched_t *gs, process_group_t *parent, uint32_t shares) {
+    if (shares == 0) {
+        shares = GROUP_DEFAULT_SHARES;
+    }
+    if (shares < GROUP_MIN_SHARES || shares > GROUP_MAX_SHARES) {
+        return NULL;
+    }
+    // 只有叶子组可以包含进程
+    if (parent && parent->member_count > 0) {
+        return NULL;
+    }
+
+    process_group_t *group = NULL;
+    for (uint32_t i = 0; i < SCHED_MAX_GROUPS; i++) {
+        if (gs->groups[i].pgid == 0) {
+            group = &gs->groups[i];
+            break;
+        }
+    }
+    if (!group) {
+        return NULL;
+    }
+
+    memset(group, 0, sizeof(process_group_t));
+    group->pgid = gs->next_pgid++;
+    group->shares = shares;
+    group->vtime_inc = GROUP_VTIME_SCALE / shares;
+    group->period = GROUP_DEFAULT_PERIOD;
+    ready_queue_init(&group->rq, 0, 0);
+
+    process_group_t *head = parent ? parent : &gs->root;
+    group->parent = parent;
+    group->sibling = head->children;
+    head->children = group;
+    gs->count++;
+    return group;
+}
+
+int group_destroy(group_sched_t *gs, process_group_t *group) {
+    if (!group || group->member_count > 0 || group->children) {
+        return -1;
+    }
+
+    process_group_t **link = group->parent ? &group->parent->children : &gs->root.children;
+    while (*link && *link != group) {
+        link = &(*link)->sibling;
+    }
+    if (*link) {
+        *link = group->sibling;
+    }
+
+    group->pgid = 0;
+    gs->count--;
+    return 0;
+}
+
+process_group_t* group_find(group_sched_t *gs, uint32_t pgid) {
+    if (pgid == 0) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < SCHED_MAX_GROUPS; i++) {
+        if (gs->groups[i].pgid == pgid) {
+            return &gs->groups[i];
+        }
+    }
+    return NULL;
+}
+
+int group_set_shares(process_group_t *group, uint32_t shares) {
+    if (!group || shares < GROUP_MIN_SHARES || shares > GROUP_MAX_SHARES) {
+        return -1;
+    }
+    group->shares = shares;
+    group->vtime_inc = GROUP_VTIME_SCALE / shares;
+    return 0;
+}
+
+int group_set_bandwidth(process_group_t *group, uint32_t quota, uint32_t period, uint32_t now) {
+    if (!group) {
+        return -1;
+    }
+    if (period == 0) {
+        period = GROUP_DEFAULT_PERIOD;
+    }
+    if (group->throttled) {
+        group->throttled = false;
+        group->stats.throttled_time += now - group->throttle_start;
+    }
+    group->quota = quota;
+    group->period = period;
+    group->period_start = now;
+    group->period_used = 0;
+    return 0;
+}
+
+/* ========== 成员管理 ========== */
+
+int group_attach(process_group_t *group, pcb_t *pcb) {
+    if (group && (group->children || group->member_count >= MAX_PROCESSES)) {
+        return -1;
+    }
+
+    group_detach(pcb);
+    if (group) {
+        group->members[group->member_count++] = pcb;
+        pcb->cold->group = group;
+    }
+    return 0;
+}
+
+void group_detach(pcb_t *pcb) {
+    process_group_t *group = pcb->cold->group;
+    if (!group) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < group->member_count; i++) {
+        if (group->members[i] == pcb) {
+            group->members[i] = group->members[--group->member_count];
+            group->members[group->member_count] = NULL;
+            break;
+        }
+    }
+    pcb->cold->group = NULL;
+}
+
+/* ========== 选择与记账 ========== */
+
+static inline process_group_t* entity_of(group_sched_t *gs, const pcb_t *pcb) {
+    return pcb->cold->group ? pcb->cold->group : &gs->root;
+}
+
+/* 子树中是否有可被选中的就绪进程 */
+static bool group_eligible(const process_group_t *group) {
+    if (group->throttled) {
+        return false;
+    }
+    if (!group->children) {
+        return group->rq.count > 0;
+    }
+    for (const process_group_t *child = group->children; child; child = child->sibling) {
+        if (group_eligible(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* 可被选中，或者正在运行（子树包含当前进程） */
+static bool entity_runnable(group_sched_t *gs, const process_group_t *entity, bool root_runnable) {
+    for (const process_group_t *group = gs->curr; group; group = group->parent) {
+        if (group == entity) {
+            return true;
+        }
+    }
+    return entity == &gs->root ? root_runnable : group_eligible(entity);
+}
+
+void group_set_current(group_sched_t *gs, const pcb_t *pcb) {
+    gs->curr = pcb ? entity_of(gs, pcb) : NULL;
+}
+
+/* 在first开始的兄弟链表中选虚拟时间最小的可选实体（顶层还要考虑root） */
+static process_group_t* pick_sibling(process_group_t *first, process_group_t *best) {
+    for (process_group_t *group = first; group; group = group->sibling) {
+        if (group_eligible(group) && (!best || group->vtime < best->vtime)) {
+            best = group;
+        }
+    }
+    return best;
+}
+
+process_group_t* group_pick(group_sched_t *gs, bool root_runnable) {
+    process_group_t *best = pick_sibling(gs->root.children, root_runnable ? &gs->root : NULL);
+    while (best && best != &gs->root && best->children) {
+        best = pick_sibling(best->children, NULL);
+    }
+    return best;
+}
+
+void group_place(group_sched_t *gs, process_group_t *entity, bool root_runnable) {
+    process_group_t *first = entity->parent ? entity->parent->children : gs->root.children;
+    bool found = false;
+    uint64_t min = 0;
+
+    // 顶层实体的兄弟包括root
+    if (!entity->parent && entity != &gs->root && entity_runnable(gs, &gs->root, root_runnable)) {
+        min = gs->root.vtime;
+        found = true;
+    }
+    for (process_group_t *group = first; group; group = group->sibling) {
+        if (group != entity && entity_runnable(gs, group, root_runnable) &&
+            (!found || group->vtime < min)) {
+            min = group->vtime;
+            found = true;
+        }
+    }
+
+    if (found && min > GROUP_SLEEP_CREDIT && entity->vtime < min - GROUP_SLEEP_CREDIT) {
+        entity->vtime = min - GROUP_SLEEP_CREDIT;
+    }
+}
+
+void group_enqueue(group_sched_t *gs, pcb_t *pcb, bool root_runnable) {
+    process_group_t *leaf = pcb->cold->group;
+
+    // 从叶子向上，原本不可运行的实体按兄弟的虚拟时间重新放置
+    for (process_group_t *group = leaf; group; group = group->parent) {
+        if (entity_runnable(gs, group, root_runnable)) {
+            break;
+        }
+        group_place(gs, group, root_runnable);
+    }
+    ready_queue_enqueue(&leaf->rq, pcb);
+}
+
+bool group_charge(group_sched_t *gs, const pcb_t *pcb, uint32_t now) {
+    process_group_t *group = pcb->cold->group;
+    if (!group) {
+        gs->root.vtime += gs->root.vtime_inc;
+        gs->root.stats.runtime++;
+        return false;
+    }
+
+    bool throttled = false;
+    for (; group; group = group->parent) {
+        group->vtime += group->vtime_inc;
+        group->stats.runtime++;
+
+        if (group->quota) {
+            group->period_used++;
+            if (!group->throttled && group->period_used >= group->quota) {
+                group->throttled = true;
+                group->throttle_start = now;
+                group->stats.throttled++;
+                throttled = true;
+            }
+        }
+    }
+    return throttled;
+}
+
+bool group_tick(group_sched_t *gs, uint32_t now) {
+    bool unthrottled = false;
+    for (uint32_t i = 0; i < SCHED_MAX_GROUPS; i++) {
+        process_group_t *group = &gs->groups[i];
+        if (group->pgid == 0 || group->quota == 0 || now - group->period_start < group->period) {
+            continue;
+        }
+
+        group->period_start = now;
+        group->period_used = 0;
+        group->stats.periods++;
+        if (group->throttled) {
+            group->throttled = false;
+            group->stats.throttled_time += now - group->throttle_start;
+            unthrottled = true;
+        }
+    }
+    return unthrottled;
+}
+
+static uint32_t group_depth(const process_group_t *group) {
+    uint32_t depth = 0;
+    for (; group->parent; group = group->parent) {
+        depth++;
+    }
+    return depth;
+}
+
+bool group_should_preempt(group_sched_t *gs, const pcb_t *curr, const pcb_t *woken) {
+    process_group_t *a = entity_of(gs, curr);
+    process_group_t *b = entity_of(gs, woken);
+    if (a == b) {
+        return false;
+    }
+    for (const process_group_t *group = b; group; group = group->parent) {
+        if (group->throttled) {
+            return false;
+        }
+    }
+
+    // 提升到同一层级的兄弟实体再比较虚拟时间
+    uint32_t da = group_depth(a);
+    uint32_t db = group_depth(b);
+    for (; da > db; da--) {
+        a = a->parent;
+    }
+    for (; db > da; db--) {
+        b = b->parent;
+    }
+    while (a->parent != b->parent) {
+        a = a->parent;
+        b = b->parent;
+    }
+    return a != b && b->vtime + GROUP_WAKEUP_GRAN < a->vtime;
+}
@@ -0,0 +1,147 @@
+/**
+ * idle.c - 空闲状态调控器实现
+ * 位于: kernel/core/idle.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/idle.h"
+
+void idle_governor_init(idle_governor_t *gov, const idle_config_t *config) {
+    memset(gov, 0, sizeof(idle_governor_t));
+    if (config) {
+        gov->config = *config;
+    }
+    if (gov->config.cycles_per_tick == 0) {
+        gov->config.cycles_per_tick = IDLE_DEFAULT_CYCLES_PER_TICK;
+    }
+    if (gov->config.poll_threshold == 0) {
+        gov->config.poll_threshold = IDLE_DEFAULT_POLL_THRESHOLD;
+    }
+    if (gov->config.poll_limit == 0) {
+        gov->config.poll_limit = IDLE_DEFAULT_POLL_LIMIT;
+    }
+    gov->predicted = IDLE_NO_EVENT;
+}
+
+/* ========== 预测 ========== */
+
+uint64_t idle_governor_typical(const idle_governor_t *gov) {
+    uint32_t n = gov->nr_history;
+    if (n < IDLE_HISTORY / 2) {
+        return IDLE_NO_EVENT;
+    }
+
+    // 标准差不超过阈值的一半时，选择不会因样本波动而改变
+    uint64_t tolerance = gov->config.poll_threshold / 2;
+    uint32_t limit = UINT32_MAX;
+    for (;;) {
+        uint64_t sum = 0;
+        uint32_t count = 0, max = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t v = gov->history[i];
+            if (v <= limit) {
+                sum += v;
+                count++;
+                max = v > max ? v : max;
+            }
+        }
+
+        uint64_t avg = sum / count;
+        uint64_t variance = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t v = gov->history[i];
+            if (v <= limit) {
+                uint64_t diff = v > avg ? v - avg : avg - v;
+                variance += diff * diff;
+            }
+        }
+        variance /= count;
+
+        // 标准差小于均值的1/6，或绝对值足够小
+        if ((avg * avg > variance * 36 && count * 4 >= n * 3) ||
+            variance <= tolerance * tolerance) {
+            return avg;
+        }
+        // 剔除到只剩3/4仍然分散，说明没有规律
+        if (count * 4 <= n * 3) {
+            return IDLE_NO_EVENT;
+        }
+        limit = max - 1;
+    }
+}
+
+/* ========== 进入与离开 ========== */
+
+idle_state_t idle_governor_select(idle_governor_t *gov, uint64_t now, uint64_t next_timer) {
+    uint64_t timer_gap = IDLE_NO_EVENT;
+    if (next_timer != IDLE_NO_EVENT) {
+        timer_gap = next_timer > now ? next_timer - now : 0;
+    }
+
+    if (!gov->in_period) {
+        gov->in_period = true;
+        gov->period_start = now;
+        gov->wake_stamp = 0;
+        uint64_t typical = idle_governor_typical(gov);
+        gov->predicted = typical < timer_gap ? typical : timer_gap;
+    }
+
+    // 已经超过预测仍没有工作，说明这次不符合规律，只看定时器
+    uint64_t elapsed = now - gov->period_start;
+    uint64_t remaining = timer_gap;
+    if (gov->predicted != IDLE_NO_EVENT && gov->predicted > elapsed &&
+        gov->predicted - elapsed < remaining) {
+        remaining = gov->predicted - elapsed;
+    }
+
+    gov->state = remaining < gov->config.poll_threshold ? IDLE_POLL : IDLE_HALT;
+    gov->state_entry = now;
+    gov->active = true;
+    gov->stats.states[gov->state].entries++;
+    return gov->state;
+}
+
+void idle_governor_exit(idle_governor_t *gov, uint64_t now, bool work) {
+    if (!gov->active) {
+        return;
+    }
+    gov->active = false;
+
+    idle_state_stats_t *st = &gov->stats.states[gov->state];
+    st->residency += now - gov->state_entry;
+    if (!work || !gov->in_period) {
+        return;
+    }
+
+    // 没有记下唤醒时刻（例如由时钟tick本身发现工作）时按立即发现计
+    uint64_t stamp = gov->wake_stamp;
+    if (stamp == 0 || stamp > now || stamp < gov->period_start) {
+        stamp = now;
+    }
+    uint64_t latency = now - stamp;
+    st->wakeups++;
+    st->latency_sum += latency;
+    if (latency > st->latency_max) {
+        st->latency_max = latency;
+    }
+
+    uint64_t duration = stamp - gov->period_start;
+    if (duration > IDLE_HISTORY_CAP) {
+        duration = IDLE_HISTORY_CAP;
+    }
+    gov->history[gov->next_slot] = (uint32_t)duration;
+    gov->next_slot = (gov->next_slot + 1) % IDLE_HISTORY;
+    if (gov->nr_history < IDLE_HISTORY) {
+        gov->nr_history++;
+    }
+
+    gov->stats.periods++;
+    if (gov->predicted != IDLE_NO_EVENT &&
+        duration * 2 >= gov->predicted && duration / 2 <= gov->predicted) {
+        gov->stats.predicted_hits++;
+    }
+    gov->in_period = false;
+    gov->wake_stamp = 0;
+}
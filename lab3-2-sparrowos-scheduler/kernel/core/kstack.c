@@ -0,0 +1,79 @@
+/**
+ * kstack.c - 内核栈池实现
+ * 位于: kernel/core/kstack.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/kstack.h"
+
+#ifdef SPARROW_HOST
+/* 主机上用静态数组代替内核栈区域 */
+static uint8_t kstack_area[KSTACK_COUNT][STACK_SIZE] __attribute__((aligned(16)));
+#endif
+
+void* kstack_ptr(uint32_t base) {
+#ifdef SPARROW_HOST
+    return kstack_area[(base - KSTACK_REGION_BASE) / STACK_SIZE];
+#else
+    return (void *)(uintptr_t)base;
+#endif
+}
+
+static inline uint32_t kstack_base(uint32_t index) {
+    return KSTACK_REGION_BASE + index * STACK_SIZE;
+}
+
+void kstack_pool_init(kstack_pool_t *pool) {
+    memset(&pool->stats, 0, sizeof(kstack_stats_t));
+    pool->nr_clean = 0;
+
+    // 下标0在表尾，从低地址开始清零和分配
+    pool->nr_dirty = KSTACK_COUNT;
+    for (uint32_t i = 0; i < KSTACK_COUNT; i++) {
+        pool->dirty[i] = KSTACK_COUNT - 1 - i;
+    }
+
+    kstack_refill(pool, KSTACK_BOOT_CLEAN);
+    pool->stats.zeroed_idle = 0;
+}
+
+uint32_t kstack_alloc(kstack_pool_t *pool) {
+    uint32_t index;
+    if (pool->nr_clean > 0) {
+        index = pool->clean[--pool->nr_clean];
+        pool->stats.clean_hits++;
+    } else if (pool->nr_dirty > 0) {
+        index = pool->dirty[--pool->nr_dirty];
+        memset(kstack_ptr(kstack_base(index)), 0, STACK_SIZE);
+        pool->stats.zeroed_inline++;
+    } else {
+        return 0;
+    }
+
+    pool->stats.allocs++;
+    return kstack_base(index);
+}
+
+void kstack_free(kstack_pool_t *pool, uint32_t base) {
+    uint32_t index = (base - KSTACK_REGION_BASE) / STACK_SIZE;
+    if (base < KSTACK_REGION_BASE || index >= KSTACK_COUNT ||
+        pool->nr_clean + pool->nr_dirty >= KSTACK_COUNT) {
+        return;
+    }
+
+    pool->dirty[pool->nr_dirty++] = index;
+    pool->stats.frees++;
+}
+
+uint32_t kstack_refill(kstack_pool_t *pool, uint32_t max) {
+    uint32_t n = 0;
+    for (; n < max && pool->nr_dirty > 0; n++) {
+        uint32_t index = pool->dirty[--pool->nr_dirty];
+        memset(kstack_ptr(kstack_base(index)), 0, STACK_SIZE);
+        pool->clean[pool->nr_clean++] = index;
+    }
+    pool->stats.zeroed_idle += n;
+    return n;
+}
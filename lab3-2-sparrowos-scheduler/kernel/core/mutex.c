@@ -0,0 +1,299 @@
+/**
+ * mutex.c - 带优先级继承的内核互斥锁实现
+ * 位于: kernel/core/mutex.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/mutex.h"
+#include "kernel/include/scheduler.h"
+
+void kmutex_init(kmutex_t *mutex, kmutex_protocol_t protocol) {
+    memset(mutex, 0, sizeof(kmutex_t));
+    wait_queue_init(&mutex->waiters, WAIT_REASON_LOCK);
+    mutex->protocol = protocol;
+}
+
+/* ========== 有效优先级 ========== */
+
+/* 实时类高于其他所有进程，实时类之间按截止时间，其余按MLFQ级别（越小越高） */
+typedef struct {
+    bool rt;
+    uint32_t deadline;
+    uint8_t level;
+} pi_prio_t;
+
+static inline bool deadline_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+/* 不计继承时进程自身的优先级 */
+static pi_prio_t base_prio(const pcb_t *pcb) {
+    pi_prio_t p;
+    p.rt = PCB_IS_REALTIME(pcb);
+    p.deadline = p.rt ? pcb->cold->rt.release + pcb->cold->rt.rel_deadline : 0;
+    p.level = PCB_HAS_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED) ?
+              pcb->cold->pi.base_level : pcb->queue_level;
+    return p;
+}
+
+static pi_prio_t effective_prio(const pcb_t *pcb) {
+    pi_prio_t p = base_prio(pcb);
+    const pi_state_t *pi = &pcb->cold->pi;
+
+    if (PCB_HAS_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED)) {
+        p.level = pcb->queue_level;
+        if (pi->rt && (!p.rt || deadline_before(pi->deadline, p.deadline))) {
+            p.rt = true;
+            p.deadline = pi->deadline;
+        }
+    }
+    return p;
+}
+
+static bool prio_higher(const pi_prio_t *a, const pi_prio_t *b) {
+    if (a->rt != b->rt) {
+        return a->rt;
+    }
+    if (a->rt) {
+        return deadline_before(a->deadline, b->deadline);
+    }
+    return a->level < b->level;
+}
+
+/* ========== 优先级继承 ========== */
+
+/* 按持有的锁上所有等待者重新计算pcb的继承优先级 */
+static void pi_apply(pcb_t *pcb) {
+    pi_state_t *pi = &pcb->cold->pi;
+    pi_prio_t base = base_prio(pcb);
+    uint8_t level = base.level;
+    bool rt = false;
+    uint32_t deadline = 0;
+
+    for (kmutex_t *m = pi->held; m; m = m->next_held) {
+        if (m->protocol != KMUTEX_PROTO_INHERIT) {
+            continue;
+        }
+        for (pcb_t *w = m->waiters.head; w; w = w->next) {
+            pi_prio_t p = effective_prio(w);
+            if (p.level < level) {
+                level = p.level;
+            }
+            if (p.rt && (!rt || deadline_before(p.deadline, deadline))) {
+                rt = true;
+                deadline = p.deadline;
+            }
+        }
+    }
+    if (rt && base.rt && !deadline_before(deadline, base.deadline)) {
+        rt = false;     // 自己的截止时间更早，无需继承
+    }
+
+    bool boost = level < base.level || rt;
+    if (!boost && !PCB_HAS_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED)) {
+        return;
+    }
+
+    // 就绪进程按新优先级重新排队（先按旧级别摘下）
+    bool queued = pcb->state == PROCESS_READY;
+    if (queued) {
+        scheduler_ready_remove_locked(pcb);
+    }
+
+    if (boost) {
+        if (!PCB_HAS_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED)) {
+            pi->base_level = pcb->queue_level;
+            PCB_SET_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED);
+        }
+        pcb->queue_level = level;
+        pi->rt = rt;
+        pi->deadline = deadline;
+        if (rt && pcb->state != PROCESS_SLEEPING) {
+            pcb->deadline = deadline;
+        }
+    } else {
+        pcb->queue_level = pi->base_level;
+        pi->rt = false;
+        PCB_CLEAR_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED);
+        if (base.rt && pcb->state != PROCESS_SLEEPING) {
+            pcb->deadline = base.deadline;
+        }
+    }
+
+    if (queued) {
+        scheduler_ready_add_locked(pcb);
+    }
+}
+
+/* 从pcb开始沿"等待的锁 -> 持有者"链传递 */
+static void pi_update(pcb_t *pcb) {
+    for (int depth = 0; pcb && depth < KMUTEX_PI_MAX_DEPTH; depth++) {
+        pi_apply(pcb);
+
+        kmutex_t *next = pcb->cold->pi.blocked_on;
+        pcb = next && next->protocol == KMUTEX_PROTO_INHERIT ? next->owner : NULL;
+    }
+}
+
+/* ========== 获取与释放 ========== */
+
+static void mutex_acquire(kmutex_t *mutex, pcb_t *pcb) {
+    mutex->owner = pcb;
+    mutex->next_held = pcb->cold->pi.held;
+    pcb->cold->pi.held = mutex;
+    mutex->acquisitions++;
+}
+
+/* 继承协议下选有效优先级最高的等待者，同优先级先到先得；否则取队头 */
+static pcb_t* pick_waiter(kmutex_t *mutex) {
+    pcb_t *best = mutex->waiters.head;
+    if (!best || mutex->protocol != KMUTEX_PROTO_INHERIT) {
+        return best;
+    }
+
+    pi_prio_t best_prio = effective_prio(best);
+    for (pcb_t *w = best->next; w; w = w->next) {
+        pi_prio_t p = effective_prio(w);
+        if (prio_higher(&p, &best_prio)) {
+            best = w;
+            best_prio = p;
+        }
+    }
+    return best;
+}
+
+/* 释放锁并直接交给下一个等待者；返回该等待者是否应立即抢占原持有者 */
+static bool mutex_release(kmutex_t *mutex) {
+    pcb_t *owner = mutex->owner;
+
+    kmutex_t **link = &owner->cold->pi.held;
+    while (*link && *link != mutex) {
+        link = &(*link)->next_held;
+    }
+    if (*link) {
+        *link = mutex->next_held;
+    }
+    mutex->next_held = NULL;
+    mutex->owner = NULL;
+
+    pcb_t *next = pick_waiter(mutex);
+    if (next) {
+        wait_queue_remove(&mutex->waiters, next);
+        next->cold->pi.blocked_on = NULL;
+
+        uint32_t wait = scheduler_get_ticks() - next->cold->pi.block_start;
+        mutex->total_wait += wait;
+        if (wait > mutex->max_wait) {
+            mutex->max_wait = wait;
+        }
+
+        mutex_acquire(mutex, next);
+        pi_apply(next);         // 其余等待者继续提升新持有者
+    }
+
+    // 原持有者恢复到其余持有锁所需的优先级
+    pi_apply(owner);
+
+    if (!next) {
+        return false;
+    }
+    bool wake_preempt = scheduler_wake_locked(next);
+
+    pi_prio_t next_prio = effective_prio(next);
+    pi_prio_t owner_prio = effective_prio(owner);
+    return wake_preempt ||
+           (owner->state == PROCESS_RUNNING && prio_higher(&next_prio, &owner_prio));
+}
+
+int kmutex_lock(kmutex_t *mutex) {
+    if (!mutex) {
+        return -1;
+    }
+
+    irqflags_t flags = scheduler_lock();
+
+    pcb_t *current = scheduler_get_current_process();
+    if (!current || current->state != PROCESS_RUNNING || mutex->owner == current) {
+        scheduler_unlock(flags);
+        return -1;      // 没有可阻塞的进程，或重复加锁
+    }
+
+    if (!mutex->owner) {
+        mutex_acquire(mutex, current);
+        scheduler_unlock(flags);
+        return 0;
+    }
+
+    // 挂到锁的等待队列，并把优先级传给持有者
+    mutex->contentions++;
+    current->cold->pi.blocked_on = mutex;
+    current->cold->pi.block_start = scheduler_get_ticks();
+    scheduler_block_locked(&mutex->waiters);
+    if (mutex->protocol == KMUTEX_PROTO_INHERIT) {
+        pi_update(mutex->owner);
+    }
+
+    scheduler_unlock(flags);
+
+    // 被唤醒时锁已经交到当前进程手上
+    scheduler_schedule();
+    return 0;
+}
+
+int kmutex_trylock(kmutex_t *mutex) {
+    if (!mutex) {
+        return -1;
+    }
+
+    irqflags_t flags = scheduler_lock();
+
+    pcb_t *current = scheduler_get_current_process();
+    int ret = -1;
+    if (current && !mutex->owner) {
+        mutex_acquire(mutex, current);
+        ret = 0;
+    }
+
+    scheduler_unlock(flags);
+    return ret;
+}
+
+int kmutex_unlock(kmutex_t *mutex) {
+    if (!mutex) {
+        return -1;
+    }
+
+    irqflags_t flags = scheduler_lock();
+
+    if (!mutex->owner || mutex->owner != scheduler_get_current_process()) {
+        scheduler_unlock(flags);
+        return -1;
+    }
+    bool preempt = mutex_release(mutex);
+
+    scheduler_unlock(flags);
+
+    if (preempt) {
+        scheduler_yield();
+    }
+    return 0;
+}
+
+void kmutex_process_exit(pcb_t *pcb) {
+    pi_state_t *pi = &pcb->cold->pi;
+
+    kmutex_t *waiting = pi->blocked_on;
+    if (waiting) {
+        wait_queue_remove(&waiting->waiters, pcb);
+        pi->blocked_on = NULL;
+        if (waiting->owner && waiting->protocol == KMUTEX_PROTO_INHERIT) {
+            pi_update(waiting->owner);
+        }
+    }
+
+    while (pi->held) {
+        mutex_release(pi->held);
+    }
+}
@@ -0,0 +1,743 @@
+/**
+ * pcb.c - 进程控制块与调度队列实现
+ * 位于: kernel/core/pcb.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include "kernel/include/pcb.h"
+
+/* 当前生效的进程表（由process_table_init登记，供pcb_alloc/pcb_free使用） */
+static process_table_t *active_table = NULL;
+
+/* PCB冷数据池：与进程表槽位一一对应，热PCB数组因此保持紧凑 */
+static pcb_cold_t cold_pool[MAX_PROCESSES];
+
+/* ========== PCB管理 ========== */
+
+/* 第一个0位的位置（x不能全为1） */
+static inline uint32_t ffz(uint32_t x) {
+    return (uint32_t)__builtin_ctz(~x);
+}
+
+pcb_t* pcb_alloc(void) {
+    if (!active_table) {
+        return NULL;
+    }
+
+    // 二级位图找到第一个未满的字，字内找第一个空闲位：每32*32个槽位只看一个字
+    for (uint32_t s = 0; s < PROCESS_SUMMARY_WORDS; s++) {
+        uint32_t summary = active_table->full_map[s];
+        if (summary == UINT32_MAX) {
+            continue;
+        }
+
+        uint32_t word = s * 32 + ffz(summary);
+        uint32_t bits = active_table->bitmap[word];
+        uint32_t index = word * 32 + ffz(bits);
+
+        bits |= 1u << (index % 32);
+        active_table->bitmap[word] = bits;
+        if (bits == UINT32_MAX) {
+            active_table->full_map[s] |= 1u << (word % 32);
+        }
+        active_table->count++;
+        return &active_table->processes[index];
+    }
+    return NULL;
+}
+
+void pcb_free(pcb_t *pcb) {
+    if (!pcb || !active_table) {
+        return;
+    }
+
+    uint32_t index = (uint32_t)(pcb - active_table->processes);
+    if (index >= MAX_PROCESSES) {
+        return;
+    }
+
+    // 从父进程的子进程链表摘除
+    if (pcb->cold->parent) {
+        pcb_remove_child(pcb->cold->parent, pcb);
+    }
+    if (pcb->cold->children) {
+        pcb_orphan_children(pcb);
+    }
+
+    pcb_reset(pcb);
+    active_table->bitmap[index / 32] &= ~(1u << (index % 32));
+    active_table->full_map[index / (32 * 32)] &= ~(1u << (index / 32 % 32));
+
+    // 新代数使旧PID失效；用尽后回绕
+    if (++active_table->generation[index] > PID_MAX_GENERATION) {
+        active_table->generation[index] = 0;
+    }
+    if (active_table->count > 0) {
+        active_table->count--;
+    }
+}
+
+void pcb_init(pcb_t *pcb, uint32_t pid, const char *name,
+              process_type_t type, uint8_t priority) {
+    if (!pcb || !pcb->cold) {
+        return;
+    }
+
+    pcb_reset(pcb);
+
+    if (priority >= MAX_PRIORITY_LEVELS) {
+        priority = MAX_PRIORITY_LEVELS - 1;
+    }
+
+    pcb->pid = pid;
+    strncpy(pcb->cold->name, name ? name : "", PROCESS_NAME_LEN - 1);
+    pcb->cold->name[PROCESS_NAME_LEN - 1] = '\0';
+
+    pcb->state = PROCESS_NEW;
+    pcb->type = type;
+    pcb->flags = PROCESS_FLAG_NONE;
+    pcb->priority = priority;
+    pcb->cold->priority_original = priority;
+    pcb->queue_level = priority;
+    pcb->cold->working_dir = -1;
+    pcb->cold->interactivity.sleep_avg = INTERACTIVITY_SCALE;   // 未观察前按交互型对待
+    pcb->cold->last_cpu = PCB_NO_CPU;
+    pcb->magic_number = PCB_MAGIC;
+}
+
+void pcb_reset(pcb_t *pcb) {
+    if (!pcb) {
+        return;
+    }
+
+    // 冷数据与槽位绑定，清零时保留绑定关系
+    pcb_cold_t *cold = pcb->cold;
+    memset(pcb, 0, sizeof(pcb_t));
+    if (cold) {
+        memset(cold, 0, sizeof(pcb_cold_t));
+        pcb->cold = cold;
+    }
+}
+
+bool pcb_validate(const pcb_t *pcb) {
+    return pcb && pcb->magic_number == PCB_MAGIC && pcb->pid != 0;
+}
+
+/* ========== 进程状态 ========== */
+
+void pcb_set_state(pcb_t *pcb, process_state_t new_state) {
+    if (pcb) {
+        pcb->state = new_state;
+    }
+}
+
+bool pcb_is_runnable(const pcb_t *pcb) {
+    return pcb && (pcb->state == PROCESS_READY || pcb->state == PROCESS_RUNNING);
+}
+
+bool pcb_is_zombie(const pcb_t *pcb) {
+    return pcb && pcb->state == PROCESS_ZOMBIE;
+}
+
+bool pcb_is_terminated(const pcb_t *pcb) {
+    return pcb && pcb->state == PROCESS_TERMINATED;
+}
+
+/* ========== 优先级管理 ========== */
+
+void pcb_set_priority(pcb_t *pcb, uint8_t priority) {
+    if (!pcb) {
+        return;
+    }
+    if (priority >= MAX_PRIORITY_LEVELS) {
+        priority = MAX_PRIORITY_LEVELS - 1;
+    }
+    pcb->priority = priority;
+}
+
+uint8_t pcb_get_effective_priority(const pcb_t *pcb) {
+    if (!pcb) {
+        return MAX_PRIORITY_LEVELS - 1;
+    }
+    return PCB_HAS_FLAG(pcb, PROCESS_FLAG_SCHED_MLFQ) ? pcb->queue_level : pcb->priority;
+}
+
+/* ========== 统计信息 ========== */
+
+void pcb_update_stats(pcb_t *pcb, uint32_t runtime) {
+    if (!pcb) {
+        return;
+    }
+    if (pcb->type == PROCESS_TYPE_SYSTEM || PCB_HAS_FLAG(pcb, PROCESS_FLAG_KERNEL)) {
+        pcb->cold->stats.kernel_time += runtime;
+    } else {
+        pcb->cold->stats.user_time += runtime;
+    }
+}
+
+void pcb_reset_stats(pcb_t *pcb) {
+    if (pcb) {
+        memset(&pcb->cold->stats, 0, sizeof(pcb->cold->stats));
+    }
+}
+
+/* ========== 进程关系 ========== */
+
+void pcb_add_child(pcb_t *parent, pcb_t *child) {
+    if (!parent || !child) {
+        return;
+    }
+    child->cold->sibling = parent->cold->children;
+    parent->cold->children = child;
+    parent->cold->resources.child_processes++;
+}
+
+void pcb_remove_child(pcb_t *parent, pcb_t *child) {
+    if (!parent || !child) {
+        return;
+    }
+
+    pcb_t **link = &parent->cold->children;
+    while (*link) {
+        if (*link == child) {
+            *link = child->cold->sibling;
+            child->cold->sibling = NULL;
+            child->cold->parent = NULL;
+            if (parent->cold->resources.child_processes > 0) {
+                parent->cold->resources.child_processes--;
+            }
+            return;
+        }
+        link = &(*link)->cold->sibling;
+    }
+}
+
+void pcb_orphan_children(pcb_t *parent) {
+    if (!parent) {
+        return;
+    }
+
+    // 子进程脱离父进程（尚无init进程可收养）
+    pcb_t *child = parent->cold->children;
+    while (child) {
+        pcb_t *next = child->cold->sibling;
+        child->cold->parent = NULL;
+        child->cold->ppid = 0;
+        child->cold->sibling = NULL;
+        child = next;
+    }
+    parent->cold->children = NULL;
+    parent->cold->resources.child_processes = 0;
+}
+
+void pcb_prune_children(pcb_t *parent) {
+    if (!parent) {
+        return;
+    }
+
+    // 一次遍历摘除全部已回收（TERMINATED）的子进程，代替逐个pcb_remove_child
+    pcb_t **link = &parent->cold->children;
+    while (*link) {
+        pcb_t *child = *link;
+        if (child->state == PROCESS_TERMINATED) {
+            *link = child->cold->sibling;
+            child->cold->sibling = NULL;
+            child->cold->parent = NULL;
+            if (parent->cold->resources.child_processes > 0) {
+                parent->cold->resources.child_processes--;
+            }
+        } else {
+            link = &child->cold->sibling;
+        }
+    }
+}
+
+/* ========== 侵入式链表 ========== */
+
+/* 就绪、等待、睡眠队列都直接用PCB的next/prev串联，pcb->queue记录所属队列：
+ * 同一时刻一个PCB至多位于一个队列中，入队出队和按PCB删除都是O(1)且无需分配 */
+
+static inline void link_before(pcb_t **head, pcb_t **tail, pcb_t *pos, pcb_t *pcb) {
+    // pos为NULL时追加到队尾
+    pcb->next = pos;
+    pcb->prev = pos ? pos->prev : *tail;
+    if (pcb->prev) {
+        pcb->prev->next = pcb;
+    } else {
+        *head = pcb;
+    }
+    if (pos) {
+        pos->prev = pcb;
+    } else {
+        *tail = pcb;
+    }
+}
+
+static inline void unlink(pcb_t **head, pcb_t **tail, pcb_t *pcb) {
+    if (pcb->prev) {
+        pcb->prev->next = pcb->next;
+    } else {
+        *head = pcb->next;
+    }
+    if (pcb->next) {
+        pcb->next->prev = pcb->prev;
+    } else {
+        *tail = pcb->prev;
+    }
+    pcb->next = pcb->prev = NULL;
+    pcb->queue = NULL;
+}
+
+/* ========== 就绪队列操作 ========== */
+
+void ready_queue_init(ready_queue_t *queue, uint32_t max_count,
+                      uint32_t time_slice) {
+    if (!queue) {
+        return;
+    }
+
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->count = 0;
+    queue->time_slice = time_slice;
+    queue->max_count = max_count;
+}
+
+void ready_queue_enqueue(ready_queue_t *queue, pcb_t *pcb) {
+    if (!queue || !pcb || pcb->queue || ready_queue_is_full(queue)) {
+        return;
+    }
+
+    link_before(&queue->head, &queue->tail, NULL, pcb);
+    pcb->queue = queue;
+    queue->count++;
+}
+
+void ready_queue_enqueue_head(ready_queue_t *queue, pcb_t *pcb) {
+    if (!queue || !pcb || pcb->queue || ready_queue_is_full(queue)) {
+        return;
+    }
+
+    link_before(&queue->head, &queue->tail, queue->head, pcb);
+    pcb->queue = queue;
+    queue->count++;
+}
+
+pcb_t* ready_queue_dequeue(ready_queue_t *queue) {
+    if (!queue || !queue->head) {
+        return NULL;
+    }
+
+    pcb_t *pcb = queue->head;
+    unlink(&queue->head, &queue->tail, pcb);
+    queue->count--;
+    return pcb;
+}
+
+pcb_t* ready_queue_peek(const ready_queue_t *queue) {
+    return queue ? queue->head : NULL;
+}
+
+void ready_queue_remove(ready_queue_t *queue, pcb_t *pcb) {
+    if (!queue || !pcb || pcb->queue != queue) {
+        return;     // 不在该队列中
+    }
+
+    unlink(&queue->head, &queue->tail, pcb);
+    queue->count--;
+}
+
+bool ready_queue_is_empty(const ready_queue_t *queue) {
+    return !queue || queue->count == 0;
+}
+
+bool ready_queue_is_full(const ready_queue_t *queue) {
+    return queue && queue->max_count != 0 && queue->count >= queue->max_count;
+}
+
+void ready_queue_clear(ready_queue_t *queue) {
+    while (ready_queue_dequeue(queue)) {
+    }
+}
+
+/* ========== 等待队列操作 ========== */
+
+void wait_queue_init(wait_queue_t *queue, uint32_t wait_reason) {
+    if (!queue) {
+        return;
+    }
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->count = 0;
+    queue->wait_reason = wait_reason;
+}
+
+void wait_queue_enqueue(wait_queue_t *queue, pcb_t *pcb) {
+    if (!queue || !pcb || pcb->queue) {
+        return;
+    }
+
+    link_before(&queue->head, &queue->tail, NULL, pcb);
+    pcb->queue = queue;
+    queue->count++;
+}
+
+/* 按deadline升序插入（睡眠队列），到期检查只需看队头 */
+void wait_queue_enqueue_by_deadline(wait_queue_t *queue, pcb_t *pcb) {
+    if (!queue || !pcb || pcb->queue) {
+        return;
+    }
+
+    // 从队尾向前找：新睡眠者的deadline通常最晚
+    pcb_t *pos = queue->tail;
+    while (pos && (int32_t)(pos->deadline - pcb->deadline) > 0) {
+        pos = pos->prev;
+    }
+
+    link_before(&queue->head, &queue->tail, pos ? pos->next : queue->head, pcb);
+    pcb->queue = queue;
+    queue->count++;
+}
+
+pcb_t* wait_queue_dequeue(wait_queue_t *queue) {
+    if (!queue || !queue->head) {
+        return NULL;
+    }
+    pcb_t *pcb = queue->head;
+    wait_queue_remove(queue, pcb);
+    return pcb;
+}
+
+void wait_queue_remove(wait_queue_t *queue, pcb_t *pcb) {
+    if (!queue || !pcb || pcb->queue != queue) {
+        return;     // 不在该队列中
+    }
+
+    unlink(&queue->head, &queue->tail, pcb);
+    queue->count--;
+}
+
+/* ========== MLFQ管理 ========== */
+
+void mlfq_init(mlfq_t *mlfq, uint32_t levels, uint32_t boost_interval) {
+    if (!mlfq) {
+        return;
+    }
+    if (levels == 0 || levels > MAX_PRIORITY_LEVELS) {
+        levels = MAX_PRIORITY_LEVELS;
+    }
+
+    memset(mlfq, 0, sizeof(mlfq_t));
+    for (uint32_t i = 0; i < levels; i++) {
+        // 时间片随级别降低而指数增长；未启用的级别时间片为0
+        mlfq->time_slices[i] = calculate_time_slice((uint8_t)i, TIME_SLICE_BASE);
+        ready_queue_init(&mlfq->queues[i], MAX_PROCESSES, mlfq->time_slices[i]);
+    }
+
+    mlfq->boost_interval = boost_interval;
+    mlfq->last_boost_time = 0;
+    mlfq->demotion_threshold = 2 * TIME_SLICE_BASE;
+    mlfq->promotion_threshold = TIME_SLICE_BASE;
+    mlfq->total_processes = 0;
+}
+
+void mlfq_enqueue(mlfq_t *mlfq, pcb_t *pcb, uint8_t priority_level) {
+    if (!mlfq || !pcb) {
+        return;
+    }
+
+    // 落到最低的已启用级别
+    while (priority_level > 0 &&
+           (priority_level >= MAX_PRIORITY_LEVELS || mlfq->time_slices[priority_level] == 0)) {
+        priority_level--;
+    }
+
+    pcb->queue_level = priority_level;
+    ready_queue_enqueue(&mlfq->queues[priority_level], pcb);
+    mlfq->total_processes++;
+}
+
+pcb_t* mlfq_dequeue(mlfq_t *mlfq) {
+    if (!mlfq) {
+        return NULL;
+    }
+
+    for (int i = 0; i < MAX_PRIORITY_LEVELS; i++) {
+        if (mlfq->queues[i].count > 0) {
+            pcb_t *pcb = ready_queue_dequeue(&mlfq->queues[i]);
+            pcb->time_slice = mlfq_time_slice(mlfq, pcb);
+            if (mlfq->total_processes > 0) {
+                mlfq->total_processes--;
+            }
+            return pcb;
+        }
+    }
+    return NULL;
+}
+
+void mlfq_adjust_priority(mlfq_t *mlfq, pcb_t *pcb, bool used_full_slice) {
+    if (!mlfq || !pcb) {
+        return;
+    }
+
+    uint8_t level = pcb->queue_level;
+
+    if (used_full_slice) {
+        // 用完配额：降一级
+        if (level + 1 < MAX_PRIORITY_LEVELS && mlfq->time_slices[level + 1] != 0) {
+            pcb->queue_level = level + 1;
+            pcb->cold->demotions++;
+        }
+    } else if (level > 0) {
+        // 提前让出：升一级
+        pcb->queue_level = level - 1;
+        pcb->cold->promotions++;
+    }
+
+    pcb->time_in_queue = 0;
+    pcb->time_slice = mlfq_time_slice(mlfq, pcb);
+}
+
+/* 固定模式按周期提升；自适应模式只在低级别进程已有boost_interval个tick没有运行时提升 */
+bool mlfq_boost_due(const mlfq_t *mlfq, uint32_t current_time) {
+    if (!mlfq || mlfq->boost_interval == 0) {
+        return false;
+    }
+
+    uint32_t since = mlfq->last_boost_time;
+    if (mlfq->adaptive && (int32_t)(mlfq->last_low_run - since) > 0) {
+        since = mlfq->last_low_run;
+    }
+    return current_time - since >= mlfq->boost_interval;
+}
+
+/* 每tick记录低级别进程是否在运行（或根本没有低级别进程在等待） */
+void mlfq_note_tick(mlfq_t *mlfq, const pcb_t *current, uint32_t current_time) {
+    if (!mlfq->adaptive) {
+        return;
+    }
+    if (current && current->queue_level > 0) {
+        mlfq->last_low_run = current_time;
+        return;
+    }
+    for (int i = 1; i < MAX_PRIORITY_LEVELS; i++) {
+        if (mlfq->queues[i].count > 0) {
+            return;
+        }
+    }
+    mlfq->last_low_run = current_time;
+}
+
+bool mlfq_has_ready_above(const mlfq_t *mlfq, uint8_t level) {
+    for (uint8_t i = 0; i < level && i < MAX_PRIORITY_LEVELS; i++) {
+        if (mlfq->queues[i].count > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* 本级别时间片；自适应模式下按批处理程度（1 - 睡眠占比）拉长 */
+uint32_t mlfq_time_slice(const mlfq_t *mlfq, const pcb_t *pcb) {
+    uint32_t slice = mlfq->time_slices[pcb->queue_level];
+    if (!mlfq->adaptive) {
+        return slice;
+    }
+
+    uint32_t batch = INTERACTIVITY_SCALE - pcb->cold->interactivity.sleep_avg;
+    return slice + slice * (MLFQ_MAX_STRETCH - 1) * batch / INTERACTIVITY_SCALE;
+}
+
+void mlfq_boost_priorities(mlfq_t *mlfq, uint32_t current_time) {
+    if (!mlfq_boost_due(mlfq, current_time)) {
+        return;
+    }
+    mlfq->boosts++;
+
+    // 把所有低级别队列整体拼接到最高级别队列尾部
+    ready_queue_t *top = &mlfq->queues[0];
+    for (int i = 1; i < MAX_PRIORITY_LEVELS; i++) {
+        ready_queue_t *queue = &mlfq->queues[i];
+        if (!queue->head) {
+            continue;
+        }
+
+        for (pcb_t *pcb = queue->head; pcb; pcb = pcb->next) {
+            pcb->queue = top;
+            pcb->queue_level = 0;
+            pcb->time_in_queue = 0;
+            pcb->cold->promotions++;
+        }
+
+        queue->head->prev = top->tail;
+        if (top->tail) {
+            top->tail->next = queue->head;
+        } else {
+            top->head = queue->head;
+        }
+        top->tail = queue->tail;
+        top->count += queue->count;
+
+        queue->head = queue->tail = NULL;
+        queue->count = 0;
+    }
+
+    mlfq->last_boost_time = current_time;
+}
+
+/* ========== 交互性估计 ========== */
+
+#define INTERACTIVITY_MAX_WINDOW    (1u << 20)  // 单个窗口计入的最长时间，防止定点乘法溢出
+
+/* 以本窗口的睡眠占比更新EWMA，并开始新窗口 */
+static void interactivity_sample(pcb_t *pcb, uint32_t slept) {
+    interactivity_t *ia = &pcb->cold->interactivity;
+    uint32_t used = pcb->cold->stats.user_time + pcb->cold->stats.kernel_time;
+    uint32_t ran = used - ia->window_used;
+    ia->window_used = used;
+
+    if (slept > INTERACTIVITY_MAX_WINDOW) {
+        slept = INTERACTIVITY_MAX_WINDOW;
+    }
+    if (ran > INTERACTIVITY_MAX_WINDOW) {
+        ran = INTERACTIVITY_MAX_WINDOW;
+    }
+    if (slept + ran == 0) {
+        return;
+    }
+
+    int32_t sample = (int32_t)(slept * INTERACTIVITY_SCALE / (slept + ran));
+    int32_t avg = (int32_t)ia->sleep_avg;
+    ia->sleep_avg = (uint32_t)(avg + (sample - avg) / (1 << INTERACTIVITY_EWMA_SHIFT));
+}
+
+void interactivity_block(pcb_t *pcb, uint32_t now) {
+    pcb->cold->interactivity.sleep_start = now;
+}
+
+void interactivity_wake(pcb_t *pcb, uint32_t now) {
+    uint32_t slept = now - pcb->cold->interactivity.sleep_start;
+    pcb->cold->stats.sleep_time += slept;
+    interactivity_sample(pcb, slept);
+}
+
+/* 运行中的进程每tick调用：连续运行满一个窗口时记一个睡眠占比为0的样本 */
+void interactivity_tick(pcb_t *pcb) {
+    const interactivity_t *ia = &pcb->cold->interactivity;
+    uint32_t used = pcb->cold->stats.user_time + pcb->cold->stats.kernel_time;
+    if (used - ia->window_used >= INTERACTIVITY_WINDOW) {
+        interactivity_sample(pcb, 0);
+    }
+}
+
+/* ========== 进程表管理 ========== */
+
+void process_table_init(process_table_t *table) {
+    if (!table) {
+        return;
+    }
+    memset(table, 0, sizeof(process_table_t));
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        table->processes[i].cold = &cold_pool[i];
+    }
+    // 二级位图末字中不对应任何一级字的位视为已满
+    for (uint32_t w = PROCESS_BITMAP_WORDS; w < PROCESS_SUMMARY_WORDS * 32; w++) {
+        table->full_map[w / 32] |= 1u << (w % 32);
+    }
+    active_table = table;
+}
+
+pcb_t* process_table_find(process_table_t *table, uint32_t pid) {
+    if (!table || pid == 0) {
+        return NULL;
+    }
+
+    uint32_t slot = PID_SLOT(pid);
+    if (!(table->bitmap[slot / 32] & (1u << (slot % 32)))) {
+        return NULL;
+    }
+    pcb_t *pcb = &table->processes[slot];
+    return pcb->pid == pid ? pcb : NULL;
+}
+
+uint32_t process_table_slot(const process_table_t *table, const pcb_t *pcb) {
+    return (uint32_t)(pcb - table->processes);
+}
+
+/* 为刚分配的槽位生成PID */
+uint32_t process_table_make_pid(const process_table_t *table, const pcb_t *pcb) {
+    uint32_t slot = process_table_slot(table, pcb);
+    return table->generation[slot] * MAX_PROCESSES + slot + 1;
+}
+
+pcb_t* process_table_find_by_name(process_table_t *table, const char *name) {
+    if (!table || !name) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        if ((table->bitmap[i / 32] & (1u << (i % 32))) &&
+            strncmp(table->processes[i].cold->name, name, PROCESS_NAME_LEN) == 0) {
+            return &table->processes[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t process_table_get_count(const process_table_t *table) {
+    return table ? table->count : 0;
+}
+
+/* ========== 调试 ========== */
+
+void pcb_dump_brief(const pcb_t *pcb) {
+    if (!pcb) {
+        printf("  (null)\n");
+        return;
+    }
+    printf("  PID:%u Name:%s State:%d Priority:%u Level:%u Used:%u Slice:%u/%u\n",
+           pcb->pid, pcb->cold->name, pcb->state, pcb->priority, pcb->queue_level,
+           pcb->cold->time_used, pcb->time_slice_used, pcb->time_slice);
+}
+
+/* ========== 工具函数 ========== */
+
+uint32_t calculate_time_slice(uint8_t priority, uint32_t base_slice) {
+    if (priority >= MAX_PRIORITY_LEVELS) {
+        priority = MAX_PRIORITY_LEVELS - 1;
+    }
+    if (base_slice == 0) {
+        base_slice = TIME_SLICE_BASE;
+    }
+    // 优先级越低时间片越长：base, 2*base, 4*base, ...
+    return base_slice << priority;
+}
+
+bool should_preempt(const pcb_t *current, const pcb_t *next) {
+    if (!current || !next || current == next) {
+        return false;
+    }
+
+    // 只有交互型/IO型（标志或测得的睡眠占比）的进程唤醒时抢占，且不抢占交互型进程
+    bool interactive = PCB_HAS_FLAG(next, PROCESS_FLAG_INTERACTIVE | PROCESS_FLAG_IO_BOUND) ||
+                       next->cold->interactivity.sleep_avg >= INTERACTIVE_THRESHOLD;
+    if (!interactive || PCB_IS_INTERACTIVE(current)) {
+        return false;
+    }
+
+    // 当前进程刚开始本时间片时不抢占
+    if (current->time_slice_used < WAKEUP_MIN_RUN) {
+        return false;
+    }
+
+    // MLFQ中位于更高级别，或虚拟运行时间领先超过粒度
+    if (PCB_HAS_FLAG(next, PROCESS_FLAG_SCHED_MLFQ) &&
+        PCB_HAS_FLAG(current, PROCESS_FLAG_SCHED_MLFQ) &&
+        next->queue_level < current->queue_level) {
+        return true;
+    }
+    return (int32_t)(current->vruntime - next->vruntime) >= WAKEUP_GRANULARITY;
+}
@@ -0,0 +1,59 @@
+/**
+ * placement.c - 缓存亲和的任务放置实现
+ * 位于: kernel/core/placement.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/placement.h"
+
+void placement_init(placement_t *pl, uint32_t num_cpus, uint32_t migration_cost) {
+    memset(pl, 0, sizeof(placement_t));
+    pl->num_cpus = (num_cpus == 0 || num_cpus > MAX_CPUS) ? 1 : num_cpus;
+    pl->migration_cost = migration_cost;
+    pl->imbalance = PLACEMENT_DEFAULT_IMBALANCE;
+}
+
+uint32_t placement_select_cpu(placement_t *pl, const pcb_t *pcb,
+                              const uint32_t *nr_running, uint32_t now) {
+    uint32_t prev = pcb->cold->last_cpu;
+    bool ran_before = prev < pl->num_cpus;
+    pl->stats.placements++;
+
+    // 最空闲的CPU，负载相同时优先上次运行的CPU
+    uint32_t idlest = ran_before ? prev : 0;
+    for (uint32_t cpu = 0; cpu < pl->num_cpus; cpu++) {
+        if (nr_running[cpu] < nr_running[idlest]) {
+            idlest = cpu;
+        }
+    }
+
+    if (!ran_before) {
+        pl->stats.first_runs++;
+        return idlest;
+    }
+
+    if (placement_cache_hot(pl, pcb, now)) {
+        if (nr_running[prev] <= nr_running[idlest] + pl->imbalance) {
+            pl->stats.affine++;
+            return prev;
+        }
+        pl->stats.affine_overridden++;
+    } else if (idlest == prev) {
+        pl->stats.cold_stays++;
+    }
+
+    if (idlest != prev) {
+        pl->stats.migrations++;
+    }
+    return idlest;
+}
+
+bool placement_can_pull(placement_t *pl, const pcb_t *pcb, uint32_t src_queued, uint32_t now) {
+    if (!placement_cache_hot(pl, pcb, now) || src_queued > pl->imbalance) {
+        return true;
+    }
+    pl->stats.pulls_refused++;
+    return false;
+}
@@ -0,0 +1,238 @@
+/**
+ * replay.c - 调度决策录制与重放实现
+ * 位于: kernel/core/replay.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "kernel/include/replay.h"
+
+/* 每种记录的参数个数 */
+static const uint8_t replay_nargs[REPLAY_NR_OPS] = {
+    [REPLAY_TICK]       = 1,
+    [REPLAY_CREATE]     = 4,
+    [REPLAY_EXIT]       = 2,
+    [REPLAY_REAP]       = 1,
+    [REPLAY_BLOCK]      = 1,
+    [REPLAY_WAKEUP]     = 1,
+    [REPLAY_WAKEUP_IRQ] = 1,
+    [REPLAY_SLEEP]      = 1,
+    [REPLAY_YIELD]      = 0,
+    [REPLAY_SCHEDULE]   = 0,
+    [REPLAY_PRIORITY]   = 2,
+    [REPLAY_PICK]       = 1,
+    [REPLAY_REAPER]     = 1,
+};
+
+static const char *replay_op_names[REPLAY_NR_OPS] = {
+    [REPLAY_TICK]       = "tick",
+    [REPLAY_CREATE]     = "create",
+    [REPLAY_EXIT]       = "exit",
+    [REPLAY_REAP]       = "reap",
+    [REPLAY_BLOCK]      = "block",
+    [REPLAY_WAKEUP]     = "wakeup",
+    [REPLAY_WAKEUP_IRQ] = "wakeup-irq",
+    [REPLAY_SLEEP]      = "sleep",
+    [REPLAY_YIELD]      = "yield",
+    [REPLAY_SCHEDULE]   = "schedule",
+    [REPLAY_PRIORITY]   = "priority",
+    [REPLAY_PICK]       = "pick",
+    [REPLAY_REAPER]     = "reaper",
+};
+
+const char* replay_op_name(uint32_t op) {
+    return op < REPLAY_NR_OPS && replay_op_names[op] ? replay_op_names[op] : "?";
+}
+
+void replay_init_record(replay_t *r, uint8_t *buf, uint32_t cap) {
+    memset(r, 0, sizeof(replay_t));
+    r->buf = buf;
+    r->cap = cap;
+}
+
+void replay_init_verify(replay_t *r, const uint8_t *log, uint32_t len) {
+    memset(r, 0, sizeof(replay_t));
+    r->buf = (uint8_t *)log;
+    r->cap = len;
+    r->len = len;
+    r->verifying = true;
+}
+
+/* ========== 编码 ========== */
+
+/* LEB128：每字节7位，最高位表示后面还有字节 */
+static inline uint32_t varint_size(uint32_t v) {
+    uint32_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static void emit(replay_t *r, replay_op_t op, const uint32_t *args) {
+    uint32_t size = 1;
+    for (uint32_t i = 0; i < replay_nargs[op]; i++) {
+        size += varint_size(args[i]);
+    }
+    if (r->overflow || r->len + size > r->cap) {
+        r->overflow = true;
+        return;
+    }
+
+    r->buf[r->len++] = (uint8_t)op;
+    for (uint32_t i = 0; i < replay_nargs[op]; i++) {
+        uint32_t v = args[i];
+        while (v >= 0x80) {
+            r->buf[r->len++] = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        r->buf[r->len++] = (uint8_t)v;
+    }
+    r->entries++;
+}
+
+static void flush_ticks(replay_t *r) {
+    if (r->pending_ticks) {
+        emit(r, REPLAY_TICK, &r->pending_ticks);
+        r->pending_ticks = 0;
+    }
+}
+
+void replay_finish(replay_t *r) {
+    if (!r->verifying) {
+        flush_ticks(r);
+    }
+}
+
+/* 解码pos处的记录，不移动读取位置；日志结束或损坏时返回0，否则返回记录长度 */
+static uint32_t decode(const replay_t *r, uint32_t pos, replay_entry_t *entry) {
+    memset(entry, 0, sizeof(replay_entry_t));
+    if (pos >= r->len) {
+        return 0;
+    }
+
+    uint32_t start = pos;
+    entry->op = r->buf[pos++];
+    if (entry->op == 0 || entry->op >= REPLAY_NR_OPS) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < replay_nargs[entry->op]; i++) {
+        uint32_t v = 0;
+        for (uint32_t shift = 0; ; shift += 7) {
+            if (pos >= r->len || shift > 28) {
+                return 0;
+            }
+            uint8_t byte = r->buf[pos++];
+            v |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        entry->args[i] = v;
+    }
+    return pos - start;
+}
+
+/* ========== 录制与校验 ========== */
+
+static void diverge(replay_t *r, const replay_entry_t *expected, const replay_entry_t *actual) {
+    if (r->diverged) {
+        return;
+    }
+    r->diverged = true;
+    r->diverge_pos = r->pos;
+    r->diverge_tick = r->now;
+    r->expected = *expected;
+    r->actual = *actual;
+}
+
+void replay_input(replay_t *r, replay_op_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    if (op == REPLAY_TICK) {
+        r->now++;
+        if (!r->verifying) {
+            r->pending_ticks++;
+        }
+        return;
+    }
+    if (r->verifying) {
+        return;
+    }
+
+    uint32_t args[REPLAY_MAX_ARGS] = { a, b, c, d };
+    flush_ticks(r);
+    emit(r, op, args);
+}
+
+void replay_pick(replay_t *r, uint32_t pid) {
+    r->picks++;
+    if (!r->verifying) {
+        flush_ticks(r);
+        emit(r, REPLAY_PICK, &pid);
+        return;
+    }
+    if (r->diverged) {
+        return;
+    }
+
+    replay_entry_t expected;
+    replay_entry_t actual = { .op = REPLAY_PICK, .args = { pid } };
+    uint32_t size = decode(r, r->pos, &expected);
+    if (size == 0 || expected.op != REPLAY_PICK || expected.args[0] != pid) {
+        diverge(r, &expected, &actual);
+        return;
+    }
+    r->pos += size;
+    r->entries++;
+}
+
+bool replay_wakeup_irq(replay_t *r, uint32_t *pid) {
+    if (!r->verifying || r->diverged || r->now != r->tick_end) {
+        return false;
+    }
+
+    replay_entry_t entry;
+    uint32_t size = decode(r, r->pos, &entry);
+    if (size == 0 || entry.op != REPLAY_WAKEUP_IRQ) {
+        return false;
+    }
+    *pid = entry.args[0];
+    r->pos += size;
+    r->entries++;
+    return true;
+}
+
+bool replay_next(replay_t *r, replay_entry_t *entry) {
+    if (r->diverged) {
+        return false;
+    }
+
+    uint32_t size = decode(r, r->pos, entry);
+    if (size == 0) {
+        if (r->pos < r->len) {
+            replay_entry_t none = {0};
+            diverge(r, entry, &none);           // 日志损坏
+        }
+        return false;
+    }
+    if (entry->op == REPLAY_PICK || entry->op == REPLAY_WAKEUP_IRQ) {
+        // 日志中这里做过一次选择或排空过唤醒，重放时调度器没有
+        replay_entry_t none = {0};
+        diverge(r, entry, &none);
+        return false;
+    }
+
+    r->pos += size;
+    r->entries++;
+    if (entry->op == REPLAY_TICK) {
+        r->tick_end = r->now + entry->args[0];
+    }
+    return true;
+}
+
+void replay_mismatch(replay_t *r, const replay_entry_t *expected, uint32_t actual) {
+    replay_entry_t got = *expected;
+    got.args[REPLAY_MAX_ARGS - 1] = actual;
+    diverge(r, expected, &got);
+}
@@ -11,33 +11,86 @@
 #include "kernel/include/scheduler.h"
 #include "kernel/include/interrupt.h"
 #include "kernel/include/spinlock.h"
+#include "kernel/include/fpu.h"
+#include "kernel/include/switch.h"
+#include "kernel/include/edf.h"
+#include "kernel/include/mutex.h"
+#include "kernel/include/wakelist.h"
+#include "kernel/include/trace.h"
+#include "kernel/include/group.h"
+#include "kernel/include/kstack.h"
+#include "kernel/include/replay.h"
+#include "kernel/include/idle.h"
+
+/* 调度事件日志；主机模拟器以 -DSCHED_QUIET 构建，关闭逐事件输出 */
+#ifdef SCHED_QUIET
+#define sched_log(...)  do { if (0) printf(__VA_ARGS__); } while (0)
+#else
+#define sched_log(...)  printf(__VA_ARGS__)
+#endif
+
+#define STATUS_TRACE_EVENTS     8       // scheduler_print_status输出的最近事件数
+
+/* 录制调度器输入（未设置录制器时为空操作）；调用者持有调度器锁 */
+#define record_input(op, a, b, c, d) \
+    do { \
+        if (scheduler_state.recorder) { \
+            replay_input(scheduler_state.recorder, (op), (a), (b), (c), (d)); \
+        } \
+    } while (0)
+
+/* 利用率与吞吐量按窗口计算，保存上一个窗口结束时的采样 */
+#define STATS_UTIL_WINDOW       100     // CPU利用率窗口（tick）
+#define STATS_THROUGHPUT_WINDOW 1000    // 吞吐量窗口（tick）
+
+typedef struct {
+    uint32_t util_start;                // 利用率窗口开始时刻
+    uint32_t util_idle_start;           // 利用率窗口开始时空闲进程的运行时间
+    uint32_t tput_start;                // 吞吐量窗口开始时刻
+    uint32_t tput_completed_start;      // 吞吐量窗口开始时的完成进程数
+} stats_window_t;
 
 /* 全局调度器状态 */
 typedef struct {
     scheduler_config_t config;          // 调度器配置
     process_table_t process_table;      // 进程表
+    kstack_pool_t kstacks;              // 内核栈池
     mlfq_t mlfq;                        // 多级反馈队列
+    edf_rq_t edf;                       // 实时进程（EDF），优先于其他所有队列
+    group_sched_t groups;               // 调度组（分组进程在组内就绪队列中）
     ready_queue_t ready_queue;          // 通用就绪队列
     wait_queue_t wait_queue;            // 等待队列
     wait_queue_t sleep_queue;           // 睡眠队列
+    wake_list_t wake_lists[MAX_CPUS];   // 中断上下文推迟的唤醒（无锁）
+    idle_governor_t idle[MAX_CPUS];     // 每CPU的空闲状态调控器
+    uint64_t tick_stamp;                // 最近一次时钟tick的idle_clock()时刻
+    pcb_t *reap_head;                   // 已回收、等待释放的僵尸（经cold->reap_next串联）
+    pcb_t *reap_tail;
+    uint32_t reap_pending;
+    reaper_stats_t reaper;              // 回收器统计
     
     pcb_t *current_process;             // 当前运行进程
     pcb_t *idle_process;                // 空闲进程
     pcb_t *init_process;                // init进程
     
     scheduler_stats_t stats;            // 调度统计
+    stats_window_t stats_window;        // 利用率/吞吐量的上一次采样点
     uint32_t system_ticks;              // 系统时钟滴答
     uint32_t last_schedule_time;        // 上次调度时间
+    uint32_t min_vruntime;              // 未分组进程vruntime的单调下界，唤醒与新建时据此放置
+    uint32_t min_vruntime_scan;         // 上次扫描就绪队列推进min_vruntime的时刻
     
     spinlock_t scheduler_lock;          // 调度器自旋锁
     bool scheduler_running;             // 调度器运行标志
     bool need_reschedule;               // 需要重新调度标志
+    replay_t *recorder;                 // 输入与决策的录制/重放校验，NULL表示关闭
 } scheduler_state_t;
 
 static scheduler_state_t scheduler_state;
 
 /* 调度器内部函数声明 */
-static pcb_t* find_free_pcb(void);
+static pcb_t* create_process_locked(const process_spec_t *spec);
+static void schedule(void);
 static void add_to_ready_queue_internal(pcb_t *pcb);
 static void remove_from_ready_queue_internal(pcb_t *pcb);
 static pcb_t* get_next_process(void);
@@ -46,18 +99,86 @@ static void check_sleeping_processes(void);
 static void update_scheduler_stats(void);
 static void load_balance(void);
 static void scheduler_tick_handler(void);
+static void rt_job_wakeup(pcb_t *pcb);
+static void interactive_wakeup(pcb_t *pcb);
+static void drain_wake_list(void);
+static void note_ready(pcb_t *pcb, bool woken);
+static bool root_runnable(void);
+static uint64_t next_timer_event(void);
+static uint32_t reap_zombies(uint32_t max, bool forced);
+static bool wakeup_preempt(pcb_t *pcb);
+static void update_min_vruntime(void);
+static void place_vruntime(pcb_t *pcb);
+
+/* 本CPU是否有工作等着空闲进程让出 */
+static inline bool idle_work_pending(void) {
+    return scheduler_state.need_reschedule ||
+           !wake_list_empty(&scheduler_state.wake_lists[this_cpu_id()]);
+}
+
+/* 中断上下文唤醒时记下时刻，只在本CPU处于空闲期时读时钟 */
+static inline void idle_note_wakeup(void) {
+    idle_governor_t *gov = &scheduler_state.idle[this_cpu_id()];
+    if (gov->in_period) {
+        idle_governor_note_wakeup(gov, idle_clock());
+    }
+}
 
-/* 空闲进程函数 */
+/* 空闲进程函数：由空闲调控器在轮询与hlt之间选择 */
 static void idle_process_entry(void) {
     while (1) {
-        // HLT指令让CPU进入低功耗状态，等待中断
-        __asm__ volatile("hlt");
+        idle_governor_t *gov = &scheduler_state.idle[this_cpu_id()];
+        uint64_t now = idle_clock();
+        
+        if (idle_governor_select(gov, now, next_timer_event()) == IDLE_POLL) {
+            uint64_t end = now + gov->config.poll_limit;
+            while (!idle_work_pending() && idle_clock() < end) {
+                cpu_relax();
+            }
+        } else {
+            // 关中断后再检查一次：sti的下一条指令执行完才响应中断，
+            // 检查之后到达的中断一定会把CPU从hlt中唤醒
+            __asm__ volatile("cli");
+            if (!idle_work_pending()) {
+                // HLT指令让CPU进入低功耗状态，等待中断
+                __asm__ volatile("sti; hlt");
+            } else {
+                __asm__ volatile("sti");
+            }
+        }
+        
+        // 时钟中断可能已经直接切走了空闲进程，那时exit已由schedule完成
+        bool work = idle_work_pending();
+        idle_governor_exit(gov, idle_clock(), work);
+        if (work) {
+            scheduler_schedule();
+        }
     }
 }
 
+#ifndef SPARROW_HOST
+/* 新进程首次被switch_to切入时从这里开始执行 */
+static void task_bootstrap(void) {
+    // 切换发生在scheduler_schedule关中断持锁期间，锁由切入方释放；
+    // 新进程没有自己保存的中断状态，直接开中断
+    spinlock_unlock(&scheduler_state.scheduler_lock);
+    local_irq_enable();
+    
+    pcb_t *self = scheduler_state.current_process;
+    void (*entry)(void) = (void (*)(void))(uintptr_t)self->cold->context.eip;
+    if (entry) {
+        entry();
+    }
+    
+    // 入口函数返回即进程退出
+    scheduler_terminate_process(self->pid, 0);
+    scheduler_schedule();
+}
+#endif
+
 /* 初始化调度器 */
 void scheduler_init(scheduler_config_t *config) {
-    printf("SparrowOS Scheduler Initializing...\n");
+    sched_log("SparrowOS Scheduler Initializing...\n");
     
     // 初始化调度器状态
     memset(&scheduler_state, 0, sizeof(scheduler_state_t));
@@ -78,6 +199,7 @@ void scheduler_init(scheduler_config_t *config) {
     
     // 初始化进程表
     process_table_init(&scheduler_state.process_table);
+    kstack_pool_init(&scheduler_state.kstacks);
     
     // 初始化就绪队列
     ready_queue_init(&scheduler_state.ready_queue, 
@@ -87,12 +209,31 @@ void scheduler_init(scheduler_config_t *config) {
     // 初始化等待队列
     wait_queue_init(&scheduler_state.wait_queue, WAIT_REASON_UNKNOWN);
     wait_queue_init(&scheduler_state.sleep_queue, WAIT_REASON_SLEEP);
+    for (int i = 0; i < MAX_CPUS; i++) {
+        wake_list_init(&scheduler_state.wake_lists[i]);
+        idle_governor_init(&scheduler_state.idle[i], NULL);
+    }
+    
+    // 初始化实时调度类
+    edf_rq_init(&scheduler_state.edf, scheduler_state.config.rt_util_limit);
+    group_sched_init(&scheduler_state.groups);
     
     // 初始化MLFQ（如果使用）
     if (scheduler_state.config.scheduler_type == SCHEDULER_MLFQ) {
         mlfq_init(&scheduler_state.mlfq, 
                  scheduler_state.config.num_priority_levels,
                  scheduler_state.config.boost_interval);
+        
+        // 按配置的基础时间片重新计算各级时间片和降级阈值
+        for (int i = 0; i < MAX_PRIORITY_LEVELS; i++) {
+            if (scheduler_state.mlfq.time_slices[i] != 0) {
+                scheduler_state.mlfq.time_slices[i] = calculate_time_slice(
+                    i, scheduler_state.config.time_quantum);
+            }
+        }
+        scheduler_state.mlfq.demotion_threshold = 
+            2 * scheduler_state.mlfq.time_slices[0];
+        scheduler_state.mlfq.adaptive = scheduler_state.config.adaptive_mlfq;
     }
     
     // 初始化自旋锁
@@ -107,12 +248,15 @@ void scheduler_init(scheduler_config_t *config) {
     );
     
     if (!scheduler_state.idle_process) {
-        printf("ERROR: Failed to create idle process\n");
+        sched_log("ERROR: Failed to create idle process\n");
         return;
     }
     
+    // 空闲进程不参与就绪队列调度，只在无进程可运行时被选中
+    remove_from_ready_queue_internal(scheduler_state.idle_process);
+    
     // 设置空闲进程的入口点
-    scheduler_state.idle_process->context.eip = (uint32_t)idle_process_entry;
+    scheduler_state.idle_process->cold->context.eip = (uint32_t)(uintptr_t)idle_process_entry;
     
     // 设置当前进程为空闲进程
     scheduler_state.current_process = scheduler_state.idle_process;
@@ -129,12 +273,16 @@ void scheduler_init(scheduler_config_t *config) {
     // 注册定时器中断处理函数
     interrupt_register_handler(IRQ_TIMER, scheduler_tick_handler);
     
-    printf("Scheduler initialized successfully\n");
-    printf("  Type: %s\n", 
+    // 惰性FPU切换：注册#NM处理函数
+    fpu_init();
+    trace_init();
+    
+    sched_log("Scheduler initialized successfully\n");
+    sched_log("  Type: %s\n", 
            scheduler_state.config.scheduler_type == SCHEDULER_MLFQ ? "MLFQ" :
            scheduler_state.config.scheduler_type == SCHEDULER_RR ? "RR" : "FIFO");
-    printf("  Time quantum: %d\n", scheduler_state.config.time_quantum);
-    printf("  Preemption: %s\n", scheduler_state.config.enable_preemption ? "enabled" : "disabled");
+    sched_log("  Time quantum: %d\n", scheduler_state.config.time_quantum);
+    sched_log("  Preemption: %s\n", scheduler_state.config.enable_preemption ? "enabled" : "disabled");
 }
 
 /* 创建新进程 */
@@ -142,45 +290,118 @@ pcb_t* scheduler_create_process(const char *name,
                                process_type_t type,
                                uint8_t priority,
                                process_flags_t flags) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    process_spec_t spec = { name, type, priority, flags };
+    
+    // 僵尸积压过多时先回收，进程表已满时回收后重试；reap_pending只在持锁时读
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    if (scheduler_state.reap_pending >= REAPER_HIGH_WATER) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        reap_zombies(0, true);
+        irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    }
+    pcb_t *pcb = create_process_locked(&spec);
+    if (!pcb && scheduler_state.reap_pending > 0) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        reap_zombies(0, true);
+        irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+        pcb = create_process_locked(&spec);
+    }
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    if (pcb) {
+        sched_log("Process created: PID=%d, Name=%s, Priority=%d\n", 
+               pcb->pid, pcb->cold->name, pcb->priority);
+    }
     
-    // 分配PCB
+    return pcb;
+}
+
+/* 批量创建进程：一次持锁完成全部分配、初始化与入队 */
+int scheduler_create_processes(const process_spec_t *specs, uint32_t count, pcb_t **out) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    if (scheduler_state.reap_pending >= REAPER_HIGH_WATER) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        reap_zombies(0, true);
+        irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    }
+    
+    // 全部成功或一个也不创建；不足时先释放回收链表上的僵尸
+    bool short_of = MAX_PROCESSES - scheduler_state.process_table.count < count ||
+                    kstack_available(&scheduler_state.kstacks) < count;
+    if (short_of && scheduler_state.reap_pending > 0) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        reap_zombies(0, true);
+        irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    }
+    if (MAX_PROCESSES - scheduler_state.process_table.count < count ||
+        kstack_available(&scheduler_state.kstacks) < count) {
+        sched_log("ERROR: Cannot create %u processes\n", count);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        pcb_t *pcb = create_process_locked(&specs[i]);
+        if (out) {
+            out[i] = pcb;
+        }
+    }
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    sched_log("Created %u processes in one batch\n", count);
+    
+    return (int)count;
+}
+
+/* 分配并初始化进程、加入就绪队列（调用者持有调度器锁） */
+static pcb_t* create_process_locked(const process_spec_t *spec) {
+    // 分配PCB与内核栈
     pcb_t *pcb = pcb_alloc();
     if (!pcb) {
-        printf("ERROR: No free PCB available\n");
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        sched_log("ERROR: No free PCB available\n");
+        return NULL;
+    }
+    uint32_t stack = kstack_alloc(&scheduler_state.kstacks);
+    if (!stack) {
+        sched_log("ERROR: No free kernel stack available\n");
+        pcb_free(pcb);
         return NULL;
     }
     
     // 初始化PCB
-    uint32_t pid = scheduler_state.process_table.next_pid++;
-    pcb_init(pcb, pid, name, type, priority);
+    uint8_t priority = spec->priority;
+    uint32_t pid = process_table_make_pid(&scheduler_state.process_table, pcb);
+    pcb_init(pcb, pid, spec->name, spec->type, priority);
     
-    // 设置进程标志
-    pcb->flags = flags;
+    // 设置进程标志；实时类只能经scheduler_set_realtime的接纳控制进入
+    pcb->flags = spec->flags & ~PROCESS_FLAG_REALTIME;
     
     // 设置父进程（如果有当前进程）
     if (scheduler_state.current_process && 
         scheduler_state.current_process != scheduler_state.idle_process) {
-        pcb->ppid = scheduler_state.current_process->pid;
-        pcb->parent = scheduler_state.current_process;
+        pcb->cold->ppid = scheduler_state.current_process->pid;
+        pcb->cold->parent = scheduler_state.current_process;
         pcb_add_child(scheduler_state.current_process, pcb);
     } else {
-        pcb->ppid = 0;  // 孤儿进程
-        pcb->parent = NULL;
+        pcb->cold->ppid = 0;  // 孤儿进程
+        pcb->cold->parent = NULL;
     }
     
     // 设置时间信息
-    pcb->time_created = scheduler_state.system_ticks;
+    pcb->cold->time_created = scheduler_state.system_ticks;
     pcb->time_slice = calculate_time_slice(priority, scheduler_state.config.time_quantum);
     
-    // 分配栈空间（模拟）
-    pcb->stack_base = 0x1000000 + (pid * STACK_SIZE);
-    pcb->stack_size = STACK_SIZE;
+    // 栈池给出的栈已清零
+    pcb->cold->stack_base = stack;
+    pcb->cold->stack_size = STACK_SIZE;
     
     // 设置初始CPU上下文
-    pcb->context.esp = pcb->stack_base + STACK_SIZE - sizeof(uint32_t);
-    pcb->context.eflags = 0x00000202;  // 中断使能，IOPL=0
+    pcb->cold->context.esp = pcb->cold->stack_base + STACK_SIZE - sizeof(uint32_t);
+    pcb->cold->context.eflags = 0x00000202;  // 中断使能，IOPL=0
+#ifndef SPARROW_HOST
+    switch_frame_init(pcb, task_bootstrap);
+#endif
     
     // 根据调度器类型设置标志
     switch (scheduler_state.config.scheduler_type) {
@@ -196,52 +417,62 @@ pcb_t* scheduler_create_process(const char *name,
             break;
     }
     
+    // 新进程从min_vruntime起步，而不是从0开始领先所有进程
+    pcb->vruntime = scheduler_state.min_vruntime;
+    
     // 加入就绪队列
     pcb_set_state(pcb, PROCESS_READY);
+    note_ready(pcb, false);
     add_to_ready_queue_internal(pcb);
     
     // 更新统计
     scheduler_state.stats.processes_created++;
-    
-    spinlock_unlock(&scheduler_state.scheduler_lock);
-    
-    printf("Process created: PID=%d, Name=%s, Priority=%d\n", 
-           pcb->pid, pcb->name, pcb->priority);
+    record_input(REPLAY_CREATE, spec->type, spec->priority, spec->flags, pcb->pid);
     
     return pcb;
 }
 
 /* 终止进程 */
 int scheduler_terminate_process(uint32_t pid, int exit_code) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_EXIT, pid, (uint32_t)exit_code, 0, 0);
     
     pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
     if (!pcb) {
-        printf("ERROR: Process %d not found\n", pid);
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        sched_log("ERROR: Process %d not found\n", pid);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
     // 检查进程状态
     if (pcb->state == PROCESS_TERMINATED || pcb->state == PROCESS_ZOMBIE) {
-        printf("ERROR: Process %d already terminated\n", pid);
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        sched_log("ERROR: Process %d already terminated\n", pid);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
-    // 保存退出代码
-    pcb->exit_code = exit_code;
+    // 保存退出代码；子进程在回收器释放PCB时脱离
+    pcb->cold->exit_code = exit_code;
     
-    // 处理子进程
-    if (pcb->children) {
-        pcb_orphan_children(pcb);
-    }
+    // 退出互斥锁等待，持有的锁交给下一个等待者
+    kmutex_process_exit(pcb);
     
-    // 从调度队列中移除
+    // 从调度队列中移除（阻塞/睡眠中的进程也可能被终止）
     remove_from_ready_queue_internal(pcb);
+    wait_queue_remove(&scheduler_state.wait_queue, pcb);
+    wait_queue_remove(&scheduler_state.sleep_queue, pcb);
+    group_detach(pcb);
+    
+    // 归还实时带宽
+    if (PCB_IS_REALTIME(pcb)) {
+        edf_release(&scheduler_state.edf, pcb->cold->rt.runtime, pcb->cold->rt.rel_deadline);
+    }
+    
+    // 进程的FPU状态不再需要保存
+    fpu_release(pcb);
     
     // 更新状态
-    pcb->time_terminated = scheduler_state.system_ticks;
+    pcb->cold->time_terminated = scheduler_state.system_ticks;
     pcb_set_state(pcb, PROCESS_ZOMBIE);  // 先变为僵尸状态
     
     // 如果终止的是当前进程，触发调度
@@ -253,60 +484,185 @@ int scheduler_terminate_process(uint32_t pid, int exit_code) {
     // 更新统计
     scheduler_state.stats.processes_terminated++;
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     
-    printf("Process terminated: PID=%d, ExitCode=%d\n", pid, exit_code);
+    sched_log("Process terminated: PID=%d, ExitCode=%d\n", pid, exit_code);
     
     return 0;
 }
 
-/* 真正回收进程资源 */
+/* 回收僵尸：排入回收链表，资源由回收器释放 */
 int scheduler_reap_process(uint32_t pid) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_REAP, pid, 0, 0, 0);
     
     pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
     if (!pcb) {
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
     if (pcb->state != PROCESS_ZOMBIE) {
-        printf("ERROR: Process %d is not a zombie\n", pid);
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        sched_log("ERROR: Process %d is not a zombie\n", pid);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
-    // 更新统计
-    uint32_t lifetime = PCB_LIFETIME(pcb);
-    uint32_t turnaround_time = PCB_TURNAROUND_TIME(pcb);
+    pcb_set_state(pcb, PROCESS_TERMINATED);
+    pcb->cold->reap_next = NULL;
+    if (scheduler_state.reap_tail) {
+        scheduler_state.reap_tail->cold->reap_next = pcb;
+    } else {
+        scheduler_state.reap_head = pcb;
+    }
+    scheduler_state.reap_tail = pcb;
+    scheduler_state.reap_pending++;
+    scheduler_state.reaper.queued++;
     
-    scheduler_state.stats.processes_completed++;
-    scheduler_state.stats.total_runtime += pcb->time_used;
-    scheduler_state.stats.total_wait_time += (lifetime - pcb->time_used);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     
-    // 计算平均时间
-    if (scheduler_state.stats.processes_completed > 0) {
-        scheduler_state.stats.avg_turnaround_time = 
-            scheduler_state.stats.total_runtime / 
-            scheduler_state.stats.processes_completed;
+    return 0;
+}
+
+/* 显式运行回收器 */
+uint32_t scheduler_reap_deferred(uint32_t max) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_REAPER, max, 0, 0, 0);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return reap_zombies(max, false);
+}
+
+/* 回收器：持锁摘下一批，锁外汇总统计，再持锁一次释放整批。
+ * 同一父进程的多个子进程在一次遍历中从其子进程链表摘除 */
+static uint32_t reap_zombies(uint32_t max, bool forced) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    if (!scheduler_state.reap_head) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        return 0;
     }
     
-    // 释放PCB
-    pcb_set_state(pcb, PROCESS_TERMINATED);
-    pcb_free(pcb);
+    // 仍挂在唤醒链表上的PCB不能释放：先处理本CPU的链表，
+    // 其他CPU链表上的留在回收链表里等下一批
+    drain_wake_list();
+    pcb_t *batch = NULL, **batch_link = &batch;
+    pcb_t *kept = NULL, *kept_last = NULL;
+    pcb_t *pcb = scheduler_state.reap_head;
+    uint32_t count = 0;
+    while (pcb && (max == 0 || count < max)) {
+        pcb_t *next = pcb->cold->reap_next;
+        if (__atomic_load_n(&pcb->cold->wake_pending, __ATOMIC_ACQUIRE)) {
+            if (kept_last) {
+                kept_last->cold->reap_next = pcb;
+            } else {
+                kept = pcb;
+            }
+            kept_last = pcb;
+            scheduler_state.reaper.deferred++;
+        } else {
+            *batch_link = pcb;
+            batch_link = &pcb->cold->reap_next;
+            count++;
+        }
+        pcb = next;
+    }
+    *batch_link = NULL;
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    // 留下的排在剩余部分之前
+    if (kept_last) {
+        kept_last->cold->reap_next = pcb;
+        scheduler_state.reap_head = kept;
+    } else {
+        scheduler_state.reap_head = pcb;
+    }
+    if (!pcb) {
+        scheduler_state.reap_tail = kept_last;
+    }
+    scheduler_state.reap_pending -= count;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    // 摘下的僵尸只属于回收器，统计不需要持锁
+    uint32_t runtime = 0, wait_time = 0;
+    for (pcb = batch; pcb; pcb = pcb->cold->reap_next) {
+        runtime += pcb->cold->time_used;
+        wait_time += PCB_LIFETIME(pcb) - pcb->cold->time_used;
+    }
     
-    return 0;
+    irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    for (pcb = batch; pcb; ) {
+        pcb_t *next = pcb->cold->reap_next;
+        if (pcb->cold->parent) {
+            pcb_prune_children(pcb->cold->parent);
+        }
+        // 释放PCB与内核栈（栈在空闲时清零）；子进程在pcb_free中脱离
+        kstack_free(&scheduler_state.kstacks, pcb->cold->stack_base);
+        pcb_free(pcb);
+        pcb = next;
+    }
+    
+    scheduler_stats_t *st = &scheduler_state.stats;
+    st->processes_completed += count;
+    st->total_runtime += runtime;
+    st->total_wait_time += wait_time;
+    if (st->processes_completed > 0) {
+        st->avg_turnaround_time = st->total_runtime / st->processes_completed;
+    }
+    
+    reaper_stats_t *rs = &scheduler_state.reaper;
+    rs->reaped += count;
+    rs->batches++;
+    if (count > rs->max_batch) {
+        rs->max_batch = count;
+    }
+    if (forced) {
+        rs->forced++;
+    }
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    return count;
+}
+
+uint32_t scheduler_reap_pending(void) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    uint32_t pending = scheduler_state.reap_pending;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return pending;
+}
+
+reaper_stats_t scheduler_get_reaper_stats(void) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    reaper_stats_t stats = scheduler_state.reaper;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return stats;
 }
 
 /* 进程调度 */
 void scheduler_schedule(void) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_SCHEDULE, 0, 0, 0, 0);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    schedule();
+}
+
+/* 选择下一个进程并切换（调度器内部的调度点不作为输入录制） */
+static void schedule(void) {
     if (!scheduler_state.scheduler_running) {
         return;
     }
     
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    
+    pcb_t *current_process = scheduler_state.current_process;
+    
+    // 先让中断上下文唤醒的进程入队，参与本次选择
+    drain_wake_list();
+    
+    // 仍可运行的当前进程先放回就绪队列，与其他进程一起参与选择
+    if (current_process && current_process != scheduler_state.idle_process &&
+        current_process->state == PROCESS_RUNNING) {
+        pcb_set_state(current_process, PROCESS_READY);
+        note_ready(current_process, false);
+        add_to_ready_queue_internal(current_process);
+    }
     
     // 获取下一个要运行的进程
     pcb_t *next_process = get_next_process();
@@ -315,79 +671,124 @@ void scheduler_schedule(void) {
     if (!next_process) {
         next_process = scheduler_state.idle_process;
     }
+    if (scheduler_state.recorder) {
+        replay_pick(scheduler_state.recorder,
+                    next_process == scheduler_state.idle_process ? 0 : next_process->pid);
+    }
     
     // 检查是否需要切换
-    pcb_t *current_process = scheduler_state.current_process;
-    
-    if (current_process != next_process) {
+    if (current_process == next_process) {
+        // 重新选中自己：开始新的时间片，不发生切换
+        pcb_set_state(next_process, PROCESS_RUNNING);
+        next_process->time_slice_used = 0;
+        scheduler_state.need_reschedule = false;
+    } else {
         // 执行上下文切换
         scheduler_state.stats.context_switches++;
         
-        // 保存当前进程上下文
-        if (current_process && current_process != scheduler_state.idle_process) {
-            // 保存CPU寄存器到PCB
-            __asm__ volatile(
-                "movl %%esp, %0\n"
-                "movl %%eip, %1\n"
-                : "=r"(current_process->context.esp),
-                  "=r"(current_process->context.eip)
-                :
-                : "memory"
-            );
-            
-            // 更新进程状态
-            if (current_process->state == PROCESS_RUNNING) {
-                pcb_set_state(current_process, PROCESS_READY);
-                add_to_ready_queue_internal(current_process);
+        // 离开空闲进程：结束本CPU的空闲期（调控器不在任何状态中时什么也不做）
+        if (current_process == scheduler_state.idle_process) {
+            idle_governor_t *gov = &scheduler_state.idle[this_cpu_id()];
+            if (gov->active) {
+                idle_governor_exit(gov, idle_clock(), true);
             }
         }
         
+        // FPU状态不随切换保存，只置位TS，等下次使用FPU时再处理
+        fpu_switch(next_process);
+        
         // 更新下一个进程状态
         pcb_set_state(next_process, PROCESS_RUNNING);
-        next_process->time_started = scheduler_state.system_ticks;
+        next_process->cold->time_started = scheduler_state.system_ticks;
         next_process->time_slice_used = 0;
         remove_from_ready_queue_internal(next_process);
         
+        // 跟踪：换入进程的排队延迟、跨CPU迁移与切换事件
+        uint32_t cpu = this_cpu_id();
+        if (next_process != scheduler_state.idle_process) {
+            trace_record_run(scheduler_state.system_ticks - next_process->cold->ready_since,
+                             next_process->cold->woken);
+            next_process->cold->woken = false;
+        }
+        if (next_process->cold->last_cpu != PCB_NO_CPU && next_process->cold->last_cpu != cpu) {
+            trace_event(TRACE_MIGRATE, scheduler_state.system_ticks, next_process->pid,
+                        next_process->cold->last_cpu);
+        }
+        next_process->cold->last_cpu = (uint8_t)cpu;
+        if (current_process) {
+            current_process->cold->last_ran = scheduler_state.system_ticks;
+        }
+        trace_event(TRACE_SWITCH, scheduler_state.system_ticks, next_process->pid,
+                    current_process ? current_process->pid : 0);
+        
         // 更新当前进程指针
         scheduler_state.current_process = next_process;
+        group_set_current(&scheduler_state.groups,
+                          next_process == scheduler_state.idle_process ? NULL : next_process);
         scheduler_state.last_schedule_time = scheduler_state.system_ticks;
         
         // 设置需要重新调度标志为false
         scheduler_state.need_reschedule = false;
         
-        printf("Context switch: %s(PID:%d) -> %s(PID:%d)\n",
-               current_process ? current_process->name : "NULL",
+        sched_log("Context switch: %s(PID:%d) -> %s(PID:%d)\n",
+               current_process ? current_process->cold->name : "NULL",
                current_process ? current_process->pid : 0,
-               next_process->name, next_process->pid);
+               next_process->cold->name, next_process->pid);
         
-        // 恢复下一个进程的上下文
-        if (next_process != scheduler_state.idle_process) {
-            __asm__ volatile(
-                "movl %0, %%esp\n"
-                "movl %1, %%eip\n"
-                :
-                : "r"(next_process->context.esp),
-                  "r"(next_process->context.eip)
-                : "memory"
-            );
-        }
+#ifndef SPARROW_HOST
+        // 自愿切换只保存被调用者保存寄存器与ESP；切回时从这里返回
+        switch_to(current_process, next_process);
+#endif
     }
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
 }
 
-/* 定时器中断处理 */
+/* 定时器中断处理
+ * 共享状态的修改全部在一次关中断持锁中完成：中断门已关中断，irqsave
+ * 只是让加锁方式与进程上下文一致；回收与切换各自加锁，放在解锁之后 */
 static void scheduler_tick_handler(void) {
+    // 时钟在加锁前读：记下tick到达的时刻，rdtsc也不必排在加锁的原子操作之后
+    uint64_t stamp = idle_clock();
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_TICK, 0, 0, 0, 0);
     scheduler_state.system_ticks++;
+    scheduler_state.tick_stamp = stamp;
     
     // 更新当前进程的时间统计
     update_process_times();
     
-    // 检查睡眠进程
+    // 处理推迟的唤醒与到期的睡眠进程
+    drain_wake_list();
     check_sleeping_processes();
+    if (scheduler_state.groups.count > 0 &&
+        group_tick(&scheduler_state.groups, scheduler_state.system_ticks)) {
+        scheduler_state.need_reschedule = true;     // 有组解除限流
+    }
+    bool idle = scheduler_state.current_process == scheduler_state.idle_process;
+    uint32_t reap_pending = 0;
+    if (idle) {
+        kstack_refill(&scheduler_state.kstacks, KSTACK_REFILL_BATCH);
+        reap_pending = scheduler_state.reap_pending;
+    }
+    
+    // MLFQ周期性优先级提升，防止低级别进程饥饿（自适应模式下按实测饥饿时间触发）
+    mlfq_note_tick(&scheduler_state.mlfq, scheduler_state.current_process,
+                   scheduler_state.system_ticks);
+    if (scheduler_state.config.scheduler_type == SCHEDULER_MLFQ &&
+        mlfq_boost_due(&scheduler_state.mlfq, scheduler_state.system_ticks)) {
+        mlfq_boost_priorities(&scheduler_state.mlfq, scheduler_state.system_ticks);
+        
+        pcb_t *current = scheduler_state.current_process;
+        if (current && current != scheduler_state.idle_process) {
+            current->queue_level = 0;
+            current->time_in_queue = 0;
+        }
+    }
     
     // 更新调度器统计
     update_scheduler_stats();
+    update_min_vruntime();
     
     // 定期负载均衡
     if (scheduler_state.config.enable_multicore &&
@@ -396,20 +797,29 @@ static void scheduler_tick_handler(void) {
     }
     
     // 检查是否需要重新调度
-    if (scheduler_state.need_reschedule ||
-        (scheduler_state.current_process && 
-         scheduler_state.config.enable_preemption &&
-         scheduler_state.current_process->time_slice_used >= 
-         scheduler_state.current_process->time_slice)) {
-        
+    if (scheduler_state.current_process && 
+        scheduler_state.config.enable_preemption &&
+        scheduler_state.current_process->time_slice_used >= 
+        scheduler_state.current_process->time_slice) {
         scheduler_state.need_reschedule = true;
-        scheduler_schedule();
+    }
+    bool resched = scheduler_state.need_reschedule;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    // 空闲时释放一批僵尸
+    if (reap_pending > 0) {
+        reap_zombies(REAPER_BATCH, false);
+    }
+    
+    if (resched) {
+        schedule();
     }
 }
 
 /* 进程主动让出CPU */
 void scheduler_yield(void) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_YIELD, 0, 0, 0, 0);
     
     if (scheduler_state.current_process && 
         scheduler_state.current_process != scheduler_state.idle_process) {
@@ -424,107 +834,112 @@ void scheduler_yield(void) {
         scheduler_state.need_reschedule = true;
     }
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     
     // 触发调度
-    scheduler_schedule();
+    schedule();
 }
 
 /* 阻塞当前进程 */
 int scheduler_block_process(uint32_t wait_reason) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_BLOCK, wait_reason, 0, 0, 0);
     
     pcb_t *pcb = scheduler_state.current_process;
     if (!pcb || pcb == scheduler_state.idle_process) {
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
-    // 设置阻塞状态
-    pcb_set_state(pcb, PROCESS_BLOCKED);
-    
-    // 加入等待队列
-    wait_queue_enqueue(&scheduler_state.wait_queue, pcb);
-    
-    // 设置需要重新调度
-    scheduler_state.need_reschedule = true;
+    // 设置阻塞状态并加入等待队列
+    scheduler_block_locked(&scheduler_state.wait_queue);
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     
     // 触发调度
-    scheduler_schedule();
+    schedule();
     
     return 0;
 }
 
 /* 唤醒阻塞进程 */
 int scheduler_wakeup_process(uint32_t pid) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
-    
-    // 在等待队列中查找进程
-    pcb_t *pcb = NULL;
-    wait_queue_node_t *node = scheduler_state.wait_queue.head;
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_WAKEUP, pid, 0, 0, 0);
     
-    while (node) {
-        if (node->pcb->pid == pid) {
-            pcb = node->pcb;
-            break;
-        }
-        node = node->next;
-    }
+    // 进程必须挂在等待队列上
+    pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
     
-    if (!pcb) {
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+    if (!pcb || pcb->queue != &scheduler_state.wait_queue) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
-    // 从等待队列移除
+    // 从等待队列移除并设置为就绪状态
     wait_queue_remove(&scheduler_state.wait_queue, pcb);
+    bool preempt = scheduler_wake_locked(pcb);
     
-    // 设置为就绪状态
-    pcb_set_state(pcb, PROCESS_READY);
-    add_to_ready_queue_internal(pcb);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    // 唤醒抢占：同步上下文中立即调度，被唤醒者不必等到下一个tick
+    if (preempt) {
+        schedule();
+    }
     
     return 0;
 }
 
+/* 中断上下文唤醒：只做无锁入链，不触碰任何队列 */
+int scheduler_wakeup_from_irq(pcb_t *pcb) {
+    if (!pcb || pcb->magic_number != PCB_MAGIC) {
+        return -1;
+    }
+    
+    // 重放输入在排空唤醒链表时（持锁）录制，不在这里
+    wake_list_push(&scheduler_state.wake_lists[this_cpu_id()], pcb);
+    idle_note_wakeup();
+    return 0;
+}
+
 /* 使进程睡眠 */
 int scheduler_sleep_process(uint32_t ticks) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_SLEEP, ticks, 0, 0, 0);
     
     pcb_t *pcb = scheduler_state.current_process;
     if (!pcb || pcb == scheduler_state.idle_process) {
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
     // 设置睡眠状态
+    trace_event(TRACE_BLOCK, scheduler_state.system_ticks, pcb->pid, WAIT_REASON_SLEEP);
     pcb_set_state(pcb, PROCESS_SLEEPING);
+    interactivity_block(pcb, scheduler_state.system_ticks);
     pcb->deadline = scheduler_state.system_ticks + ticks;
     
-    // 加入睡眠队列
-    wait_queue_enqueue(&scheduler_state.sleep_queue, pcb);
+    // 按唤醒时间顺序加入睡眠队列
+    wait_queue_enqueue_by_deadline(&scheduler_state.sleep_queue, pcb);
     
     // 设置需要重新调度
     scheduler_state.need_reschedule = true;
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     
     // 触发调度
-    scheduler_schedule();
+    schedule();
     
     return 0;
 }
 
 /* 设置进程优先级 */
 int scheduler_set_priority(uint32_t pid, uint8_t priority) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    record_input(REPLAY_PRIORITY, pid, priority, 0, 0);
     
     pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
     if (!pcb) {
-        spinlock_unlock(&scheduler_state.scheduler_lock);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
         return -1;
     }
     
@@ -547,14 +962,326 @@ int scheduler_set_priority(uint32_t pid, uint8_t priority) {
         add_to_ready_queue_internal(pcb);
     }
     
-    printf("Process %d priority changed: %d -> %d\n", 
+    sched_log("Process %d priority changed: %d -> %d\n", 
            pid, old_priority, priority);
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    return 0;
+}
+
+/* 把进程放入实时调度类（EDF） */
+int scheduler_set_realtime(uint32_t pid, uint32_t runtime, uint32_t period,
+                           uint32_t deadline) {
+    if (deadline == 0) {
+        deadline = period;
+    }
+    if (runtime == 0 || deadline < runtime || period < deadline) {
+        return -1;
+    }
+    
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    
+    pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
+    if (!pcb || pcb == scheduler_state.idle_process ||
+        pcb->state == PROCESS_TERMINATED || pcb->state == PROCESS_ZOMBIE) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        return -1;
+    }
+    
+    // 修改参数时以新带宽替换旧带宽，未通过则保持原参数
+    rt_params_t *rt = &pcb->cold->rt;
+    if (!edf_admit(&scheduler_state.edf, runtime, deadline,
+                   PCB_IS_REALTIME(pcb) ? rt : NULL)) {
+        sched_log("Process %d rejected by EDF admission control (%u/%u)\n",
+               pid, runtime, deadline);
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        return -1;
+    }
+    
+    bool queued = pcb->state == PROCESS_READY;
+    if (queued) {
+        remove_from_ready_queue_internal(pcb);
+    }
+    
+    rt->runtime = runtime;
+    rt->period = period;
+    rt->rel_deadline = deadline;
+    PCB_SET_FLAG(pcb, PROCESS_FLAG_REALTIME);
+    
+    // 第一个作业此刻释放；睡眠/阻塞中的进程在唤醒时释放
+    if (pcb->state != PROCESS_SLEEPING && pcb->state != PROCESS_BLOCKED) {
+        rt->release = scheduler_state.system_ticks;
+        pcb->deadline = rt->release + deadline;
+    }
+    
+    if (queued) {
+        add_to_ready_queue_internal(pcb);
+    }
+    
+    sched_log("Process %d admitted to EDF: runtime=%u period=%u deadline=%u\n",
+           pid, runtime, period, deadline);
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    return 0;
+}
+
+/* 把进程移出实时调度类 */
+int scheduler_clear_realtime(uint32_t pid) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    
+    pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
+    if (!pcb || !PCB_IS_REALTIME(pcb)) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        return -1;
+    }
+    
+    bool queued = pcb->state == PROCESS_READY;
+    if (queued) {
+        remove_from_ready_queue_internal(pcb);
+    }
+    
+    edf_release(&scheduler_state.edf, pcb->cold->rt.runtime, pcb->cold->rt.rel_deadline);
+    PCB_CLEAR_FLAG(pcb, PROCESS_FLAG_REALTIME);
+    
+    if (queued) {
+        add_to_ready_queue_internal(pcb);
+    }
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    return 0;
+}
+
+/* 当前实时进程完成本周期作业，睡眠到下一次释放 */
+int scheduler_rt_job_done(void) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    
+    pcb_t *pcb = scheduler_state.current_process;
+    if (!pcb || !PCB_IS_REALTIME(pcb)) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        return -1;
+    }
+    
+    uint32_t now = scheduler_state.system_ticks;
+    rt_params_t *rt = &pcb->cold->rt;
+    edf_job_complete(&scheduler_state.edf, pcb, now);
     
+    rt->release += rt->period;
+    if ((int32_t)(rt->release - now) > 0) {
+        pcb_set_state(pcb, PROCESS_SLEEPING);
+        pcb->deadline = rt->release;
+        wait_queue_enqueue_by_deadline(&scheduler_state.sleep_queue, pcb);
+    } else {
+        // 作业超期，下一个作业已经释放，带着新的截止时间重新排队
+        pcb->deadline = rt->release + rt->rel_deadline;
+    }
+    
+    scheduler_state.need_reschedule = true;
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    schedule();
+    
+    return 0;
+}
+
+/* 设置录制器（录制或重放校验），NULL关闭；须在scheduler_init之后调用 */
+void scheduler_set_recorder(replay_t *recorder) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    scheduler_state.recorder = recorder;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+}
+
+/* 获取内核栈池统计 */
+kstack_stats_t scheduler_get_kstack_stats(void) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    kstack_stats_t stats = scheduler_state.kstacks.stats;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return stats;
+}
+
+/* 获取实时调度统计 */
+rt_stats_t scheduler_get_rt_stats(void) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    rt_stats_t stats = scheduler_state.edf.stats;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return stats;
+}
+
+/* ========== 调度组 ========== */
+
+/* 创建调度组；parent_pgid为0表示顶层组 */
+int scheduler_group_create(uint32_t parent_pgid, uint32_t shares) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    
+    group_sched_t *gs = &scheduler_state.groups;
+    process_group_t *parent = group_find(gs, parent_pgid);
+    int pgid = -1;
+    if (parent_pgid == 0 || parent) {
+        process_group_t *group = group_create(gs, parent, shares);
+        if (group) {
+            // 新组从兄弟的虚拟时间起步，不会因vtime为0独占CPU
+            group_place(gs, group, root_runnable());
+            group_set_bandwidth(group, 0, 0, scheduler_state.system_ticks);
+            pgid = (int)group->pgid;
+        }
+    }
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    return pgid;
+}
+
+/* 删除没有成员和子组的调度组 */
+int scheduler_group_destroy(uint32_t pgid) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    int ret = group_destroy(&scheduler_state.groups, group_find(&scheduler_state.groups, pgid));
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return ret;
+}
+
+int scheduler_group_set_shares(uint32_t pgid, uint32_t shares) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    int ret = group_set_shares(group_find(&scheduler_state.groups, pgid), shares);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return ret;
+}
+
+/* 每period个tick最多运行quota个tick；quota为0表示不限制 */
+int scheduler_group_set_bandwidth(uint32_t pgid, uint32_t quota, uint32_t period) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    int ret = group_set_bandwidth(group_find(&scheduler_state.groups, pgid), quota, period,
+                                  scheduler_state.system_ticks);
+    scheduler_state.need_reschedule = true;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return ret;
+}
+
+/* 把进程移入调度组；pgid为0表示移回根（未分组） */
+int scheduler_group_attach(uint32_t pid, uint32_t pgid) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    
+    group_sched_t *gs = &scheduler_state.groups;
+    pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
+    process_group_t *group = group_find(gs, pgid);
+    if (!pcb || pcb == scheduler_state.idle_process ||
+        pcb->state == PROCESS_TERMINATED || pcb->state == PROCESS_ZOMBIE ||
+        (pgid != 0 && !group)) {
+        spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+        return -1;
+    }
+    
+    bool queued = pcb->state == PROCESS_READY;
+    if (queued) {
+        remove_from_ready_queue_internal(pcb);
+    }
+    
+    int ret = group_attach(group, pcb);
+    if (pcb == scheduler_state.current_process) {
+        group_set_current(gs, pcb);
+        scheduler_state.need_reschedule = true;
+    }
+    
+    if (queued) {
+        add_to_ready_queue_internal(pcb);
+    }
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    return ret;
+}
+
+/* 获取调度组统计；pgid为0时返回未分组进程的统计 */
+int scheduler_group_get_stats(uint32_t pgid, group_stats_t *stats) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    
+    process_group_t *group = pgid ? group_find(&scheduler_state.groups, pgid)
+                                  : &scheduler_state.groups.root;
+    if (group) {
+        *stats = group->stats;
+    }
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    
+    return group ? 0 : -1;
+}
+
+/* ========== 同步原语支持 ========== */
+
+irqflags_t scheduler_lock(void) {
+    return spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+}
+
+void scheduler_unlock(irqflags_t flags) {
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, flags);
+}
+
+/* 获取调度器锁的竞争统计 */
+spinlock_stats_t scheduler_get_lock_stats(void) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    spinlock_stats_t stats = scheduler_state.scheduler_lock.stats;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return stats;
+}
+
+/* 获取某个CPU的空闲状态统计 */
+int scheduler_get_idle_stats(uint32_t cpu, idle_stats_t *stats) {
+    if (cpu >= MAX_CPUS || !stats) {
+        return -1;
+    }
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    *stats = scheduler_state.idle[cpu].stats;
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     return 0;
 }
 
+/* 设置所有CPU的空闲调控参数（已有的历史与统计清零） */
+void scheduler_set_idle_config(const idle_config_t *config) {
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    for (int i = 0; i < MAX_CPUS; i++) {
+        idle_governor_init(&scheduler_state.idle[i], config);
+    }
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+}
+
+uint32_t scheduler_get_ticks(void) {
+    return scheduler_state.system_ticks;
+}
+
+/* 当前进程挂到queue上并标记为阻塞，由调用者在释放锁后触发调度 */
+void scheduler_block_locked(wait_queue_t *queue) {
+    pcb_t *pcb = scheduler_state.current_process;
+    
+    trace_event(TRACE_BLOCK, scheduler_state.system_ticks, pcb->pid, queue->wait_reason);
+    pcb_set_state(pcb, PROCESS_BLOCKED);
+    interactivity_block(pcb, scheduler_state.system_ticks);
+    wait_queue_enqueue(queue, pcb);
+    scheduler_state.need_reschedule = true;
+}
+
+/* 已从等待队列摘下的进程变为就绪；返回是否触发了唤醒抢占，
+ * 同步上下文的调用者应在释放锁后调度 */
+bool scheduler_wake_locked(pcb_t *pcb) {
+    trace_event(TRACE_WAKEUP, scheduler_state.system_ticks, pcb->pid, pcb->state);
+    rt_job_wakeup(pcb);
+    interactive_wakeup(pcb);
+    place_vruntime(pcb);
+    pcb_set_state(pcb, PROCESS_READY);
+    note_ready(pcb, true);
+    add_to_ready_queue_internal(pcb);
+    return wakeup_preempt(pcb);
+}
+
+void scheduler_ready_remove_locked(pcb_t *pcb) {
+    remove_from_ready_queue_internal(pcb);
+}
+
+void scheduler_ready_add_locked(pcb_t *pcb) {
+    add_to_ready_queue_internal(pcb);
+}
+
 /* 获取当前进程 */
 pcb_t* scheduler_get_current_process(void) {
     return scheduler_state.current_process;
@@ -562,23 +1289,26 @@ pcb_t* scheduler_get_current_process(void) {
 
 /* 获取进程信息 */
 pcb_t* scheduler_get_process(uint32_t pid) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
     pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    if (pcb && pcb->state == PROCESS_TERMINATED) {
+        pcb = NULL;                     // 已回收，只是尚未释放
+    }
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     return pcb;
 }
 
 /* 获取调度器统计 */
 scheduler_stats_t scheduler_get_stats(void) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
     scheduler_stats_t stats = scheduler_state.stats;
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
     return stats;
 }
 
 /* 打印调度器状态 */
 void scheduler_print_status(void) {
-    spinlock_lock(&scheduler_state.scheduler_lock);
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
     
     printf("\n=== SparrowOS Scheduler Status ===\n");
     printf("System ticks: %u\n", scheduler_state.system_ticks);
@@ -596,6 +1326,34 @@ void scheduler_print_status(void) {
     // 进程表信息
     printf("Process table: %u/%u processes\n", 
            scheduler_state.process_table.count, MAX_PROCESSES);
+    const kstack_pool_t *ks = &scheduler_state.kstacks;
+    printf("Kernel stacks: %u clean, %u dirty; %u allocs (%u pre-zeroed, %u zeroed inline)\n",
+           ks->nr_clean, ks->nr_dirty, ks->stats.allocs, ks->stats.clean_hits,
+           ks->stats.zeroed_inline);
+    const reaper_stats_t *rs = &scheduler_state.reaper;
+    printf("Reaper: %u pending; %u reaped in %u batches (max %u), %u forced, %u deferred\n",
+           scheduler_state.reap_pending, rs->reaped, rs->batches, rs->max_batch,
+           rs->forced, rs->deferred);
+    const spinlock_stats_t *ls = &scheduler_state.scheduler_lock.stats;
+    printf("Scheduler lock (%s): %u acquisitions, %u contended, max wait %u polls\n",
+           spinlock_impl_name(), ls->acquisitions, ls->contended, ls->max_spins);
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        const idle_stats_t *is = &scheduler_state.idle[cpu].stats;
+        if (is->periods == 0) {
+            continue;
+        }
+        const idle_state_stats_t *poll = &is->states[IDLE_POLL];
+        const idle_state_stats_t *halt = &is->states[IDLE_HALT];
+        printf("Idle CPU%d: %u periods (%u predicted); poll %u entries, %llu cycles, "
+               "wake avg %llu max %llu; halt %u entries, %llu cycles, wake avg %llu max %llu\n",
+               cpu, is->periods, is->predicted_hits,
+               poll->entries, (unsigned long long)poll->residency,
+               (unsigned long long)(poll->wakeups ? poll->latency_sum / poll->wakeups : 0),
+               (unsigned long long)poll->latency_max,
+               halt->entries, (unsigned long long)halt->residency,
+               (unsigned long long)(halt->wakeups ? halt->latency_sum / halt->wakeups : 0),
+               (unsigned long long)halt->latency_max);
+    }
     
     // 统计信息
     printf("\nStatistics:\n");
@@ -606,13 +1364,101 @@ void scheduler_print_status(void) {
     printf("  Avg turnaround time: %u\n", scheduler_state.stats.avg_turnaround_time);
     printf("  CPU utilization: %u%%\n", scheduler_state.stats.cpu_utilization);
     
-    spinlock_unlock(&scheduler_state.scheduler_lock);
+    // 惰性FPU统计
+    const fpu_cpu_state_t *fpu = fpu_get_state(this_cpu_id());
+    printf("  FPU: %u #NM traps, %u saves, %u restores, %u inits, %u owner returns\n",
+           fpu->nm_traps, fpu->saves, fpu->restores, fpu->inits, fpu->owner_returns);
+    
+    // MLFQ提升与自适应统计
+    if (scheduler_state.config.scheduler_type == SCHEDULER_MLFQ) {
+        const mlfq_t *mlfq = &scheduler_state.mlfq;
+        printf("  MLFQ: %s, %u boosts, %u interactive wakeups to level 0\n",
+               mlfq->adaptive ? "adaptive" : "static", mlfq->boosts,
+               mlfq->interactive_wakeups);
+    }
+    if (scheduler_state.config.wakeup_preemption) {
+        printf("  Wake-up preemptions: %u\n", scheduler_state.stats.wakeup_preemptions);
+    }
+    
+    // 中断上下文唤醒统计
+    const wake_list_t *wl = &scheduler_state.wake_lists[this_cpu_id()];
+    printf("  IRQ wakeups: %u pushed, %u coalesced, %u drained in %u batches, %u stale\n",
+           wl->pushed, wl->coalesced, wl->drained, wl->batches, wl->stale);
+    
+    // 跟踪事件与延迟直方图
+    const trace_cpu_t *trace = trace_get_cpu(this_cpu_id());
+    printf("  Trace: %u switches, %u wakeups, %u migrations, %u blocks\n",
+           trace->counts[TRACE_SWITCH], trace->counts[TRACE_WAKEUP],
+           trace->counts[TRACE_MIGRATE], trace->counts[TRACE_BLOCK]);
+    lat_hist_print("Run-queue wait", &trace->runq_wait);
+    lat_hist_print("Wakeup latency", &trace->wake_latency);
+    
+    trace_event_t recent[STATUS_TRACE_EVENTS];
+    uint32_t n = trace_read(this_cpu_id(), recent, STATUS_TRACE_EVENTS);
+    if (n > 0) {
+        printf("  Recent events:\n");
+        for (uint32_t i = 0; i < n; i++) {
+            printf("    [%6u] cpu%u %-7s pid=%u arg=%u\n", recent[i].ticks, recent[i].cpu,
+                   trace_type_name(recent[i].type), recent[i].pid, recent[i].arg);
+        }
+    }
+    
+    // 实时调度统计
+    const edf_rq_t *edf = &scheduler_state.edf;
+    printf("  RT (EDF): %u tasks, utilization %u.%u%% (limit %u.%u%%), %u rejected\n",
+           edf->tasks, edf->utilization / 10, edf->utilization % 10,
+           edf->util_limit / 10, edf->util_limit % 10, edf->stats.rejected);
+    printf("  RT jobs: %u completed, %u deadline misses, %u preemptions\n",
+           edf->stats.jobs, edf->stats.deadline_misses, edf->stats.preemptions);
+    if (edf->stats.jobs > 0) {
+        lat_hist_print("RT response time", &edf->stats.response_hist);
+    }
+    
+    // 调度组
+    const group_sched_t *gs = &scheduler_state.groups;
+    if (gs->count > 0) {
+        printf("  Groups: %u (root runtime %u)\n", gs->count, gs->root.stats.runtime);
+        for (uint32_t i = 0; i < SCHED_MAX_GROUPS; i++) {
+            const process_group_t *g = &gs->groups[i];
+            if (g->pgid == 0) {
+                continue;
+            }
+            printf("    pgid=%u parent=%u shares=%u members=%u queued=%u runtime=%u",
+                   g->pgid, g->parent ? g->parent->pgid : 0, g->shares, g->member_count,
+                   g->rq.count, g->stats.runtime);
+            if (g->quota) {
+                printf(" quota=%u/%u throttled=%u (%u ticks)%s", g->quota, g->period,
+                       g->stats.throttled, g->stats.throttled_time,
+                       g->throttled ? " [throttled]" : "");
+            }
+            printf("\n");
+        }
+    }
+    
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
 }
 
 /* ========== 内部函数实现 ========== */
 
 /* 获取下一个要运行的进程 */
 static pcb_t* get_next_process(void) {
+    // 实时进程严格优先
+    pcb_t *rt = edf_dequeue(&scheduler_state.edf);
+    if (rt) {
+        return rt;
+    }
+    
+    // 有调度组时先按组的虚拟时间选实体，选中未分组进程才走原有策略
+    if (scheduler_state.groups.count > 0) {
+        process_group_t *group = group_pick(&scheduler_state.groups, root_runnable());
+        if (!group) {
+            return NULL;
+        }
+        if (group != &scheduler_state.groups.root) {
+            return ready_queue_dequeue(&group->rq);
+        }
+    }
+    
     switch (scheduler_state.config.scheduler_type) {
         case SCHEDULER_MLFQ:
             return mlfq_dequeue(&scheduler_state.mlfq);
@@ -636,6 +1482,49 @@ static void add_to_ready_queue_internal(pcb_t *pcb) {
         return;
     }
     
+    if (pi_in_rt_class(pcb)) {
+        // 继承得到的截止时间更早时按继承值排序
+        if (PCB_HAS_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED) && pcb->cold->pi.rt &&
+            (!PCB_IS_REALTIME(pcb) || (int32_t)(pcb->cold->pi.deadline - pcb->deadline) < 0)) {
+            pcb->deadline = pcb->cold->pi.deadline;
+        }
+        edf_enqueue(&scheduler_state.edf, pcb);
+        
+        // 截止时间早于当前进程（或当前进程不是实时进程）时立即抢占
+        pcb_t *current = scheduler_state.current_process;
+        if (pcb != current &&
+            (!current || !pi_in_rt_class(current) ||
+             (int32_t)(pcb->deadline - current->deadline) < 0)) {
+            if (current && current != scheduler_state.idle_process &&
+                current->state == PROCESS_RUNNING) {
+                scheduler_state.edf.stats.preemptions++;
+            }
+            scheduler_state.need_reschedule = true;
+        }
+        return;
+    }
+    
+    if (scheduler_state.groups.count > 0) {
+        group_sched_t *gs = &scheduler_state.groups;
+        bool root = root_runnable();
+        if (pcb->cold->group) {
+            group_enqueue(gs, pcb, root);
+        } else if (!root) {
+            group_place(gs, &gs->root, false);
+        }
+        
+        // 被唤醒进程所在实体的虚拟时间明显落后时抢占当前进程
+        pcb_t *current = scheduler_state.current_process;
+        if (current && current != pcb && current != scheduler_state.idle_process &&
+            current->state == PROCESS_RUNNING && !pi_in_rt_class(current) &&
+            group_should_preempt(gs, current, pcb)) {
+            scheduler_state.need_reschedule = true;
+        }
+        if (pcb->cold->group) {
+            return;
+        }
+    }
+    
     switch (scheduler_state.config.scheduler_type) {
         case SCHEDULER_MLFQ:
             // 根据进程的当前队列级别添加到MLFQ
@@ -656,10 +1545,22 @@ static void remove_from_ready_queue_internal(pcb_t *pcb) {
         return;
     }
     
+    if (pcb->queue == &scheduler_state.edf) {
+        edf_remove(&scheduler_state.edf, pcb);
+        return;
+    }
+    
+    if (pcb->cold->group && pcb->queue == &pcb->cold->group->rq) {
+        ready_queue_remove(&pcb->cold->group->rq, pcb);
+        return;
+    }
+    
     switch (scheduler_state.config.scheduler_type) {
         case SCHEDULER_MLFQ:
-            // MLFQ队列移除（简化实现）
-            // 在实际实现中，需要遍历队列找到并移除
+            // 从进程所在级别的MLFQ队列移除
+            if (pcb->queue_level < MAX_PRIORITY_LEVELS) {
+                ready_queue_remove(&scheduler_state.mlfq.queues[pcb->queue_level], pcb);
+            }
             break;
             
         case SCHEDULER_RR:
@@ -678,98 +1579,285 @@ static void update_process_times(void) {
         pcb_t *pcb = scheduler_state.current_process;
         
         // 增加已使用时间
-        pcb->time_used++;
+        pcb->cold->time_used++;
         pcb->time_slice_used++;
         pcb->vruntime++;
         
         // 更新进程统计
         pcb_update_stats(pcb, 1);
+        interactivity_tick(pcb);
+        
+        // 调度组记账，用完配额的组被限流
+        if (scheduler_state.groups.count > 0 &&
+            group_charge(&scheduler_state.groups, pcb, scheduler_state.system_ticks)) {
+            scheduler_state.need_reschedule = true;
+        }
         
-        // 对于MLFQ，增加在当前队列的时间
-        if (PCB_HAS_FLAG(pcb, PROCESS_FLAG_SCHED_MLFQ)) {
+        // 对于MLFQ，增加在当前队列的时间（实时进程和继承提升中的进程不参与升降级）
+        if (PCB_HAS_FLAG(pcb, PROCESS_FLAG_SCHED_MLFQ) &&
+            !PCB_HAS_FLAG(pcb, PROCESS_FLAG_REALTIME | PROCESS_FLAG_PI_BOOSTED)) {
             pcb->time_in_queue++;
             
             // 检查是否需要调整优先级
             if (pcb->time_in_queue >= scheduler_state.mlfq.demotion_threshold) {
                 mlfq_adjust_priority(&scheduler_state.mlfq, pcb, true);
+                
+                // 自适应模式下降级后若有更高级别的进程就绪，不等时间片用完就让出
+                if (scheduler_state.mlfq.adaptive &&
+                    mlfq_has_ready_above(&scheduler_state.mlfq, pcb->queue_level)) {
+                    scheduler_state.need_reschedule = true;
+                }
             }
         }
+    } else if (scheduler_state.current_process) {
+        // 空闲进程只累计运行时间，用于计算CPU利用率
+        scheduler_state.current_process->cold->time_used++;
     }
 }
 
-/* 检查睡眠进程 */
-static void check_sleeping_processes(void) {
-    // 检查睡眠队列中的进程是否应该被唤醒
-    wait_queue_node_t *node = scheduler_state.sleep_queue.head;
-    wait_queue_node_t *prev = NULL;
+/* 实时进程被唤醒：当前作业的截止时间已过则以此刻为释放时间开始新作业，
+ * 否则沿用原截止时间（防止频繁阻塞/唤醒借此提前自己的截止时间） */
+static void rt_job_wakeup(pcb_t *pcb) {
+    if (!PCB_IS_REALTIME(pcb)) {
+        return;
+    }
     
-    while (node) {
-        pcb_t *pcb = node->pcb;
-        
-        if (scheduler_state.system_ticks >= pcb->deadline) {
-            // 唤醒进程
-            wait_queue_node_t *next = node->next;
-            
-            // 从睡眠队列移除
-            if (prev) {
-                prev->next = next;
-            } else {
-                scheduler_state.sleep_queue.head = next;
-            }
-            
-            if (!next) {
-                scheduler_state.sleep_queue.tail = prev;
+    rt_params_t *rt = &pcb->cold->rt;
+    uint32_t now = scheduler_state.system_ticks;
+    if ((int32_t)(now - (rt->release + rt->rel_deadline)) >= 0) {
+        rt->release = now;
+    }
+    pcb->deadline = rt->release + rt->rel_deadline;
+}
+
+/* 记录睡眠时间并更新交互性。自适应MLFQ下交互型进程唤醒时直接回到0级，
+ * 并抢占正在用长时间片运行的批处理型进程，唤醒延迟因此不受时间片拉长的影响 */
+static void interactive_wakeup(pcb_t *pcb) {
+    interactivity_wake(pcb, scheduler_state.system_ticks);
+    
+    mlfq_t *mlfq = &scheduler_state.mlfq;
+    if (!mlfq->adaptive || !PCB_HAS_FLAG(pcb, PROCESS_FLAG_SCHED_MLFQ) ||
+        PCB_HAS_FLAG(pcb, PROCESS_FLAG_REALTIME | PROCESS_FLAG_PI_BOOSTED) ||
+        pcb->cold->interactivity.sleep_avg < INTERACTIVE_THRESHOLD) {
+        return;
+    }
+    
+    if (pcb->queue_level > 0) {
+        pcb->queue_level = 0;
+        pcb->time_in_queue = 0;
+        pcb->cold->promotions++;
+        mlfq->interactive_wakeups++;
+    }
+    
+    pcb_t *current = scheduler_state.current_process;
+    if (current && current != scheduler_state.idle_process &&
+        current->state == PROCESS_RUNNING && current->queue_level > 0 &&
+        current->cold->interactivity.sleep_avg < INTERACTIVE_THRESHOLD) {
+        scheduler_state.need_reschedule = true;
+    }
+}
+
+/* 唤醒抢占：被唤醒的交互型进程明显领先于当前进程时移到所在队列队首，
+ * 并立即重新调度，而不是等当前进程用完时间片。实时类与调度组有各自的抢占规则。
+ * 返回是否抢占；中断上下文只留下need_reschedule，同步上下文由调用者调度 */
+static bool wakeup_preempt(pcb_t *pcb) {
+    pcb_t *current = scheduler_state.current_process;
+    if (!scheduler_state.config.wakeup_preemption || !scheduler_state.config.enable_preemption ||
+        !current || current == scheduler_state.idle_process ||
+        current->state != PROCESS_RUNNING || pcb->state != PROCESS_READY ||
+        pi_in_rt_class(current) || pi_in_rt_class(pcb) ||
+        current->cold->group || pcb->cold->group) {
+        return false;
+    }
+    if (!should_preempt(current, pcb)) {
+        return false;
+    }
+    
+    ready_queue_t *queue = &scheduler_state.ready_queue;
+    if (scheduler_state.config.scheduler_type == SCHEDULER_MLFQ) {
+        queue = &scheduler_state.mlfq.queues[pcb->queue_level];
+    }
+    if (pcb->queue != queue) {
+        return false;
+    }
+    ready_queue_remove(queue, pcb);
+    ready_queue_enqueue_head(queue, pcb);
+    scheduler_state.need_reschedule = true;
+    scheduler_state.stats.wakeup_preemptions++;
+    return true;
+}
+
+/* 推进min_vruntime：取当前进程与MLFQ/RR/FIFO就绪队列中vruntime的最小值，
+ * 只在变大时更新，与CFS的min_vruntime一样单调不减（按差值比较，允许回绕）。
+ * 就绪队列没有按vruntime排序，扫描代价与就绪进程数成正比，所以两次扫描至少
+ * 相隔这么多tick：均摊到每个tick是常数，而排队进程多时最小值本来也涨得慢 */
+static void update_min_vruntime(void) {
+    ready_queue_t *queues = &scheduler_state.ready_queue;
+    int levels = 1;
+    if (scheduler_state.config.scheduler_type == SCHEDULER_MLFQ) {
+        queues = scheduler_state.mlfq.queues;
+        levels = MAX_PRIORITY_LEVELS;
+    }
+    uint32_t ready = 0;
+    for (int i = 0; i < levels; i++) {
+        ready += queues[i].count;
+    }
+    uint32_t interval = ready > MIN_VRUNTIME_INTERVAL ? ready : MIN_VRUNTIME_INTERVAL;
+    if (scheduler_state.system_ticks - scheduler_state.min_vruntime_scan < interval) {
+        return;
+    }
+    scheduler_state.min_vruntime_scan = scheduler_state.system_ticks;
+    
+    pcb_t *current = scheduler_state.current_process;
+    bool found = false;
+    uint32_t min = 0;
+    if (current && current != scheduler_state.idle_process &&
+        current->state == PROCESS_RUNNING &&
+        !pi_in_rt_class(current) && !current->cold->group) {
+        min = current->vruntime;
+        found = true;
+    }
+    
+    for (int i = 0; i < levels; i++) {
+        for (pcb_t *pcb = queues[i].head; pcb; pcb = pcb->next) {
+            if (!found || (int32_t)(pcb->vruntime - min) < 0) {
+                min = pcb->vruntime;
+                found = true;
             }
-            
-            // 设置为就绪状态并加入就绪队列
-            pcb_set_state(pcb, PROCESS_READY);
-            add_to_ready_queue_internal(pcb);
-            
-            // 移动到下一个节点
-            node = next;
-        } else {
-            prev = node;
-            node = node->next;
         }
     }
+    
+    if (found && (int32_t)(min - scheduler_state.min_vruntime) > 0) {
+        scheduler_state.min_vruntime = min;
+    }
 }
 
-/* 更新调度器统计 */
-static void update_scheduler_stats(void) {
-    // 计算CPU利用率
-    static uint32_t last_idle_time = 0;
-    static uint32_t last_total_time = 0;
+/* 被唤醒进程的vruntime停在入睡时；长时间睡眠后按原值比较会领先所有进程，
+ * 每次唤醒都抢占。放置时拉到不低于 min_vruntime - WAKEUP_GRANULARITY，
+ * 睡过的进程最多保留一个粒度的领先 */
+static void place_vruntime(pcb_t *pcb) {
+    uint32_t floor = scheduler_state.min_vruntime - WAKEUP_GRANULARITY;
+    if ((int32_t)(pcb->vruntime - floor) < 0) {
+        pcb->vruntime = floor;
+    }
+}
+
+/* 是否有未分组的就绪进程（在MLFQ/RR/FIFO队列中） */
+static bool root_runnable(void) {
+    if (scheduler_state.config.scheduler_type == SCHEDULER_MLFQ) {
+        return mlfq_has_ready_above(&scheduler_state.mlfq, MAX_PRIORITY_LEVELS);
+    }
+    return scheduler_state.ready_queue.count > 0;
+}
+
+/* 进程进入就绪状态：记录时刻，开始运行时计入排队/唤醒延迟直方图 */
+static void note_ready(pcb_t *pcb, bool woken) {
+    pcb->cold->ready_since = scheduler_state.system_ticks;
+    pcb->cold->woken = woken;
+}
+
+/* 批量处理本CPU的唤醒链表（持有调度器锁） */
+static void drain_wake_list(void) {
+    // 重放：日志在这里排空过中断上下文的唤醒时按记录重现，唤醒链表本身为空
+    replay_t *rp = scheduler_state.recorder;
+    uint32_t pid;
+    while (rp && rp->verifying && replay_wakeup_irq(rp, &pid)) {
+        pcb_t *pcb = process_table_find(&scheduler_state.process_table, pid);
+        if (pcb && pcb->queue == &scheduler_state.wait_queue) {
+            wait_queue_remove(&scheduler_state.wait_queue, pcb);
+            scheduler_wake_locked(pcb);
+        }
+    }
+    
+    wake_list_t *list = &scheduler_state.wake_lists[this_cpu_id()];
+    if (wake_list_empty(list)) {
+        return;
+    }
     
-    uint32_t current_idle_time = scheduler_state.idle_process->time_used;
-    uint32_t current_total_time = scheduler_state.system_ticks;
+    pcb_t *pcb = wake_list_take_all(list);
+    list->batches++;
     
-    if (current_total_time > last_total_time) {
-        uint32_t idle_delta = current_idle_time - last_idle_time;
-        uint32_t total_delta = current_total_time - last_total_time;
+    while (pcb) {
+        pcb_t *next = wake_list_pop(pcb);
+        list->drained++;
+        
+        // 入链后进程可能已被同步唤醒或终止，此时忽略
+        if (pcb->queue == &scheduler_state.wait_queue) {
+            record_input(REPLAY_WAKEUP_IRQ, pcb->pid, 0, 0, 0);
+            wait_queue_remove(&scheduler_state.wait_queue, pcb);
+            scheduler_wake_locked(pcb);
+        } else {
+            list->stale++;
+        }
+        pcb = next;
+    }
+}
+
+/* 下一个会带来工作的定时器：睡眠队列队首到期的那个tick，换算为idle_clock()时刻 */
+static uint64_t next_timer_event(void) {
+    uint64_t when = IDLE_NO_EVENT;
+    irqflags_t irqflags = spinlock_lock_irqsave(&scheduler_state.scheduler_lock);
+    pcb_t *head = scheduler_state.sleep_queue.head;
+    if (head) {
+        int32_t ticks = (int32_t)(head->deadline - scheduler_state.system_ticks);
+        uint64_t cycles_per_tick = scheduler_state.idle[this_cpu_id()].config.cycles_per_tick;
+        when = scheduler_state.tick_stamp + (uint64_t)(ticks > 1 ? ticks : 1) * cycles_per_tick;
+    }
+    spinlock_unlock_irqrestore(&scheduler_state.scheduler_lock, irqflags);
+    return when;
+}
+
+/* 检查睡眠进程 */
+static void check_sleeping_processes(void) {
+    // 睡眠队列按deadline排序，只需从队头取出已到期的进程
+    pcb_t *pcb;
+    
+    while ((pcb = scheduler_state.sleep_queue.head) != NULL &&
+           (int32_t)(scheduler_state.system_ticks - pcb->deadline) >= 0) {
+        // 从睡眠队列移除
+        wait_queue_remove(&scheduler_state.sleep_queue, pcb);
+        idle_note_wakeup();
+        trace_event(TRACE_WAKEUP, scheduler_state.system_ticks, pcb->pid, pcb->state);
+        rt_job_wakeup(pcb);
+        interactive_wakeup(pcb);
+        place_vruntime(pcb);
         
-        if (total_delta > 0) {
-            scheduler_state.stats.cpu_utilization = 
-                100 - (idle_delta * 100 / total_delta);
+        // 设置为就绪状态并加入就绪队列
+        pcb_set_state(pcb, PROCESS_READY);
+        note_ready(pcb, true);
+        add_to_ready_queue_internal(pcb);
+        wakeup_preempt(pcb);
+    }
+}
+
+/* 更新调度器统计 */
+static void update_scheduler_stats(void) {
+    // 采样点保存在scheduler_state中，scheduler_init重新初始化时一并清零
+    stats_window_t *w = &scheduler_state.stats_window;
+    uint32_t now = scheduler_state.system_ticks;
+    
+    // 计算CPU利用率（最近一个窗口内非空闲时间占比）
+    uint32_t total_delta = now - w->util_start;
+    if (total_delta >= STATS_UTIL_WINDOW) {
+        uint32_t idle_time = scheduler_state.idle_process->cold->time_used;
+        uint32_t idle_delta = idle_time - w->util_idle_start;
+        if (idle_delta > total_delta) {
+            idle_delta = total_delta;
         }
+        scheduler_state.stats.cpu_utilization = 100 - (idle_delta * 100 / total_delta);
         
-        last_idle_time = current_idle_time;
-        last_total_time = current_total_time;
+        w->util_start = now;
+        w->util_idle_start = idle_time;
     }
     
     // 计算吞吐量（每秒完成的进程数）
-    static uint32_t last_completed = 0;
-    static uint32_t last_time = 0;
-    
-    if (scheduler_state.system_ticks - last_time >= 1000) { // 每秒计算一次
-        uint32_t completed_delta = scheduler_state.stats.processes_completed - last_completed;
-        uint32_t time_delta = scheduler_state.system_ticks - last_time;
-        
-        if (time_delta > 0) {
-            scheduler_state.stats.throughput = completed_delta * 1000 / time_delta;
-        }
+    uint32_t time_delta = now - w->tput_start;
+    if (time_delta >= STATS_THROUGHPUT_WINDOW) {
+        uint32_t completed_delta = scheduler_state.stats.processes_completed - w->tput_completed_start;
+        scheduler_state.stats.throughput = completed_delta * 1000 / time_delta;
         
-        last_completed = scheduler_state.stats.processes_completed;
-        last_time = scheduler_state.system_ticks;
+        w->tput_completed_start = scheduler_state.stats.processes_completed;
+        w->tput_start = now;
     }
 }
 
@@ -787,11 +1875,6 @@ static void load_balance(void) {
     
     // 如果有太多就绪进程，可以考虑创建更多调度实体
     if (ready_count > MAX_PROCESSES / 2) {
-        printf("Load balancing: %u processes in ready queue\n", ready_count);
+        sched_log("Load balancing: %u processes in ready queue\n", ready_count);
     }
-}
-
-/* 分配空闲PCB */
-static pcb_t* find_free_pcb(void) {
-    return pcb_alloc();
 }
\ No newline at end of file
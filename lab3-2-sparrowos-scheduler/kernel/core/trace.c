@@ -0,0 +1,135 @@
+/**
+ * trace.c - 调度器跟踪点与延迟直方图实现
+ * 位于: kernel/core/trace.c
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include "kernel/include/trace.h"
+
+static trace_cpu_t trace_cpus[MAX_CPUS];
+static bool trace_enabled = true;
+
+void trace_init(void) {
+    memset(trace_cpus, 0, sizeof(trace_cpus));
+}
+
+void trace_set_enabled(bool enabled) {
+    trace_enabled = enabled;
+}
+
+void trace_event(trace_type_t type, uint32_t ticks, uint32_t pid, uint32_t arg) {
+    if (!trace_enabled) {
+        return;
+    }
+
+    uint32_t cpu_id = this_cpu_id();
+    trace_cpu_t *cpu = &trace_cpus[cpu_id];
+    trace_event_t *ev = &cpu->ring[cpu->head % TRACE_RING_SIZE];
+
+    ev->ticks = ticks;
+    ev->pid = pid;
+    ev->arg = arg;
+    ev->type = (uint8_t)type;
+    ev->cpu = (uint8_t)cpu_id;
+    cpu->head++;
+    cpu->counts[type]++;
+}
+
+void trace_record_run(uint32_t wait, bool woken) {
+    if (!trace_enabled) {
+        return;
+    }
+
+    trace_cpu_t *cpu = &trace_cpus[this_cpu_id()];
+    lat_hist_add(&cpu->runq_wait, wait);
+    if (woken) {
+        lat_hist_add(&cpu->wake_latency, wait);
+    }
+}
+
+const trace_cpu_t* trace_get_cpu(uint32_t cpu) {
+    return cpu < MAX_CPUS ? &trace_cpus[cpu] : NULL;
+}
+
+uint32_t trace_read(uint32_t cpu_id, trace_event_t *out, uint32_t max) {
+    if (cpu_id >= MAX_CPUS || !out) {
+        return 0;
+    }
+
+    const trace_cpu_t *cpu = &trace_cpus[cpu_id];
+    uint32_t available = cpu->head < TRACE_RING_SIZE ? cpu->head : TRACE_RING_SIZE;
+    uint32_t n = available < max ? available : max;
+
+    // 取最新的n个，按写入顺序输出
+    uint32_t start = cpu->head - n;
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = cpu->ring[(start + i) % TRACE_RING_SIZE];
+    }
+    return n;
+}
+
+/* ========== 直方图 ========== */
+
+void lat_hist_add(lat_hist_t *hist, uint32_t value) {
+    if (value > hist->max) {
+        hist->max = value;
+    }
+    hist->count++;
+
+    // log2分桶：0落入桶0，[2^(i-1), 2^i)落入桶i
+    uint32_t bucket = 0;
+    while (value && bucket < LAT_HIST_BUCKETS - 1) {
+        value >>= 1;
+        bucket++;
+    }
+    hist->buckets[bucket]++;
+}
+
+uint32_t lat_hist_percentile(const lat_hist_t *hist, uint32_t percent) {
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    // 第一个累计数达到 count * percent / 100（向上取整）的桶；拆开计算避免32位溢出
+    uint32_t target = hist->count / 100 * percent + ((hist->count % 100) * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < LAT_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= target && seen > 0) {
+            uint32_t upper = i ? (1u << i) - 1 : 0;
+            return (i == LAT_HIST_BUCKETS - 1 || upper > hist->max) ? hist->max : upper;
+        }
+    }
+    return hist->max;
+}
+
+void lat_hist_print(const char *name, const lat_hist_t *hist) {
+    printf("  %s (ticks): %u samples, p50 <= %u, p90 <= %u, p99 <= %u, max %u\n", name,
+           hist->count, lat_hist_percentile(hist, 50), lat_hist_percentile(hist, 90),
+           lat_hist_percentile(hist, 99), hist->max);
+    for (uint32_t i = 0; i < LAT_HIST_BUCKETS; i++) {
+        if (hist->buckets[i] == 0) {
+            continue;
+        }
+        uint32_t lo = i ? 1u << (i - 1) : 0;
+        uint32_t hi = i ? 1u << i : 1;
+        if (i == LAT_HIST_BUCKETS - 1) {
+            printf("    [%5u,   inf): %u\n", lo, hist->buckets[i]);
+        } else {
+            printf("    [%5u, %5u): %u\n", lo, hi, hist->buckets[i]);
+        }
+    }
+}
+
+const char* trace_type_name(uint32_t type) {
+    switch (type) {
+        case TRACE_SWITCH:  return "switch";
+        case TRACE_WAKEUP:  return "wakeup";
+        case TRACE_MIGRATE: return "migrate";
+        case TRACE_BLOCK:   return "block";
+        default:            return "?";
+    }
+}
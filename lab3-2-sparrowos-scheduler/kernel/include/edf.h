@@ -0,0 +1,66 @@
+/**
+ * edf.h - 最早截止时间优先（EDF）实时调度类
+ * 位于: kernel/include/edf.h
+ *
+ * 实时进程按绝对截止时间（pcb->deadline）放入最小堆，严格优先于
+ * MLFQ/RR/FIFO：只要堆非空，调度器就选堆顶进程。接纳控制按密度
+ * runtime/rel_deadline 之和不超过上限进行，保证EDF可调度。
+ */
+
+#ifndef _SPARROW_EDF_H
+#define _SPARROW_EDF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+#include "kernel/include/trace.h"
+
+#define EDF_MAX_TASKS       64      // 可同时接纳的实时进程数
+#define EDF_UTIL_SCALE      1000    // 利用率以千分比表示
+#define EDF_UTIL_DEFAULT    900     // 默认上限：为非实时进程保留10%
+
+/* 堆节点：截止时间与PCB放在一起，比较时不触及PCB */
+typedef struct {
+    uint32_t deadline;              // 绝对截止时间
+    uint32_t seq;                   // 入堆序号，截止时间相同时先入先出
+    pcb_t *pcb;
+} edf_node_t;
+
+/* 实时调度统计 */
+typedef struct {
+    uint32_t admitted;              // 接纳次数
+    uint32_t rejected;              // 因利用率超限被拒绝次数
+    uint32_t jobs;                  // 完成作业数
+    uint32_t deadline_misses;       // 错过截止时间的作业数
+    uint32_t preemptions;           // 实时进程就绪时抢占当前进程次数
+    lat_hist_t response_hist;       // 作业响应时间（log2分桶，单位tick）
+} rt_stats_t;
+
+/* EDF就绪队列 */
+typedef struct {
+    edf_node_t heap[EDF_MAX_TASKS];
+    uint32_t count;
+    uint32_t seq;
+    uint32_t utilization;           // 已接纳进程的密度之和（千分比）
+    uint32_t util_limit;            // 接纳上限（千分比）
+    uint32_t tasks;                 // 已接纳进程数
+    rt_stats_t stats;
+} edf_rq_t;
+
+void edf_rq_init(edf_rq_t *rq, uint32_t util_limit);
+
+/* 堆操作：pcb->queue 指向rq表示在堆中 */
+void edf_enqueue(edf_rq_t *rq, pcb_t *pcb);
+pcb_t* edf_dequeue(edf_rq_t *rq);
+pcb_t* edf_peek(const edf_rq_t *rq);
+void edf_remove(edf_rq_t *rq, pcb_t *pcb);
+
+/* 接纳控制：成功返回true并计入带宽；old非空表示替换该进程原有的参数 */
+bool edf_admit(edf_rq_t *rq, uint32_t runtime, uint32_t rel_deadline,
+               const rt_params_t *old);
+void edf_release(edf_rq_t *rq, uint32_t runtime, uint32_t rel_deadline);
+
+/* 作业完成：记录响应时间与是否错过截止时间 */
+void edf_job_complete(edf_rq_t *rq, pcb_t *pcb, uint32_t now);
+
+#endif /* _SPARROW_EDF_H */
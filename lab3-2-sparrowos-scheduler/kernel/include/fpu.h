@@ -0,0 +1,53 @@
+/**
+ * fpu.h - 惰性FPU/SSE上下文切换
+ * 位于: kernel/include/fpu.h
+ *
+ * 上下文切换时不保存FPU状态，只置位CR0.TS；进程切换后第一次执行
+ * FPU/SSE指令触发#NM，此时才把上一个属主的状态FXSAVE回其PCB并
+ * FXRSTOR当前进程的状态。只做整数运算的进程因此不再承担每次切换
+ * 512字节的FXSAVE/FXRSTOR。
+ */
+
+#ifndef _SPARROW_FPU_H
+#define _SPARROW_FPU_H
+
+#include <stdint.h>
+#include "kernel/include/pcb.h"
+#include "kernel/include/percpu.h"
+
+/* 每CPU的FPU状态 */
+typedef struct {
+    pcb_t *owner;                   // FPU寄存器中当前装载的是哪个进程的状态
+    uint32_t nm_traps;              // #NM陷入次数
+    uint32_t saves;                 // FXSAVE次数
+    uint32_t restores;              // FXRSTOR次数
+    uint32_t inits;                 // 首次使用FPU时的FNINIT次数
+    uint32_t owner_returns;         // 切回属主进程，免去一次陷入
+} fpu_cpu_state_t;
+
+/* 初始化：启用SSE、置位TS、注册#NM处理函数 */
+void fpu_init(void);
+
+/* 上下文切换到next时调用（调度器锁内） */
+void fpu_switch(pcb_t *next);
+
+/* #NM（设备不可用）异常处理 */
+void fpu_handle_nm(void);
+
+/* 进程退出：丢弃其FPU状态 */
+void fpu_release(pcb_t *pcb);
+
+/* 迁移到其他CPU前调用（在源CPU上）：把仍在寄存器中的状态写回PCB */
+void fpu_flush(pcb_t *pcb);
+
+const fpu_cpu_state_t* fpu_get_state(uint32_t cpu);
+
+/* 体系结构原语，见 kernel/arch_x86/context_switch.S */
+extern void save_fpu_state(uint8_t *buffer);
+extern void restore_fpu_state(const uint8_t *buffer);
+extern void fpu_set_ts(void);
+extern void fpu_clear_ts(void);
+extern void fpu_reset_state(void);
+extern void enable_sse(void);
+
+#endif /* _SPARROW_FPU_H */
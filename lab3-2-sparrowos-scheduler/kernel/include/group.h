@@ -0,0 +1,78 @@
+/**
+ * group.h - 调度组：层级份额与带宽限制
+ * 位于: kernel/include/group.h
+ *
+ * 调度组（process_group_t）组成一棵树。每个组按运行时间累计加权虚拟时间
+ * （运行一个tick增加 GROUP_VTIME_SCALE / shares），调度时从根开始逐级选
+ * 虚拟时间最小的可运行子组，直到叶子组，再从叶子组的就绪队列轮转取进程；
+ * 兄弟组因此按份额比例分得CPU。未分组的进程仍由原有调度策略（MLFQ/RR/FIFO）
+ * 管理，整体作为根下的一个实体（root）参与竞争。
+ *
+ * 设置了配额的组在一个周期内运行满 quota 个tick后被限流，整棵子树在
+ * 周期结束前不再被选中。
+ */
+
+#ifndef _SPARROW_GROUP_H
+#define _SPARROW_GROUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+
+#define SCHED_MAX_GROUPS        16          // 可同时存在的调度组数
+#define GROUP_DEFAULT_SHARES    1024
+#define GROUP_MIN_SHARES        2
+#define GROUP_MAX_SHARES        262144
+#define GROUP_VTIME_SCALE       (1u << 20)  // 份额为1024时每tick虚拟时间加1024
+#define GROUP_DEFAULT_PERIOD    100         // 默认带宽周期（tick）
+
+/* 唤醒抢占粒度：被唤醒进程所在实体的虚拟时间落后超过这么多才抢占 */
+#define GROUP_WAKEUP_GRAN       (GROUP_VTIME_SCALE / GROUP_DEFAULT_SHARES)
+
+/* 重新变为可运行的实体最多获得的补偿（大于抢占粒度，睡眠后醒来的组可以抢占） */
+#define GROUP_SLEEP_CREDIT      (3 * GROUP_WAKEUP_GRAN)
+
+typedef struct {
+    process_group_t groups[SCHED_MAX_GROUPS];   // pgid为0表示未使用
+    process_group_t root;           // 未分组进程组成的实体，也是顶层组的父节点
+    process_group_t *curr;          // 正在运行的进程所属实体，空闲时为NULL
+    uint32_t count;                 // 已创建的组数
+    uint32_t next_pgid;
+} group_sched_t;
+
+void group_sched_init(group_sched_t *gs);
+
+/* 组的创建与配置；parent为NULL表示顶层组 */
+process_group_t* group_create(group_sched_t *gs, process_group_t *parent, uint32_t shares);
+int group_destroy(group_sched_t *gs, process_group_t *group);
+process_group_t* group_find(group_sched_t *gs, uint32_t pgid);
+int group_set_shares(process_group_t *group, uint32_t shares);
+int group_set_bandwidth(process_group_t *group, uint32_t quota, uint32_t period, uint32_t now);
+
+/* 成员管理（调用者保证pcb不在任何就绪队列中）；group为NULL表示移回根 */
+int group_attach(process_group_t *group, pcb_t *pcb);
+void group_detach(pcb_t *pcb);
+
+/* 记录正在运行的进程，CPU空闲时传NULL */
+void group_set_current(group_sched_t *gs, const pcb_t *pcb);
+
+/* 就绪进程加入所在叶子组；root_runnable表示是否有未分组的就绪进程 */
+void group_enqueue(group_sched_t *gs, pcb_t *pcb, bool root_runnable);
+
+/* 实体重新变为可运行：虚拟时间不低于可运行兄弟实体的最小值减去补偿 */
+void group_place(group_sched_t *gs, process_group_t *entity, bool root_runnable);
+
+/* 逐级选择虚拟时间最小的可运行实体：返回叶子组，选中未分组进程时返回
+ * &gs->root，没有可运行的实体时返回NULL */
+process_group_t* group_pick(group_sched_t *gs, bool root_runnable);
+
+/* 为pcb运行的一个tick记账；有组因此被限流时返回true */
+bool group_charge(group_sched_t *gs, const pcb_t *pcb, uint32_t now);
+
+/* 带宽周期推进；有组解除限流时返回true */
+bool group_tick(group_sched_t *gs, uint32_t now);
+
+/* 唤醒的woken是否应抢占正在运行的curr */
+bool group_should_preempt(group_sched_t *gs, const pcb_t *curr, const pcb_t *woken);
+
+#endif /* _SPARROW_GROUP_H */
@@ -0,0 +1,108 @@
+/**
+ * idle.h - 空闲状态调控器
+ * 位于: kernel/include/idle.h
+ *
+ * CPU无事可做时，空闲进程在两种状态之间选择：
+ *   IDLE_POLL  用pause轮询唤醒链表与重新调度标志，工作一到立即发现，
+ *              但CPU一直在执行指令
+ *   IDLE_HALT  sti; hlt，直到下一个中断；省电，但退出有硬件延迟，
+ *              短暂停留时得不偿失
+ *
+ * 调控器按菜单式（menu）的思路预测本次空闲还会持续多久：取最近
+ * IDLE_HISTORY 次空闲时长，方差足够小时用其均值，否则逐个剔除最大值
+ * 重算；再与下一个带来工作的定时器（睡眠队列队首的到期时刻）取较小者。
+ * 预测短于 poll_threshold 时轮询，最多轮询 poll_limit 后重新选择；否则
+ * 执行hlt。
+ *
+ * 一次"空闲期"从空闲进程开始等待起，到有工作可做为止，其间可能多次进出
+ * hlt（没有工作的时钟tick只是让它重新选择）。时间以 idle_clock()（目标机
+ * 为TSC周期）为单位；中断上下文唤醒进程时记下时刻，空闲进程据此统计各
+ * 状态的唤醒延迟。
+ */
+
+#ifndef _SPARROW_IDLE_H
+#define _SPARROW_IDLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define IDLE_HISTORY            8           // 参与预测的最近空闲期数
+#define IDLE_HISTORY_CAP        (1u << 30)  // 样本上限，保证方差计算不溢出
+#define IDLE_NO_EVENT           UINT64_MAX  // 没有已知的定时器事件
+
+/* 默认参数（TSC周期，按约1GHz、1ms时钟tick估算；启动时应按实测频率设置） */
+#define IDLE_DEFAULT_CYCLES_PER_TICK    1000000
+#define IDLE_DEFAULT_POLL_THRESHOLD     20000   // 约20µs：短于此不值得进hlt
+#define IDLE_DEFAULT_POLL_LIMIT         20000   // 连续轮询上限，之后重新选择
+
+typedef enum {
+    IDLE_POLL = 0,
+    IDLE_HALT = 1,
+    IDLE_NR_STATES
+} idle_state_t;
+
+typedef struct {
+    uint64_t poll_threshold;        // 预测空闲短于此值时轮询
+    uint64_t poll_limit;            // 单次轮询的最长时间
+    uint64_t cycles_per_tick;       // 一个时钟tick的时钟周期数
+} idle_config_t;
+
+/* 每个状态的驻留与唤醒延迟 */
+typedef struct {
+    uint32_t entries;               // 进入次数
+    uint32_t wakeups;               // 在该状态中等到工作的次数
+    uint64_t residency;             // 累计驻留时间
+    uint64_t latency_sum;           // 唤醒事件到空闲进程发现工作的时间
+    uint64_t latency_max;
+} idle_state_stats_t;
+
+typedef struct {
+    idle_state_stats_t states[IDLE_NR_STATES];
+    uint32_t periods;               // 结束的空闲期数
+    uint32_t predicted_hits;        // 预测值与实际时长相差不到一倍的空闲期
+} idle_stats_t;
+
+/* 每CPU一个 */
+typedef struct {
+    idle_config_t config;
+    uint32_t history[IDLE_HISTORY]; // 最近的空闲期时长（环形）
+    uint32_t nr_history;
+    uint32_t next_slot;
+    bool in_period;                 // 空闲期是否已开始
+    uint64_t period_start;
+    uint64_t predicted;             // 本空闲期开始时的预测时长
+    idle_state_t state;             // 当前（最近一次）选择的状态
+    bool active;                    // 处于state中，尚未调用exit
+    uint64_t state_entry;
+    volatile uint64_t wake_stamp;   // 中断上下文记下的首个唤醒时刻，0表示没有
+    idle_stats_t stats;
+} idle_governor_t;
+
+/* 时钟：目标机与x86主机都读TSC */
+static inline uint64_t idle_clock(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/* config为NULL时使用默认参数 */
+void idle_governor_init(idle_governor_t *gov, const idle_config_t *config);
+
+/* 按历史估计空闲期的典型时长，样本太少或太分散时返回 IDLE_NO_EVENT */
+uint64_t idle_governor_typical(const idle_governor_t *gov);
+
+/* 选择并进入一个状态。next_timer为下一个带来工作的定时器的绝对时刻 */
+idle_state_t idle_governor_select(idle_governor_t *gov, uint64_t now, uint64_t next_timer);
+
+/* 离开状态：work为真表示有工作可做，空闲期结束并计入历史；
+ * 不在任何状态中时什么也不做 */
+void idle_governor_exit(idle_governor_t *gov, uint64_t now, bool work);
+
+/* 中断上下文：记下唤醒时刻（只保留空闲期内的第一个） */
+static inline void idle_governor_note_wakeup(idle_governor_t *gov, uint64_t now) {
+    if (gov->in_period && gov->wake_stamp == 0) {
+        gov->wake_stamp = now ? now : 1;
+    }
+}
+
+#endif /* _SPARROW_IDLE_H */
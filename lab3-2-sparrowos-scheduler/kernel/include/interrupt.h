@@ -0,0 +1,30 @@
+/**
+ * interrupt.h - 内核中断注册接口
+ * 位于: kernel/include/interrupt.h
+ */
+
+#ifndef _SPARROW_KERNEL_INTERRUPT_H
+#define _SPARROW_KERNEL_INTERRUPT_H
+
+#include <stdint.h>
+
+/* IRQ编号（相对8259A主片） */
+#define IRQ_TIMER       0       // 8254定时器
+#define IRQ_KEYBOARD    1       // 键盘
+#define IRQ_DISK        14      // 主IDE通道
+#define NUM_IRQS        16
+
+/* CPU异常向量 */
+#define EXC_DEVICE_NOT_AVAILABLE 7  // #NM：CR0.TS置位时执行FPU/SSE指令
+#define NUM_EXCEPTIONS  32
+
+/* IRQ处理函数类型 */
+typedef void (*irq_handler_t)(void);
+
+/* 注册IRQ处理函数（由平台层实现） */
+void interrupt_register_handler(uint8_t irq, irq_handler_t handler);
+
+/* 注册CPU异常处理函数（由平台层实现） */
+void interrupt_register_exception(uint8_t vector, irq_handler_t handler);
+
+#endif /* _SPARROW_KERNEL_INTERRUPT_H */
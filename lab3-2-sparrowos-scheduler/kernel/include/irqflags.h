@@ -0,0 +1,67 @@
+/**
+ * irqflags.h - 本CPU的中断开关
+ * 位于: kernel/include/irqflags.h
+ *
+ * 中断处理函数也会获取的锁必须关中断持有：本CPU持锁时被中断打断，
+ * 处理函数会在同一把锁上自旋，而锁要等被打断的代码继续执行才会释放。
+ * local_irq_save() 关中断并返回原来的状态，local_irq_restore() 恢复，
+ * 可以嵌套。主机模拟器用每CPU标志代替EFLAGS.IF，sim_fire_irq() 在
+ * 处理函数运行期间置位，与中断门自动关中断一致。
+ */
+
+#ifndef _SPARROW_IRQFLAGS_H
+#define _SPARROW_IRQFLAGS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/percpu.h"
+
+typedef uint32_t irqflags_t;
+
+#define IRQFLAGS_IF     0x200       // EFLAGS.IF
+
+#ifdef SPARROW_HOST
+extern irqflags_t sim_irqflags[MAX_CPUS];  // 主机模拟器中各CPU的IF位
+
+static inline irqflags_t local_irq_save(void) {
+    irqflags_t flags = sim_irqflags[this_cpu_id()];
+    sim_irqflags[this_cpu_id()] = 0;
+    return flags;
+}
+
+static inline void local_irq_restore(irqflags_t flags) {
+    sim_irqflags[this_cpu_id()] = flags & IRQFLAGS_IF;
+}
+
+static inline void local_irq_enable(void) {
+    sim_irqflags[this_cpu_id()] = IRQFLAGS_IF;
+}
+
+static inline bool irqs_disabled(void) {
+    return !(sim_irqflags[this_cpu_id()] & IRQFLAGS_IF);
+}
+#else
+static inline irqflags_t local_irq_save(void) {
+    irqflags_t flags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+    return flags & IRQFLAGS_IF;
+}
+
+static inline void local_irq_restore(irqflags_t flags) {
+    if (flags & IRQFLAGS_IF) {
+        __asm__ volatile("sti" ::: "memory");
+    }
+}
+
+static inline void local_irq_enable(void) {
+    __asm__ volatile("sti" ::: "memory");
+}
+
+static inline bool irqs_disabled(void) {
+    irqflags_t flags;
+    __asm__ volatile("pushf; pop %0" : "=r"(flags));
+    return !(flags & IRQFLAGS_IF);
+}
+#endif
+
+#endif /* _SPARROW_IRQFLAGS_H */
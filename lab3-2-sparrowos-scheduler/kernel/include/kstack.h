@@ -0,0 +1,60 @@
+/**
+ * kstack.h - 内核栈池
+ * 位于: kernel/include/kstack.h
+ *
+ * 每个进程一个 STACK_SIZE 大小的内核栈，从 KSTACK_REGION_BASE 开始的区域
+ * 中分配。释放的栈先进入脏栈表，由 kstack_refill() 在CPU空闲时清零后移到
+ * 干净栈表；分配优先取干净的栈，创建进程的路径上不必再清零4KB。两张表都
+ * 按后进先出使用，刚释放的栈（缓存里可能还有）最先被清零和复用。
+ *
+ * 栈以32位地址标识（pcb_cold_t.stack_base）。主机构建没有这段物理内存，
+ * 由静态数组代替，kstack_ptr() 负责把地址转换成可访问的指针。
+ */
+
+#ifndef _SPARROW_KSTACK_H
+#define _SPARROW_KSTACK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+
+#define KSTACK_REGION_BASE      0x1000000   // 内核栈区域起始地址
+#define KSTACK_COUNT            MAX_PROCESSES
+#define KSTACK_BOOT_CLEAN       32          // 初始化时预先清零的栈数
+#define KSTACK_REFILL_BATCH     8           // 每个空闲tick最多清零的栈数
+
+/* 栈池统计 */
+typedef struct {
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t clean_hits;            // 分配时直接取到已清零的栈
+    uint32_t zeroed_inline;         // 没有干净的栈，在分配路径上清零
+    uint32_t zeroed_idle;           // 由kstack_refill在空闲时清零
+} kstack_stats_t;
+
+typedef struct {
+    uint32_t clean[KSTACK_COUNT];   // 已清零的空闲栈（下标）
+    uint32_t dirty[KSTACK_COUNT];   // 待清零的空闲栈（下标）
+    uint32_t nr_clean;
+    uint32_t nr_dirty;
+    kstack_stats_t stats;
+} kstack_pool_t;
+
+/* 所有栈都视为脏栈（目标机上内存内容未知），再预先清零KSTACK_BOOT_CLEAN个 */
+void kstack_pool_init(kstack_pool_t *pool);
+
+/* 分配一个已清零的栈，返回栈基址；没有空闲栈时返回0 */
+uint32_t kstack_alloc(kstack_pool_t *pool);
+void kstack_free(kstack_pool_t *pool, uint32_t base);
+
+/* 清零最多max个脏栈，返回清零的个数 */
+uint32_t kstack_refill(kstack_pool_t *pool, uint32_t max);
+
+static inline uint32_t kstack_available(const kstack_pool_t *pool) {
+    return pool->nr_clean + pool->nr_dirty;
+}
+
+/* 栈基址对应的可访问内存 */
+void* kstack_ptr(uint32_t base);
+
+#endif /* _SPARROW_KSTACK_H */
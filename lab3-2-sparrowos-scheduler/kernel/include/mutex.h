@@ -0,0 +1,56 @@
+/**
+ * mutex.h - 带优先级继承的内核互斥锁
+ * 位于: kernel/include/mutex.h
+ *
+ * 互斥锁记录持有者，等待者挂在锁自己的wait_queue_t上。高优先级进程
+ * 等待低优先级持有者时，持有者临时继承等待者的MLFQ级别或实时类
+ * （EDF截止时间）；持有者自己又在等待其他锁时沿链继续传递。解锁时
+ * 直接把锁交给优先级最高的等待者，持有者恢复原优先级。
+ */
+
+#ifndef _SPARROW_MUTEX_H
+#define _SPARROW_MUTEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+
+#define KMUTEX_PI_MAX_DEPTH     16      // 传递继承的最大链长（防止死锁成环时死循环）
+
+/* 锁协议 */
+typedef enum {
+    KMUTEX_PROTO_NONE    = 0,   // 不做优先级继承（仅用于对比）
+    KMUTEX_PROTO_INHERIT = 1    // 优先级继承
+} kmutex_protocol_t;
+
+typedef struct kmutex {
+    pcb_t *owner;                   // 持有者，空闲时为NULL
+    wait_queue_t waiters;           // 等待者
+    struct kmutex *next_held;       // 持有者的已持有锁链表
+    uint32_t protocol;              // kmutex_protocol_t
+
+    /* 统计 */
+    uint32_t acquisitions;          // 获取次数
+    uint32_t contentions;           // 需要等待的次数
+    uint32_t max_wait;              // 最长等待时间（tick）
+    uint32_t total_wait;            // 累计等待时间（tick）
+} kmutex_t;
+
+/* 进程当前是否按实时类（EDF）调度：本身是实时进程，或继承了实时等待者 */
+static inline bool pi_in_rt_class(const pcb_t *pcb) {
+    return PCB_IS_REALTIME(pcb) ||
+           (PCB_HAS_FLAG(pcb, PROCESS_FLAG_PI_BOOSTED) && pcb->cold->pi.rt);
+}
+
+void kmutex_init(kmutex_t *mutex, kmutex_protocol_t protocol);
+
+/* 获取锁，锁被占用时阻塞当前进程；返回时当前进程已持有锁
+ * （主机构建不真正切换，调用者以 mutex->owner 判断是否已获得） */
+int kmutex_lock(kmutex_t *mutex);
+int kmutex_trylock(kmutex_t *mutex);
+int kmutex_unlock(kmutex_t *mutex);
+
+/* 进程退出时由调度器调用（持有调度器锁）：退出等待并释放持有的锁 */
+void kmutex_process_exit(pcb_t *pcb);
+
+#endif /* _SPARROW_MUTEX_H */
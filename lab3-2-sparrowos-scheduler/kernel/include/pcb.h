@@ -0,0 +1,14 @@
+/**
+ * pcb.h - 内核头文件路径下的进程控制块定义
+ * 位于: kernel/include/pcb.h
+ *
+ * PCB的完整定义与实验讲义共用 src/pcb.h，这里只做转发，
+ * 保证内核源文件统一使用 "kernel/include/..." 的包含路径。
+ */
+
+#ifndef _SPARROW_KERNEL_PCB_H
+#define _SPARROW_KERNEL_PCB_H
+
+#include "../../src/pcb.h"
+
+#endif /* _SPARROW_KERNEL_PCB_H */
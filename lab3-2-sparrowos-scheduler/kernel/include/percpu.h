@@ -0,0 +1,28 @@
+/**
+ * percpu.h - 每CPU数据支持
+ * 位于: kernel/include/percpu.h
+ *
+ * 每CPU数据以 [MAX_CPUS] 数组存放，以 this_cpu_id() 作为下标。
+ * 目前只启动BSP；主机模拟器可通过 sim_current_cpu 模拟多个CPU。
+ */
+
+#ifndef _SPARROW_PERCPU_H
+#define _SPARROW_PERCPU_H
+
+#include <stdint.h>
+
+#define MAX_CPUS        8
+
+#ifdef SPARROW_HOST
+extern uint32_t sim_current_cpu;    // 主机模拟器中"正在执行"的CPU
+
+static inline uint32_t this_cpu_id(void) {
+    return sim_current_cpu;
+}
+#else
+static inline uint32_t this_cpu_id(void) {
+    return 0;   // 尚未启动AP，只有BSP
+}
+#endif
+
+#endif /* _SPARROW_PERCPU_H */
@@ -0,0 +1,61 @@
+/**
+ * placement.h - 缓存亲和的任务放置
+ * 位于: kernel/include/placement.h
+ *
+ * 进程被唤醒时为它选一个CPU：离上次运行不到 migration_cost 个tick，
+ * 认为上次运行的CPU缓存仍热，只要该CPU的负载不比最空闲的CPU多出
+ * imbalance 以上就留在原CPU；缓存已冷则直接选最空闲的CPU（负载相同
+ * 时仍优先原CPU）。空闲CPU拉取进程做负载均衡时同样不拉缓存仍热的
+ * 进程，除非源CPU排队的进程已超过 imbalance。各CPU的可运行进程数
+ * 由调用者提供。
+ *
+ * 调度器核心目前只有一个共享就绪队列，不调用这里的函数，只在换出时
+ * 记录 last_cpu 与 last_ran；策略由 tools/affinity_sim 的每CPU队列模型
+ * 评估，等调度器有了每CPU就绪队列再接入唤醒与负载均衡路径。
+ */
+
+#ifndef _SPARROW_PLACEMENT_H
+#define _SPARROW_PLACEMENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+#include "kernel/include/percpu.h"
+
+#define PLACEMENT_DEFAULT_IMBALANCE 2   // 缓存热时原CPU最多可比最空闲CPU多的进程数
+
+/* 放置统计 */
+typedef struct {
+    uint32_t placements;            // 选择CPU的次数
+    uint32_t first_runs;            // 从未运行过，直接选最空闲的CPU
+    uint32_t affine;                // 缓存仍热，留在原CPU
+    uint32_t affine_overridden;     // 缓存仍热，但原CPU过载而迁移
+    uint32_t cold_stays;            // 缓存已冷，原CPU恰好最空闲
+    uint32_t migrations;            // 选中的CPU与上次运行的CPU不同
+    uint32_t pulls_refused;         // 负载均衡因缓存仍热不拉取的次数
+} placement_stats_t;
+
+typedef struct {
+    uint32_t num_cpus;
+    uint32_t migration_cost;        // 上次运行后多少tick内认为缓存仍热
+    uint32_t imbalance;
+    placement_stats_t stats;
+} placement_t;
+
+/* migration_cost为0表示不考虑缓存亲和，总是选最空闲的CPU */
+void placement_init(placement_t *pl, uint32_t num_cpus, uint32_t migration_cost);
+
+/* 进程上次运行的缓存是否可能仍热 */
+static inline bool placement_cache_hot(const placement_t *pl, const pcb_t *pcb, uint32_t now) {
+    return pcb->cold->last_cpu != PCB_NO_CPU &&
+           now - pcb->cold->last_ran < pl->migration_cost;
+}
+
+/* 为就绪的pcb选择CPU；nr_running[i]为CPU i当前的可运行进程数 */
+uint32_t placement_select_cpu(placement_t *pl, const pcb_t *pcb,
+                              const uint32_t *nr_running, uint32_t now);
+
+/* 负载均衡能否把排在src_queued个进程的队列里的pcb拉到其他CPU */
+bool placement_can_pull(placement_t *pl, const pcb_t *pcb, uint32_t src_queued, uint32_t now);
+
+#endif /* _SPARROW_PLACEMENT_H */
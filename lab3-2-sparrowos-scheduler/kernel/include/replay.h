@@ -0,0 +1,97 @@
+/**
+ * replay.h - 调度决策的录制与重放
+ * 位于: kernel/include/replay.h
+ *
+ * 录制模式下，调度器在每个外部输入（时钟tick、创建、退出、回收、阻塞、
+ * 唤醒、睡眠、让出、调度请求、改优先级）的入口和每次选出下一个进程时各追加
+ * 一条记录，都在持有调度器锁时写入。中断上下文的唤醒在排空唤醒链表时
+ * 才记录，而不是在入链时。记录是一个操作码字节加若干LEB128变长整数，连续的tick合并
+ * 成一条，写入调用者提供的缓冲区，内核里不需要动态内存。
+ *
+ * 重放模式下，驱动程序用 replay_next() 依次取出输入并调用对应的调度器
+ * 接口；调度器每次选择进程时调用 replay_pick()，与日志中的下一条选择
+ * 记录比较，第一次不一致时记下位置、时刻与双方的值。中断上下文的唤醒
+ * 同样由调度器在排空唤醒链表时用 replay_wakeup_irq() 从日志取出。重放不运行进程
+ * 本身，只驱动调度器核心，因此远快于实际时间。
+ */
+
+#ifndef _SPARROW_REPLAY_H
+#define _SPARROW_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define REPLAY_MAX_ARGS     4
+
+/* 记录类型 */
+typedef enum {
+    REPLAY_TICK        = 1,         // 连续的时钟tick数
+    REPLAY_CREATE      = 2,         // type, priority, flags, 得到的PID
+    REPLAY_EXIT        = 3,         // pid, exit_code
+    REPLAY_REAP        = 4,         // pid
+    REPLAY_BLOCK       = 5,         // wait_reason
+    REPLAY_WAKEUP      = 6,         // pid
+    REPLAY_WAKEUP_IRQ  = 7,         // pid（排空唤醒链表时）
+    REPLAY_SLEEP       = 8,         // ticks
+    REPLAY_YIELD       = 9,
+    REPLAY_SCHEDULE    = 10,
+    REPLAY_PRIORITY    = 11,        // pid, priority
+    REPLAY_PICK        = 12,        // 选中进程的PID（0为空闲进程）
+    REPLAY_REAPER      = 13,        // max（显式调用回收器）
+    REPLAY_NR_OPS
+} replay_op_t;
+
+typedef struct {
+    uint8_t op;
+    uint32_t args[REPLAY_MAX_ARGS];
+} replay_entry_t;
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t cap;
+    uint32_t len;                   // 已写入（录制）或日志总长度（重放）
+    uint32_t pos;                   // 重放读取位置
+    bool verifying;
+    bool overflow;                  // 缓冲区已满，之后的记录被丢弃
+    uint32_t pending_ticks;         // 尚未写出的连续tick
+    uint32_t tick_end;              // 重放：最近一条tick记录的最后一个tick
+
+    uint32_t now;                   // 经过的tick数
+    uint32_t entries;               // 写出（录制）或读取（重放）的记录数
+    uint32_t picks;
+
+    /* 第一次不一致 */
+    bool diverged;
+    uint32_t diverge_pos;           // 期望记录在日志中的偏移
+    uint32_t diverge_tick;
+    replay_entry_t expected;
+    replay_entry_t actual;
+} replay_t;
+
+void replay_init_record(replay_t *r, uint8_t *buf, uint32_t cap);
+void replay_init_verify(replay_t *r, const uint8_t *log, uint32_t len);
+
+/* 写出尚未合并完的tick记录（录制结束时调用） */
+void replay_finish(replay_t *r);
+
+/* 调度器输入；重放模式下只计时，输入由驱动程序从日志取出 */
+void replay_input(replay_t *r, replay_op_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+
+/* 调度器选出了pid（0为空闲进程）；重放模式下与日志比较 */
+void replay_pick(replay_t *r, uint32_t pid);
+
+/* 重放：日志在当前位置排空过一次中断上下文的唤醒时取出其pid并返回true；
+ * 仍在一条tick记录的中间（还没到录制时排空的那个tick）时返回false */
+bool replay_wakeup_irq(replay_t *r, uint32_t *pid);
+
+/* 重放：取下一条输入记录；日志结束、已经不一致或遇到调度器没有做出的
+ * 选择或唤醒（记为不一致）时返回false */
+bool replay_next(replay_t *r, replay_entry_t *entry);
+
+/* 重放：驱动程序发现输入的结果与日志不符（如创建得到的PID不同），
+ * actual对应记录的最后一个参数 */
+void replay_mismatch(replay_t *r, const replay_entry_t *expected, uint32_t actual);
+
+const char* replay_op_name(uint32_t op);
+
+#endif /* _SPARROW_REPLAY_H */
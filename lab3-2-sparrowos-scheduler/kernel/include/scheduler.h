@@ -0,0 +1,136 @@
+/**
+ * scheduler.h - SparrowOS内核调度器接口
+ * 位于: kernel/include/scheduler.h
+ */
+
+#ifndef _SPARROW_KERNEL_SCHEDULER_H
+#define _SPARROW_KERNEL_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+#include "kernel/include/edf.h"
+#include "kernel/include/kstack.h"
+#include "kernel/include/replay.h"
+#include "kernel/include/spinlock.h"
+#include "kernel/include/idle.h"
+
+/* 调度算法类型（scheduler_config_t.scheduler_type） */
+typedef enum {
+    SCHEDULER_FIFO = 0,     // 先来先服务
+    SCHEDULER_RR   = 1,     // 时间片轮转
+    SCHEDULER_MLFQ = 2      // 多级反馈队列
+} scheduler_type_t;
+
+/* 等待原因（wait_queue_t.wait_reason） */
+typedef enum {
+    WAIT_REASON_UNKNOWN = 0,    // 未指定
+    WAIT_REASON_SLEEP   = 1,    // 定时睡眠
+    WAIT_REASON_IO      = 2,    // 等待IO完成
+    WAIT_REASON_LOCK    = 3,    // 等待锁
+    WAIT_REASON_CHILD   = 4     // 等待子进程
+} wait_reason_t;
+
+/* 批量创建时每个进程的参数 */
+typedef struct {
+    const char *name;
+    process_type_t type;
+    uint8_t priority;
+    process_flags_t flags;
+} process_spec_t;
+
+/* 调度器生命周期 */
+void scheduler_init(scheduler_config_t *config);
+void scheduler_schedule(void);
+void scheduler_yield(void);
+
+/* 进程管理 */
+pcb_t* scheduler_create_process(const char *name,
+                               process_type_t type,
+                               uint8_t priority,
+                               process_flags_t flags);
+
+/* 批量创建：一次持锁分配PCB与内核栈、初始化并入队count个进程，
+ * out（可为NULL）依次返回各进程；PCB或栈不足时一个也不创建，返回-1 */
+int scheduler_create_processes(const process_spec_t *specs, uint32_t count, pcb_t **out);
+kstack_stats_t scheduler_get_kstack_stats(void);
+
+/* 退出与回收：terminate只做让进程不再运行所需的O(1)工作，进程成为僵尸；
+ * reap把僵尸排入回收链表后立即返回，此后按pid已查不到该进程。释放内核栈
+ * 与PCB、从父进程摘除、让子进程脱离、汇总统计由回收器分批完成：CPU空闲时
+ * 每个tick一批，积压超过 REAPER_HIGH_WATER 或进程表已满时由创建路径同步
+ * 执行，也可以直接调用 scheduler_reap_deferred（max为0表示全部） */
+#define REAPER_BATCH        32      // 空闲时每次回收的僵尸数
+#define REAPER_HIGH_WATER   256     // 积压到此数量时创建路径先回收
+
+typedef struct {
+    uint32_t queued;                // 排入回收链表的僵尸
+    uint32_t reaped;                // 已释放
+    uint32_t batches;               // 回收器执行次数
+    uint32_t max_batch;             // 单批释放的最大数量
+    uint32_t deferred;              // 仍在唤醒链表上、留到下一批的次数
+    uint32_t forced;                // 创建路径上的同步回收次数
+} reaper_stats_t;
+
+int scheduler_terminate_process(uint32_t pid, int exit_code);
+int scheduler_reap_process(uint32_t pid);
+uint32_t scheduler_reap_deferred(uint32_t max);
+uint32_t scheduler_reap_pending(void);
+reaper_stats_t scheduler_get_reaper_stats(void);
+
+/* 阻塞、唤醒与睡眠 */
+int scheduler_block_process(uint32_t wait_reason);
+int scheduler_wakeup_process(uint32_t pid);
+int scheduler_sleep_process(uint32_t ticks);
+
+/* 中断上下文唤醒：不获取调度器锁，只把PCB压入本CPU的唤醒链表，
+ * 由下一个调度点（时钟tick或scheduler_schedule）批量处理 */
+int scheduler_wakeup_from_irq(pcb_t *pcb);
+
+/* 实时调度（EDF）：deadline为0时取period；接纳控制失败返回-1 */
+int scheduler_set_realtime(uint32_t pid, uint32_t runtime, uint32_t period,
+                           uint32_t deadline);
+int scheduler_clear_realtime(uint32_t pid);
+int scheduler_rt_job_done(void);
+rt_stats_t scheduler_get_rt_stats(void);
+
+/* 录制与重放（kernel/core/replay.c）：录制器在scheduler_init之后设置，
+ * 记录外部输入与每次选择的进程；重放时用同一接口校验选择是否一致 */
+void scheduler_set_recorder(replay_t *recorder);
+
+/* 调度组（kernel/core/group.c）：兄弟组按份额分CPU，可设每周期的运行配额；
+ * 只有叶子组可以包含进程，pgid为0表示根（未分组进程） */
+int scheduler_group_create(uint32_t parent_pgid, uint32_t shares);
+int scheduler_group_destroy(uint32_t pgid);
+int scheduler_group_set_shares(uint32_t pgid, uint32_t shares);
+int scheduler_group_set_bandwidth(uint32_t pgid, uint32_t quota, uint32_t period);
+int scheduler_group_attach(uint32_t pid, uint32_t pgid);
+int scheduler_group_get_stats(uint32_t pgid, group_stats_t *stats);
+
+/* 同步原语支持（kernel/core/mutex.c）
+ * 带 _locked 后缀的函数要求调用者已通过 scheduler_lock() 持有调度器锁；
+ * 时钟中断也会获取该锁，所以加锁时关本CPU中断，解锁时恢复返回的状态 */
+irqflags_t scheduler_lock(void);
+void scheduler_unlock(irqflags_t flags);
+spinlock_stats_t scheduler_get_lock_stats(void);
+uint32_t scheduler_get_ticks(void);
+void scheduler_block_locked(wait_queue_t *queue);
+bool scheduler_wake_locked(pcb_t *pcb);
+void scheduler_ready_remove_locked(pcb_t *pcb);
+void scheduler_ready_add_locked(pcb_t *pcb);
+
+/* 优先级与查询 */
+int scheduler_set_priority(uint32_t pid, uint8_t priority);
+pcb_t* scheduler_get_current_process(void);
+pcb_t* scheduler_get_process(uint32_t pid);
+
+/* 空闲状态调控（kernel/core/idle.c）：空闲进程按预测的空闲时长在轮询与hlt
+ * 之间选择；统计各状态的驻留时间与唤醒延迟，单位为idle_clock()周期 */
+void scheduler_set_idle_config(const idle_config_t *config);
+int scheduler_get_idle_stats(uint32_t cpu, idle_stats_t *stats);
+
+/* 统计与调试 */
+scheduler_stats_t scheduler_get_stats(void);
+void scheduler_print_status(void);
+
+#endif /* _SPARROW_KERNEL_SCHEDULER_H */
@@ -0,0 +1,365 @@
+/**
+ * spinlock.h - 内核自旋锁接口
+ * 位于: kernel/include/spinlock.h
+ *
+ * 三种互斥自旋锁和一种读写锁，接口相同（init / lock / trylock / unlock）：
+ *   tas_lock_t     测试并设置：等待者都轮询同一个缓存行，释放时一起抢，
+ *                  谁抢到不确定，竞争激烈时可能有CPU一直拿不到锁。
+ *   ticket_lock_t  排队票号：先取号再等叫号，严格先来先得；等待者仍轮询
+ *                  同一缓存行，每次交接让所有等待者的缓存行失效一次。
+ *   mcs_lock_t     MCS队列锁：每个等待者在自己的节点上自旋，交接只写下一个
+ *                  等待者的节点，先来先得，交接代价与等待者数量无关。
+ *   rwlock_t       读写锁：读者共享；写者经票号锁排队，有写者等待时新来的
+ *                  读者也排队，写者不会被源源不断的读者饿死。
+ *
+ * spinlock_t 按 SPINLOCK_IMPL 选用前三种之一（默认票号锁），并在持锁期间
+ * 累计竞争统计。各 *_lock() 返回等待期间的轮询次数，0表示没有竞争。
+ * 目标机与主机构建都用GCC原子内建函数实现（x86上即 lock xadd / xchg /
+ * cmpxchg），不再依赖 context_switch.S。
+ *
+ * 中断处理函数也会获取的 spinlock_t，所有获取都必须用
+ * spinlock_lock_irqsave()（调度器锁即如此）。否则持锁或等锁时同一CPU被中断、
+ * 处理函数再来加锁：票号锁与TAS在自己持有的锁上自旋到死锁；MCS更糟，
+ * 每个CPU只有一个节点，中断里的获取会重新初始化被打断的那次获取正在使用的
+ * 节点，破坏等待队列。关中断持锁后同一CPU上不会嵌套获取同一把锁。
+ */
+
+#ifndef _SPARROW_SPINLOCK_H
+#define _SPARROW_SPINLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/percpu.h"
+#include "kernel/include/irqflags.h"
+
+#define SPINLOCK_TAS        0
+#define SPINLOCK_TICKET     1
+#define SPINLOCK_MCS        2
+
+#ifndef SPINLOCK_IMPL
+#define SPINLOCK_IMPL       SPINLOCK_TICKET
+#endif
+
+#define SPINLOCK_CACHE_LINE 64
+
+static inline void cpu_relax(void) {
+    __asm__ volatile("pause" ::: "memory");
+}
+
+/* ========== 测试并设置 ========== */
+
+typedef struct {
+    uint32_t locked;                // 0: 空闲, 1: 已持有
+} tas_lock_t;
+
+static inline void tas_lock_init(tas_lock_t *lock) {
+    lock->locked = 0;
+}
+
+static inline uint32_t tas_lock(tas_lock_t *lock) {
+    uint32_t spins = 0;
+    while (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE)) {
+        // 只读轮询，锁看起来空闲时再交换
+        do {
+            cpu_relax();
+            spins++;
+        } while (__atomic_load_n(&lock->locked, __ATOMIC_RELAXED));
+    }
+    return spins;
+}
+
+static inline bool tas_trylock(tas_lock_t *lock) {
+    return !__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE);
+}
+
+static inline void tas_unlock(tas_lock_t *lock) {
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
+/* ========== 排队票号 ========== */
+
+typedef union {
+    uint32_t word;                  // trylock整体比较交换
+    struct {
+        uint16_t owner;             // 正在服务的票号
+        uint16_t next;              // 下一个发出的票号
+    };
+} ticket_lock_t;
+
+static inline void ticket_lock_init(ticket_lock_t *lock) {
+    lock->word = 0;
+}
+
+static inline uint32_t ticket_lock(ticket_lock_t *lock) {
+    uint16_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+    uint32_t spins = 0;
+    for (;;) {
+        uint16_t owner = __atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE);
+        if (owner == ticket) {
+            return spins;
+        }
+        // 按前面排队的人数退避，减少对锁所在缓存行的轮询
+        for (uint16_t ahead = (uint16_t)(ticket - owner); ahead; ahead--) {
+            cpu_relax();
+        }
+        spins++;
+    }
+}
+
+static inline bool ticket_trylock(ticket_lock_t *lock) {
+    ticket_lock_t old = { .word = __atomic_load_n(&lock->word, __ATOMIC_RELAXED) };
+    if (old.owner != old.next) {
+        return false;
+    }
+    ticket_lock_t taken = old;
+    taken.next++;
+    return __atomic_compare_exchange_n(&lock->word, &old.word, taken.word, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/* 只有持有者写owner，不需要原子加 */
+static inline void ticket_unlock(ticket_lock_t *lock) {
+    __atomic_store_n(&lock->owner, (uint16_t)(lock->owner + 1), __ATOMIC_RELEASE);
+}
+
+/* ========== MCS队列锁 ========== */
+
+/* 等待节点，从加锁到解锁期间不能复用 */
+typedef struct mcs_node {
+    struct mcs_node *next;
+    uint32_t waiting;               // 前驱交接时清零
+} __attribute__((aligned(SPINLOCK_CACHE_LINE))) mcs_node_t;
+
+typedef struct {
+    mcs_node_t *tail;               // 队尾，NULL表示空闲
+} mcs_lock_t;
+
+static inline void mcs_lock_init(mcs_lock_t *lock) {
+    lock->tail = NULL;
+}
+
+static inline uint32_t mcs_lock(mcs_lock_t *lock, mcs_node_t *node) {
+    node->next = NULL;
+    node->waiting = 1;
+    mcs_node_t *prev = __atomic_exchange_n(&lock->tail, node, __ATOMIC_ACQ_REL);
+    if (!prev) {
+        return 0;
+    }
+
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+    uint32_t spins = 1;
+    while (__atomic_load_n(&node->waiting, __ATOMIC_ACQUIRE)) {
+        cpu_relax();
+        spins++;
+    }
+    return spins;
+}
+
+static inline bool mcs_trylock(mcs_lock_t *lock, mcs_node_t *node) {
+    mcs_node_t *expected = NULL;
+    node->next = NULL;
+    node->waiting = 0;
+    return __atomic_compare_exchange_n(&lock->tail, &expected, node, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void mcs_unlock(mcs_lock_t *lock, mcs_node_t *node) {
+    mcs_node_t *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    if (!next) {
+        mcs_node_t *expected = node;
+        if (__atomic_compare_exchange_n(&lock->tail, &expected, NULL, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return;
+        }
+        // 后继已换上队尾，但还没来得及链到本节点
+        while (!(next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE))) {
+            cpu_relax();
+        }
+    }
+    __atomic_store_n(&next->waiting, 0, __ATOMIC_RELEASE);
+}
+
+/* ========== 读写锁 ========== */
+
+#define RWLOCK_WRITER_LOCKED    0x1
+#define RWLOCK_WRITER_WAITING   0x2
+#define RWLOCK_WRITER_MASK      0x3
+#define RWLOCK_READER_BIAS      0x4
+
+typedef struct {
+    uint32_t cnts;                  // 读者数 * RWLOCK_READER_BIAS | 写者位
+    ticket_lock_t wait;             // 慢路径上的读者与写者在此排队
+} rwlock_t;
+
+static inline void rwlock_init(rwlock_t *lock) {
+    lock->cnts = 0;
+    ticket_lock_init(&lock->wait);
+}
+
+static inline uint32_t rwlock_read_lock(rwlock_t *lock) {
+    uint32_t cnts = __atomic_add_fetch(&lock->cnts, RWLOCK_READER_BIAS, __ATOMIC_ACQUIRE);
+    if (!(cnts & RWLOCK_WRITER_MASK)) {
+        return 0;
+    }
+
+    // 有写者持有或等待：退出快路径，排到写者后面
+    __atomic_sub_fetch(&lock->cnts, RWLOCK_READER_BIAS, __ATOMIC_RELAXED);
+    uint32_t spins = 1 + ticket_lock(&lock->wait);
+    __atomic_add_fetch(&lock->cnts, RWLOCK_READER_BIAS, __ATOMIC_ACQUIRE);
+    while (__atomic_load_n(&lock->cnts, __ATOMIC_ACQUIRE) & RWLOCK_WRITER_LOCKED) {
+        cpu_relax();
+        spins++;
+    }
+    ticket_unlock(&lock->wait);
+    return spins;
+}
+
+static inline bool rwlock_read_trylock(rwlock_t *lock) {
+    uint32_t cnts = __atomic_add_fetch(&lock->cnts, RWLOCK_READER_BIAS, __ATOMIC_ACQUIRE);
+    if (!(cnts & RWLOCK_WRITER_MASK)) {
+        return true;
+    }
+    __atomic_sub_fetch(&lock->cnts, RWLOCK_READER_BIAS, __ATOMIC_RELAXED);
+    return false;
+}
+
+static inline void rwlock_read_unlock(rwlock_t *lock) {
+    __atomic_sub_fetch(&lock->cnts, RWLOCK_READER_BIAS, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t rwlock_write_lock(rwlock_t *lock) {
+    uint32_t expected = 0;
+    if (__atomic_compare_exchange_n(&lock->cnts, &expected, RWLOCK_WRITER_LOCKED, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+
+    uint32_t spins = 1 + ticket_lock(&lock->wait);
+    // 先挂出等待位挡住新读者，再等现有读者（和快路径上抢到的写者）退出
+    __atomic_fetch_or(&lock->cnts, RWLOCK_WRITER_WAITING, __ATOMIC_RELAXED);
+    for (;;) {
+        expected = RWLOCK_WRITER_WAITING;
+        if (__atomic_load_n(&lock->cnts, __ATOMIC_RELAXED) == RWLOCK_WRITER_WAITING &&
+            __atomic_compare_exchange_n(&lock->cnts, &expected, RWLOCK_WRITER_LOCKED, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+        cpu_relax();
+        spins++;
+    }
+    ticket_unlock(&lock->wait);
+    return spins;
+}
+
+static inline bool rwlock_write_trylock(rwlock_t *lock) {
+    uint32_t expected = 0;
+    return __atomic_compare_exchange_n(&lock->cnts, &expected, RWLOCK_WRITER_LOCKED, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void rwlock_write_unlock(rwlock_t *lock) {
+    __atomic_fetch_sub(&lock->cnts, RWLOCK_WRITER_LOCKED, __ATOMIC_RELEASE);
+}
+
+/* ========== spinlock_t ========== */
+
+/* 竞争统计，只在持锁期间更新 */
+typedef struct {
+    uint32_t acquisitions;
+    uint32_t contended;             // 第一次尝试没有拿到锁的次数
+    uint64_t spins;                 // 等待期间的轮询总次数
+    uint32_t max_spins;             // 单次加锁最多的轮询次数
+} spinlock_stats_t;
+
+typedef struct {
+#if SPINLOCK_IMPL == SPINLOCK_MCS
+    mcs_lock_t lock;
+    mcs_node_t nodes[MAX_CPUS];     // 每个CPU对同一把锁最多等待一次，中断共用的锁须irqsave
+#elif SPINLOCK_IMPL == SPINLOCK_TAS
+    tas_lock_t lock;
+#else
+    ticket_lock_t lock;
+#endif
+    spinlock_stats_t stats;
+} spinlock_t;
+
+static inline const char* spinlock_impl_name(void) {
+#if SPINLOCK_IMPL == SPINLOCK_MCS
+    return "mcs";
+#elif SPINLOCK_IMPL == SPINLOCK_TAS
+    return "tas";
+#else
+    return "ticket";
+#endif
+}
+
+static inline void spinlock_init(spinlock_t *lock) {
+#if SPINLOCK_IMPL == SPINLOCK_MCS
+    mcs_lock_init(&lock->lock);
+#elif SPINLOCK_IMPL == SPINLOCK_TAS
+    tas_lock_init(&lock->lock);
+#else
+    ticket_lock_init(&lock->lock);
+#endif
+    lock->stats = (spinlock_stats_t){0};
+}
+
+static inline void spinlock_note(spinlock_stats_t *stats, uint32_t spins) {
+    stats->acquisitions++;
+    if (spins) {
+        stats->contended++;
+        stats->spins += spins;
+        if (spins > stats->max_spins) {
+            stats->max_spins = spins;
+        }
+    }
+}
+
+static inline void spinlock_lock(spinlock_t *lock) {
+#if SPINLOCK_IMPL == SPINLOCK_MCS
+    uint32_t spins = mcs_lock(&lock->lock, &lock->nodes[this_cpu_id()]);
+#elif SPINLOCK_IMPL == SPINLOCK_TAS
+    uint32_t spins = tas_lock(&lock->lock);
+#else
+    uint32_t spins = ticket_lock(&lock->lock);
+#endif
+    spinlock_note(&lock->stats, spins);
+}
+
+static inline bool spinlock_trylock(spinlock_t *lock) {
+#if SPINLOCK_IMPL == SPINLOCK_MCS
+    bool taken = mcs_trylock(&lock->lock, &lock->nodes[this_cpu_id()]);
+#elif SPINLOCK_IMPL == SPINLOCK_TAS
+    bool taken = tas_trylock(&lock->lock);
+#else
+    bool taken = ticket_trylock(&lock->lock);
+#endif
+    if (taken) {
+        spinlock_note(&lock->stats, 0);
+    }
+    return taken;
+}
+
+static inline void spinlock_unlock(spinlock_t *lock) {
+#if SPINLOCK_IMPL == SPINLOCK_MCS
+    mcs_unlock(&lock->lock, &lock->nodes[this_cpu_id()]);
+#elif SPINLOCK_IMPL == SPINLOCK_TAS
+    tas_unlock(&lock->lock);
+#else
+    ticket_unlock(&lock->lock);
+#endif
+}
+
+/* 中断处理函数也会获取的锁：先关本CPU中断再加锁，返回原来的中断状态 */
+static inline irqflags_t spinlock_lock_irqsave(spinlock_t *lock) {
+    irqflags_t flags = local_irq_save();
+    spinlock_lock(lock);
+    return flags;
+}
+
+static inline void spinlock_unlock_irqrestore(spinlock_t *lock, irqflags_t flags) {
+    spinlock_unlock(lock);
+    local_irq_restore(flags);
+}
+
+#endif /* _SPARROW_SPINLOCK_H */
@@ -0,0 +1,39 @@
+/**
+ * switch.h - 进程切换接口
+ * 位于: kernel/include/switch.h
+ *
+ * 两条路径：
+ *   - 自愿切换（阻塞、让出、退出、调度点）：switch_to()，只保存
+ *     EBX/ESI/EDI/EBP和ESP，约20条指令；
+ *   - 中断抢占：中断入口用 interrupt_context_save/restore 保存完整帧，
+ *     处理函数内部调用调度器时同样经由switch_to切换内核栈。
+ */
+
+#ifndef _SPARROW_SWITCH_H
+#define _SPARROW_SWITCH_H
+
+#include <stdint.h>
+#include "kernel/include/pcb.h"
+
+/* 汇编实现，见 kernel/arch_x86/context_switch.S */
+extern void switch_stack(uint32_t *prev_sp, uint32_t next_sp);
+
+/* 从prev切换到next；prev为NULL（已退出）时丢弃当前栈 */
+static inline void switch_to(pcb_t *prev, pcb_t *next) {
+    static uint32_t discarded_sp;
+    switch_stack(prev ? &prev->cold->context.esp : &discarded_sp,
+                 next->cold->context.esp);
+}
+
+/* 在进程栈顶构造switch_to的初始帧，首次切入时"返回"到entry */
+static inline void switch_frame_init(pcb_t *pcb, void (*entry)(void)) {
+    uint32_t *sp = (uint32_t *)(uintptr_t)(pcb->cold->stack_base + pcb->cold->stack_size);
+    *--sp = (uint32_t)(uintptr_t)entry;     // 返回地址
+    *--sp = 0;                              // ebp
+    *--sp = 0;                              // ebx
+    *--sp = 0;                              // esi
+    *--sp = 0;                              // edi
+    pcb->cold->context.esp = (uint32_t)(uintptr_t)sp;
+}
+
+#endif /* _SPARROW_SWITCH_H */
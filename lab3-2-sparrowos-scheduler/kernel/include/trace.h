@@ -0,0 +1,78 @@
+/**
+ * trace.h - 调度器跟踪点与延迟直方图
+ * 位于: kernel/include/trace.h
+ *
+ * 切换、唤醒、迁移、阻塞等事件写入每CPU的环形缓冲区，满了覆盖最旧的
+ * 事件，写入只在本CPU上进行，无需加锁。同时按log2分桶统计就绪队列
+ * 等待时间与唤醒到运行的延迟，用于读出p50/p99而不只是均值。
+ */
+
+#ifndef _SPARROW_TRACE_H
+#define _SPARROW_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+#include "kernel/include/percpu.h"
+
+#define TRACE_RING_SIZE     256     // 每CPU缓冲的事件数（2的幂）
+#define LAT_HIST_BUCKETS    16      // 桶i：[2^(i-1), 2^i) 个tick，桶0为0
+
+/* 事件类型 */
+typedef enum {
+    TRACE_SWITCH  = 0,              // arg: 换出进程的PID（0为空闲）
+    TRACE_WAKEUP  = 1,              // arg: 唤醒前的状态
+    TRACE_MIGRATE = 2,              // arg: 上次运行的CPU
+    TRACE_BLOCK   = 3,              // arg: 等待原因
+    TRACE_NR_EVENTS
+} trace_type_t;
+
+typedef struct {
+    uint32_t ticks;                 // 发生时刻
+    uint32_t pid;                   // 相关进程（切换时为换入进程）
+    uint32_t arg;
+    uint8_t type;                   // trace_type_t
+    uint8_t cpu;
+    uint16_t reserved;
+} trace_event_t;
+
+/* log2延迟直方图 */
+typedef struct {
+    uint32_t buckets[LAT_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t max;
+} lat_hist_t;
+
+/* 每CPU跟踪状态 */
+typedef struct {
+    trace_event_t ring[TRACE_RING_SIZE];
+    uint32_t head;                  // 累计写入的事件数，head % TRACE_RING_SIZE 为下一个写入位置
+    uint32_t counts[TRACE_NR_EVENTS];
+    lat_hist_t runq_wait;           // 进入就绪队列到开始运行
+    lat_hist_t wake_latency;        // 被唤醒到开始运行
+} __attribute__((aligned(CACHE_LINE_SIZE))) trace_cpu_t;
+
+void trace_init(void);
+void trace_set_enabled(bool enabled);
+
+/* 记录一个事件（调度器锁内调用） */
+void trace_event(trace_type_t type, uint32_t ticks, uint32_t pid, uint32_t arg);
+
+/* 进程开始运行：wait为在就绪队列中等待的tick数，woken表示这次就绪由唤醒引起 */
+void trace_record_run(uint32_t wait, bool woken);
+
+const trace_cpu_t* trace_get_cpu(uint32_t cpu);
+
+/* 按时间顺序复制最近最多max个事件，返回复制的个数 */
+uint32_t trace_read(uint32_t cpu, trace_event_t *out, uint32_t max);
+
+void lat_hist_add(lat_hist_t *hist, uint32_t value);
+
+/* 百分位数（0-100）所在桶的上界，直方图为空时返回0 */
+uint32_t lat_hist_percentile(const lat_hist_t *hist, uint32_t percent);
+
+void lat_hist_print(const char *name, const lat_hist_t *hist);
+
+const char* trace_type_name(uint32_t type);
+
+#endif /* _SPARROW_TRACE_H */
@@ -0,0 +1,81 @@
+/**
+ * wakelist.h - 每CPU无锁唤醒链表
+ * 位于: kernel/include/wakelist.h
+ *
+ * 多生产者单消费者：中断处理函数等任意上下文用CAS把PCB压到链表头，
+ * 不获取调度器锁；调度器在下一个调度点用一次原子交换取走整条链表，
+ * 反转成入链顺序后在锁内批量处理。PCB经 cold->wake_next 串联，
+ * cold->wake_pending 保证同一PCB同时只在一条链表上，重复唤醒直接合并。
+ * 消费者一次取走整条链表，不存在单个节点出链的ABA问题。
+ */
+
+#ifndef _SPARROW_WAKELIST_H
+#define _SPARROW_WAKELIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/include/pcb.h"
+
+/* 每CPU一个，独占缓存行，避免不同CPU的生产者互相干扰 */
+typedef struct {
+    pcb_t *head;                    // 后入链的在前
+    uint32_t pushed;                // 入链次数（生产者原子累加）
+    uint32_t coalesced;             // 已在链上而被合并的唤醒（生产者原子累加）
+    uint32_t drained;               // 出链处理的PCB数（仅消费者）
+    uint32_t batches;               // 非空批次数（仅消费者）
+    uint32_t stale;                 // 出链时已不在等待状态的PCB数（仅消费者）
+} __attribute__((aligned(CACHE_LINE_SIZE))) wake_list_t;
+
+static inline void wake_list_init(wake_list_t *list) {
+    list->head = NULL;
+    list->pushed = 0;
+    list->coalesced = 0;
+    list->drained = 0;
+    list->batches = 0;
+    list->stale = 0;
+}
+
+/* 压入PCB；已在某条唤醒链表上时返回false */
+static inline bool wake_list_push(wake_list_t *list, pcb_t *pcb) {
+    if (__atomic_exchange_n(&pcb->cold->wake_pending, 1, __ATOMIC_ACQUIRE)) {
+        __atomic_fetch_add(&list->coalesced, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    pcb_t *head = __atomic_load_n(&list->head, __ATOMIC_RELAXED);
+    do {
+        pcb->cold->wake_next = head;
+    } while (!__atomic_compare_exchange_n(&list->head, &head, pcb, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    __atomic_fetch_add(&list->pushed, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+static inline bool wake_list_empty(const wake_list_t *list) {
+    return __atomic_load_n(&list->head, __ATOMIC_RELAXED) == NULL;
+}
+
+/* 取走整条链表并按入链顺序返回（只能由所属CPU的调度器调用） */
+static inline pcb_t* wake_list_take_all(wake_list_t *list) {
+    pcb_t *pcb = __atomic_exchange_n(&list->head, NULL, __ATOMIC_ACQUIRE);
+    pcb_t *fifo = NULL;
+
+    while (pcb) {
+        pcb_t *next = pcb->cold->wake_next;
+        pcb->cold->wake_next = fifo;
+        fifo = pcb;
+        pcb = next;
+    }
+    return fifo;
+}
+
+/* 出链：返回下一个节点并清除pending，之后该PCB可以再次被压入 */
+static inline pcb_t* wake_list_pop(pcb_t *pcb) {
+    pcb_t *next = pcb->cold->wake_next;
+    pcb->cold->wake_next = NULL;
+    __atomic_store_n(&pcb->cold->wake_pending, 0, __ATOMIC_RELEASE);
+    return next;
+}
+
+#endif /* _SPARROW_WAKELIST_H */
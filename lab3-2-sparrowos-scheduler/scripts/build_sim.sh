@@ -0,0 +1,101 @@
+#!/bin/bash
+
+# SparrowOS Scheduler Simulator Build Script
+# 在主机上编译内核调度器核心 + 离散事件模拟器
+
+set -e  # 遇到错误立即退出
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_DIR="$(dirname "$SCRIPT_DIR")"
+KERNEL_DIR="$PROJECT_DIR/kernel"
+TOOLS_DIR="$PROJECT_DIR/tools"
+BUILD_DIR="$PROJECT_DIR/build/sim"
+BIN_DIR="$PROJECT_DIR/bin"
+
+# 模拟器需要容纳上千个并发任务
+MAX_PROCESSES=${MAX_PROCESSES:-4096}
+
+echo "=== SparrowOS Scheduler Simulator Build ==="
+
+mkdir -p "$BUILD_DIR"
+mkdir -p "$BIN_DIR"
+
+if ! command -v gcc &> /dev/null; then
+    echo "Error: GCC compiler not found"
+    exit 1
+fi
+
+# SPARROW_HOST: 跳过目标机专用汇编；SCHED_QUIET: 关闭逐事件日志
+CFLAGS="-Wall -Wextra -O2 -g -DSPARROW_HOST -DSCHED_QUIET -DMAX_PROCESSES=$MAX_PROCESSES -I$PROJECT_DIR -I$TOOLS_DIR"
+
+C_SOURCES=(
+    "$KERNEL_DIR/core/scheduler.c"
+    "$KERNEL_DIR/core/pcb.c"
+    "$KERNEL_DIR/core/fpu.c"
+    "$KERNEL_DIR/core/edf.c"
+    "$KERNEL_DIR/core/mutex.c"
+    "$KERNEL_DIR/core/trace.c"
+    "$KERNEL_DIR/core/group.c"
+    "$KERNEL_DIR/core/kstack.c"
+    "$KERNEL_DIR/core/replay.c"
+    "$KERNEL_DIR/core/idle.c"
+    "$TOOLS_DIR/sim_host.c"
+    "$TOOLS_DIR/sim_workload.c"
+    "$TOOLS_DIR/sched_sim.c"
+)
+
+OBJECTS=()
+for source in "${C_SOURCES[@]}"; do
+    filename=$(basename "$source" .c)
+    echo "  Compiling $filename.c..."
+    gcc $CFLAGS -c "$source" -o "$BUILD_DIR/$filename.o"
+    OBJECTS+=("$BUILD_DIR/$filename.o")
+done
+
+echo "Linking sched_sim..."
+gcc -o "$BIN_DIR/sched_sim" "${OBJECTS[@]}"
+
+echo "Linking queue_bench..."
+gcc $CFLAGS -c "$TOOLS_DIR/queue_bench.c" -o "$BUILD_DIR/queue_bench.o"
+gcc -o "$BIN_DIR/queue_bench" "$BUILD_DIR/queue_bench.o" "$BUILD_DIR/pcb.o"
+
+echo "Linking spawn_bench..."
+gcc $CFLAGS -c "$TOOLS_DIR/spawn_bench.c" -o "$BUILD_DIR/spawn_bench.o"
+SPAWN_OBJECTS=()
+for obj in "${OBJECTS[@]}"; do
+    case "$(basename "$obj")" in
+        sched_sim.o|sim_workload.o) ;;
+        *) SPAWN_OBJECTS+=("$obj") ;;
+    esac
+done
+gcc -o "$BIN_DIR/spawn_bench" "$BUILD_DIR/spawn_bench.o" "${SPAWN_OBJECTS[@]}"
+
+echo "Linking reap_bench..."
+gcc $CFLAGS -c "$TOOLS_DIR/reap_bench.c" -o "$BUILD_DIR/reap_bench.o"
+gcc -o "$BIN_DIR/reap_bench" "$BUILD_DIR/reap_bench.o" "${SPAWN_OBJECTS[@]}"
+
+echo "Linking affinity_sim..."
+gcc $CFLAGS -c "$KERNEL_DIR/core/placement.c" -o "$BUILD_DIR/placement.o"
+gcc $CFLAGS -c "$TOOLS_DIR/affinity_sim.c" -o "$BUILD_DIR/affinity_sim.o"
+gcc -o "$BIN_DIR/affinity_sim" "$BUILD_DIR/affinity_sim.o" "$BUILD_DIR/placement.o" "$BUILD_DIR/sim_workload.o"
+
+echo "Linking idle_sim..."
+gcc $CFLAGS -c "$TOOLS_DIR/idle_sim.c" -o "$BUILD_DIR/idle_sim.o"
+gcc -o "$BIN_DIR/idle_sim" "$BUILD_DIR/idle_sim.o" "$BUILD_DIR/idle.o"
+
+echo "Linking lock_bench..."
+gcc $CFLAGS -pthread -o "$BIN_DIR/lock_bench" "$TOOLS_DIR/lock_bench.c"
+
+# 上下文切换基准为x86-64内联汇编，其他主机架构跳过
+if [ "$(uname -m)" = "x86_64" ]; then
+    echo "Linking switch_bench..."
+    gcc -Wall -Wextra -O2 -g -o "$BIN_DIR/switch_bench" "$TOOLS_DIR/switch_bench.c"
+
+    # 绿色线程运行时复用内核核心的就绪队列与MLFQ（pcb.o）
+    echo "Linking uthread_bench..."
+    gcc $CFLAGS -pthread -o "$BIN_DIR/uthread_bench" "$TOOLS_DIR/uthread_bench.c" \
+        "$PROJECT_DIR/uthread/core/uthread.c" "$PROJECT_DIR/uthread/arch_x86_64/uthread_switch.S" \
+        "$BUILD_DIR/pcb.o"
+fi
+
+echo "Build complete: $BIN_DIR/sched_sim $BIN_DIR/queue_bench $BIN_DIR/affinity_sim $BIN_DIR/spawn_bench $BIN_DIR/reap_bench $BIN_DIR/idle_sim $BIN_DIR/lock_bench $BIN_DIR/switch_bench $BIN_DIR/uthread_bench"
@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# SparrowOS Scheduler Simulator perf对比
+# 用 perf stat 统计模拟器的缓存未命中；可选给出一个git版本作为对照组
+# 用法: ./scripts/perf_sim.sh [BASE_REF] [-- sched_sim参数...]
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_DIR="$(dirname "$SCRIPT_DIR")"
+PERF_DIR="$PROJECT_DIR/build/perf"
+EVENTS=${EVENTS:-cycles,instructions,cache-references,cache-misses,L1-dcache-loads,L1-dcache-load-misses,LLC-load-misses,dTLB-load-misses}
+REPEAT=${REPEAT:-5}
+
+BASE_REF=""
+if [ $# -gt 0 ] && [ "$1" != "--" ]; then
+    BASE_REF="$1"
+    shift
+fi
+[ "$1" == "--" ] && shift
+SIM_ARGS=("$@")
+if [ ${#SIM_ARGS[@]} -eq 0 ]; then
+    SIM_ARGS=(-n 4000 -l 1.2 -q 10 -b 1000)
+fi
+
+if ! command -v perf &> /dev/null; then
+    echo "Error: perf not found"
+    echo "Install with: sudo apt install linux-tools-common linux-tools-\$(uname -r)"
+    exit 1
+fi
+
+mkdir -p "$PERF_DIR"
+
+# 编译当前工作区
+"$SCRIPT_DIR/build_sim.sh" > /dev/null
+cp "$PROJECT_DIR/bin/sched_sim" "$PERF_DIR/sched_sim.current"
+
+# 编译对照版本（在临时工作树中使用其自带的构建脚本）
+if [ -n "$BASE_REF" ]; then
+    REPO_ROOT="$(git -C "$PROJECT_DIR" rev-parse --show-toplevel)"
+    SUBDIR="${PROJECT_DIR#$REPO_ROOT/}"
+    WORKTREE="$PERF_DIR/base-src"
+    rm -rf "$WORKTREE"
+    mkdir -p "$WORKTREE"
+    git -C "$REPO_ROOT" archive "$BASE_REF" "$SUBDIR" | tar -x -C "$WORKTREE"
+    bash "$WORKTREE/$SUBDIR/scripts/build_sim.sh" > /dev/null
+    cp "$WORKTREE/$SUBDIR/bin/sched_sim" "$PERF_DIR/sched_sim.base"
+fi
+
+run_perf() {
+    local label="$1"
+    local binary="$2"
+    echo "=== $label: sched_sim ${SIM_ARGS[*]} ==="
+    perf stat -r "$REPEAT" -e "$EVENTS" "$binary" "${SIM_ARGS[@]}" -o /dev/null 2>&1 \
+        | grep -v "^Workload:"
+}
+
+[ -n "$BASE_REF" ] && run_perf "base ($BASE_REF)" "$PERF_DIR/sched_sim.base"
+run_perf "current" "$PERF_DIR/sched_sim.current"
@@ -0,0 +1,95 @@
+#!/bin/bash
+
+# SparrowOS Kernel Scheduler Test Runner
+# 在主机上针对内核调度器核心（kernel/core）编译并运行测试
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_DIR="$(dirname "$SCRIPT_DIR")"
+TEST_DIR="$PROJECT_DIR/tests"
+BIN_DIR="$PROJECT_DIR/bin"
+
+CFLAGS="-Wall -Wextra -O2 -g -pthread -DSPARROW_HOST -DSCHED_QUIET -I$PROJECT_DIR -I$PROJECT_DIR/tools"
+
+KERNEL_SOURCES=(
+    "$PROJECT_DIR/kernel/core/scheduler.c"
+    "$PROJECT_DIR/kernel/core/pcb.c"
+    "$PROJECT_DIR/kernel/core/fpu.c"
+    "$PROJECT_DIR/kernel/core/edf.c"
+    "$PROJECT_DIR/kernel/core/mutex.c"
+    "$PROJECT_DIR/kernel/core/trace.c"
+    "$PROJECT_DIR/kernel/core/group.c"
+    "$PROJECT_DIR/kernel/core/kstack.c"
+    "$PROJECT_DIR/kernel/core/replay.c"
+    "$PROJECT_DIR/kernel/core/idle.c"
+    "$PROJECT_DIR/kernel/core/placement.c"
+    "$PROJECT_DIR/tools/sim_host.c"
+)
+
+# 基于内核核心的测试
+KERNEL_TESTS=(
+    test_lazy_fpu
+    test_edf
+    test_pi_mutex
+    test_wakelist
+    test_pid_table
+    test_adaptive_mlfq
+    test_trace
+    test_placement
+    test_group
+    test_kstack_pool
+    test_replay
+    test_spinlock
+    test_idle
+    test_reaper
+    test_wakeup_preempt
+)
+
+# 绿色线程运行时：只依赖内核核心的 pcb.c，切换为x86-64汇编
+UTHREAD_SOURCES=(
+    "$PROJECT_DIR/uthread/core/uthread.c"
+    "$PROJECT_DIR/uthread/arch_x86_64/uthread_switch.S"
+    "$PROJECT_DIR/kernel/core/pcb.c"
+)
+
+UTHREAD_TESTS=()
+if [ "$(uname -m)" = "x86_64" ]; then
+    UTHREAD_TESTS=(test_uthread)
+fi
+
+echo "=== SparrowOS Kernel Scheduler Tests ==="
+mkdir -p "$BIN_DIR"
+
+FAILED=0
+for test in "${KERNEL_TESTS[@]}"; do
+    echo -e "\n--- $test ---"
+    if ! gcc $CFLAGS "$TEST_DIR/$test.c" "${KERNEL_SOURCES[@]}" -o "$BIN_DIR/$test"; then
+        echo "✗ $test failed to build"
+        FAILED=$((FAILED + 1))
+        continue
+    fi
+    if "$BIN_DIR/$test"; then
+        echo "✓ $test passed"
+    else
+        echo "✗ $test failed"
+        FAILED=$((FAILED + 1))
+    fi
+done
+
+for test in "${UTHREAD_TESTS[@]}"; do
+    echo -e "\n--- $test ---"
+    if ! gcc $CFLAGS "$TEST_DIR/$test.c" "${UTHREAD_SOURCES[@]}" -o "$BIN_DIR/$test"; then
+        echo "✗ $test failed to build"
+        FAILED=$((FAILED + 1))
+        continue
+    fi
+    if "$BIN_DIR/$test"; then
+        echo "✓ $test passed"
+    else
+        echo "✗ $test failed"
+        FAILED=$((FAILED + 1))
+    fi
+done
+
+TOTAL=$((${#KERNEL_TESTS[@]} + ${#UTHREAD_TESTS[@]}))
+echo -e "\n=== $((TOTAL - FAILED))/$TOTAL kernel test programs passed ==="
+[ $FAILED -eq 0 ]
@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# SparrowOS Scheduler Simulator Sweep
+# 对 FIFO/RR/MLFQ 扫描 time_quantum 和 boost_interval，结果写入CSV
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_DIR="$(dirname "$SCRIPT_DIR")"
+OUTPUT=${OUTPUT:-"$PROJECT_DIR/build/sim_results.csv"}
+
+# 可通过环境变量覆盖扫描参数
+TASKS=${TASKS:-5000}
+MIX=${MIX:-mixed}
+LOAD=${LOAD:-0.9}
+SEED=${SEED:-1}
+QUANTA=${QUANTA:-2,5,10,20,50}
+BOOSTS=${BOOSTS:-100,500,1000,5000}
+
+"$SCRIPT_DIR/build_sim.sh"
+
+echo "=== Running sweep: tasks=$TASKS mix=$MIX load=$LOAD seed=$SEED ==="
+"$PROJECT_DIR/bin/sched_sim" -n "$TASKS" -m "$MIX" -l "$LOAD" -s "$SEED" \
+    -q "$QUANTA" -b "$BOOSTS" -o "$OUTPUT" "$@"
+
+column -s, -t < "$OUTPUT" 2>/dev/null || cat "$OUTPUT"
+echo "Results written to $OUTPUT"
@@ -9,13 +9,32 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#define MAX_PROCESSES       64
+#ifndef MAX_PROCESSES
+#define MAX_PROCESSES       1024    // 主机模拟器可通过 -DMAX_PROCESSES 放大
+#endif
+#if MAX_PROCESSES % 32 != 0
+#error "MAX_PROCESSES must be a multiple of 32"
+#endif
 #define MAX_PRIORITY_LEVELS 4
 #define TIME_SLICE_BASE     10      // 基本时间片（时间单位）
 #define MAX_RUNTIME         1000    // 最大运行时间
 #define STACK_SIZE          4096    // 进程栈大小
 #define PROCESS_NAME_LEN    32
 
+/* 自适应MLFQ：按睡眠占比估计交互性 */
+#define INTERACTIVITY_SCALE     1024    // 睡眠占比定点表示，1024 = 100%
+#define INTERACTIVITY_EWMA_SHIFT 2      // EWMA每个样本权重 1/4
+#define INTERACTIVITY_WINDOW    TIME_SLICE_BASE // 连续运行满这么多tick即结束一个统计窗口
+#define INTERACTIVE_THRESHOLD   768     // 睡眠占比 >= 75% 视为交互型
+#define MLFQ_MAX_STRETCH        4       // 批处理型进程时间片最多拉长到4倍
+
+/* 唤醒抢占（should_preempt）：粒度限制防止频繁切换 */
+#define WAKEUP_GRANULARITY      4       // 被唤醒进程的vruntime至少领先这么多tick
+#define WAKEUP_MIN_RUN          2       // 当前进程本时间片至少已运行这么多tick
+#define MIN_VRUNTIME_INTERVAL   8       // 扫描就绪队列推进min_vruntime的最短间隔（tick）
+#define CACHE_LINE_SIZE     64
+#define PCB_NO_CPU          0xFF    // last_cpu：尚未运行过
+
 /* 进程状态枚举 */
 typedef enum {
     PROCESS_NEW,        // 新建
@@ -24,7 +43,7 @@ typedef enum {
     PROCESS_BLOCKED,    // 阻塞
     PROCESS_SLEEPING,   // 睡眠
     PROCESS_ZOMBIE,     // 僵尸（已终止但资源未回收）
-    PROCESS_TERMINATED  // 终止
+    PROCESS_TERMINATED  // 终止（已回收，PCB与内核栈由回收器释放）
 } process_state_t;
 
 /* 进程类型 */
@@ -45,7 +64,9 @@ typedef enum {
     PROCESS_FLAG_KERNEL     = 0x10,  // 内核进程
     PROCESS_FLAG_SCHED_MLFQ = 0x20,  // MLFQ调度
     PROCESS_FLAG_SCHED_RR   = 0x40,  // RR调度
-    PROCESS_FLAG_SCHED_FIFO = 0x80   // FIFO调度
+    PROCESS_FLAG_SCHED_FIFO = 0x80,  // FIFO调度
+    PROCESS_FLAG_FPU_USED   = 0x100, // 已使用过FPU，fpu_state中保存有效状态
+    PROCESS_FLAG_PI_BOOSTED = 0x200  // 因优先级继承而提升，见pi_state_t
 } process_flags_t;
 
 /* CPU上下文结构（用于上下文切换） */
@@ -75,8 +96,8 @@ typedef struct {
     uint32_t eflags;
     uint32_t cr3;   // 页目录基址寄存器
     
-    /* 浮点寄存器上下文（可选） */
-    uint8_t fpu_state[512];
+    /* 浮点寄存器上下文（FXSAVE区域，要求16字节对齐；惰性保存，见fpu.c） */
+    uint8_t fpu_state[512] __attribute__((aligned(16)));
 } cpu_context_t;
 
 /* 进程统计信息 */
@@ -98,20 +119,43 @@ typedef struct {
     uint32_t child_processes; // 子进程数
 } resource_usage_t;
 
-/* 进程控制块（PCB）结构体 */
-typedef struct process_control_block {
+/* 实时（EDF）参数与统计，由scheduler_set_realtime设置 */
+typedef struct {
+    uint32_t runtime;               // 每个作业的最坏执行时间（WCET）
+    uint32_t period;                // 释放周期
+    uint32_t rel_deadline;          // 相对截止时间（≤ period）
+    uint32_t release;               // 当前作业的释放时刻
+    uint32_t jobs;                  // 已完成作业数
+    uint32_t deadline_misses;       // 错过截止时间的作业数
+    uint32_t max_response;          // 最大响应时间
+} rt_params_t;
+
+/* 优先级继承状态（kernel/core/mutex.c） */
+typedef struct {
+    struct kmutex *blocked_on;      // 正在等待的互斥锁
+    struct kmutex *held;            // 持有的互斥锁链表
+    uint8_t base_level;             // 提升前的MLFQ级别
+    bool rt;                        // 继承了实时类
+    uint32_t deadline;              // 继承的绝对截止时间（rt为真时有效）
+    uint32_t block_start;           // 开始等待互斥锁的时刻
+} pi_state_t;
+
+/* 交互性估计：每个统计窗口（到下一次唤醒，或连续运行INTERACTIVITY_WINDOW个tick）
+ * 的睡眠占比做EWMA */
+typedef struct {
+    uint32_t sleep_avg;             // 睡眠占比EWMA（0..INTERACTIVITY_SCALE）
+    uint32_t sleep_start;           // 最近一次阻塞/睡眠的时刻
+    uint32_t window_used;           // 本窗口开始时的运行时间（user_time + kernel_time）
+} interactivity_t;
+
+/* PCB冷数据：创建/退出、信号、文件、IPC等路径才访问，单独分配，
+ * 避免调度路径遍历队列时把这些字段带进缓存 */
+typedef struct pcb_cold {
     /* === 标识信息 === */
-    uint32_t pid;                   // 进程ID
     uint32_t ppid;                  // 父进程ID
     uint32_t uid;                   // 用户ID
     uint32_t gid;                   // 组ID
     char name[PROCESS_NAME_LEN];   // 进程名称
-    
-    /* === 状态信息 === */
-    process_state_t state;          // 进程状态
-    process_type_t type;            // 进程类型
-    process_flags_t flags;          // 进程标志
-    uint8_t priority;               // 当前优先级（0最高，MAX_PRIORITY_LEVELS-1最低）
     uint32_t priority_original;     // 原始优先级
     int exit_code;                  // 退出代码
     
@@ -120,13 +164,30 @@ typedef struct process_control_block {
     uint32_t time_started;          // 开始运行时间
     uint32_t time_terminated;       // 终止时间
     uint32_t time_used;             // 已使用CPU时间
-    uint32_t time_slice;            // 当前时间片长度
-    uint32_t time_slice_used;       // 当前时间片已使用时间
-    uint32_t vruntime;              // 虚拟运行时间（用于CFS）
-    uint32_t deadline;              // 截止时间（用于实时调度）
+    uint8_t demotions;              // 降级次数
+    uint8_t promotions;             // 升级次数
+    
+    /* === 实时调度 === */
+    rt_params_t rt;                 // EDF参数（仅PROCESS_FLAG_REALTIME进程有效）
+    pi_state_t pi;                  // 优先级继承
+    interactivity_t interactivity;  // 自适应MLFQ的交互性估计
+    struct process_group *group;    // 所属调度组，NULL表示未分组
+    
+    /* === 跟踪与CPU亲和 === */
+    uint32_t ready_since;           // 最近一次进入就绪状态的时刻
+    bool woken;                     // 这次就绪由唤醒引起（计入唤醒延迟）
+    uint8_t last_cpu;               // 最近一次运行的CPU，PCB_NO_CPU表示尚未运行
+    uint32_t last_ran;              // 最近一次被换出的时刻（估计缓存是否仍热）
+    
+    /* === 中断上下文唤醒 === */
+    struct process_control_block *wake_next; // 每CPU唤醒链表中的下一个
+    uint32_t wake_pending;          // 已在唤醒链表上（原子访问）
+    
+    /* === 延迟回收 === */
+    struct process_control_block *reap_next; // 回收链表中的下一个
     
     /* === CPU上下文 === */
-    cpu_context_t context;          // CPU寄存器上下文
+    cpu_context_t context;          // CPU寄存器上下文（仅上下文切换时访问）
     
     /* === 内存管理 === */
     uint32_t stack_base;            // 栈基址
@@ -135,19 +196,11 @@ typedef struct process_control_block {
     uint32_t heap_size;             // 堆大小
     uint32_t page_dir;              // 页目录地址
     
-    /* === 调度信息 === */
-    struct process_control_block *next;      // 链表指针
-    struct process_control_block *prev;      // 链表指针
+    /* === 进程关系 === */
     struct process_control_block *parent;    // 父进程指针
     struct process_control_block *children;  // 子进程链表头
     struct process_control_block *sibling;   // 兄弟进程指针
     
-    /* === MLFQ特定字段 === */
-    uint32_t time_in_queue;         // 在当前队列中的时间
-    uint8_t demotions;              // 降级次数
-    uint8_t promotions;             // 升级次数
-    uint8_t queue_level;            // 当前队列级别
-    
     /* === 统计信息 === */
     process_stats_t stats;          // 运行统计
     resource_usage_t resources;     // 资源使用
@@ -173,21 +226,41 @@ typedef struct process_control_block {
     
     /* === 扩展字段 === */
     void *private_data;             // 进程私有数据
-    uint32_t magic_number;          // 魔数，用于验证PCB完整性
-} pcb_t;
-
-/* 就绪队列节点 */
-typedef struct ready_queue_node {
-    pcb_t *pcb;
-    struct ready_queue_node *next;
-    struct ready_queue_node *prev;
-    uint32_t enqueue_time;          // 入队时间
-} ready_queue_node_t;
-
-/* 就绪队列结构 */
+} pcb_cold_t;
+
+/* 进程控制块（PCB）结构体
+ * 只保留调度路径上的热字段，恰好占一条缓存行并按缓存行对齐：
+ * 遍历就绪/等待队列时每个进程只触及一条缓存行，其余字段经cold指针访问 */
+typedef struct process_control_block {
+    /* === 队列链接 === */
+    struct process_control_block *next;      // 队列链表指针（就绪/等待/睡眠队列共用）
+    struct process_control_block *prev;      // 队列链表指针
+    void *queue;                             // 当前所在队列，不在任何队列中时为NULL
+    struct pcb_cold *cold;                   // 冷数据（由进程表为每个槽位绑定）
+    
+    /* === 调度状态 === */
+    uint32_t pid;                   // 进程ID
+    uint8_t state;                  // 进程状态（process_state_t）
+    uint8_t type;                   // 进程类型（process_type_t）
+    uint8_t priority;               // 当前优先级（0最高，MAX_PRIORITY_LEVELS-1最低）
+    uint8_t queue_level;            // 当前队列级别
+    uint16_t flags;                 // 进程标志（process_flags_t）
+    uint16_t magic_number;          // 魔数，用于验证PCB完整性
+    uint32_t vruntime;              // 虚拟运行时间（每个tick累加，唤醒抢占比较）
+    
+    /* === 时间片 === */
+    uint32_t time_slice;            // 当前时间片长度
+    uint32_t time_slice_used;       // 当前时间片已使用时间
+    uint32_t time_in_queue;         // 在当前MLFQ队列中的时间
+    uint32_t deadline;              // 截止时间（实时调度/睡眠唤醒时刻）
+} __attribute__((aligned(CACHE_LINE_SIZE))) pcb_t;
+
+_Static_assert(sizeof(pcb_t) == CACHE_LINE_SIZE, "pcb_t must stay one cache line");
+
+/* 就绪队列结构（侵入式：通过PCB自身的next/prev链接，入队出队无需分配） */
 typedef struct {
-    ready_queue_node_t *head;
-    ready_queue_node_t *tail;
+    pcb_t *head;
+    pcb_t *tail;
     uint32_t count;
     uint32_t time_slice;            // 该队列的时间片长度
     uint32_t max_count;             // 队列最大容量
@@ -210,6 +283,12 @@ typedef struct {
     uint32_t demotion_threshold;    // 降级阈值
     uint32_t promotion_threshold;   // 升级阈值
     uint32_t total_processes;       // 总进程数
+    
+    /* 自适应模式：时间片随交互性伸缩，只在低级别进程确实饥饿时提升 */
+    bool adaptive;
+    uint32_t last_low_run;          // 低级别（>0）进程最近一次运行或低级别队列为空的时刻
+    uint32_t boosts;                // 已执行的优先级提升次数
+    uint32_t interactive_wakeups;   // 交互型进程唤醒时直接回到0级的次数
 } mlfq_t;
 
 /* 调度统计 */
@@ -224,6 +303,7 @@ typedef struct {
     uint32_t avg_turnaround_time;
     uint32_t throughput;            // 吞吐量（进程/时间单位）
     uint32_t cpu_utilization;       // CPU利用率百分比
+    uint32_t wakeup_preemptions;    // 被唤醒的交互型进程立即抢占的次数
 } scheduler_stats_t;
 
 /* 调度器配置 */
@@ -235,23 +315,67 @@ typedef struct {
     uint32_t num_priority_levels;   // 优先级级别数
     uint32_t boost_interval;        // 优先级提升间隔
     uint32_t load_balance_interval; // 负载均衡间隔
+    uint32_t rt_util_limit;         // 实时进程利用率上限（千分比，0为默认值）
+    bool adaptive_mlfq;             // MLFQ按测得的交互性自适应调整时间片和提升时机
+    bool wakeup_preemption;         // 交互型进程唤醒时按should_preempt立即抢占
 } scheduler_config_t;
 
+/* 进程表位图：一级每位对应一个槽位，二级每位对应一个已满的一级字 */
+#define PROCESS_BITMAP_WORDS    (MAX_PROCESSES / 32)
+#define PROCESS_SUMMARY_WORDS   ((PROCESS_BITMAP_WORDS + 31) / 32)
+
+/* PID编码槽位与代数：pid = 代数 * MAX_PROCESSES + 槽位 + 1。
+ * 按PID查找直接定位槽位，再比较代数；槽位回收后代数加一，旧PID随之失效 */
+#define PID_SLOT(pid)           (((pid) - 1) % MAX_PROCESSES)
+#define PID_GENERATION(pid)     (((pid) - 1) / MAX_PROCESSES)
+#define PID_MAX_GENERATION      ((UINT32_MAX - MAX_PROCESSES) / MAX_PROCESSES)
+
 /* 进程表 */
 typedef struct {
     pcb_t processes[MAX_PROCESSES]; // 进程数组
-    uint32_t bitmap[MAX_PROCESSES / 32]; // 位图，用于快速查找空闲PCB
+    uint32_t bitmap[PROCESS_BITMAP_WORDS];      // 槽位占用位图
+    uint32_t full_map[PROCESS_SUMMARY_WORDS];   // 二级位图：bitmap对应字已满
+    uint32_t generation[MAX_PROCESSES];         // 槽位代数，每次回收加一
     uint32_t count;                 // 当前进程数
-    uint32_t next_pid;              // 下一个可用的PID
     pcb_t *idle_process;            // 空闲进程
 } process_table_t;
 
-/* 进程组信息 */
+/* 调度组统计 */
 typedef struct {
+    uint32_t runtime;               // 组内进程累计运行时间（tick）
+    uint32_t periods;               // 经过的带宽周期数
+    uint32_t throttled;             // 因用完配额被限流的次数
+    uint32_t throttled_time;        // 处于限流状态的总时间（tick）
+} group_stats_t;
+
+/* 进程组信息（同时作为调度组：按份额与兄弟组分CPU，可按周期限制带宽）
+ * 只有叶子组可以包含进程，未分组的进程整体作为一个实体与顶层组竞争 */
+typedef struct process_group {
     uint32_t pgid;                  // 进程组ID
     pcb_t *leader;                  // 进程组领导进程
     uint32_t member_count;          // 成员数量
     pcb_t *members[MAX_PROCESSES];  // 成员列表
+    
+    /* === 层级 === */
+    struct process_group *parent;   // 上级组，顶层组为NULL
+    struct process_group *children; // 第一个子组
+    struct process_group *sibling;  // 下一个兄弟组
+    
+    /* === 份额 === */
+    uint32_t shares;                // 与兄弟组的相对权重
+    uint32_t vtime_inc;             // 每运行一个tick虚拟时间的增量（GROUP_VTIME_SCALE / shares）
+    uint64_t vtime;                 // 加权虚拟运行时间，兄弟组中最小者先运行
+    ready_queue_t rq;               // 组内就绪进程（轮转）
+    
+    /* === 带宽限制 === */
+    uint32_t quota;                 // 每周期可运行的tick数，0表示不限制
+    uint32_t period;                // 周期长度（tick）
+    uint32_t period_start;          // 当前周期开始时刻
+    uint32_t period_used;           // 当前周期已运行的tick数
+    uint32_t throttle_start;        // 本次限流开始时刻
+    bool throttled;                 // 配额已用完，等待下一周期
+    
+    group_stats_t stats;
 } process_group_t;
 
 /* 会话信息 */
@@ -304,11 +428,13 @@ void pcb_remove_open_file(pcb_t *pcb, int fd);
 void pcb_add_child(pcb_t *parent, pcb_t *child);
 void pcb_remove_child(pcb_t *parent, pcb_t *child);
 void pcb_orphan_children(pcb_t *parent);
+void pcb_prune_children(pcb_t *parent);
 
 // 队列操作
 void ready_queue_init(ready_queue_t *queue, uint32_t max_count, 
                       uint32_t time_slice);
 void ready_queue_enqueue(ready_queue_t *queue, pcb_t *pcb);
+void ready_queue_enqueue_head(ready_queue_t *queue, pcb_t *pcb);
 pcb_t* ready_queue_dequeue(ready_queue_t *queue);
 pcb_t* ready_queue_peek(const ready_queue_t *queue);
 void ready_queue_remove(ready_queue_t *queue, pcb_t *pcb);
@@ -320,6 +446,8 @@ void ready_queue_clear(ready_queue_t *queue);
 void wait_queue_init(wait_queue_t *queue, uint32_t wait_reason);
 void wait_queue_enqueue(wait_queue_t *queue, pcb_t *pcb);
 pcb_t* wait_queue_dequeue(wait_queue_t *queue);
+void wait_queue_remove(wait_queue_t *queue, pcb_t *pcb);
+void wait_queue_enqueue_by_deadline(wait_queue_t *queue, pcb_t *pcb);
 void wait_queue_wake_all(wait_queue_t *queue);
 void wait_queue_wake_one(wait_queue_t *queue);
 
@@ -329,10 +457,21 @@ void mlfq_enqueue(mlfq_t *mlfq, pcb_t *pcb, uint8_t priority_level);
 pcb_t* mlfq_dequeue(mlfq_t *mlfq);
 void mlfq_adjust_priority(mlfq_t *mlfq, pcb_t *pcb, bool used_full_slice);
 void mlfq_boost_priorities(mlfq_t *mlfq, uint32_t current_time);
+bool mlfq_boost_due(const mlfq_t *mlfq, uint32_t current_time);
+bool mlfq_has_ready_above(const mlfq_t *mlfq, uint8_t level);
+void mlfq_note_tick(mlfq_t *mlfq, const pcb_t *current, uint32_t current_time);
+uint32_t mlfq_time_slice(const mlfq_t *mlfq, const pcb_t *pcb);
+
+// 交互性估计
+void interactivity_block(pcb_t *pcb, uint32_t now);
+void interactivity_wake(pcb_t *pcb, uint32_t now);
+void interactivity_tick(pcb_t *pcb);
 
 // 进程表管理
 void process_table_init(process_table_t *table);
 pcb_t* process_table_find(process_table_t *table, uint32_t pid);
+uint32_t process_table_slot(const process_table_t *table, const pcb_t *pcb);
+uint32_t process_table_make_pid(const process_table_t *table, const pcb_t *pcb);
 pcb_t* process_table_find_by_name(process_table_t *table, const char *name);
 pcb_t** process_table_get_all(process_table_t *table, uint32_t *count);
 uint32_t process_table_get_count(const process_table_t *table);
@@ -352,7 +491,7 @@ bool should_preempt(const pcb_t *current, const pcb_t *next);
 uint32_t get_scheduler_flags(const pcb_t *pcb);
 
 // 宏定义
-#define PCB_MAGIC 0x53504152  // "SPAR" in ASCII
+#define PCB_MAGIC 0x5350      // "SP" in ASCII
 
 #define PCB_SET_FLAG(pcb, flag) ((pcb)->flags |= (flag))
 #define PCB_CLEAR_FLAG(pcb, flag) ((pcb)->flags &= ~(flag))
@@ -363,8 +502,8 @@ uint32_t get_scheduler_flags(const pcb_t *pcb);
 #define PCB_IS_INTERACTIVE(pcb) PCB_HAS_FLAG(pcb, PROCESS_FLAG_INTERACTIVE)
 #define PCB_IS_REALTIME(pcb) PCB_HAS_FLAG(pcb, PROCESS_FLAG_REALTIME)
 
-#define PCB_LIFETIME(pcb) ((pcb)->time_terminated - (pcb)->time_created)
-#define PCB_RESPONSE_TIME(pcb) ((pcb)->time_started - (pcb)->time_created)
-#define PCB_TURNAROUND_TIME(pcb) ((pcb)->time_terminated - (pcb)->time_created)
+#define PCB_LIFETIME(pcb) ((pcb)->cold->time_terminated - (pcb)->cold->time_created)
+#define PCB_RESPONSE_TIME(pcb) ((pcb)->cold->time_started - (pcb)->cold->time_created)
+#define PCB_TURNAROUND_TIME(pcb) ((pcb)->cold->time_terminated - (pcb)->cold->time_created)
 
 #endif /* _SPARROW_PCB_H */
\ No newline at end of file
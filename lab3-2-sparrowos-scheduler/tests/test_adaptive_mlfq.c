@@ -0,0 +1,210 @@
+/**
+ * test_adaptive_mlfq.c - 自适应MLFQ测试程序
+ *
+ * 基于内核调度器核心与主机平台层（tools/sim_host.c）构建。每个进程按
+ * "运行run个tick后睡眠sleep个tick"循环（sleep为0即纯计算），每次
+ * sim_fire_irq(IRQ_TIMER) 后由当前进程执行一步。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "tools/sim_host.h"
+
+#define MAX_TASKS   12
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+typedef struct {
+    pcb_t *pcb;
+    uint32_t run;
+    uint32_t sleep;
+    uint32_t ran;           // 本次已运行的tick
+    uint32_t wake_at;       // 睡眠到期时刻
+    bool waiting;           // 已醒来、尚未重新运行
+    uint32_t max_latency;   // 醒来到重新运行的最长时间
+} task_t;
+
+static task_t tasks[MAX_TASKS];
+static int num_tasks;
+static uint32_t now;
+
+static void setup(bool adaptive, uint32_t boost_interval) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_MLFQ,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = boost_interval,
+        .load_balance_interval = 500,
+        .adaptive_mlfq = adaptive
+    };
+    scheduler_init(&config);
+    memset(tasks, 0, sizeof(tasks));
+    num_tasks = 0;
+    now = 0;
+}
+
+static task_t* spawn(const char *name, uint32_t run, uint32_t sleep) {
+    task_t *task = &tasks[num_tasks++];
+    task->pcb = scheduler_create_process(name, PROCESS_TYPE_USER, 0, PROCESS_FLAG_NONE);
+    task->run = run;
+    task->sleep = sleep;
+    return task;
+}
+
+static void run_ticks(uint32_t ticks) {
+    for (uint32_t t = 0; t < ticks; t++, now++) {
+        sim_fire_irq(IRQ_TIMER);
+
+        // 睡眠到期的进程开始计算唤醒延迟
+        for (int i = 0; i < num_tasks; i++) {
+            if (tasks[i].sleep && tasks[i].wake_at == now && !tasks[i].waiting &&
+                tasks[i].pcb->state != PROCESS_SLEEPING) {
+                tasks[i].waiting = true;
+            }
+        }
+
+        pcb_t *current = scheduler_get_current_process();
+        for (int i = 0; i < num_tasks; i++) {
+            task_t *task = &tasks[i];
+            if (task->pcb != current) {
+                continue;
+            }
+            if (task->waiting) {
+                task->waiting = false;
+                if (now - task->wake_at > task->max_latency) {
+                    task->max_latency = now - task->wake_at;
+                }
+            }
+            // 运行满run个tick（下一次时钟中断时已记账）后睡眠
+            if (!task->sleep) {
+                continue;
+            }
+            if (task->ran < task->run) {
+                task->ran++;
+                continue;
+            }
+            task->ran = 0;
+            task->wake_at = now + task->sleep + 1;
+            scheduler_sleep_process(task->sleep);
+        }
+    }
+}
+
+/* 测试1: 睡眠占比的EWMA区分交互型与批处理型，批处理型获得更长时间片 */
+void test_classification(void) {
+    print_test_header("Interactivity EWMA and Slice Stretching");
+    setup(true, 1000);
+
+    task_t *editor = spawn("editor", 1, 9);
+    task_t *batch = spawn("batch", 0, 0);
+    scheduler_schedule();
+    run_ticks(500);
+
+    uint32_t ia_editor = editor->pcb->cold->interactivity.sleep_avg;
+    uint32_t ia_batch = batch->pcb->cold->interactivity.sleep_avg;
+    printf("editor: sleep_avg %u/%u, sleep_time %u, user_time %u\n", ia_editor,
+           INTERACTIVITY_SCALE, editor->pcb->cold->stats.sleep_time,
+           editor->pcb->cold->stats.user_time);
+    printf("batch:  sleep_avg %u/%u, level %u, slice %u\n", ia_batch, INTERACTIVITY_SCALE,
+           batch->pcb->queue_level, batch->pcb->time_slice);
+
+    int passed = ia_editor >= INTERACTIVE_THRESHOLD && ia_batch < INTERACTIVITY_SCALE / 16;
+    passed &= editor->pcb->cold->stats.sleep_time > 0 && editor->pcb->cold->stats.user_time > 0;
+    // 批处理型的时间片接近本级别的 MLFQ_MAX_STRETCH 倍
+    uint32_t base = calculate_time_slice(batch->pcb->queue_level, 10);
+    passed &= batch->pcb->time_slice > base * (MLFQ_MAX_STRETCH - 1);
+    print_test_result("Sleep ratio separates task classes", passed);
+}
+
+/* 测试2: 交互型进程的唤醒延迟不受批处理型长时间片影响 */
+static uint32_t wakeup_latency(bool adaptive) {
+    setup(adaptive, 1000);
+
+    task_t *editor = spawn("editor", 1, 15);
+    for (int i = 0; i < 3; i++) {
+        spawn("batch", 0, 0);
+    }
+    scheduler_schedule();
+    run_ticks(200);                 // 热身：完成分类和降级
+    editor->max_latency = 0;
+    run_ticks(2000);
+
+    scheduler_stats_t stats = scheduler_get_stats();
+    printf("  %s: editor max wakeup latency %u ticks, %u context switches\n",
+           adaptive ? "adaptive" : "static  ", editor->max_latency, stats.context_switches);
+    return editor->max_latency;
+}
+
+void test_wakeup_latency(void) {
+    print_test_header("Interactive Wakeup Latency Under Batch Load");
+
+    uint32_t fixed = wakeup_latency(false);
+    uint32_t adaptive = wakeup_latency(true);
+    print_test_result("Interactive task runs within one tick of waking",
+                      adaptive <= 1 && adaptive < fixed);
+}
+
+/* 测试3: 自适应模式只在低级别进程饥饿时提升 */
+/* 两个批处理型进程被提升的总次数 */
+static uint32_t batch_promotions(bool adaptive, int interactive) {
+    setup(adaptive, 100);
+
+    task_t *batch = spawn("batch", 0, 0);
+    spawn("batch", 0, 0);
+    for (int i = 0; i < interactive; i++) {
+        spawn("shell", 1, 5);
+    }
+    scheduler_schedule();
+    run_ticks(2000);
+    return batch->pcb->cold->promotions + tasks[1].pcb->cold->promotions;
+}
+
+void test_boost_on_starvation(void) {
+    print_test_header("Priority Boost Only When Starving");
+
+    // 只有批处理型进程：没有饥饿，自适应模式不需要提升
+    uint32_t fixed_idle = batch_promotions(false, 0);
+    uint32_t adaptive_idle = batch_promotions(true, 0);
+    // 8个交互型进程（各占约1/6 CPU）占满0级，批处理型进程只能靠提升运行
+    uint32_t adaptive_starved = batch_promotions(true, 8);
+    printf("Batch promotions: static %u, adaptive %u, adaptive+starved %u\n",
+           fixed_idle, adaptive_idle, adaptive_starved);
+
+    int passed = fixed_idle >= 15 && adaptive_idle == 0 && adaptive_starved > 0;
+    print_test_result("Boost timing follows measured starvation", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Adaptive MLFQ Test Suite\n");
+    printf("================================\n");
+
+    test_classification();
+    test_wakeup_latency();
+    test_boost_on_starvation();
+
+    printf("\n================================\n");
+    printf("Adaptive MLFQ Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
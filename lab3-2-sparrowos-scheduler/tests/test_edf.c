@@ -0,0 +1,209 @@
+/**
+ * test_edf.c - EDF实时调度类测试程序
+ *
+ * 基于内核调度器核心与主机平台层（tools/sim_host.c）构建，
+ * 每次 sim_fire_irq(IRQ_TIMER) 推进一个tick，当前进程即视为在该tick内运行。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+static uint32_t job_used[MAX_PROCESSES];    // 上一个作业完成时进程的time_used
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static void setup(uint32_t type, uint32_t rt_util_limit) {
+    sim_host_reset();
+    memset(job_used, 0, sizeof(job_used));
+
+    scheduler_config_t config = {
+        .scheduler_type = type,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500,
+        .rt_util_limit = rt_util_limit
+    };
+    scheduler_init(&config);
+}
+
+/* 推进ticks个tick：当前实时进程执行满work[pid]个tick后报告作业完成 */
+static void run_ticks(uint32_t ticks, const uint32_t *work) {
+    for (uint32_t t = 0; t < ticks; t++) {
+        sim_fire_irq(IRQ_TIMER);
+
+        pcb_t *current = scheduler_get_current_process();
+        if (current && PCB_IS_REALTIME(current) &&
+            current->cold->time_used - job_used[current->pid] >= work[current->pid]) {
+            job_used[current->pid] = current->cold->time_used;
+            scheduler_rt_job_done();
+        }
+    }
+}
+
+/* 测试1: 接纳控制 */
+void test_admission(void) {
+    print_test_header("EDF Admission Control");
+    setup(SCHEDULER_RR, 0);
+
+    pcb_t *p[4];
+    for (int i = 0; i < 4; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "rt%d", i);
+        p[i] = scheduler_create_process(name, PROCESS_TYPE_USER, 1, PROCESS_FLAG_REALTIME);
+    }
+
+    int passed = !PCB_IS_REALTIME(p[0]);                            // 标志不能绕过接纳控制
+    passed &= scheduler_set_realtime(p[0]->pid, 5, 10, 20) == -1;   // deadline > period
+    passed &= scheduler_set_realtime(p[0]->pid, 5, 10, 4) == -1;    // runtime > deadline
+    passed &= scheduler_set_realtime(p[0]->pid, 3, 10, 0) == 0;     // 30%
+    passed &= scheduler_set_realtime(p[1]->pid, 3, 10, 0) == 0;     // 60%
+    passed &= scheduler_set_realtime(p[2]->pid, 3, 10, 0) == 0;     // 90%，达到默认上限
+    passed &= scheduler_set_realtime(p[3]->pid, 1, 10, 0) == -1;    // 超限被拒
+
+    // 修改参数失败时保留原带宽
+    passed &= scheduler_set_realtime(p[2]->pid, 5, 10, 0) == -1;
+    passed &= PCB_IS_REALTIME(p[2]) && p[2]->cold->rt.runtime == 3;
+
+    // 退出的实时进程归还带宽
+    scheduler_terminate_process(p[0]->pid, 0);
+    passed &= scheduler_set_realtime(p[3]->pid, 1, 10, 0) == 0;
+
+    rt_stats_t stats = scheduler_get_rt_stats();
+    printf("Admitted=%u Rejected=%u\n", stats.admitted, stats.rejected);
+    passed &= stats.admitted == 4 && stats.rejected == 2;
+    print_test_result("Utilization-based admission", passed);
+}
+
+/* 测试2: 实时进程严格优先，且按截止时间排序 */
+void test_precedence(void) {
+    print_test_header("EDF Strict Precedence");
+    setup(SCHEDULER_MLFQ, 0);
+
+    pcb_t *bg = scheduler_create_process("bg", PROCESS_TYPE_USER, 0, PROCESS_FLAG_CPU_BOUND);
+    pcb_t *late = scheduler_create_process("late", PROCESS_TYPE_USER, 7, PROCESS_FLAG_NONE);
+    pcb_t *early = scheduler_create_process("early", PROCESS_TYPE_USER, 7, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+    int passed = scheduler_get_current_process() == bg;
+
+    scheduler_set_realtime(late->pid, 2, 50, 0);
+    scheduler_set_realtime(early->pid, 2, 20, 0);
+
+    // 实时进程就绪后的下一个tick立即抢占后台进程
+    uint32_t work[MAX_PROCESSES] = {0};
+    work[late->pid] = 2;
+    work[early->pid] = 2;
+    run_ticks(1, work);
+    passed &= scheduler_get_current_process() == early;
+    run_ticks(2, work);
+    passed &= scheduler_get_current_process() == late;
+    run_ticks(2, work);
+    passed &= scheduler_get_current_process() == bg;
+
+    rt_stats_t stats = scheduler_get_rt_stats();
+    printf("Jobs=%u Preemptions=%u\n", stats.jobs, stats.preemptions);
+    passed &= stats.jobs == 2 && stats.preemptions >= 1;
+    print_test_result("Earliest deadline runs before MLFQ", passed);
+}
+
+/* 测试3: 后台负载下周期性控制任务满足截止时间 */
+void test_periodic_under_load(void) {
+    print_test_header("Periodic Tasks Under Background Load");
+    setup(SCHEDULER_MLFQ, 0);
+
+    for (int i = 0; i < 4; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "bg%d", i);
+        scheduler_create_process(name, PROCESS_TYPE_USER, 0, PROCESS_FLAG_CPU_BOUND);
+    }
+    pcb_t *control = scheduler_create_process("control", PROCESS_TYPE_USER, 3, PROCESS_FLAG_NONE);
+    pcb_t *data = scheduler_create_process("data", PROCESS_TYPE_USER, 3, PROCESS_FLAG_NONE);
+    pcb_t *monitor = scheduler_create_process("monitor", PROCESS_TYPE_USER, 3, PROCESS_FLAG_NONE);
+
+    // 总利用率 0.2 + 0.2 + 0.2 = 60%
+    int passed = scheduler_set_realtime(control->pid, 2, 10, 0) == 0;
+    passed &= scheduler_set_realtime(data->pid, 3, 15, 0) == 0;
+    passed &= scheduler_set_realtime(monitor->pid, 4, 20, 0) == 0;
+
+    uint32_t work[MAX_PROCESSES] = {0};
+    work[control->pid] = 2;
+    work[data->pid] = 3;
+    work[monitor->pid] = 4;
+    scheduler_schedule();
+    run_ticks(1200, work);
+
+    rt_stats_t stats = scheduler_get_rt_stats();
+    printf("control: %u jobs, %u misses, max response %u\n", control->cold->rt.jobs,
+           control->cold->rt.deadline_misses, control->cold->rt.max_response);
+    printf("data:    %u jobs, %u misses, max response %u\n", data->cold->rt.jobs,
+           data->cold->rt.deadline_misses, data->cold->rt.max_response);
+    printf("monitor: %u jobs, %u misses, max response %u\n", monitor->cold->rt.jobs,
+           monitor->cold->rt.deadline_misses, monitor->cold->rt.max_response);
+
+    passed &= stats.deadline_misses == 0;
+    passed &= control->cold->rt.jobs >= 119 && data->cold->rt.jobs >= 79 &&
+              monitor->cold->rt.jobs >= 59;
+    passed &= control->cold->rt.max_response <= 10;
+
+    // 剩余40%的CPU仍留给后台进程
+    scheduler_stats_t sched = scheduler_get_stats();
+    printf("CPU utilization: %u%%\n", sched.cpu_utilization);
+    scheduler_print_status();
+    print_test_result("No deadline misses at 60% RT load", passed);
+}
+
+/* 测试4: 作业超出声明的执行时间会被记为错过截止时间 */
+void test_overrun_counted(void) {
+    print_test_header("Deadline Miss Accounting");
+    setup(SCHEDULER_RR, 0);
+
+    scheduler_create_process("bg", PROCESS_TYPE_USER, 1, PROCESS_FLAG_CPU_BOUND);
+    pcb_t *rt = scheduler_create_process("overrun", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    int passed = scheduler_set_realtime(rt->pid, 2, 10, 5) == 0;
+
+    // 声明2个tick，实际每个作业执行6个tick
+    uint32_t work[MAX_PROCESSES] = {0};
+    work[rt->pid] = 6;
+    scheduler_schedule();
+    run_ticks(100, work);
+
+    rt_stats_t stats = scheduler_get_rt_stats();
+    printf("Jobs=%u Misses=%u\n", stats.jobs, stats.deadline_misses);
+    passed &= stats.jobs > 0 && stats.deadline_misses == stats.jobs;
+    passed &= stats.response_hist.buckets[3] == stats.jobs;     // 响应时间6落在[4, 8)
+    print_test_result("Overruns reported as misses", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("EDF Real-time Scheduling Test Suite\n");
+    printf("================================\n");
+
+    test_admission();
+    test_precedence();
+    test_periodic_under_load();
+    test_overrun_counted();
+
+    printf("\n================================\n");
+    printf("EDF Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
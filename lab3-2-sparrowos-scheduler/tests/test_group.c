@@ -0,0 +1,334 @@
+/**
+ * test_group.c - 调度组测试程序
+ *
+ * 基于内核调度器核心与主机平台层（tools/sim_host.c）构建。进程按
+ * "运行run个tick后睡眠sleep个tick"循环（sleep为0即纯计算），每次
+ * sim_fire_irq(IRQ_TIMER) 后由当前进程执行一步；各组的CPU份额取自
+ * scheduler_group_get_stats() 的运行时间记账。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/group.h"
+#include "tools/sim_host.h"
+
+#define MAX_TASKS   12
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+typedef struct {
+    pcb_t *pcb;
+    uint32_t run;
+    uint32_t sleep;
+    uint32_t ran;           // 本次已运行的tick
+    uint32_t wake_at;       // 睡眠到期时刻
+    bool waiting;           // 已醒来、尚未重新运行
+    uint32_t max_latency;   // 醒来到重新运行的最长时间
+} task_t;
+
+static task_t tasks[MAX_TASKS];
+static int num_tasks;
+static uint32_t now;
+
+static void setup(void) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+    memset(tasks, 0, sizeof(tasks));
+    num_tasks = 0;
+    now = 0;
+}
+
+/* 创建进程并放入pgid组（0表示不分组） */
+static task_t* spawn(const char *name, uint32_t pgid, uint32_t run, uint32_t sleep) {
+    task_t *task = &tasks[num_tasks++];
+    task->pcb = scheduler_create_process(name, PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    task->run = run;
+    task->sleep = sleep;
+    if (pgid) {
+        scheduler_group_attach(task->pcb->pid, pgid);
+    }
+    return task;
+}
+
+static void run_ticks(uint32_t ticks) {
+    for (uint32_t t = 0; t < ticks; t++, now++) {
+        sim_fire_irq(IRQ_TIMER);
+
+        // 睡眠到期的进程开始计算唤醒延迟
+        for (int i = 0; i < num_tasks; i++) {
+            if (tasks[i].sleep && tasks[i].wake_at == now && !tasks[i].waiting &&
+                tasks[i].pcb->state != PROCESS_SLEEPING) {
+                tasks[i].waiting = true;
+            }
+        }
+
+        pcb_t *current = scheduler_get_current_process();
+        for (int i = 0; i < num_tasks; i++) {
+            task_t *task = &tasks[i];
+            if (task->pcb != current) {
+                continue;
+            }
+            if (task->waiting) {
+                task->waiting = false;
+                if (now - task->wake_at > task->max_latency) {
+                    task->max_latency = now - task->wake_at;
+                }
+            }
+            if (!task->sleep) {
+                continue;
+            }
+            if (task->ran < task->run) {
+                task->ran++;
+                continue;
+            }
+            task->ran = 0;
+            task->wake_at = now + task->sleep + 1;
+            scheduler_sleep_process(task->sleep);
+        }
+    }
+}
+
+static uint32_t runtime_of(uint32_t pgid) {
+    group_stats_t stats;
+    return scheduler_group_get_stats(pgid, &stats) == 0 ? stats.runtime : 0;
+}
+
+/* 实际份额（千分比）是否在期望值的±tol内 */
+static int share_near(uint32_t runtime, uint32_t total, uint32_t expect, uint32_t tol) {
+    uint32_t permille = runtime * 1000 / total;
+    return permille + tol >= expect && permille <= expect + tol;
+}
+
+/* 测试1: 兄弟组按份额比例分CPU，与组内进程数无关 */
+void test_shares(void) {
+    print_test_header("Sibling Groups Split CPU by Shares");
+    setup();
+
+    int a = scheduler_group_create(0, 2048);
+    int b = scheduler_group_create(0, 1024);
+    spawn("a0", a, 0, 0);
+    spawn("b0", b, 0, 0);
+    spawn("b1", b, 0, 0);
+    spawn("b2", b, 0, 0);
+    scheduler_schedule();
+    run_ticks(3000);
+
+    uint32_t ra = runtime_of(a);
+    uint32_t rb = runtime_of(b);
+    printf("a (2048, 1 task): %u ticks, b (1024, 3 tasks): %u ticks\n", ra, rb);
+    int passed = share_near(ra, ra + rb, 667, 10) && share_near(rb, ra + rb, 333, 10);
+
+    // 运行中调整份额：此后两组各占一半
+    scheduler_group_set_shares(a, 1024);
+    run_ticks(2000);
+    uint32_t da = runtime_of(a) - ra;
+    uint32_t db = runtime_of(b) - rb;
+    printf("after set_shares(a, 1024): a %u ticks, b %u ticks\n", da, db);
+    passed &= share_near(da, da + db, 500, 10);
+    print_test_result("2:1 shares give 2:1 runtime", passed);
+}
+
+/* 测试2: 层级份额：子组在父组分得的份额内再按比例分 */
+void test_hierarchy(void) {
+    print_test_header("Hierarchical Shares");
+    setup();
+
+    int p = scheduler_group_create(0, 1024);
+    int q = scheduler_group_create(0, 1024);
+    int c1 = scheduler_group_create(p, 256);
+    int c2 = scheduler_group_create(p, 768);
+    spawn("c1", c1, 0, 0);
+    spawn("c2", c2, 0, 0);
+    spawn("q0", q, 0, 0);
+    spawn("q1", q, 0, 0);
+    scheduler_schedule();
+    run_ticks(4000);
+
+    uint32_t total = runtime_of(p) + runtime_of(q);
+    printf("p %u, c1 %u, c2 %u, q %u (of %u ticks)\n", runtime_of(p), runtime_of(c1),
+           runtime_of(c2), runtime_of(q), total);
+    int passed = share_near(runtime_of(p), total, 500, 10);
+    passed &= share_near(runtime_of(q), total, 500, 10);
+    passed &= share_near(runtime_of(c1), total, 125, 10);
+    passed &= share_near(runtime_of(c2), total, 375, 10);
+    // 父组的运行时间是子组之和
+    passed &= runtime_of(p) == runtime_of(c1) + runtime_of(c2);
+    print_test_result("50% / 12.5% / 37.5% split", passed);
+}
+
+/* 测试3: 配额用完后组被限流到周期结束 */
+void test_bandwidth(void) {
+    print_test_header("Quota/Period Throttling");
+    setup();
+
+    int limited = scheduler_group_create(0, 0);
+    spawn("hog0", limited, 0, 0);
+    spawn("hog1", limited, 0, 0);
+    spawn("free", 0, 0, 0);
+    scheduler_group_set_bandwidth(limited, 20, 100);
+    scheduler_schedule();
+    run_ticks(1000);
+
+    group_stats_t stats;
+    scheduler_group_get_stats(limited, &stats);
+    uint32_t root = runtime_of(0);
+    printf("limited: runtime %u, periods %u, throttled %u times for %u ticks; root %u\n",
+           stats.runtime, stats.periods, stats.throttled, stats.throttled_time, root);
+    // 每100个tick最多20个tick
+    int passed = stats.runtime >= 190 && stats.runtime <= 210;
+    passed &= stats.periods >= 9 && stats.throttled >= 9;
+    passed &= stats.throttled_time >= 700;
+    passed &= root >= 780;
+
+    // 没有其他进程时，被限流的组让CPU空闲，而不是超出配额
+    setup();
+    limited = scheduler_group_create(0, 0);
+    spawn("alone", limited, 0, 0);
+    scheduler_group_set_bandwidth(limited, 30, 100);
+    scheduler_schedule();
+    run_ticks(1000);
+    scheduler_group_get_stats(limited, &stats);
+    scheduler_stats_t sched = scheduler_get_stats();
+    printf("alone: runtime %u, CPU utilization %u%%\n", stats.runtime, sched.cpu_utilization);
+    passed &= stats.runtime >= 290 && stats.runtime <= 310;
+    print_test_result("20/100 quota caps the group at 20%", passed);
+}
+
+/* 测试4: 嘈杂的批处理组不会拖慢交互组的唤醒 */
+static uint32_t editor_latency(bool grouped, uint32_t *editor_runtime) {
+    setup();
+
+    int batch = grouped ? scheduler_group_create(0, 0) : 0;
+    int ui = grouped ? scheduler_group_create(0, 0) : 0;
+    task_t *editor = spawn("editor", ui, 1, 9);
+    for (int i = 0; i < 8; i++) {
+        spawn("batch", batch, 0, 0);
+    }
+    scheduler_schedule();
+    run_ticks(3000);
+
+    *editor_runtime = editor->pcb->cold->stats.user_time;
+    printf("  %s: editor max wakeup latency %u ticks, ran %u ticks\n",
+           grouped ? "grouped  " : "ungrouped", editor->max_latency, *editor_runtime);
+    return editor->max_latency;
+}
+
+void test_noisy_neighbor(void) {
+    print_test_header("Interactive Group Next to a Noisy Batch Group");
+
+    uint32_t flat_runtime, grouped_runtime;
+    uint32_t flat = editor_latency(false, &flat_runtime);
+    uint32_t grouped = editor_latency(true, &grouped_runtime);
+    int passed = grouped <= 1 && grouped < flat && grouped_runtime >= flat_runtime;
+    print_test_result("Woken interactive group preempts the batch group", passed);
+}
+
+/* 测试5: 未分组的进程整体作为一个实体与顶层组竞争 */
+void test_root_entity(void) {
+    print_test_header("Ungrouped Tasks Compete as One Entity");
+    setup();
+
+    int g = scheduler_group_create(0, 0);
+    spawn("r0", 0, 0, 0);
+    spawn("r1", 0, 0, 0);
+    spawn("r2", 0, 0, 0);
+    spawn("g0", g, 0, 0);
+    scheduler_schedule();
+    run_ticks(2000);
+
+    uint32_t root = runtime_of(0);
+    uint32_t group = runtime_of(g);
+    printf("root (3 tasks): %u ticks, group (1 task): %u ticks\n", root, group);
+    int passed = share_near(group, root + group, 500, 10);
+
+    // 移回根后组变空，可以删除
+    passed &= scheduler_group_attach(tasks[3].pcb->pid, 0) == 0;
+    passed &= tasks[3].pcb->cold->group == NULL;
+    passed &= scheduler_group_destroy(g) == 0;
+    uint32_t before = tasks[3].pcb->cold->stats.user_time;
+    run_ticks(400);
+    passed &= tasks[3].pcb->cold->stats.user_time > before;
+    print_test_result("Root and group split 50/50", passed);
+}
+
+/* 测试6: 参数检查与限制 */
+void test_api_errors(void) {
+    print_test_header("Group API Error Handling");
+    setup();
+
+    int passed = scheduler_group_create(99, 0) == -1;                 // 父组不存在
+    passed &= scheduler_group_create(0, 1) == -1;                     // 份额过小
+    int leaf = scheduler_group_create(0, 0);
+    task_t *task = spawn("t", leaf, 0, 0);
+    passed &= task->pcb->cold->group != NULL;
+    passed &= scheduler_group_create(leaf, 0) == -1;                  // 有成员的组不能有子组
+    passed &= scheduler_group_destroy(leaf) == -1;                    // 有成员不能删除
+
+    int parent = scheduler_group_create(0, 0);
+    int child = scheduler_group_create(parent, 0);
+    passed &= child > 0;
+    passed &= scheduler_group_attach(task->pcb->pid, parent) == -1;   // 只有叶子组可以包含进程
+    passed &= scheduler_group_destroy(parent) == -1;                  // 有子组不能删除
+    passed &= scheduler_group_attach(task->pcb->pid, 99) == -1;
+    passed &= scheduler_group_set_shares(leaf, GROUP_MAX_SHARES + 1) == -1;
+    passed &= scheduler_group_set_bandwidth(99, 10, 100) == -1;
+
+    group_stats_t stats;
+    passed &= scheduler_group_get_stats(99, &stats) == -1;
+
+    // 组数达到上限
+    int created = 3;
+    while (scheduler_group_create(0, 0) > 0) {
+        created++;
+    }
+    passed &= created == SCHED_MAX_GROUPS;
+
+    // 进程退出时离开所在组
+    scheduler_terminate_process(task->pcb->pid, 0);
+    passed &= scheduler_group_destroy(leaf) == 0;
+    print_test_result("Invalid requests rejected", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Scheduling Group Test Suite\n");
+    printf("================================\n");
+
+    test_shares();
+    test_hierarchy();
+    test_bandwidth();
+    test_noisy_neighbor();
+    test_root_entity();
+    test_api_errors();
+
+    printf("\n================================\n");
+    printf("Group Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * test_idle.c - 空闲状态调控器测试程序
+ *
+ * 检查 kernel/core/idle.c：历史空闲时长的典型值估计（含剔除离群值）、
+ * 按预测与下一个定时器在轮询和hlt之间的选择、空闲期内多次进出状态时
+ * 的驻留与唤醒延迟统计，以及调度器的配置与查询接口。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/idle.h"
+#include "tools/sim_host.h"
+
+#define THRESHOLD   20000
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static void init_governor(idle_governor_t *gov) {
+    idle_config_t config = {
+        .poll_threshold = THRESHOLD,
+        .poll_limit = THRESHOLD,
+        .cycles_per_tick = 1000000
+    };
+    idle_governor_init(gov, &config);
+}
+
+/* 模拟一个从now开始、持续duration后由中断带来工作的空闲期 */
+static uint64_t idle_period(idle_governor_t *gov, uint64_t now, uint64_t duration) {
+    idle_governor_select(gov, now, IDLE_NO_EVENT);
+    idle_governor_note_wakeup(gov, now + duration);
+    idle_governor_exit(gov, now + duration, true);
+    return now + duration;
+}
+
+/* 测试1: 典型时长估计 */
+void test_typical(void) {
+    print_test_header("Typical Interval");
+    idle_governor_t gov;
+    init_governor(&gov);
+    int passed = idle_governor_typical(&gov) == IDLE_NO_EVENT;
+
+    // 稳定的5000周期左右
+    static const uint32_t steady[8] = { 4800, 5100, 5000, 4900, 5200, 5000, 4950, 5050 };
+    uint64_t now = 1000;
+    for (int i = 0; i < 8; i++) {
+        now = idle_period(&gov, now, steady[i]) + 100;
+    }
+    uint64_t typical = idle_governor_typical(&gov);
+    printf("Steady history -> typical %llu\n", (unsigned long long)typical);
+    passed &= typical >= 4900 && typical <= 5100;
+    print_test_result("Steady history predicts its mean", passed);
+
+    // 一个离群值被剔除
+    init_governor(&gov);
+    static const uint32_t outlier[8] = { 50000, 51000, 49000, 50500, 900000, 49500, 50000, 50200 };
+    for (int i = 0; i < 8; i++) {
+        now = idle_period(&gov, now, outlier[i]) + 100;
+    }
+    typical = idle_governor_typical(&gov);
+    printf("History with one outlier -> typical %llu\n", (unsigned long long)typical);
+    print_test_result("Single outlier is discarded", typical >= 49000 && typical <= 51000);
+
+    // 毫无规律
+    init_governor(&gov);
+    static const uint32_t scattered[8] = { 1000, 400000, 30000, 900000, 5000, 200000, 70000, 600000 };
+    for (int i = 0; i < 8; i++) {
+        now = idle_period(&gov, now, scattered[i]) + 100;
+    }
+    typical = idle_governor_typical(&gov);
+    print_test_result("Scattered history gives no prediction", typical == IDLE_NO_EVENT);
+}
+
+/* 测试2: 状态选择 */
+void test_select(void) {
+    print_test_header("State Selection");
+    idle_governor_t gov;
+    init_governor(&gov);
+
+    // 没有历史也没有定时器：hlt；定时器很近：轮询
+    int passed = idle_governor_select(&gov, 1000, IDLE_NO_EVENT) == IDLE_HALT;
+    idle_governor_exit(&gov, 1500, true);
+    passed &= idle_governor_select(&gov, 2000, 2000 + THRESHOLD / 2) == IDLE_POLL;
+    idle_governor_exit(&gov, 2000 + THRESHOLD / 2, true);
+    print_test_result("Near timer polls, unknown gap halts", passed);
+
+    // 稳定的短空闲期：轮询；长空闲期：hlt
+    init_governor(&gov);
+    uint64_t now = 1000;
+    for (int i = 0; i < 8; i++) {
+        now = idle_period(&gov, now, 3000) + 100;
+    }
+    passed = idle_governor_select(&gov, now, IDLE_NO_EVENT) == IDLE_POLL;
+    // 轮询到预测时长之后仍没有工作：这次不符合规律，改为hlt
+    idle_governor_exit(&gov, now + THRESHOLD, false);
+    passed &= idle_governor_select(&gov, now + THRESHOLD, IDLE_NO_EVENT) == IDLE_HALT;
+    idle_governor_exit(&gov, now + 5 * THRESHOLD, true);
+    print_test_result("Short history polls, overrun falls back to halt", passed);
+
+    init_governor(&gov);
+    for (int i = 0; i < 8; i++) {
+        now = idle_period(&gov, now, 10 * THRESHOLD) + 100;
+    }
+    passed = idle_governor_select(&gov, now, IDLE_NO_EVENT) == IDLE_HALT;
+    // 定时器比历史更早到期时以定时器为准
+    idle_governor_exit(&gov, now + 100, false);
+    passed &= idle_governor_select(&gov, now + 100, now + 200) == IDLE_POLL;
+    idle_governor_exit(&gov, now + 200, true);
+    print_test_result("Long history halts unless a timer is due", passed);
+}
+
+/* 测试3: 驻留与唤醒延迟统计 */
+void test_stats(void) {
+    print_test_header("Residency and Wake Latency");
+    idle_governor_t gov;
+    init_governor(&gov);
+
+    // 一个空闲期：hlt 1000周期被无关中断唤醒，再hlt，500周期后唤醒事件到达，300周期后发现
+    idle_governor_select(&gov, 10000, IDLE_NO_EVENT);
+    idle_governor_exit(&gov, 11000, false);
+    idle_governor_select(&gov, 11000, IDLE_NO_EVENT);
+    idle_governor_note_wakeup(&gov, 11500);
+    idle_governor_note_wakeup(&gov, 11600);         // 只保留第一个
+    idle_governor_exit(&gov, 11800, true);
+    idle_governor_exit(&gov, 12000, true);          // 已不在状态中：忽略
+
+    const idle_state_stats_t *halt = &gov.stats.states[IDLE_HALT];
+    int passed = halt->entries == 2 && halt->residency == 1800 && halt->wakeups == 1;
+    passed &= halt->latency_sum == 300 && halt->latency_max == 300;
+    passed &= gov.stats.periods == 1 && gov.nr_history == 1 && gov.history[0] == 1500;
+    passed &= !gov.in_period && gov.wake_stamp == 0;
+    printf("halt: %u entries, %llu residency, latency %llu; history[0] = %u\n",
+           halt->entries, (unsigned long long)halt->residency,
+           (unsigned long long)halt->latency_sum, gov.history[0]);
+    print_test_result("Period spans several entries, latency from first wake stamp", passed);
+
+    // 空闲期外的唤醒不记录
+    idle_governor_note_wakeup(&gov, 13000);
+    print_test_result("Wake outside a period is ignored", gov.wake_stamp == 0);
+}
+
+/* 测试4: 调度器接口 */
+void test_scheduler_interface(void) {
+    print_test_header("Scheduler Interface");
+    sim_host_reset();
+    scheduler_init(NULL);
+
+    idle_stats_t stats;
+    int passed = scheduler_get_idle_stats(0, &stats) == 0 && stats.periods == 0;
+    passed &= scheduler_get_idle_stats(MAX_CPUS, &stats) == -1;
+
+    idle_config_t config = { .poll_threshold = 5000, .poll_limit = 0, .cycles_per_tick = 0 };
+    scheduler_set_idle_config(&config);
+    passed &= scheduler_get_idle_stats(MAX_CPUS - 1, &stats) == 0;
+
+    // 主机上空闲进程从不运行：中断唤醒与时钟tick不会开始空闲期
+    pcb_t *pcb = scheduler_create_process("sleeper", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_wakeup_from_irq(pcb);
+    for (int i = 0; i < 5; i++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    scheduler_get_idle_stats(0, &stats);
+    passed &= stats.periods == 0 && stats.states[IDLE_HALT].entries == 0;
+    print_test_result("Stats query, per-CPU config and no spurious periods", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Idle Governor Test Suite\n");
+    printf("================================\n");
+
+    test_typical();
+    test_select();
+    test_stats();
+    test_scheduler_interface();
+
+    printf("\n================================\n");
+    printf("Idle Governor Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * test_kstack_pool.c - 内核栈池与批量创建测试程序
+ *
+ * 前半部分直接操作 kstack_pool_t，检查干净/脏栈的分配、释放与清零；
+ * 后半部分基于内核调度器核心与主机平台层（tools/sim_host.c），检查
+ * scheduler_create_processes() 的批量创建、全有或全无语义，以及回收的
+ * 栈在CPU空闲时被清零后复用。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/kstack.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static bool stack_is_zero(uint32_t base) {
+    const uint8_t *p = kstack_ptr(base);
+    for (uint32_t i = 0; i < STACK_SIZE; i++) {
+        if (p[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void setup(void) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+}
+
+static kstack_pool_t pool;
+
+/* 测试1: 分配总是得到清零的栈，释放的栈在refill时清零 */
+void test_pool(void) {
+    print_test_header("Clean and Dirty Stack Lists");
+
+    kstack_pool_init(&pool);
+    int passed = pool.nr_clean == KSTACK_BOOT_CLEAN &&
+                 pool.nr_dirty == KSTACK_COUNT - KSTACK_BOOT_CLEAN;
+
+    uint32_t a = kstack_alloc(&pool);
+    passed &= a >= KSTACK_REGION_BASE && stack_is_zero(a);
+    passed &= pool.stats.clean_hits == 1;
+
+    // 用过的栈释放后是脏的，refill之后重新分配到的仍是它且已清零
+    memset(kstack_ptr(a), 0xA5, STACK_SIZE);
+    kstack_free(&pool, a);
+    passed &= pool.nr_dirty == KSTACK_COUNT - KSTACK_BOOT_CLEAN + 1;
+    passed &= kstack_refill(&pool, 1) == 1;
+    uint32_t b = kstack_alloc(&pool);
+    passed &= b == a && stack_is_zero(b);
+
+    // 干净的栈用完后在分配路径上清零
+    memset(kstack_ptr(b), 0xA5, STACK_SIZE);
+    kstack_free(&pool, b);
+    while (pool.nr_clean > 0) {
+        kstack_alloc(&pool);
+    }
+    uint32_t c = kstack_alloc(&pool);
+    passed &= c == b && stack_is_zero(c) && pool.stats.zeroed_inline == 1;
+
+    // 耗尽后返回0；非法地址不入池
+    while (kstack_alloc(&pool)) {
+    }
+    passed &= kstack_available(&pool) == 0 && pool.stats.allocs == KSTACK_COUNT + 2;
+    kstack_free(&pool, 0);
+    kstack_free(&pool, KSTACK_REGION_BASE + KSTACK_COUNT * STACK_SIZE);
+    passed &= kstack_available(&pool) == 0;
+    printf("allocs=%u clean_hits=%u zeroed_inline=%u zeroed_idle=%u\n", pool.stats.allocs,
+           pool.stats.clean_hits, pool.stats.zeroed_inline, pool.stats.zeroed_idle);
+    print_test_result("Stacks handed out zeroed", passed);
+}
+
+/* 测试2: 批量创建的进程与逐个创建的相同，按给定顺序入队 */
+void test_batch_create(void) {
+    print_test_header("Batch Creation");
+    setup();
+
+    process_spec_t specs[] = {
+        { "w0", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE },
+        { "w1", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE },
+        { "w2", PROCESS_TYPE_SYSTEM, 2, PROCESS_FLAG_CPU_BOUND | PROCESS_FLAG_REALTIME },
+    };
+    pcb_t *out[3];
+    scheduler_stats_t before = scheduler_get_stats();
+    int passed = scheduler_create_processes(specs, 3, out) == 3;
+
+    for (int i = 0; i < 3; i++) {
+        passed &= out[i] && out[i]->state == PROCESS_READY;
+        passed &= strcmp(out[i]->cold->name, specs[i].name) == 0;
+        passed &= out[i]->cold->stack_size == STACK_SIZE && stack_is_zero(out[i]->cold->stack_base);
+        passed &= scheduler_get_process(out[i]->pid) == out[i];
+    }
+    passed &= out[0]->cold->stack_base != out[1]->cold->stack_base;
+    passed &= out[1]->cold->stack_base != out[2]->cold->stack_base;
+    passed &= out[2]->type == PROCESS_TYPE_SYSTEM && out[2]->priority == 2;
+    // 实时类只能经接纳控制进入
+    passed &= !PCB_IS_REALTIME(out[2]) && PCB_HAS_FLAG(out[2], PROCESS_FLAG_CPU_BOUND);
+    passed &= scheduler_get_stats().processes_created == before.processes_created + 3;
+
+    // RR下按给定顺序运行
+    scheduler_schedule();
+    passed &= scheduler_get_current_process() == out[0];
+    scheduler_yield();
+    passed &= scheduler_get_current_process() == out[1];
+    print_test_result("Batch matches one-at-a-time creation", passed);
+}
+
+/* 测试3: 空间不足时一个也不创建 */
+void test_all_or_nothing(void) {
+    print_test_header("All-or-nothing Batches");
+    setup();
+
+    static process_spec_t specs[MAX_PROCESSES];
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        specs[i] = (process_spec_t){ "bulk", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE };
+    }
+
+    // 空闲进程占一个槽位
+    uint32_t room = MAX_PROCESSES - 1;
+    int passed = scheduler_create_processes(specs, room - 2, NULL) == (int)(room - 2);
+    passed &= scheduler_create_processes(specs, 3, NULL) == -1;
+    passed &= scheduler_get_stats().processes_created == room - 2 + 1;
+    passed &= scheduler_create_processes(specs, 2, NULL) == 2;
+    passed &= scheduler_create_process("extra", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE) == NULL;
+    passed &= scheduler_create_processes(specs, 0, NULL) == 0;
+    print_test_result("Oversized batch rejected without side effects", passed);
+}
+
+/* 测试4: 回收的栈在CPU空闲时清零，之后的创建不再清零 */
+void test_idle_refill(void) {
+    print_test_header("Stacks Zeroed While Idle");
+    setup();
+
+    process_spec_t specs[64];
+    pcb_t *out[64];
+    for (int i = 0; i < 64; i++) {
+        specs[i] = (process_spec_t){ "burst", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE };
+    }
+    scheduler_create_processes(specs, 64, out);
+
+    // 弄脏这些栈，然后全部退出并回收
+    for (int i = 0; i < 64; i++) {
+        memset(kstack_ptr(out[i]->cold->stack_base), 0x5A, STACK_SIZE);
+        uint32_t pid = out[i]->pid;
+        scheduler_terminate_process(pid, 0);
+        scheduler_reap_process(pid);
+    }
+    scheduler_reap_deferred(0);         // 栈由回收器归还
+    kstack_stats_t stats = scheduler_get_kstack_stats();
+    int passed = stats.frees == 64;
+
+    // 空闲状态下每个tick清零KSTACK_REFILL_BATCH个
+    scheduler_schedule();
+    for (int t = 0; t < 64 / KSTACK_REFILL_BATCH; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    kstack_stats_t idle = scheduler_get_kstack_stats();
+    passed &= idle.zeroed_idle - stats.zeroed_idle == 64;
+
+    scheduler_create_processes(specs, 64, out);
+    kstack_stats_t reuse = scheduler_get_kstack_stats();
+    for (int i = 0; i < 64; i++) {
+        passed &= stack_is_zero(out[i]->cold->stack_base);
+    }
+    passed &= reuse.clean_hits - idle.clean_hits == 64;
+    passed &= reuse.zeroed_inline == idle.zeroed_inline;
+    printf("zeroed while idle: %u, pre-zeroed hits: %u, zeroed inline: %u\n",
+           idle.zeroed_idle - stats.zeroed_idle, reuse.clean_hits - idle.clean_hits,
+           reuse.zeroed_inline - idle.zeroed_inline);
+    print_test_result("Reused stacks pre-zeroed", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Kernel Stack Pool Test Suite\n");
+    printf("================================\n");
+
+    test_pool();
+    test_batch_create();
+    test_all_or_nothing();
+    test_idle_refill();
+
+    printf("\n================================\n");
+    printf("Kernel Stack Pool Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * test_lazy_fpu.c - 惰性FPU切换测试程序
+ *
+ * 基于内核调度器核心与主机平台层（tools/sim_host.c）构建，
+ * 用 sim_fpu_use() 模拟进程执行FPU指令。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/fpu.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static void setup(void) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+}
+
+/* 测试1: 只做整数运算的进程不触发任何FPU保存/恢复 */
+void test_integer_only(void) {
+    print_test_header("Integer-only Tasks");
+    setup();
+
+    for (int i = 0; i < 4; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "int%d", i);
+        scheduler_create_process(name, PROCESS_TYPE_USER, 1, PROCESS_FLAG_CPU_BOUND);
+    }
+
+    scheduler_schedule();
+    for (int i = 0; i < 100; i++) {
+        scheduler_yield();
+    }
+
+    const fpu_cpu_state_t *fpu = fpu_get_state(0);
+    printf("Traps=%u Saves=%u Restores=%u\n", fpu->nm_traps, fpu->saves, fpu->restores);
+    print_test_result("No FXSAVE/FXRSTOR for integer tasks",
+                      fpu->nm_traps == 0 && fpu->saves == 0 && fpu->restores == 0);
+}
+
+/* 测试2: FPU状态在进程间被正确保存与恢复 */
+void test_state_preserved(void) {
+    print_test_header("FPU State Preserved Across Switches");
+    setup();
+
+    // RR按创建顺序轮转：A(FPU) -> B(整数) -> C(FPU) -> A ...
+    pcb_t *a = scheduler_create_process("fpuA", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    pcb_t *b = scheduler_create_process("intB", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    pcb_t *c = scheduler_create_process("fpuC", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    const fpu_cpu_state_t *fpu = fpu_get_state(0);
+    int passed = 1;
+
+    scheduler_schedule();
+    passed &= scheduler_get_current_process() == a;
+    sim_fpu_use()[0] = 0xAA;                // A首次使用FPU：陷入并初始化
+    passed &= fpu->inits == 1 && fpu->owner == a;
+
+    scheduler_yield();                      // -> B，不使用FPU
+    passed &= scheduler_get_current_process() == b;
+
+    scheduler_yield();                      // -> C，首次使用：保存A，初始化C
+    passed &= scheduler_get_current_process() == c;
+    uint8_t *regs = sim_fpu_use();
+    passed &= regs[0] == 0 && fpu->saves == 1;
+    regs[0] = 0xCC;
+
+    scheduler_yield();                      // -> A：保存C，恢复A
+    passed &= scheduler_get_current_process() == a;
+    passed &= sim_fpu_use()[0] == 0xAA && fpu->restores == 1;
+
+    scheduler_yield();                      // -> B
+    scheduler_yield();                      // -> C：恢复C
+    passed &= sim_fpu_use()[0] == 0xCC;
+
+    printf("Traps=%u Saves=%u Restores=%u Inits=%u\n",
+           fpu->nm_traps, fpu->saves, fpu->restores, fpu->inits);
+    print_test_result("FPU state preserved", passed);
+}
+
+/* 测试3: 切回FPU属主时不产生陷入 */
+void test_owner_return(void) {
+    print_test_header("Switching Back to FPU Owner");
+    setup();
+
+    scheduler_create_process("fpu", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_create_process("int", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    const fpu_cpu_state_t *fpu = fpu_get_state(0);
+
+    scheduler_schedule();
+    sim_fpu_use();
+    for (int i = 0; i < 10; i++) {
+        scheduler_yield();                  // -> int
+        scheduler_yield();                  // -> fpu，寄存器中仍是它的状态
+        sim_fpu_use();
+    }
+
+    printf("Traps=%u OwnerReturns=%u\n", fpu->nm_traps, fpu->owner_returns);
+    print_test_result("Single trap for repeated FPU use", fpu->nm_traps == 1 && fpu->owner_returns == 10);
+}
+
+/* 测试4: 属主退出后其状态被丢弃 */
+void test_owner_exit(void) {
+    print_test_header("FPU Owner Exit");
+    setup();
+
+    pcb_t *a = scheduler_create_process("fpuA", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    pcb_t *b = scheduler_create_process("fpuB", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    const fpu_cpu_state_t *fpu = fpu_get_state(0);
+
+    scheduler_schedule();
+    sim_fpu_use();
+    uint32_t pid = a->pid;
+    scheduler_terminate_process(pid, 0);
+    scheduler_reap_process(pid);
+    scheduler_schedule();
+
+    int passed = scheduler_get_current_process() == b && fpu->owner == NULL;
+    sim_fpu_use();
+    passed &= fpu->saves == 0 && fpu->owner == b;
+
+    print_test_result("Exited owner not saved", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Lazy FPU Switching Test Suite\n");
+    printf("================================\n");
+
+    test_integer_only();
+    test_state_preserved();
+    test_owner_return();
+    test_owner_exit();
+
+    printf("\n================================\n");
+    printf("Lazy FPU Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,306 @@
+/**
+ * test_pi_mutex.c - 优先级继承互斥锁测试程序
+ *
+ * 基于内核调度器核心与主机平台层（tools/sim_host.c）构建。每个进程执行
+ * 一段简单的"程序"（加锁、解锁、计算若干tick……），每次 sim_fire_irq(IRQ_TIMER)
+ * 后由当前进程执行一步，以此重现经典的优先级反转场景。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/mutex.h"
+#include "tools/sim_host.h"
+
+#define MAX_TASKS   8
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+/* ========== 进程程序解释器 ========== */
+
+typedef enum {
+    OP_LOCK,        // 获取mutexes[arg]
+    OP_UNLOCK,      // 释放mutexes[arg]
+    OP_YIELD,       // 主动让出CPU
+    OP_RUN,         // 计算arg个tick
+    OP_JOB_DONE,    // 实时作业完成，回到程序开头
+    OP_SPIN         // 一直计算
+} op_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t arg;
+} op_t;
+
+typedef struct {
+    pcb_t *pcb;
+    const op_t *prog;
+    uint32_t pc;
+    uint32_t ran;       // 当前OP_RUN已计算的tick
+} task_t;
+
+static kmutex_t mutexes[2];
+static task_t tasks[MAX_TASKS];
+static int num_tasks;
+
+static void setup(uint32_t type, kmutex_protocol_t protocol) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = type,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 100000,   // 不依赖周期性提升来缓解反转
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+
+    for (int i = 0; i < 2; i++) {
+        kmutex_init(&mutexes[i], protocol);
+    }
+    memset(tasks, 0, sizeof(tasks));
+    num_tasks = 0;
+}
+
+static pcb_t* spawn(const char *name, uint8_t priority, const op_t *prog) {
+    pcb_t *pcb = scheduler_create_process(name, PROCESS_TYPE_USER, priority, PROCESS_FLAG_NONE);
+    tasks[num_tasks].pcb = pcb;
+    tasks[num_tasks].prog = prog;
+    num_tasks++;
+    return pcb;
+}
+
+/* 当前进程执行一步 */
+static void step(void) {
+    pcb_t *current = scheduler_get_current_process();
+    task_t *task = NULL;
+    for (int i = 0; i < num_tasks; i++) {
+        if (tasks[i].pcb == current) {
+            task = &tasks[i];
+        }
+    }
+    if (!task) {
+        return;
+    }
+
+    const op_t *op = &task->prog[task->pc];
+    switch (op->type) {
+        case OP_LOCK:
+            // 被唤醒时锁已交到手上，不必再次调用
+            if (mutexes[op->arg].owner != current) {
+                kmutex_lock(&mutexes[op->arg]);
+            }
+            if (mutexes[op->arg].owner == current) {
+                task->pc++;
+            }
+            break;
+        case OP_UNLOCK:
+            task->pc++;
+            kmutex_unlock(&mutexes[op->arg]);
+            break;
+        case OP_YIELD:
+            task->pc++;
+            scheduler_yield();
+            break;
+        case OP_RUN:
+            if (++task->ran >= op->arg) {
+                task->ran = 0;
+                task->pc++;
+            }
+            break;
+        case OP_JOB_DONE:
+            task->pc = 0;
+            scheduler_rt_job_done();
+            break;
+        case OP_SPIN:
+            break;
+    }
+}
+
+static void run_ticks(uint32_t ticks) {
+    for (uint32_t t = 0; t < ticks; t++) {
+        sim_fire_irq(IRQ_TIMER);
+        step();
+    }
+}
+
+/* ========== 测试场景 ========== */
+
+/* 低优先级L持锁后让出，高优先级H等待该锁，三个中优先级进程持续计算 */
+static const op_t prog_low[] = {
+    { OP_LOCK, 0 }, { OP_YIELD, 0 }, { OP_RUN, 5 }, { OP_UNLOCK, 0 }, { OP_SPIN, 0 }
+};
+static const op_t prog_high[] = {
+    { OP_LOCK, 0 }, { OP_RUN, 2 }, { OP_UNLOCK, 0 }, { OP_SPIN, 0 }
+};
+static const op_t prog_medium[] = {
+    { OP_SPIN, 0 }
+};
+
+static uint32_t inversion_scenario(kmutex_protocol_t protocol) {
+    setup(SCHEDULER_MLFQ, protocol);
+
+    pcb_t *low = spawn("low", 3, prog_low);
+    scheduler_schedule();
+    step();                                 // L获得锁
+    spawn("high", 0, prog_high);
+    for (int i = 0; i < 3; i++) {
+        spawn("medium", 1, prog_medium);
+    }
+    step();                                 // L让出，H开始运行
+
+    run_ticks(2000);
+
+    printf("  %s: H acquired=%s, max wait=%u ticks, L level now %u\n",
+           protocol == KMUTEX_PROTO_INHERIT ? "inherit" : "none   ",
+           tasks[1].pc > 0 ? "yes" : "no",
+           mutexes[0].max_wait, low->queue_level);
+    return tasks[1].pc > 0 ? mutexes[0].max_wait : UINT32_MAX;
+}
+
+/* 测试1: 优先级反转下H的阻塞时间有界 */
+void test_bounded_blocking(void) {
+    print_test_header("Bounded Blocking Under Priority Inversion");
+
+    uint32_t without = inversion_scenario(KMUTEX_PROTO_NONE);
+    uint32_t with = inversion_scenario(KMUTEX_PROTO_INHERIT);
+
+    // 继承后H最多等待L剩余的临界区（5个tick）加一次调度
+    print_test_result("Blocking bounded by critical section", with <= 6);
+    print_test_result("Inversion reproduced without inheritance", without > 10 * with);
+}
+
+/* 测试2: 传递继承 L <- P <- H */
+static const op_t prog_chain_low[] = {
+    { OP_LOCK, 0 }, { OP_YIELD, 0 }, { OP_RUN, 5 }, { OP_UNLOCK, 0 }, { OP_SPIN, 0 }
+};
+static const op_t prog_chain_mid[] = {
+    { OP_LOCK, 1 }, { OP_LOCK, 0 }, { OP_RUN, 2 }, { OP_UNLOCK, 0 }, { OP_UNLOCK, 1 }, { OP_SPIN, 0 }
+};
+static const op_t prog_chain_high[] = {
+    { OP_LOCK, 1 }, { OP_RUN, 2 }, { OP_UNLOCK, 1 }, { OP_SPIN, 0 }
+};
+
+void test_transitive(void) {
+    print_test_header("Transitive Inheritance");
+    setup(SCHEDULER_MLFQ, KMUTEX_PROTO_INHERIT);
+
+    pcb_t *low = spawn("low", 3, prog_chain_low);
+    scheduler_schedule();
+    step();                                 // L持有M0
+    pcb_t *mid = spawn("mid", 2, prog_chain_mid);
+    step();                                 // L让出
+    step();                                 // P持有M1
+    step();                                 // P等待M0，L继承P的级别
+    int passed = low->queue_level == 2 && mid->state == PROCESS_BLOCKED;
+
+    pcb_t *high = spawn("high", 0, prog_chain_high);
+    for (int i = 0; i < 2; i++) {
+        spawn("medium", 1, prog_medium);
+    }
+    scheduler_yield();                      // 让H运行
+    step();                                 // H等待M1：P和L都提升到0级
+    passed &= high->state == PROCESS_BLOCKED;
+    passed &= mid->queue_level == 0 && low->queue_level == 0;
+    printf("After H blocks: L level %u, P level %u\n", low->queue_level, mid->queue_level);
+
+    run_ticks(100);
+    passed &= mutexes[0].owner == NULL && mutexes[1].owner == NULL;
+    passed &= !PCB_HAS_FLAG(low, PROCESS_FLAG_PI_BOOSTED) && low->queue_level >= 2;
+    passed &= mutexes[1].max_wait <= 12;
+    printf("H max wait on M1: %u ticks; L restored to level %u\n",
+           mutexes[1].max_wait, low->queue_level);
+    print_test_result("Priority propagates along the chain", passed);
+}
+
+/* 测试3: 实时进程等待普通进程持有的锁 */
+static const op_t prog_rt[] = {
+    { OP_LOCK, 0 }, { OP_RUN, 1 }, { OP_UNLOCK, 0 }, { OP_RUN, 1 }, { OP_JOB_DONE, 0 }
+};
+static const op_t prog_rt_low[] = {
+    { OP_LOCK, 0 }, { OP_RUN, 3 }, { OP_UNLOCK, 0 }, { OP_SPIN, 0 }
+};
+
+void test_realtime_inheritance(void) {
+    print_test_header("Real-time Waiter Boosts Holder into EDF");
+    setup(SCHEDULER_MLFQ, KMUTEX_PROTO_INHERIT);
+
+    pcb_t *low = spawn("low", 3, prog_rt_low);
+    scheduler_schedule();
+    step();                                 // L持锁
+
+    // 周期20、执行2、截止时间10；L剩余临界区2个tick，最坏响应 2 + 2 = 4
+    for (int i = 0; i < 3; i++) {
+        spawn("medium", 1, prog_medium);
+    }
+    pcb_t *rt = spawn("control", 0, prog_rt);
+    int passed = scheduler_set_realtime(rt->pid, 2, 20, 10) == 0;
+
+    bool saw_rt_boost = false;
+    for (int t = 0; t < 2000; t++) {
+        sim_fire_irq(IRQ_TIMER);
+        step();
+        saw_rt_boost |= pi_in_rt_class(low) && !PCB_IS_REALTIME(low);
+    }
+
+    rt_stats_t stats = scheduler_get_rt_stats();
+    printf("Jobs=%u Misses=%u Contentions=%u MaxWait=%u BoostSeen=%s\n", stats.jobs,
+           stats.deadline_misses, mutexes[0].contentions, mutexes[0].max_wait,
+           saw_rt_boost ? "yes" : "no");
+    passed &= stats.jobs >= 99 && stats.deadline_misses == 0;
+    passed &= mutexes[0].contentions > 0 && saw_rt_boost;
+    passed &= !pi_in_rt_class(low);
+    print_test_result("Holder inherits EDF deadline", passed);
+}
+
+/* 测试4: 持有者退出时锁交给等待者 */
+void test_owner_exit(void) {
+    print_test_header("Owner Exit Hands Off Mutex");
+    setup(SCHEDULER_RR, KMUTEX_PROTO_INHERIT);
+
+    pcb_t *low = spawn("low", 3, prog_low);
+    scheduler_schedule();
+    step();                                 // L持锁
+    pcb_t *high = spawn("high", 0, prog_high);
+    step();                                 // L让出
+    step();                                 // H阻塞
+    int passed = high->state == PROCESS_BLOCKED && mutexes[0].owner == low;
+
+    scheduler_terminate_process(low->pid, 0);
+    passed &= mutexes[0].owner == high && high->state == PROCESS_READY;
+    passed &= high->cold->pi.blocked_on == NULL;
+    print_test_result("Waiter owns mutex after owner exit", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Priority Inheritance Mutex Test Suite\n");
+    printf("================================\n");
+
+    test_bounded_blocking();
+    test_transitive();
+    test_realtime_inheritance();
+    test_owner_exit();
+
+    printf("\n================================\n");
+    printf("PI Mutex Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
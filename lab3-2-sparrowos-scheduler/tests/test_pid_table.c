@@ -0,0 +1,157 @@
+/**
+ * test_pid_table.c - 进程表槽位分配与PID查找测试程序
+ *
+ * 直接测试 kernel/core/pcb.c 中的进程表：两级位图分配最低空闲槽位、
+ * PID按槽位直接定位、槽位回收后旧PID失效，以及满表时分配/查找的开销。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "kernel/include/pcb.h"
+
+static int failures = 0;
+static process_table_t table;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+/* 与 scheduler_create_process 相同的分配流程 */
+static pcb_t* spawn(void) {
+    pcb_t *pcb = pcb_alloc();
+    if (pcb) {
+        pcb_init(pcb, process_table_make_pid(&table, pcb), "p", PROCESS_TYPE_USER, 1);
+    }
+    return pcb;
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+/* 测试1: 总是分配最低的空闲槽位，满表时失败 */
+void test_lowest_free_slot(void) {
+    print_test_header("Lowest Free Slot Allocation");
+    process_table_init(&table);
+
+    int passed = 1;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        pcb_t *pcb = spawn();
+        passed &= pcb && process_table_slot(&table, pcb) == i && pcb->pid == i + 1;
+    }
+    passed &= pcb_alloc() == NULL && process_table_get_count(&table) == MAX_PROCESSES;
+
+    // 释放跨越不同位图字的几个槽位，按从低到高的顺序重新分配
+    uint32_t holes[] = { MAX_PROCESSES - 1, 33, 31, MAX_PROCESSES / 2 };
+    for (int i = 0; i < 4; i++) {
+        pcb_free(&table.processes[holes[i]]);
+    }
+    uint32_t expect[] = { 31, 33, MAX_PROCESSES / 2, MAX_PROCESSES - 1 };
+    for (int i = 0; i < 4; i++) {
+        pcb_t *pcb = spawn();
+        passed &= pcb && process_table_slot(&table, pcb) == expect[i];
+    }
+    passed &= pcb_alloc() == NULL;
+    print_test_result("Bitmap find-first-zero", passed);
+}
+
+/* 测试2: 回收后的槽位换用新代数的PID，旧PID查不到 */
+void test_pid_generations(void) {
+    print_test_header("PID Recycling with Generations");
+    process_table_init(&table);
+
+    pcb_t *a = spawn();
+    pcb_t *b = spawn();
+    uint32_t old_pid = a->pid;
+    int passed = process_table_find(&table, old_pid) == a;
+    passed &= process_table_find(&table, b->pid) == b;
+
+    pcb_free(a);
+    passed &= process_table_find(&table, old_pid) == NULL;
+
+    pcb_t *c = spawn();
+    passed &= c == a && c->pid != old_pid;
+    passed &= PID_SLOT(c->pid) == PID_SLOT(old_pid);
+    passed &= PID_GENERATION(c->pid) == PID_GENERATION(old_pid) + 1;
+    passed &= process_table_find(&table, c->pid) == c;
+    passed &= process_table_find(&table, old_pid) == NULL;
+    printf("Slot 0: pid %u -> %u\n", old_pid, c->pid);
+
+    // 未分配槽位、PID 0 与超出范围的代数
+    passed &= process_table_find(&table, 0) == NULL;
+    passed &= process_table_find(&table, 3) == NULL;
+    passed &= process_table_find(&table, b->pid + 5 * MAX_PROCESSES) == NULL;
+
+    // 代数用尽后回绕，PID仍然非0且可查找
+    table.generation[1] = PID_MAX_GENERATION;
+    pcb_free(b);
+    passed &= table.generation[1] == 0;
+    pcb_t *d = spawn();
+    passed &= d == b && d->pid == 2 && process_table_find(&table, 2) == d;
+    print_test_result("Stale PIDs rejected after recycling", passed);
+}
+
+/* 测试3: 几乎满表时分配与查找的开销与空表相当 */
+void test_cost_independent_of_load(void) {
+    print_test_header("Allocation and Lookup Cost vs. Table Occupancy");
+    const int iters = 200000;
+    double ns[2][2];
+
+    for (int full = 0; full < 2; full++) {
+        process_table_init(&table);
+        uint32_t keep = full ? MAX_PROCESSES - 1 : 1;
+        for (uint32_t i = 0; i < keep; i++) {
+            spawn();
+        }
+        uint32_t probe = table.processes[keep - 1].pid;
+
+        struct timespec t0, t1, t2;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int i = 0; i < iters; i++) {
+            pcb_free(spawn());                  // 总是取到最后一个空闲槽位
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        uintptr_t sink = 0;
+        for (int i = 0; i < iters; i++) {
+            sink += (uintptr_t)process_table_find(&table, probe);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t2);
+
+        ns[full][0] = elapsed_ns(&t0, &t1) / iters;
+        ns[full][1] = elapsed_ns(&t1, &t2) / iters;
+        printf("%u/%u slots used: alloc+free %.1f ns, lookup %.1f ns%s\n",
+               keep, MAX_PROCESSES, ns[full][0], ns[full][1], sink ? "" : " (miss)");
+    }
+
+    // 线性扫描在满表时会慢两个数量级；留足余量避免计时抖动误报
+    int passed = ns[1][0] < ns[0][0] * 20 + 50 && ns[1][1] < ns[0][1] * 20 + 50;
+    print_test_result("Cost does not grow with occupancy", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Process Table Test Suite (MAX_PROCESSES=%d)\n", MAX_PROCESSES);
+    printf("================================\n");
+
+    test_lowest_free_slot();
+    test_pid_generations();
+    test_cost_independent_of_load();
+
+    printf("\n================================\n");
+    printf("Process Table Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
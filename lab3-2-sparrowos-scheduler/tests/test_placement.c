@@ -0,0 +1,162 @@
+/**
+ * test_placement.c - 缓存亲和放置测试程序
+ *
+ * 前半部分直接调用 placement_select_cpu()/placement_can_pull()，用手工构造的
+ * 各CPU负载检查放置决策；后半部分基于内核调度器核心与主机平台层
+ * （tools/sim_host.c），检查调度器在换出进程时记录 last_cpu 与 last_ran。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/placement.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+/* 只用到冷数据中的 last_cpu/last_ran */
+static pcb_t task;
+static pcb_cold_t task_cold;
+
+static void set_history(uint8_t last_cpu, uint32_t last_ran) {
+    memset(&task, 0, sizeof(task));
+    memset(&task_cold, 0, sizeof(task_cold));
+    task.cold = &task_cold;
+    task_cold.last_cpu = last_cpu;
+    task_cold.last_ran = last_ran;
+}
+
+/* 测试1: 缓存仍热时留在原CPU，过载时迁移 */
+void test_hot_wakeup(void) {
+    print_test_header("Hot Task Stays on Previous CPU");
+
+    placement_t pl;
+    placement_init(&pl, 4, 20);
+
+    // 上次在CPU2上运行，10个tick前换出
+    set_history(2, 90);
+    uint32_t load[MAX_CPUS] = {1, 0, 2, 1};
+    int passed = placement_select_cpu(&pl, &task, load, 100) == 2;
+    passed &= pl.stats.affine == 1 && pl.stats.migrations == 0;
+
+    // 原CPU比最空闲的CPU多出的进程超过imbalance
+    uint32_t busy[MAX_CPUS] = {1, 0, 3, 1};
+    passed &= placement_select_cpu(&pl, &task, busy, 100) == 1;
+    passed &= pl.stats.affine_overridden == 1 && pl.stats.migrations == 1;
+
+    // 不考虑亲和时直接选最空闲的CPU
+    placement_t spread;
+    placement_init(&spread, 4, 0);
+    passed &= placement_select_cpu(&spread, &task, load, 100) == 1;
+    printf("affine=%u overridden=%u migrations=%u\n", pl.stats.affine,
+           pl.stats.affine_overridden, pl.stats.migrations);
+    print_test_result("Affinity bounded by imbalance", passed);
+}
+
+/* 测试2: 缓存已冷或从未运行过时选最空闲的CPU */
+void test_cold_wakeup(void) {
+    print_test_header("Cold Task Goes to Idlest CPU");
+
+    placement_t pl;
+    placement_init(&pl, 4, 20);
+
+    set_history(2, 50);     // 50个tick前换出，超过阈值
+    uint32_t load[MAX_CPUS] = {1, 0, 1, 1};
+    int passed = placement_select_cpu(&pl, &task, load, 100) == 1;
+
+    // 负载相同时仍优先原CPU，不算迁移
+    uint32_t even[MAX_CPUS] = {1, 1, 1, 1};
+    passed &= placement_select_cpu(&pl, &task, even, 100) == 2;
+    passed &= pl.stats.cold_stays == 1 && pl.stats.migrations == 1;
+
+    set_history(PCB_NO_CPU, 0);
+    uint32_t first[MAX_CPUS] = {2, 1, 0, 3};
+    passed &= placement_select_cpu(&pl, &task, first, 100) == 2;
+    passed &= pl.stats.first_runs == 1 && pl.stats.migrations == 1;
+
+    // 超出num_cpus的CPU不参与选择
+    uint32_t wide[MAX_CPUS] = {1, 1, 1, 1, 0, 0, 0, 0};
+    passed &= placement_select_cpu(&pl, &task, wide, 100) < 4;
+    print_test_result("Cold and first placements", passed);
+}
+
+/* 测试3: 负载均衡不拉取缓存仍热的进程 */
+void test_pull(void) {
+    print_test_header("Load Balancer Leaves Hot Tasks Alone");
+
+    placement_t pl;
+    placement_init(&pl, 2, 20);
+
+    set_history(0, 95);
+    int passed = !placement_can_pull(&pl, &task, 2, 100);
+    passed &= placement_can_pull(&pl, &task, 3, 100);       // 源队列太长时仍允许
+    passed &= placement_can_pull(&pl, &task, 1, 120);       // 已冷
+    passed &= pl.stats.pulls_refused == 1;
+    print_test_result("Pull decisions", passed);
+}
+
+/* 测试4: 调度器记录换出时刻与运行的CPU */
+void test_scheduler_history(void) {
+    print_test_header("Scheduler Records Last CPU and Last Run");
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+
+    pcb_t *a = scheduler_create_process("a", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    pcb_t *b = scheduler_create_process("b", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    int passed = a->cold->last_cpu == PCB_NO_CPU;
+
+    scheduler_schedule();
+    for (int i = 0; i < 7; i++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    scheduler_yield();
+    passed &= scheduler_get_current_process() == b;
+    passed &= a->cold->last_cpu == 0 && a->cold->last_ran == 7;
+
+    placement_t pl;
+    placement_init(&pl, 2, 5);
+    passed &= placement_cache_hot(&pl, a, 11) && !placement_cache_hot(&pl, a, 12);
+    printf("a: last_cpu=%u last_ran=%u\n", a->cold->last_cpu, a->cold->last_ran);
+    print_test_result("History recorded on switch-out", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Cache-affine Placement Test Suite\n");
+    printf("================================\n");
+
+    test_hot_wakeup();
+    test_cold_wakeup();
+    test_pull();
+    test_scheduler_history();
+
+    printf("\n================================\n");
+    printf("Placement Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * test_reaper.c - 延迟回收测试程序
+ *
+ * 基于内核调度器核心与主机平台层（tools/sim_host.c），检查
+ * scheduler_reap_process() 只把僵尸排入回收链表、回收器分批释放PCB与
+ * 内核栈并汇总统计；同一父进程的子进程一次摘除、先退出的父进程的子进程
+ * 被释放时脱离；仍在唤醒链表上的PCB留到下一批；以及CPU空闲时的tick和
+ * 进程表已满时的创建路径会运行回收器。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static void setup(void) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+}
+
+static int exit_and_reap(pcb_t *pcb) {
+    uint32_t pid = pcb->pid;
+    if (scheduler_terminate_process(pid, 0) != 0) {
+        return -1;
+    }
+    return scheduler_reap_process(pid);
+}
+
+/* 父进程成为当前进程后创建n个子进程 */
+static pcb_t* spawn_family(pcb_t **children, uint32_t n) {
+    pcb_t *parent = scheduler_create_process("parent", PROCESS_TYPE_USER, 0, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+    for (uint32_t i = 0; i < n; i++) {
+        children[i] = scheduler_create_process("child", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    }
+    return parent;
+}
+
+/* 测试1: reap只排队，回收器释放并汇总统计 */
+void test_deferred_release(void) {
+    print_test_header("Reap Queues, Reaper Releases");
+    setup();
+
+    pcb_t *a = scheduler_create_process("a", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    pcb_t *b = scheduler_create_process("b", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+    for (int i = 0; i < 5; i++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    uint32_t table = scheduler_get_stats().processes_created;
+    kstack_stats_t before = scheduler_get_kstack_stats();
+
+    uint32_t pid = a->pid;
+    int passed = exit_and_reap(a) == 0 && exit_and_reap(b) == 0;
+    passed &= scheduler_reap_process(pid) == -1;        // 已在回收链表上
+    passed &= scheduler_get_process(pid) == NULL;
+    passed &= scheduler_reap_pending() == 2;
+    passed &= scheduler_get_kstack_stats().frees == before.frees;
+    passed &= scheduler_get_stats().processes_completed == 0;
+    print_test_result("Reaped zombies are hidden but not yet freed", passed);
+
+    passed = scheduler_reap_deferred(0) == 2 && scheduler_reap_pending() == 0;
+    scheduler_stats_t stats = scheduler_get_stats();
+    reaper_stats_t rs = scheduler_get_reaper_stats();
+    passed &= scheduler_get_kstack_stats().frees == before.frees + 2;
+    passed &= stats.processes_completed == 2 && stats.total_runtime == 5;
+    passed &= rs.queued == 2 && rs.reaped == 2 && rs.batches == 1 && rs.max_batch == 2;
+    passed &= scheduler_reap_deferred(0) == 0;
+    printf("created %u, completed %u, runtime %u, reaper %u/%u in %u batches\n",
+           table, stats.processes_completed, stats.total_runtime, rs.reaped, rs.queued,
+           rs.batches);
+    print_test_result("Reaper frees stacks and PCBs and aggregates stats", passed);
+}
+
+/* 测试2: 父子关系 */
+void test_family(void) {
+    print_test_header("Children Pruned and Orphaned");
+    setup();
+
+    pcb_t *children[8];
+    pcb_t *parent = spawn_family(children, 8);
+    int passed = parent->cold->resources.child_processes == 8;
+
+    // 按创建顺序退出（最早的在子进程链表尾），回收一批后链表只剩活着的两个
+    for (int i = 0; i < 6; i++) {
+        passed &= exit_and_reap(children[i]) == 0;
+    }
+    passed &= parent->cold->resources.child_processes == 8;
+    scheduler_reap_deferred(0);
+    passed &= parent->cold->resources.child_processes == 2;
+    passed &= parent->cold->children == children[7] &&
+              children[7]->cold->sibling == children[6] &&
+              children[6]->cold->sibling == NULL;
+    print_test_result("One pass removes every reaped sibling", passed);
+
+    // 父进程先退出：子进程在父进程被释放时脱离
+    passed = exit_and_reap(parent) == 0;
+    passed &= children[6]->cold->parent == parent;
+    scheduler_reap_deferred(0);
+    passed &= children[6]->cold->parent == NULL && children[6]->cold->ppid == 0;
+    passed &= children[7]->cold->parent == NULL && children[7]->cold->sibling == NULL;
+    print_test_result("Children of a reaped parent are orphaned", passed);
+
+    // 父进程与子进程在同一批中
+    setup();
+    parent = spawn_family(children, 4);
+    passed = exit_and_reap(children[0]) == 0 && exit_and_reap(parent) == 0 &&
+             exit_and_reap(children[3]) == 0;
+    passed &= scheduler_reap_deferred(0) == 3;
+    passed &= children[1]->cold->parent == NULL && children[2]->cold->parent == NULL;
+    passed &= scheduler_get_process(children[1]->pid) == children[1];
+    print_test_result("Parent and children released in one batch", passed);
+}
+
+/* 测试3: 仍在唤醒链表上的PCB留到下一批 */
+void test_wake_pending(void) {
+    print_test_header("Wake-Pending Zombies Deferred");
+    setup();
+
+    pcb_t *p[3];
+    for (int i = 0; i < 3; i++) {
+        p[i] = scheduler_create_process("p", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+        exit_and_reap(p[i]);
+    }
+    // 模拟p[1]还挂在另一个CPU的唤醒链表上
+    p[1]->cold->wake_pending = 1;
+    int passed = scheduler_reap_deferred(0) == 2 && scheduler_reap_pending() == 1;
+    passed &= scheduler_get_reaper_stats().deferred == 1;
+    p[1]->cold->wake_pending = 0;
+    passed &= scheduler_reap_deferred(0) == 1 && scheduler_reap_pending() == 0;
+    print_test_result("PCB on a wake list is kept for the next batch", passed);
+
+    // 一批的数量上限
+    for (int i = 0; i < 3; i++) {
+        p[i] = scheduler_create_process("p", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+        exit_and_reap(p[i]);
+    }
+    passed = scheduler_reap_deferred(2) == 2 && scheduler_reap_pending() == 1;
+    passed &= scheduler_reap_deferred(2) == 1;
+    print_test_result("Batch size is bounded by max", passed);
+}
+
+/* 测试4: 空闲tick与创建路径运行回收器 */
+void test_triggers(void) {
+    print_test_header("Idle Ticks and Allocation Pressure");
+    setup();
+
+    uint32_t n = REAPER_BATCH * 2 + 1;
+    pcb_t **procs = calloc(MAX_PROCESSES, sizeof(pcb_t *));
+    for (uint32_t i = 0; i < n; i++) {
+        procs[i] = scheduler_create_process("burst", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        exit_and_reap(procs[i]);
+    }
+
+    // 忙碌时不回收；空闲后每个tick一批
+    pcb_t *busy = scheduler_create_process("busy", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+    sim_fire_irq(IRQ_TIMER);
+    int passed = scheduler_reap_pending() == n;
+    exit_and_reap(busy);
+    scheduler_schedule();
+    sim_fire_irq(IRQ_TIMER);
+    passed &= scheduler_reap_pending() == n + 1 - REAPER_BATCH;
+    for (int t = 0; t < 3; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    passed &= scheduler_reap_pending() == 0;
+    passed &= scheduler_get_reaper_stats().max_batch == REAPER_BATCH;
+    print_test_result("Idle ticks reap REAPER_BATCH at a time", passed);
+
+    // 进程表已满：创建路径先回收再重试
+    setup();
+    uint32_t count = 0;
+    while ((procs[count] = scheduler_create_process("fill", PROCESS_TYPE_USER, 1,
+                                                    PROCESS_FLAG_NONE)) != NULL) {
+        count++;
+    }
+    exit_and_reap(procs[0]);
+    passed = scheduler_create_process("more", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE) != NULL;
+    passed &= scheduler_get_reaper_stats().forced == 1 && scheduler_reap_pending() == 0;
+
+    // 批量创建同样先回收
+    process_spec_t specs[2] = {
+        { "pair", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE },
+        { "pair", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE },
+    };
+    exit_and_reap(procs[1]);
+    exit_and_reap(procs[2]);
+    passed &= scheduler_create_processes(specs, 2, NULL) == 2;
+    passed &= scheduler_get_reaper_stats().forced == 2;
+    printf("table filled with %u processes\n", count);
+    print_test_result("Full process table reaps before failing", passed);
+
+    // 积压超过高水位时创建路径回收
+    setup();
+    for (uint32_t i = 0; i < REAPER_HIGH_WATER; i++) {
+        procs[i] = scheduler_create_process("burst", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    }
+    for (uint32_t i = 0; i < REAPER_HIGH_WATER; i++) {
+        exit_and_reap(procs[i]);
+    }
+    passed = scheduler_reap_pending() == REAPER_HIGH_WATER;
+    scheduler_create_process("next", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    passed &= scheduler_reap_pending() == 0 && scheduler_get_reaper_stats().forced == 1;
+
+    scheduler_print_status();
+    print_test_result("Backlog above the high-water mark is reaped on create", passed);
+    free(procs);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Deferred Reaper Test Suite\n");
+    printf("================================\n");
+
+    test_deferred_release();
+    test_family();
+    test_wake_pending();
+    test_triggers();
+
+    printf("\n================================\n");
+    printf("Reaper Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,257 @@
+/**
+ * test_replay.c - 调度决策录制与重放测试程序
+ *
+ * 前半部分直接操作 replay_t，检查编码、tick合并与缓冲区溢出；后半部分
+ * 基于内核调度器核心与主机平台层（tools/sim_host.c）录制一段包含创建、
+ * 阻塞、唤醒、睡眠、让出和改优先级的运行，再按日志重放并校验每次选择；
+ * 改变时间片后重放应在第一次不同的选择处报告不一致。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/replay.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static uint8_t log_buf[1 << 16];
+
+static void setup(uint32_t quantum) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_MLFQ,
+        .time_quantum = quantum,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 200,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+}
+
+/* 测试1: 编码、tick合并与溢出 */
+void test_encoding(void) {
+    print_test_header("Log Encoding");
+
+    replay_t r;
+    replay_init_record(&r, log_buf, sizeof(log_buf));
+    for (int i = 0; i < 300; i++) {
+        replay_input(&r, REPLAY_TICK, 0, 0, 0, 0);
+    }
+    replay_input(&r, REPLAY_CREATE, 0, 3, 0x200, 70000);
+    replay_pick(&r, 70000);
+    replay_input(&r, REPLAY_TICK, 0, 0, 0, 0);
+    replay_input(&r, REPLAY_EXIT, 70000, (uint32_t)-1, 0, 0);
+    replay_finish(&r);
+
+    // tick(300)=3字节, create=1+1+1+2+3, pick=1+3, tick(1)=2, exit=1+3+5
+    int passed = r.entries == 5 && r.len == 3 + 8 + 4 + 2 + 9 && r.now == 301;
+
+    replay_t v;
+    replay_init_verify(&v, log_buf, r.len);
+    replay_entry_t e;
+    passed &= replay_next(&v, &e) && e.op == REPLAY_TICK && e.args[0] == 300;
+    passed &= replay_next(&v, &e) && e.op == REPLAY_CREATE && e.args[1] == 3 &&
+              e.args[2] == 0x200 && e.args[3] == 70000;
+    // 下一条是选择记录：驱动程序不能越过它
+    passed &= !replay_next(&v, &e) && v.diverged && v.expected.op == REPLAY_PICK;
+
+    replay_init_verify(&v, log_buf, r.len);
+    replay_next(&v, &e);
+    replay_next(&v, &e);
+    replay_pick(&v, 70000);
+    passed &= replay_next(&v, &e) && e.op == REPLAY_TICK && e.args[0] == 1;
+    passed &= replay_next(&v, &e) && e.op == REPLAY_EXIT && e.args[1] == UINT32_MAX;
+    passed &= !replay_next(&v, &e) && !v.diverged && v.pos == r.len;
+
+    // 缓冲区满后丢弃后续记录并标记
+    replay_t small;
+    replay_init_record(&small, log_buf, 4);
+    replay_input(&small, REPLAY_WAKEUP, 5, 0, 0, 0);
+    replay_input(&small, REPLAY_WAKEUP, 5, 0, 0, 0);
+    replay_input(&small, REPLAY_YIELD, 0, 0, 0, 0);
+    passed &= small.overflow && small.len == 4 && small.entries == 2;
+    printf("log: %u entries, %u bytes for %u ticks\n", r.entries, r.len, r.now);
+    print_test_result("Entries round-trip", passed);
+}
+
+/* 一段有代表性的负载：计算型、交互型与改优先级 */
+static void workload(uint32_t ticks) {
+    pcb_t *hog = scheduler_create_process("hog", PROCESS_TYPE_USER, 1, PROCESS_FLAG_CPU_BOUND);
+    pcb_t *editor = scheduler_create_process("editor", PROCESS_TYPE_USER, 0, PROCESS_FLAG_NONE);
+    pcb_t *io = scheduler_create_process("io", PROCESS_TYPE_USER, 1, PROCESS_FLAG_IO_BOUND);
+    uint32_t io_wake = 0;
+    scheduler_schedule();
+
+    for (uint32_t t = 0; t < ticks; t++) {
+        sim_fire_irq(IRQ_TIMER);
+        pcb_t *current = scheduler_get_current_process();
+        if (current == editor && t % 7 == 0) {
+            scheduler_sleep_process(5);
+        } else if (current == io && t % 5 == 0) {
+            scheduler_block_process(WAIT_REASON_IO);
+            io_wake = t + 12;
+        } else if (current == hog && t % 50 == 0) {
+            scheduler_yield();
+        }
+        if (t == io_wake) {
+            if (t % 2) {
+                scheduler_wakeup_process(io->pid);
+            } else {
+                scheduler_wakeup_from_irq(io);
+            }
+        }
+        if (t == ticks / 2) {
+            scheduler_set_priority(hog->pid, 3);
+        }
+        if (t == ticks - 50) {
+            scheduler_terminate_process(editor->pid, 0);
+            scheduler_reap_process(editor->pid);
+            scheduler_reap_deferred(0);
+            scheduler_schedule();
+        }
+    }
+}
+
+/* 按日志驱动调度器，返回是否完全一致 */
+static bool replay_log(replay_t *rp) {
+    scheduler_set_recorder(rp);
+    replay_entry_t e;
+    while (replay_next(rp, &e)) {
+        uint32_t *a = e.args;
+        switch (e.op) {
+            case REPLAY_TICK:
+                for (uint32_t i = 0; i < a[0]; i++) {
+                    sim_fire_irq(IRQ_TIMER);
+                }
+                break;
+            case REPLAY_CREATE: {
+                pcb_t *pcb = scheduler_create_process("replay", (process_type_t)a[0],
+                                                      (uint8_t)a[1], (process_flags_t)a[2]);
+                if (!pcb || pcb->pid != a[3]) {
+                    replay_mismatch(rp, &e, pcb ? pcb->pid : 0);
+                }
+                break;
+            }
+            case REPLAY_EXIT:        scheduler_terminate_process(a[0], (int)a[1]); break;
+            case REPLAY_REAP:        scheduler_reap_process(a[0]); break;
+            case REPLAY_BLOCK:       scheduler_block_process(a[0]); break;
+            case REPLAY_WAKEUP:      scheduler_wakeup_process(a[0]); break;
+            case REPLAY_SLEEP:       scheduler_sleep_process(a[0]); break;
+            case REPLAY_YIELD:       scheduler_yield(); break;
+            case REPLAY_SCHEDULE:    scheduler_schedule(); break;
+            case REPLAY_PRIORITY:    scheduler_set_priority(a[0], (uint8_t)a[1]); break;
+            case REPLAY_REAPER:      scheduler_reap_deferred(a[0]); break;
+            default: break;
+        }
+    }
+    scheduler_set_recorder(NULL);
+    return !rp->diverged && rp->pos == rp->len;
+}
+
+/* 测试2: 录制的运行重放后每次选择都相同 */
+static replay_t recorded;
+
+void test_record_replay(void) {
+    print_test_header("Record and Replay a Mixed Workload");
+
+    setup(10);
+    replay_init_record(&recorded, log_buf, sizeof(log_buf));
+    scheduler_set_recorder(&recorded);
+    workload(1000);
+    replay_finish(&recorded);
+    scheduler_set_recorder(NULL);
+    scheduler_stats_t live = scheduler_get_stats();
+
+    bool seen[REPLAY_NR_OPS] = {false};
+    int passed_scan = 1;
+    replay_t scan;
+    replay_init_verify(&scan, log_buf, recorded.len);
+    replay_entry_t e;
+    while (scan.pos < scan.len) {
+        if (!replay_next(&scan, &e)) {
+            // 停在调度器写出的选择或唤醒记录处：按记录取出后继续
+            seen[scan.expected.op] = true;
+            scan.diverged = false;
+            if (scan.expected.op == REPLAY_PICK) {
+                replay_pick(&scan, scan.expected.args[0]);
+            } else {
+                uint32_t pid;
+                passed_scan &= replay_wakeup_irq(&scan, &pid) && pid == scan.expected.args[0];
+            }
+            continue;
+        }
+        seen[e.op] = true;
+        if (e.op == REPLAY_TICK) {
+            scan.now += e.args[0];          // 只扫描不触发tick，直接推进时钟
+        }
+    }
+    int passed = passed_scan && !recorded.overflow && recorded.now == 1000;
+    for (int op = REPLAY_TICK; op < REPLAY_NR_OPS; op++) {
+        passed &= seen[op];
+    }
+
+    setup(10);
+    replay_t rp;
+    replay_init_verify(&rp, log_buf, recorded.len);
+    passed &= replay_log(&rp);
+    passed &= rp.picks == recorded.picks && rp.now == recorded.now;
+    passed &= scheduler_get_stats().context_switches == live.context_switches;
+    printf("recorded %u picks in %u bytes; replayed %u picks, %u context switches\n",
+           recorded.picks, recorded.len, rp.picks, live.context_switches);
+    print_test_result("Identical decisions on replay", passed);
+}
+
+/* 测试3: 策略参数改变时报告第一次不同的选择 */
+void test_divergence(void) {
+    print_test_header("Divergence Reported at First Different Pick");
+
+    setup(20);
+    replay_t rp;
+    replay_init_verify(&rp, log_buf, recorded.len);
+    int passed = !replay_log(&rp);
+    passed &= rp.diverged && rp.expected.op == REPLAY_PICK;
+    passed &= rp.diverge_tick > 0 && rp.diverge_tick < recorded.now;
+    printf("diverged at tick %u: recorded %s %u, replayed %s\n", rp.diverge_tick,
+           replay_op_name(rp.expected.op), rp.expected.args[0],
+           rp.actual.op ? "a different pick" : "no pick");
+
+    // 截断的日志：停在截断处，不会越界
+    setup(10);
+    replay_init_verify(&rp, log_buf, recorded.len - 1);
+    passed &= !replay_log(&rp);
+    print_test_result("Changed time quantum detected", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Record/Replay Test Suite\n");
+    printf("================================\n");
+
+    test_encoding();
+    test_record_replay();
+    test_divergence();
+
+    printf("\n================================\n");
+    printf("Record/Replay Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,342 @@
+/**
+ * test_spinlock.c - 自旋锁测试程序
+ *
+ * 检查测试并设置锁、票号锁、MCS锁与读写锁（kernel/include/spinlock.h）的
+ * trylock语义与票号回绕、多线程下的互斥、票号锁与MCS锁的先来先得顺序、
+ * 读写锁的读者共享与写者优先，以及调度器锁的竞争统计。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/spinlock.h"
+#include "tools/sim_host.h"
+
+#define THREADS         4
+#define ITERATIONS      20000
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+typedef enum {
+    KIND_TAS,
+    KIND_TICKET,
+    KIND_MCS,
+    KIND_RW_WRITE,
+    KIND_SPINLOCK,
+    KIND_NR
+} kind_t;
+
+static const char *kind_names[KIND_NR] = { "tas", "ticket", "mcs", "rwlock(write)", "spinlock_t" };
+
+static tas_lock_t tas;
+static ticket_lock_t ticket;
+static mcs_lock_t mcs;
+static rwlock_t rw;
+static spinlock_t spin;
+static mcs_node_t nodes[THREADS];
+
+static uint32_t acquire(kind_t kind, int id) {
+    switch (kind) {
+        case KIND_TAS:      return tas_lock(&tas);
+        case KIND_TICKET:   return ticket_lock(&ticket);
+        case KIND_MCS:      return mcs_lock(&mcs, &nodes[id]);
+        case KIND_RW_WRITE: return rwlock_write_lock(&rw);
+        default:            spinlock_lock(&spin); return 0;
+    }
+}
+
+static void release(kind_t kind, int id) {
+    switch (kind) {
+        case KIND_TAS:      tas_unlock(&tas); break;
+        case KIND_TICKET:   ticket_unlock(&ticket); break;
+        case KIND_MCS:      mcs_unlock(&mcs, &nodes[id]); break;
+        case KIND_RW_WRITE: rwlock_write_unlock(&rw); break;
+        default:            spinlock_unlock(&spin); break;
+    }
+}
+
+static void init_all(void) {
+    tas_lock_init(&tas);
+    ticket_lock_init(&ticket);
+    mcs_lock_init(&mcs);
+    rwlock_init(&rw);
+    spinlock_init(&spin);
+}
+
+/* 测试1: 单线程语义 */
+void test_trylock(void) {
+    print_test_header("Trylock and Ticket Wraparound");
+    init_all();
+
+    int passed = tas_lock(&tas) == 0 && !tas_trylock(&tas);
+    tas_unlock(&tas);
+    passed &= tas_trylock(&tas);
+    tas_unlock(&tas);
+
+    passed &= ticket_lock(&ticket) == 0 && !ticket_trylock(&ticket);
+    ticket_unlock(&ticket);
+    passed &= ticket_trylock(&ticket);
+    ticket_unlock(&ticket);
+
+    passed &= mcs_lock(&mcs, &nodes[0]) == 0 && !mcs_trylock(&mcs, &nodes[1]);
+    mcs_unlock(&mcs, &nodes[0]);
+    passed &= mcs_trylock(&mcs, &nodes[1]) && mcs.tail == &nodes[1];
+    mcs_unlock(&mcs, &nodes[1]);
+    passed &= mcs.tail == NULL;
+    print_test_result("Trylock fails only while held", passed);
+
+    // 16位票号回绕
+    ticket.owner = 0xFFFE;
+    ticket.next = 0xFFFE;
+    passed = true;
+    for (int i = 0; i < 4; i++) {
+        passed &= ticket_lock(&ticket) == 0;
+        ticket_unlock(&ticket);
+    }
+    passed &= ticket.owner == 2 && ticket.next == 2 && ticket_trylock(&ticket);
+    ticket_unlock(&ticket);
+    print_test_result("Ticket counters wrap", passed);
+
+    spinlock_lock(&spin);
+    passed = !spinlock_trylock(&spin);
+    spinlock_unlock(&spin);
+    passed &= spinlock_trylock(&spin);
+    spinlock_unlock(&spin);
+    passed &= spin.stats.acquisitions == 2 && spin.stats.contended == 0;
+    printf("spinlock_t is %s: %u acquisitions, %u contended\n", spinlock_impl_name(),
+           spin.stats.acquisitions, spin.stats.contended);
+    print_test_result("spinlock_t counts acquisitions", passed);
+}
+
+/* 测试2: 多线程互斥
+ * 主机线程在等锁时可能被换出，排队锁的下一个持有者不在运行时交接要等一个
+ * 主机时间片；CPU少于THREADS个时只用两个线程，并在解锁后让出CPU */
+static kind_t stress_kind;
+static int stress_threads;
+static volatile int go;
+static volatile uint64_t counter;         // 防止编译器把读写移出临界区外的辅助函数
+
+static void* stress_worker(void *arg) {
+    int id = (int)(long)arg;
+    while (!go) {
+        cpu_relax();
+    }
+    for (int i = 0; i < ITERATIONS; i++) {
+        acquire(stress_kind, id);
+        // 非原子的读-改-写：互斥失效时会丢失更新
+        uint64_t v = counter;
+        cpu_relax();
+        counter = v + 1;
+        release(stress_kind, id);
+        sched_yield();
+    }
+    return NULL;
+}
+
+void test_mutual_exclusion(void) {
+    print_test_header("Mutual Exclusion Under Threads");
+    stress_threads = sysconf(_SC_NPROCESSORS_ONLN) >= THREADS ? THREADS : 2;
+    printf("%d threads x %d iterations\n", stress_threads, ITERATIONS);
+
+    for (int kind = 0; kind < KIND_NR; kind++) {
+        init_all();
+        stress_kind = (kind_t)kind;
+        counter = 0;
+        go = 0;
+
+        pthread_t threads[THREADS];
+        for (long t = 0; t < stress_threads; t++) {
+            pthread_create(&threads[t], NULL, stress_worker, (void *)t);
+        }
+        go = 1;
+        for (int t = 0; t < stress_threads; t++) {
+            pthread_join(threads[t], NULL);
+        }
+
+        int passed = counter == (uint64_t)stress_threads * ITERATIONS;
+        if (kind == KIND_SPINLOCK) {
+            passed &= spin.stats.acquisitions == (uint32_t)stress_threads * ITERATIONS;
+        }
+        printf("%s: counter %llu\n", kind_names[kind], (unsigned long long)counter);
+        print_test_result(kind_names[kind], passed);
+    }
+}
+
+/* 测试3: 排队锁按到达顺序交接 */
+static int order[THREADS];
+static int served;
+static uint32_t waited[THREADS];
+
+static void* fifo_worker(void *arg) {
+    int id = (int)(long)arg;
+    waited[id] = acquire(stress_kind, id);
+    order[served++] = id;
+    release(stress_kind, id);
+    return NULL;
+}
+
+static bool queued(kind_t kind, int id) {
+    if (kind == KIND_TICKET) {
+        return __atomic_load_n(&ticket.next, __ATOMIC_ACQUIRE) == (uint16_t)(id + 2);
+    }
+    return __atomic_load_n(&mcs.tail, __ATOMIC_ACQUIRE) == &nodes[id];
+}
+
+void test_fifo_order(void) {
+    print_test_header("FIFO Handoff");
+
+    static const kind_t kinds[] = { KIND_TICKET, KIND_MCS };
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        init_all();
+        stress_kind = kinds[k];
+        served = 0;
+
+        // 持锁期间让线程一个接一个排进队列
+        static mcs_node_t holder;
+        if (stress_kind == KIND_TICKET) {
+            ticket_lock(&ticket);
+        } else {
+            mcs_lock(&mcs, &holder);
+        }
+        pthread_t threads[THREADS];
+        for (long t = 0; t < THREADS; t++) {
+            pthread_create(&threads[t], NULL, fifo_worker, (void *)t);
+            while (!queued(stress_kind, (int)t)) {
+                sched_yield();
+            }
+        }
+        if (stress_kind == KIND_TICKET) {
+            ticket_unlock(&ticket);
+        } else {
+            mcs_unlock(&mcs, &holder);
+        }
+        for (int t = 0; t < THREADS; t++) {
+            pthread_join(threads[t], NULL);
+        }
+
+        int passed = served == THREADS;
+        for (int t = 0; t < THREADS; t++) {
+            passed &= order[t] == t && waited[t] > 0;
+        }
+        printf("%s order: %d %d %d %d\n", kind_names[stress_kind], order[0], order[1],
+               order[2], order[3]);
+        print_test_result(kind_names[stress_kind], passed);
+    }
+}
+
+/* 测试4: 读写锁 */
+static volatile int writer_done;
+
+static void* writer_worker(void *arg) {
+    (void)arg;
+    rwlock_write_lock(&rw);
+    writer_done = 1;
+    rwlock_write_unlock(&rw);
+    return NULL;
+}
+
+void test_rwlock(void) {
+    print_test_header("Reader-Writer Lock");
+    init_all();
+
+    // 读者之间共享，与写者互斥
+    int passed = rwlock_read_lock(&rw) == 0 && rwlock_read_trylock(&rw);
+    passed &= !rwlock_write_trylock(&rw);
+    rwlock_read_unlock(&rw);
+    rwlock_read_unlock(&rw);
+    passed &= rwlock_write_trylock(&rw) && !rwlock_read_trylock(&rw);
+    rwlock_write_unlock(&rw);
+    passed &= rw.cnts == 0;
+    print_test_result("Readers share, writers exclude", passed);
+
+    // 写者等待期间新读者不能插队
+    writer_done = 0;
+    rwlock_read_lock(&rw);
+    pthread_t writer;
+    pthread_create(&writer, NULL, writer_worker, NULL);
+    while (!(__atomic_load_n(&rw.cnts, __ATOMIC_ACQUIRE) & RWLOCK_WRITER_WAITING)) {
+        sched_yield();
+    }
+    passed = !rwlock_read_trylock(&rw) && !writer_done;
+    rwlock_read_unlock(&rw);
+    pthread_join(writer, NULL);
+    passed &= writer_done && rw.cnts == 0 && rwlock_read_trylock(&rw);
+    rwlock_read_unlock(&rw);
+    print_test_result("Waiting writer blocks new readers", passed);
+}
+
+/* 测试5: 调度器锁统计 */
+void test_scheduler_lock_stats(void) {
+    print_test_header("Scheduler Lock Statistics");
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+    spinlock_stats_t before = scheduler_get_lock_stats();
+    scheduler_create_process("a", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_create_process("b", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+    for (int i = 0; i < 100; i++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    spinlock_stats_t after = scheduler_get_lock_stats();
+
+    // 两次创建、一次调度、每个tick至少一次，再加上本次读取与时间片到期的重新调度
+    uint32_t taken = after.acquisitions - before.acquisitions;
+    int passed = taken >= 2 + 1 + 100 + 1;
+    passed &= after.contended == 0 && after.max_spins == 0;
+    printf("%u acquisitions during the run, %u contended\n", taken, after.contended);
+    print_test_result("Every acquisition counted", passed);
+
+    // 时钟中断也获取调度器锁：持锁期间本CPU关中断，解锁与中断返回后恢复
+    irqflags_t flags = scheduler_lock();
+    passed = irqs_disabled();
+    scheduler_unlock(flags);
+    passed &= !irqs_disabled();
+    sim_fire_irq(IRQ_TIMER);
+    passed &= !irqs_disabled();
+    print_test_result("Scheduler lock held with interrupts off", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Spinlock Test Suite\n");
+    printf("================================\n");
+
+    test_trylock();
+    test_mutual_exclusion();
+    test_fifo_order();
+    test_rwlock();
+    test_scheduler_lock_stats();
+
+    printf("\n================================\n");
+    printf("Spinlock Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * test_trace.c - 调度器跟踪点与延迟直方图测试程序
+ *
+ * 环形缓冲区与直方图部分直接调用trace接口；其余部分基于内核调度器核心与
+ * 主机平台层（tools/sim_host.c），每次 sim_fire_irq(IRQ_TIMER) 推进一个tick，
+ * 检查调度路径上的跟踪点是否记录了正确的事件与延迟。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/trace.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static void setup(void) {
+    sim_host_reset();
+    sim_current_cpu = 0;
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+}
+
+static void run_ticks(uint32_t ticks) {
+    for (uint32_t t = 0; t < ticks; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+}
+
+/* 测试1: 环形缓冲区覆盖最旧事件，按写入顺序读出 */
+void test_ring_wrap(void) {
+    print_test_header("Trace Ring Wraps and Preserves Order");
+    trace_init();
+
+    uint32_t total = TRACE_RING_SIZE + 44;
+    for (uint32_t i = 0; i < total; i++) {
+        trace_event(TRACE_SWITCH, i, i + 1, 0);
+    }
+
+    trace_event_t out[TRACE_RING_SIZE * 2];
+    uint32_t n = trace_read(0, out, TRACE_RING_SIZE * 2);
+    int passed = n == TRACE_RING_SIZE;
+    for (uint32_t i = 0; i < n; i++) {
+        passed &= out[i].ticks == total - TRACE_RING_SIZE + i;
+    }
+
+    n = trace_read(0, out, 4);
+    passed &= n == 4 && out[0].ticks == total - 4 && out[3].ticks == total - 1;
+    passed &= trace_get_cpu(0)->counts[TRACE_SWITCH] == total;
+    passed &= trace_read(1, out, 4) == 0;
+    printf("Read %u events, oldest tick %u\n", n, out[0].ticks);
+    print_test_result("Newest events kept in order", passed);
+}
+
+/* 测试2: log2分桶与百分位数 */
+void test_histogram(void) {
+    print_test_header("Log2 Histogram Percentiles");
+
+    lat_hist_t hist;
+    memset(&hist, 0, sizeof(hist));
+    lat_hist_add(&hist, 0);
+    lat_hist_add(&hist, 1);
+    lat_hist_add(&hist, 3);
+    lat_hist_add(&hist, 4);
+    lat_hist_add(&hist, 7);
+    int passed = hist.buckets[0] == 1 && hist.buckets[1] == 1 && hist.buckets[2] == 1;
+    passed &= hist.buckets[3] == 2 && hist.count == 5 && hist.max == 7;
+
+    // 99个1和1个1000：p50/p99落在[1, 2)，p100为最大值
+    memset(&hist, 0, sizeof(hist));
+    for (int i = 0; i < 99; i++) {
+        lat_hist_add(&hist, 1);
+    }
+    lat_hist_add(&hist, 1000);
+    passed &= lat_hist_percentile(&hist, 50) == 1 && lat_hist_percentile(&hist, 99) == 1;
+    passed &= lat_hist_percentile(&hist, 100) == 1000;
+
+    // 超出范围的值落入最后一个桶；桶上界不超过实际最大值
+    memset(&hist, 0, sizeof(hist));
+    lat_hist_add(&hist, 5);
+    lat_hist_add(&hist, 0xFFFFFFFFu);
+    passed &= lat_hist_percentile(&hist, 50) == 7;
+    passed &= hist.buckets[LAT_HIST_BUCKETS - 1] == 1;
+    memset(&hist, 0, sizeof(hist));
+    lat_hist_add(&hist, 5);
+    passed &= lat_hist_percentile(&hist, 99) == 5;
+    memset(&hist, 0, sizeof(hist));
+    passed &= lat_hist_percentile(&hist, 99) == 0;
+    print_test_result("Buckets and percentiles", passed);
+}
+
+/* 测试3: 睡眠唤醒后的唤醒延迟与事件 */
+void test_wakeup_latency(void) {
+    print_test_header("Wakeup Latency Recorded");
+    setup();
+
+    pcb_t *sleeper = scheduler_create_process("sleeper", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    pcb_t *hog = scheduler_create_process("hog", PROCESS_TYPE_USER, 1, PROCESS_FLAG_CPU_BOUND);
+    scheduler_schedule();
+    int passed = scheduler_get_current_process() == sleeper;
+
+    // sleeper睡3个tick后被唤醒，要等hog用完10个tick的时间片
+    scheduler_sleep_process(3);
+    passed &= scheduler_get_current_process() == hog;
+    uint32_t woke_at = 0;
+    for (uint32_t t = 0; t < 30 && scheduler_get_current_process() != sleeper; t++) {
+        sim_fire_irq(IRQ_TIMER);
+        if (!woke_at && sleeper->state == PROCESS_READY) {
+            woke_at = scheduler_get_ticks();
+        }
+    }
+    uint32_t expected = scheduler_get_ticks() - woke_at;
+    passed &= scheduler_get_current_process() == sleeper;
+
+    const trace_cpu_t *trace = trace_get_cpu(0);
+    passed &= trace->counts[TRACE_BLOCK] == 1 && trace->counts[TRACE_WAKEUP] == 1;
+    passed &= trace->wake_latency.count == 1 && trace->wake_latency.max == expected;
+    passed &= trace->runq_wait.count >= trace->wake_latency.count;
+    printf("Woke at tick %u, ran at tick %u, latency %u (expected %u)\n", woke_at,
+           scheduler_get_ticks(), trace->wake_latency.max, expected);
+
+    trace_event_t last;
+    passed &= trace_read(0, &last, 1) == 1;
+    passed &= last.type == TRACE_SWITCH && last.pid == sleeper->pid && last.arg == hog->pid;
+
+    scheduler_print_status();
+    print_test_result("Wake-to-run latency and events", passed);
+}
+
+/* 测试4: 进程换到另一个CPU上运行时记录迁移 */
+void test_migration(void) {
+    print_test_header("Migration Event on CPU Change");
+    setup();
+
+    pcb_t *a = scheduler_create_process("a", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    pcb_t *b = scheduler_create_process("b", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+    scheduler_yield();
+    int passed = a->cold->last_cpu == 0 && b->cold->last_cpu == 0;
+
+    // 在CPU1上切回a
+    sim_current_cpu = 1;
+    scheduler_yield();
+    const trace_cpu_t *trace = trace_get_cpu(1);
+    trace_event_t ev;
+    passed &= trace_read(1, &ev, 1) == 1 && ev.type == TRACE_SWITCH;
+    passed &= trace->counts[TRACE_MIGRATE] == 1 && a->cold->last_cpu == 1;
+    passed &= trace_get_cpu(0)->counts[TRACE_MIGRATE] == 0;
+    sim_current_cpu = 0;
+
+    printf("a last ran on cpu%u, %u migration(s) on cpu1\n", a->cold->last_cpu,
+           trace->counts[TRACE_MIGRATE]);
+    print_test_result("Migration traced on the new CPU", passed);
+}
+
+/* 测试5: 重新初始化后利用率与吞吐量重新计算 */
+void test_stats_reset(void) {
+    print_test_header("Utilization Window Reset on Reinit");
+
+    // 先空闲运行一段较长时间
+    setup();
+    run_ticks(500);
+    int passed = scheduler_get_stats().cpu_utilization == 0;
+
+    // 重新初始化后时钟从0开始，新窗口不能沿用上一轮的采样点
+    setup();
+    scheduler_create_process("busy", PROCESS_TYPE_USER, 1, PROCESS_FLAG_CPU_BOUND);
+    scheduler_schedule();
+    run_ticks(150);
+    scheduler_stats_t stats = scheduler_get_stats();
+    printf("Utilization after reinit: %u%%\n", stats.cpu_utilization);
+    passed &= stats.cpu_utilization == 100;
+    print_test_result("Stats recomputed after reinit", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Scheduler Trace Test Suite\n");
+    printf("================================\n");
+
+    test_ring_wrap();
+    test_histogram();
+    test_wakeup_latency();
+    test_migration();
+    test_stats_reset();
+
+    printf("\n================================\n");
+    printf("Trace Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
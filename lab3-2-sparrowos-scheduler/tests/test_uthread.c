@@ -0,0 +1,348 @@
+/**
+ * test_uthread.c - 绿色线程运行时测试程序
+ *
+ * 检查 uthread 运行时（uthread/）：FIFO让出顺序、RR下 preempt_point 的
+ * 时间片轮转、MLFQ对计算密集线程的降级、睡眠定时、经epoll的管道往返
+ * （1个与4个工作线程）、join，以及M:N下大量绿色线程的计数一致性。
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "uthread/include/uthread.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void init(uthread_policy_t policy, uint32_t workers, uint32_t quantum_ms) {
+    uthread_config_t config = {
+        .policy = policy,
+        .workers = workers,
+        .quantum_ms = quantum_ms,
+        .boost_ms = 0,
+        .stack_size = 0
+    };
+    if (uthread_init(&config) != 0) {
+        printf("uthread_init failed\n");
+        exit(1);
+    }
+}
+
+/* ========== 测试1: FIFO让出顺序 ========== */
+
+static int order[16];
+static int order_len;
+
+static void fifo_worker(void *arg) {
+    int id = (int)(intptr_t)arg;
+    for (int round = 0; round < 3; round++) {
+        order[order_len++] = id;
+        uthread_yield();
+    }
+}
+
+void test_fifo_order(void) {
+    print_test_header("FIFO Yield Order");
+    init(UTHREAD_FIFO, 1, 0);
+    order_len = 0;
+    for (int i = 1; i <= 3; i++) {
+        uthread_create(fifo_worker, (void *)(intptr_t)i, 0);
+    }
+    uthread_run();
+
+    static const int expected[9] = { 1, 2, 3, 1, 2, 3, 1, 2, 3 };
+    int passed = order_len == 9 && memcmp(order, expected, sizeof(expected)) == 0;
+    printf("Order:");
+    for (int i = 0; i < order_len; i++) {
+        printf(" %d", order[i]);
+    }
+    printf("\n");
+    print_test_result("Yield puts the thread behind every other ready thread", passed);
+}
+
+/* ========== 测试2: RR时间片 ========== */
+
+static volatile int last_runner;
+static int handoffs;
+
+static void spinner(void *arg) {
+    int id = (int)(intptr_t)arg;
+    uint64_t end = now_us() + 60000;
+    while (now_us() < end) {
+        if (last_runner != id) {
+            last_runner = id;
+            handoffs++;
+        }
+        uthread_preempt_point();
+    }
+}
+
+static int run_spinners(uthread_policy_t policy) {
+    init(policy, 1, 5);
+    last_runner = 0;
+    handoffs = 0;
+    uthread_create(spinner, (void *)1, 0);
+    uthread_create(spinner, (void *)2, 0);
+    uthread_run();
+    return handoffs;
+}
+
+void test_rr_preempt_point(void) {
+    print_test_header("Round Robin Preempt Point");
+    int fifo = run_spinners(UTHREAD_FIFO);
+    int rr = run_spinners(UTHREAD_RR);
+    printf("Handoffs over 60 ms + 60 ms of spinning: FIFO %d, RR (5 ms quantum) %d\n", fifo, rr);
+    print_test_result("FIFO runs each spinner to completion", fifo == 2);
+    print_test_result("RR interleaves the spinners", rr >= 6);
+}
+
+/* ========== 测试3: MLFQ降级 ========== */
+
+static uint8_t hog_level, sleeper_level;
+static volatile int hog_done;
+
+static void hog(void *arg) {
+    (void)arg;
+    uint64_t end = now_us() + 150000;
+    while (now_us() < end) {
+        uthread_preempt_point();
+    }
+    hog_level = uthread_level(uthread_self());
+    hog_done = 1;
+}
+
+static void sleeper(void *arg) {
+    (void)arg;
+    while (!hog_done) {
+        uthread_sleep(2);
+    }
+    sleeper_level = uthread_level(uthread_self());
+}
+
+void test_mlfq_demotion(void) {
+    print_test_header("MLFQ Demotion");
+    init(UTHREAD_MLFQ, 1, 0);
+    hog_done = 0;
+    uthread_create(hog, NULL, 0);
+    uthread_create(sleeper, NULL, 0);
+    uthread_run();
+
+    printf("Hog ended at level %u, sleeper at level %u\n", hog_level, sleeper_level);
+    print_test_result("CPU hog sinks below the sleeper", hog_level > 0 && sleeper_level == 0);
+}
+
+/* ========== 测试4: 睡眠 ========== */
+
+static uint64_t slept_us[3];
+
+static void timed_sleeper(void *arg) {
+    int i = (int)(intptr_t)arg;
+    uint64_t start = now_us();
+    uthread_sleep(10 * (i + 1));
+    slept_us[i] = now_us() - start;
+}
+
+void test_sleep(void) {
+    print_test_header("Sleep Timing");
+    init(UTHREAD_RR, 2, 0);
+    // 后创建的睡得短，检查按唤醒时刻排序
+    for (int i = 2; i >= 0; i--) {
+        uthread_create(timed_sleeper, (void *)(intptr_t)i, 0);
+    }
+    uthread_run();
+
+    int passed = 1;
+    for (int i = 0; i < 3; i++) {
+        uint64_t want = 10000 * (i + 1);
+        printf("sleep(%d ms) took %.1f ms\n", 10 * (i + 1), slept_us[i] / 1000.0);
+        passed &= slept_us[i] >= want - 1000 && slept_us[i] < want + 100000;
+    }
+    uthread_stats_t stats = uthread_get_stats();
+    passed &= stats.sleeps == 3;
+    print_test_result("Each sleeper wakes after its own deadline", passed);
+}
+
+/* ========== 测试5: 管道往返 ========== */
+
+#define PINGPONG_ROUNDS 2000
+
+static int ping[2], pong[2];
+static int pingpong_ok;
+
+static void pinger(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < PINGPONG_ROUNDS; i++) {
+        uint32_t reply;
+        if (uthread_write(ping[1], &i, sizeof(i)) != sizeof(i) ||
+            uthread_read(pong[0], &reply, sizeof(reply)) != sizeof(reply) || reply != i + 1) {
+            pingpong_ok = 0;
+            return;
+        }
+    }
+}
+
+static void ponger(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < PINGPONG_ROUNDS; i++) {
+        uint32_t value;
+        if (uthread_read(ping[0], &value, sizeof(value)) != sizeof(value)) {
+            pingpong_ok = 0;
+            return;
+        }
+        value++;
+        if (uthread_write(pong[1], &value, sizeof(value)) != sizeof(value)) {
+            pingpong_ok = 0;
+            return;
+        }
+    }
+}
+
+static void run_pingpong(uint32_t workers) {
+    init(UTHREAD_RR, workers, 0);
+    if (pipe(ping) != 0 || pipe(pong) != 0) {
+        print_test_result("pipe", 0);
+        return;
+    }
+    for (int i = 0; i < 2; i++) {
+        uthread_set_nonblock(ping[i]);
+        uthread_set_nonblock(pong[i]);
+    }
+    pingpong_ok = 1;
+    uint64_t start = now_us();
+    // 先创建读者，保证它会在空管道上挂起
+    uthread_create(ponger, NULL, 0);
+    uthread_create(pinger, NULL, 0);
+    uthread_run();
+    uint64_t elapsed = now_us() - start;
+    uthread_stats_t stats = uthread_get_stats();
+
+    for (int i = 0; i < 2; i++) {
+        close(ping[i]);
+        close(pong[i]);
+    }
+
+    char name[64];
+    printf("%u worker(s): %d round trips in %.1f ms, %llu I/O waits\n", workers,
+           PINGPONG_ROUNDS, elapsed / 1000.0, (unsigned long long)stats.io_waits);
+    snprintf(name, sizeof(name), "Ping-pong over epoll with %u worker(s)", workers);
+    print_test_result(name, pingpong_ok && stats.io_waits > 0 && stats.exited == 2);
+}
+
+void test_pingpong(void) {
+    print_test_header("Pipe Ping-Pong");
+    run_pingpong(1);
+    run_pingpong(4);
+}
+
+/* ========== 测试6: join ========== */
+
+static volatile int child_done;
+static int joined_after_child;
+
+static void child(void *arg) {
+    (void)arg;
+    uthread_sleep(10);
+    child_done = 1;
+}
+
+static void parent(void *arg) {
+    (void)arg;
+    uthread_t *c = uthread_create(child, NULL, 0);
+    uthread_join(c);
+    joined_after_child = child_done;
+    // 已退出的线程立即返回
+    joined_after_child &= uthread_join(c) == 0;
+}
+
+void test_join(void) {
+    print_test_header("Join");
+    init(UTHREAD_RR, 2, 0);
+    child_done = 0;
+    joined_after_child = 0;
+    uthread_create(parent, NULL, 0);
+    uthread_run();
+    print_test_result("join returns only after the child exits", joined_after_child);
+}
+
+/* ========== 测试7: M:N ========== */
+
+#define MN_THREADS      200
+#define MN_ITERATIONS   500
+
+static volatile uint64_t shared_counter;
+static uint64_t worker_hits[UTHREAD_MAX_WORKERS];
+
+static void mn_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < MN_ITERATIONS; i++) {
+        __atomic_fetch_add(&shared_counter, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&worker_hits[uthread_worker_id()], 1, __ATOMIC_RELAXED);
+        uthread_yield();
+    }
+}
+
+void test_many_to_many(void) {
+    print_test_header("M:N Scheduling");
+    const uint32_t workers = 4;
+    init(UTHREAD_RR, workers, 0);
+    shared_counter = 0;
+    memset(worker_hits, 0, sizeof(worker_hits));
+    for (int i = 0; i < MN_THREADS; i++) {
+        uthread_create(mn_worker, NULL, (uint8_t)(i % 4));
+    }
+    uthread_run();
+    uthread_stats_t stats = uthread_get_stats();
+
+    printf("%d green threads on %u workers: counter %llu, switches %llu, per worker:",
+           MN_THREADS, workers, (unsigned long long)shared_counter,
+           (unsigned long long)stats.switches);
+    for (uint32_t i = 0; i < workers; i++) {
+        printf(" %llu", (unsigned long long)worker_hits[i]);
+    }
+    printf("\n");
+    int passed = shared_counter == (uint64_t)MN_THREADS * MN_ITERATIONS;
+    passed &= stats.created == MN_THREADS && stats.exited == MN_THREADS;
+    print_test_result("Every increment from every green thread lands", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Green Thread Runtime Test Suite\n");
+    printf("================================\n");
+
+    test_fifo_order();
+    test_rr_preempt_point();
+    test_mlfq_demotion();
+    test_sleep();
+    test_pingpong();
+    test_join();
+    test_many_to_many();
+
+    printf("\n================================\n");
+    printf("Green Thread Runtime Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,288 @@
+/**
+ * test_wakelist.c - 中断上下文无锁唤醒测试程序
+ *
+ * 前半部分基于内核调度器核心与主机平台层（tools/sim_host.c）：模拟磁盘中断
+ * 调用 scheduler_wakeup_from_irq，检查唤醒推迟到下一个调度点才生效。
+ * 后半部分直接对 wake_list_t 做多线程压力测试，验证多生产者并发入链时
+ * 不丢失、不重复。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/wakelist.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+static pcb_t *irq_target;       // 磁盘中断要唤醒的进程
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+static void disk_irq(void) {
+    scheduler_wakeup_from_irq(irq_target);
+}
+
+static void setup(void) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_RR,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+    interrupt_register_handler(IRQ_DISK, disk_irq);
+}
+
+/* 创建两个进程并让第一个阻塞在IO上 */
+static pcb_t* block_one(pcb_t **other) {
+    pcb_t *io = scheduler_create_process("io", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    *other = scheduler_create_process("cpu", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+    scheduler_block_process(WAIT_REASON_IO);
+    return io;
+}
+
+/* 测试1: 中断中的唤醒推迟到下一个tick */
+void test_deferred_wakeup(void) {
+    print_test_header("IRQ Wakeup Deferred to Next Scheduling Point");
+    setup();
+
+    pcb_t *cpu;
+    pcb_t *io = block_one(&cpu);
+    int passed = io->state == PROCESS_BLOCKED && scheduler_get_current_process() == cpu;
+
+    irq_target = io;
+    sim_fire_irq(IRQ_DISK);
+    passed &= io->state == PROCESS_BLOCKED && io->cold->wake_pending == 1;
+
+    sim_fire_irq(IRQ_TIMER);
+    passed &= io->state == PROCESS_READY && io->cold->wake_pending == 0;
+    passed &= io->cold->wake_next == NULL;
+    printf("After tick: io state %d, current %s\n", io->state,
+           scheduler_get_current_process()->cold->name);
+    print_test_result("Woken process enqueued at next tick", passed);
+}
+
+/* 测试2: 调度点处理前的重复唤醒被合并，进程只入队一次 */
+void test_coalescing(void) {
+    print_test_header("Duplicate IRQ Wakeups Coalesce");
+    setup();
+
+    pcb_t *cpu;
+    pcb_t *io = block_one(&cpu);
+
+    irq_target = io;
+    sim_fire_irq(IRQ_DISK);
+    sim_fire_irq(IRQ_DISK);
+    sim_fire_irq(IRQ_DISK);
+
+    // 主动调度同样是调度点
+    scheduler_yield();
+    int passed = scheduler_get_current_process() == io && cpu->state == PROCESS_READY;
+
+    // 若io被重复入队，之后的轮转中io会连续被选中
+    pcb_t *seen[4];
+    for (int i = 0; i < 4; i++) {
+        pcb_t *prev = scheduler_get_current_process();
+        for (int t = 0; t < 100 && scheduler_get_current_process() == prev; t++) {
+            sim_fire_irq(IRQ_TIMER);
+        }
+        seen[i] = scheduler_get_current_process();
+    }
+    passed &= seen[0] == cpu && seen[1] == io && seen[2] == cpu && seen[3] == io;
+    print_test_result("Single enqueue for repeated wakeups", passed);
+}
+
+/* 测试3: 入链后已被同步唤醒或退出的进程不会再次入队，待处理的PCB不会被提前回收 */
+void test_stale_and_reap(void) {
+    print_test_header("Stale Wakeups and Reaping");
+    setup();
+
+    pcb_t *cpu;
+    pcb_t *io = block_one(&cpu);
+
+    irq_target = io;
+    sim_fire_irq(IRQ_DISK);
+    int passed = scheduler_wakeup_process(io->pid) == 0;    // 同步路径抢先唤醒
+    sim_fire_irq(IRQ_TIMER);
+    passed &= io->state == PROCESS_READY && io->cold->wake_pending == 0;
+
+    // 进程退出后才处理唤醒：回收时先清空唤醒链表
+    irq_target = cpu;
+    sim_fire_irq(IRQ_DISK);
+    uint32_t pid = cpu->pid;
+    scheduler_terminate_process(pid, 0);
+    passed &= scheduler_reap_process(pid) == 0;
+    passed &= scheduler_get_process(pid) == NULL;
+
+    scheduler_print_status();
+    print_test_result("Stale entries ignored, reap waits for list", passed);
+}
+
+/* ========== 多生产者压力测试 ========== */
+
+#define PRODUCERS       4
+#define PCBS_PER_PROD   64
+#define ROUNDS          2000
+
+static wake_list_t stress_list;
+static pcb_t stress_pcbs[PRODUCERS][PCBS_PER_PROD];
+static pcb_cold_t stress_cold[PRODUCERS][PCBS_PER_PROD];
+static uint32_t seen_count[PRODUCERS][PCBS_PER_PROD];
+static volatile int go;
+
+/* 每个生产者反复唤醒自己的一组PCB，上一次唤醒被处理后再唤醒下一次 */
+static void* producer(void *arg) {
+    long id = (long)arg;
+    while (!go) {
+    }
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < PCBS_PER_PROD; i++) {
+            pcb_t *pcb = &stress_pcbs[id][i];
+            while (__atomic_load_n(&pcb->cold->wake_pending, __ATOMIC_ACQUIRE)) {
+                __builtin_ia32_pause();
+            }
+            wake_list_push(&stress_list, pcb);
+        }
+    }
+    return NULL;
+}
+
+/* 所有生产者争用同一组PCB，验证合并计数 */
+static void* contender(void *arg) {
+    (void)arg;
+    while (!go) {
+    }
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < PCBS_PER_PROD; i++) {
+            wake_list_push(&stress_list, &stress_pcbs[0][i]);
+        }
+    }
+    return NULL;
+}
+
+/* 消费者：批量取走并记录每个PCB出链的次数 */
+static uint32_t consume_until(uint32_t target, const volatile int *producers_done) {
+    uint32_t total = 0;
+    for (;;) {
+        int done = *producers_done;
+        pcb_t *pcb = wake_list_take_all(&stress_list);
+        if (pcb) {
+            stress_list.batches++;
+        }
+        while (pcb) {
+            long prod = (pcb - &stress_pcbs[0][0]) / PCBS_PER_PROD;
+            long idx = (pcb - &stress_pcbs[0][0]) % PCBS_PER_PROD;
+            seen_count[prod][idx]++;
+            pcb = wake_list_pop(pcb);
+            total++;
+        }
+        if (total >= target || (done && wake_list_empty(&stress_list))) {
+            return total;
+        }
+    }
+}
+
+static void stress_setup(void) {
+    wake_list_init(&stress_list);
+    memset(stress_pcbs, 0, sizeof(stress_pcbs));
+    memset(stress_cold, 0, sizeof(stress_cold));
+    memset(seen_count, 0, sizeof(seen_count));
+    for (int p = 0; p < PRODUCERS; p++) {
+        for (int i = 0; i < PCBS_PER_PROD; i++) {
+            stress_pcbs[p][i].cold = &stress_cold[p][i];
+        }
+    }
+    go = 0;
+}
+
+void test_mpsc_stress(void) {
+    print_test_header("Multi-Producer Stress");
+    stress_setup();
+
+    static volatile int done = 0;
+    pthread_t threads[PRODUCERS];
+    for (long p = 0; p < PRODUCERS; p++) {
+        pthread_create(&threads[p], NULL, producer, (void *)p);
+    }
+    go = 1;
+
+    uint32_t expected = PRODUCERS * PCBS_PER_PROD * ROUNDS;
+    uint32_t total = consume_until(expected, &done);
+    for (int p = 0; p < PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+    }
+
+    int passed = total == expected && wake_list_empty(&stress_list);
+    passed &= stress_list.pushed == expected && stress_list.coalesced == 0;
+    for (int p = 0; p < PRODUCERS; p++) {
+        for (int i = 0; i < PCBS_PER_PROD; i++) {
+            passed &= seen_count[p][i] == ROUNDS;
+            passed &= stress_cold[p][i].wake_pending == 0;
+        }
+    }
+    printf("Drained %u wakeups in %u batches (avg %.1f per batch)\n",
+           total, stress_list.batches, (double)total / stress_list.batches);
+    print_test_result("No lost or duplicated wakeups", passed);
+
+    // 多个生产者同时唤醒同一组PCB：每次唤醒要么入链要么被合并
+    stress_setup();
+    done = 0;
+    for (long p = 0; p < PRODUCERS; p++) {
+        pthread_create(&threads[p], NULL, contender, NULL);
+    }
+    go = 1;
+
+    uint32_t drained = 0;
+    uint32_t attempts = PRODUCERS * PCBS_PER_PROD * ROUNDS;
+    while (__atomic_load_n(&stress_list.pushed, __ATOMIC_RELAXED) +
+           __atomic_load_n(&stress_list.coalesced, __ATOMIC_RELAXED) < attempts) {
+        drained += consume_until(0, &done);
+    }
+    for (int p = 0; p < PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+    }
+    done = 1;
+    drained += consume_until(UINT32_MAX, &done);
+
+    passed = stress_list.pushed + stress_list.coalesced == attempts;
+    passed &= drained == stress_list.pushed && stress_list.coalesced > 0;
+    printf("Attempts %u: %u pushed, %u coalesced, %u drained\n",
+           attempts, stress_list.pushed, stress_list.coalesced, drained);
+    print_test_result("Concurrent duplicates coalesce", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("IRQ Wake List Test Suite\n");
+    printf("================================\n");
+
+    test_deferred_wakeup();
+    test_coalescing();
+    test_stale_and_reap();
+    test_mpsc_stress();
+
+    printf("\n================================\n");
+    printf("Wake List Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+/**
+ * test_wakeup_preempt.c - 唤醒抢占测试程序
+ *
+ * 前半部分直接构造PCB检查 should_preempt() 的判定：只有交互型/IO型进程
+ * 唤醒时抢占，且受最短运行时间与vruntime粒度限制；后半部分基于内核
+ * 调度器核心与主机平台层（tools/sim_host.c），检查开启 wakeup_preemption
+ * 后被唤醒的交互型进程在下一个tick就抢占计算型进程，关闭时不抢占；
+ * 同步唤醒（scheduler_wakeup_process）在返回前就切换到被唤醒者；
+ * 长时间睡眠后醒来的进程与新建进程都按min_vruntime放置，不带着很小的
+ * vruntime领先其他进程。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel/include/scheduler.h"
+#include "tools/sim_host.h"
+
+static int failures = 0;
+
+/* 测试辅助函数 */
+static void print_test_header(const char* test_name) {
+    printf("\n================================\n");
+    printf("Test: %s\n", test_name);
+    printf("================================\n");
+}
+
+static void print_test_result(const char* test_name, int passed) {
+    printf("%s: %s\n", test_name, passed ? "✓ PASS" : "✗ FAIL");
+    if (!passed) {
+        failures++;
+    }
+}
+
+/* ========== should_preempt ========== */
+
+static pcb_t cur_pcb, next_pcb;
+static pcb_cold_t cur_cold, next_cold;
+
+static void make_pair(process_flags_t cur_flags, process_flags_t next_flags) {
+    memset(&cur_pcb, 0, sizeof(pcb_t));
+    memset(&next_pcb, 0, sizeof(pcb_t));
+    memset(&cur_cold, 0, sizeof(pcb_cold_t));
+    memset(&next_cold, 0, sizeof(pcb_cold_t));
+    cur_pcb.cold = &cur_cold;
+    next_pcb.cold = &next_cold;
+    cur_pcb.flags = cur_flags;
+    next_pcb.flags = next_flags;
+
+    // 当前进程已运行一段时间、vruntime明显落后
+    cur_pcb.time_slice_used = WAKEUP_MIN_RUN;
+    cur_pcb.vruntime = 100;
+    next_pcb.vruntime = 100 - WAKEUP_GRANULARITY;
+}
+
+/* 测试1: 判定规则 */
+void test_should_preempt(void) {
+    print_test_header("should_preempt Rules");
+
+    make_pair(PROCESS_FLAG_CPU_BOUND, PROCESS_FLAG_INTERACTIVE);
+    int passed = should_preempt(&cur_pcb, &next_pcb);
+    passed &= !should_preempt(NULL, &next_pcb) && !should_preempt(&cur_pcb, NULL);
+    passed &= !should_preempt(&cur_pcb, &cur_pcb);
+    next_pcb.flags = PROCESS_FLAG_IO_BOUND;
+    passed &= should_preempt(&cur_pcb, &next_pcb);
+    print_test_result("Interactive and IO-bound wakers preempt a CPU hog", passed);
+
+    // 计算型的waker（测得的睡眠占比也低）不抢占；不抢占交互型进程
+    make_pair(PROCESS_FLAG_NONE, PROCESS_FLAG_CPU_BOUND);
+    passed = !should_preempt(&cur_pcb, &next_pcb);
+    next_cold.interactivity.sleep_avg = INTERACTIVE_THRESHOLD;
+    passed &= should_preempt(&cur_pcb, &next_pcb);
+    make_pair(PROCESS_FLAG_INTERACTIVE, PROCESS_FLAG_INTERACTIVE);
+    passed &= !should_preempt(&cur_pcb, &next_pcb);
+    print_test_result("Only interactive wakers, never over an interactive task", passed);
+
+    // 粒度限制
+    make_pair(PROCESS_FLAG_CPU_BOUND, PROCESS_FLAG_INTERACTIVE);
+    next_pcb.vruntime = 100 - WAKEUP_GRANULARITY + 1;
+    passed = !should_preempt(&cur_pcb, &next_pcb);
+    next_pcb.vruntime = 100 - WAKEUP_GRANULARITY;
+    cur_pcb.time_slice_used = WAKEUP_MIN_RUN - 1;
+    passed &= !should_preempt(&cur_pcb, &next_pcb);
+    print_test_result("vruntime lead and minimum run are both required", passed);
+
+    // MLFQ：级别更高时不看vruntime
+    make_pair(PROCESS_FLAG_SCHED_MLFQ, PROCESS_FLAG_SCHED_MLFQ | PROCESS_FLAG_INTERACTIVE);
+    next_pcb.vruntime = 200;
+    cur_pcb.queue_level = 2;
+    next_pcb.queue_level = 1;
+    passed = should_preempt(&cur_pcb, &next_pcb);
+    next_pcb.queue_level = 2;
+    passed &= !should_preempt(&cur_pcb, &next_pcb);
+    print_test_result("Higher MLFQ level preempts regardless of vruntime", passed);
+}
+
+/* ========== 调度器集成 ========== */
+
+static void setup(uint32_t type, bool wakeup) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = type,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500,
+        .wakeup_preemption = wakeup
+    };
+    scheduler_init(&config);
+}
+
+/* 编辑器先运行并阻塞，计算进程运行hog_ticks后编辑器被唤醒，
+ * 返回再过一个tick时的当前进程 */
+static pcb_t* wake_during_hog(uint32_t type, bool wakeup, uint32_t hog_ticks,
+                              pcb_t **editor_out, pcb_t **other_out) {
+    setup(type, wakeup);
+    pcb_t *editor = scheduler_create_process("editor", PROCESS_TYPE_USER, 1,
+                                             PROCESS_FLAG_INTERACTIVE);
+    scheduler_create_process("hog", PROCESS_TYPE_USER, 1, PROCESS_FLAG_CPU_BOUND);
+    pcb_t *other = scheduler_create_process("other", PROCESS_TYPE_USER, 1,
+                                            PROCESS_FLAG_CPU_BOUND);
+    scheduler_schedule();
+    scheduler_block_process(WAIT_REASON_IO);
+    scheduler_schedule();
+
+    for (uint32_t t = 0; t < hog_ticks; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    scheduler_wakeup_process(editor->pid);
+    sim_fire_irq(IRQ_TIMER);
+
+    *editor_out = editor;
+    if (other_out) {
+        *other_out = other;
+    }
+    return scheduler_get_current_process();
+}
+
+/* 测试2: RR与MLFQ中的唤醒抢占 */
+void test_scheduler(void) {
+    print_test_header("Wake-Up Preemption in the Scheduler");
+
+    pcb_t *editor, *other;
+    // 排在其他就绪进程之前：插到队首
+    int passed = wake_during_hog(SCHEDULER_RR, true, 5, &editor, &other) == editor;
+    passed &= scheduler_get_stats().wakeup_preemptions == 1;
+    passed &= other->state == PROCESS_READY;
+    print_test_result("RR: woken editor runs on the next tick", passed);
+
+    passed = wake_during_hog(SCHEDULER_RR, false, 5, &editor, NULL) != editor;
+    passed &= scheduler_get_stats().wakeup_preemptions == 0;
+    print_test_result("RR: disabled by default", passed);
+
+    // 当前进程刚开始时间片：不抢占
+    passed = wake_during_hog(SCHEDULER_RR, true, 0, &editor, NULL) != editor;
+    passed &= scheduler_get_stats().wakeup_preemptions == 0;
+    print_test_result("RR: no preemption before the minimum run", passed);
+
+    passed = wake_during_hog(SCHEDULER_MLFQ, true, 5, &editor, NULL) == editor;
+    passed &= scheduler_get_stats().wakeup_preemptions == 1;
+    scheduler_print_status();
+    print_test_result("MLFQ: woken editor runs on the next tick", passed);
+}
+
+/* 测试3: 同步唤醒在返回前就完成切换，不等下一个tick */
+void test_sync_wakeup(void) {
+    print_test_header("Synchronous Wake-Up Switches Immediately");
+
+    setup(SCHEDULER_RR, true);
+    pcb_t *editor = scheduler_create_process("editor", PROCESS_TYPE_USER, 1,
+                                             PROCESS_FLAG_INTERACTIVE);
+    pcb_t *hog = scheduler_create_process("hog", PROCESS_TYPE_USER, 1,
+                                          PROCESS_FLAG_CPU_BOUND);
+    scheduler_schedule();
+    scheduler_block_process(WAIT_REASON_IO);
+    scheduler_schedule();
+    for (int t = 0; t < 5; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+
+    uint32_t ticks = scheduler_get_ticks();
+    int passed = scheduler_get_current_process() == hog;
+    passed &= scheduler_wakeup_process(editor->pid) == 0;
+    passed &= scheduler_get_current_process() == editor;
+    passed &= editor->state == PROCESS_RUNNING && hog->state == PROCESS_READY;
+    passed &= scheduler_get_ticks() == ticks;
+    passed &= scheduler_get_stats().wakeup_preemptions == 1;
+    print_test_result("RR: woken editor runs before the next tick", passed);
+
+    // 关闭唤醒抢占：唤醒只让编辑器就绪
+    setup(SCHEDULER_RR, false);
+    editor = scheduler_create_process("editor", PROCESS_TYPE_USER, 1,
+                                      PROCESS_FLAG_INTERACTIVE);
+    hog = scheduler_create_process("hog", PROCESS_TYPE_USER, 1, PROCESS_FLAG_CPU_BOUND);
+    scheduler_schedule();
+    scheduler_block_process(WAIT_REASON_IO);
+    scheduler_schedule();
+    for (int t = 0; t < 5; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    scheduler_wakeup_process(editor->pid);
+    passed = scheduler_get_current_process() == hog && editor->state == PROCESS_READY;
+    print_test_result("RR: no switch on wake-up when disabled", passed);
+}
+
+/* 测试4: 长睡眠进程与新建进程按min_vruntime放置 */
+void test_placement(void) {
+    print_test_header("Sleepers and New Tasks Start Near min_vruntime");
+
+    setup(SCHEDULER_RR, true);
+    pcb_t *sleeper = scheduler_create_process("sleeper", PROCESS_TYPE_USER, 1,
+                                              PROCESS_FLAG_INTERACTIVE);
+    pcb_t *hog = scheduler_create_process("hog", PROCESS_TYPE_USER, 1,
+                                          PROCESS_FLAG_CPU_BOUND);
+    scheduler_schedule();
+    scheduler_sleep_process(1000);
+    scheduler_schedule();
+    for (int t = 0; t < 900; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+
+    // 新进程从min_vruntime起步，而不是0
+    pcb_t *fresh = scheduler_create_process("fresh", PROCESS_TYPE_USER, 1,
+                                            PROCESS_FLAG_CPU_BOUND);
+    int32_t lead = (int32_t)(hog->vruntime - fresh->vruntime);
+    int passed = hog->vruntime >= 900 - 1 && lead >= 0 && lead <= MIN_VRUNTIME_INTERVAL;
+    printf("hog vruntime %u, fresh task starts at %u\n", hog->vruntime, fresh->vruntime);
+    print_test_result("New task starts at min_vruntime", passed);
+
+    // 睡眠到期：vruntime拉到min_vruntime - WAKEUP_GRANULARITY，仍能抢占一次
+    for (int t = 0; t < 200 && sleeper->state == PROCESS_SLEEPING; t++) {
+        sim_fire_irq(IRQ_TIMER);
+    }
+    uint32_t floor = hog->vruntime < fresh->vruntime ? hog->vruntime : fresh->vruntime;
+    lead = (int32_t)(floor - sleeper->vruntime);
+    passed = sleeper->state != PROCESS_SLEEPING;
+    passed &= lead <= WAKEUP_GRANULARITY + MIN_VRUNTIME_INTERVAL;
+    passed &= scheduler_get_stats().wakeup_preemptions == 1;
+    printf("sleeper woke at vruntime %u, %d behind the others\n", sleeper->vruntime, lead);
+    print_test_result("Long sleeper keeps at most one granularity of lead", passed);
+}
+
+/* 主函数 */
+int main(void) {
+    printf("Wake-Up Preemption Test Suite\n");
+    printf("================================\n");
+
+    test_should_preempt();
+    test_scheduler();
+    test_sync_wakeup();
+    test_placement();
+
+    printf("\n================================\n");
+    printf("Wake-Up Preemption Test Suite Complete: %d failure(s)\n", failures);
+    printf("================================\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,458 @@
+/**
+ * affinity_sim.c - 缓存亲和放置的多CPU模拟实验
+ *
+ * 模拟N个CPU，每个CPU一个先来先服务的就绪队列（时间片轮转）。任务到达
+ * 或IO完成时由内核的 placement_select_cpu()（kernel/core/placement.c）
+ * 选择CPU；CPU空闲而本地队列为空时从最长的队列拉取一个
+ * placement_can_pull() 允许迁移的任务。
+ *
+ * 缓存模型：任务开始运行时若换了CPU，需付出完整的缓存重填代价
+ * （-r 个tick，计入任务的计算量）；留在原CPU且期间没有其他任务运行过
+ * 则没有代价；否则代价按离上次运行的时间线性增长，经过 -d 个tick后
+ * 缓存被其他任务完全冲掉，与迁移无异。
+ * 对每个迁移代价阈值输出一行CSV：迁移次数、重填代价与延迟。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "kernel/include/placement.h"
+#include "sim_workload.h"
+
+#define MAX_SWEEP_VALUES 32
+#define NO_TASK          UINT32_MAX
+
+/* 任务的运行时状态 */
+typedef struct {
+    const sim_task_spec_t *spec;
+    pcb_t pcb;
+    uint32_t phase;             // 当前阶段下标
+    uint32_t remaining;         // 当前CPU阶段剩余tick（含重填代价）
+    uint32_t ready_since;       // 最近一次被唤醒的时刻
+    uint32_t next;              // 就绪队列中的下一个任务
+    bool waking;                // 已唤醒但尚未重新运行
+} aff_task_t;
+
+/* 每CPU就绪队列与当前任务 */
+typedef struct {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t queued;
+    uint32_t current;
+    uint32_t slice_used;
+    uint32_t last_task;         // 上一个在该CPU上运行的任务
+} aff_cpu_t;
+
+/* IO完成事件（按时间排序的二叉堆） */
+typedef struct {
+    uint32_t time;
+    uint32_t task;
+} aff_event_t;
+
+typedef struct {
+    aff_event_t *events;
+    uint32_t count;
+    uint32_t capacity;
+} event_heap_t;
+
+typedef struct {
+    uint32_t num_cpus;
+    uint32_t quantum;
+    uint32_t refill;            // 迁移后的缓存重填代价（tick）
+    uint32_t decay;             // 留在原CPU时缓存完全变冷所需的时间（tick）
+    uint32_t max_ticks;
+} aff_params_t;
+
+/* 单次模拟结果 */
+typedef struct {
+    uint32_t migration_cost;
+    uint32_t completed;
+    uint32_t sim_ticks;
+    uint32_t migrations;        // 开始运行时换了CPU的次数（含拉取）
+    uint32_t pulls;             // 空闲CPU从其他队列拉取的次数
+    uint32_t affine;            // 因缓存仍热留在原CPU的唤醒次数
+    uint64_t penalty;           // 重填代价总和（tick）
+    double penalty_pct;         // 重填代价占总CPU需求的百分比
+    double avg_wakeup;
+    uint32_t p99_wakeup;
+    double avg_turnaround;
+    double utilization;         // 所有CPU的忙碌比例
+} aff_result_t;
+
+/* ========== 事件堆 ========== */
+
+static void heap_push(event_heap_t *heap, uint32_t time, uint32_t task) {
+    if (heap->count == heap->capacity) {
+        heap->capacity = heap->capacity ? heap->capacity * 2 : 1024;
+        heap->events = realloc(heap->events, heap->capacity * sizeof(aff_event_t));
+        if (!heap->events) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+
+    uint32_t i = heap->count++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (heap->events[parent].time <= time) {
+            break;
+        }
+        heap->events[i] = heap->events[parent];
+        i = parent;
+    }
+    heap->events[i].time = time;
+    heap->events[i].task = task;
+}
+
+static aff_event_t heap_pop(event_heap_t *heap) {
+    aff_event_t top = heap->events[0];
+    aff_event_t last = heap->events[--heap->count];
+
+    uint32_t i = 0;
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && heap->events[child + 1].time < heap->events[child].time) {
+            child++;
+        }
+        if (last.time <= heap->events[child].time) {
+            break;
+        }
+        heap->events[i] = heap->events[child];
+        i = child;
+    }
+    if (heap->count > 0) {
+        heap->events[i] = last;
+    }
+    return top;
+}
+
+/* ========== 每CPU就绪队列 ========== */
+
+static aff_task_t *tasks;
+static aff_cpu_t cpus[MAX_CPUS];
+static uint32_t nr_running[MAX_CPUS];
+
+static void rq_push(uint32_t cpu, uint32_t t) {
+    aff_cpu_t *c = &cpus[cpu];
+    tasks[t].next = NO_TASK;
+    if (c->tail == NO_TASK) {
+        c->head = t;
+    } else {
+        tasks[c->tail].next = t;
+    }
+    c->tail = t;
+    c->queued++;
+}
+
+/* 摘下prev之后的任务（prev为NO_TASK时摘队头） */
+static uint32_t rq_remove_after(uint32_t cpu, uint32_t prev) {
+    aff_cpu_t *c = &cpus[cpu];
+    uint32_t t = (prev == NO_TASK) ? c->head : tasks[prev].next;
+    if (t == NO_TASK) {
+        return NO_TASK;
+    }
+    if (prev == NO_TASK) {
+        c->head = tasks[t].next;
+    } else {
+        tasks[prev].next = tasks[t].next;
+    }
+    if (c->tail == t) {
+        c->tail = prev;
+    }
+    c->queued--;
+    return t;
+}
+
+static uint32_t rq_pop(uint32_t cpu) {
+    return rq_remove_after(cpu, NO_TASK);
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* ========== 模拟主循环 ========== */
+
+/* 任务就绪：按放置策略选CPU入队 */
+static void make_ready(placement_t *pl, uint32_t t, uint32_t now) {
+    uint32_t cpu = placement_select_cpu(pl, &tasks[t].pcb, nr_running, now);
+    rq_push(cpu, t);
+    nr_running[cpu]++;
+}
+
+/* 空闲CPU从排队最多的CPU拉取第一个允许迁移的任务 */
+static uint32_t pull_task(placement_t *pl, uint32_t cpu, const aff_params_t *params, uint32_t now) {
+    uint32_t busiest = cpu;
+    for (uint32_t i = 0; i < params->num_cpus; i++) {
+        if (cpus[i].queued > cpus[busiest].queued) {
+            busiest = i;
+        }
+    }
+    if (busiest == cpu) {
+        return NO_TASK;
+    }
+    uint32_t prev = NO_TASK;
+    uint32_t t = cpus[busiest].head;
+    while (t != NO_TASK && !placement_can_pull(pl, &tasks[t].pcb, cpus[busiest].queued, now)) {
+        prev = t;
+        t = tasks[t].next;
+    }
+    if (t == NO_TASK) {
+        return NO_TASK;
+    }
+    rq_remove_after(busiest, prev);
+    nr_running[busiest]--;
+    nr_running[cpu]++;
+    return t;
+}
+
+static void sim_run(const sim_workload_t *wl, const aff_params_t *params,
+                    uint32_t migration_cost, aff_result_t *result) {
+    memset(result, 0, sizeof(aff_result_t));
+    result->migration_cost = migration_cost;
+
+    placement_t pl;
+    placement_init(&pl, params->num_cpus, migration_cost);
+
+    pcb_cold_t *colds = calloc(wl->count, sizeof(pcb_cold_t));
+    uint32_t *wakeups = malloc(sizeof(uint32_t) * 64);
+    uint32_t num_wakeups = 0, wakeup_capacity = 64;
+    tasks = calloc(wl->count, sizeof(aff_task_t));
+    if (!colds || !wakeups || !tasks) {
+        perror("calloc");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < wl->count; i++) {
+        tasks[i].spec = &wl->tasks[i];
+        tasks[i].pcb.pid = i + 1;
+        tasks[i].pcb.cold = &colds[i];
+        colds[i].last_cpu = PCB_NO_CPU;
+    }
+    for (uint32_t c = 0; c < MAX_CPUS; c++) {
+        cpus[c].head = cpus[c].tail = cpus[c].current = cpus[c].last_task = NO_TASK;
+        cpus[c].queued = cpus[c].slice_used = 0;
+        nr_running[c] = 0;
+    }
+
+    event_heap_t heap = {0};
+    uint32_t next_arrival = 0;
+    uint64_t busy = 0, turnaround_sum = 0;
+    uint32_t now = 0;
+
+    while (result->completed < wl->count && now < params->max_ticks) {
+        // 到达与IO完成
+        while (next_arrival < wl->count && tasks[next_arrival].spec->arrival <= now) {
+            uint32_t t = next_arrival++;
+            tasks[t].remaining = tasks[t].spec->phases[0];
+            make_ready(&pl, t, now);
+        }
+        while (heap.count > 0 && heap.events[0].time <= now) {
+            uint32_t t = heap_pop(&heap).task;
+            tasks[t].ready_since = now;
+            tasks[t].waking = true;
+            make_ready(&pl, t, now);
+        }
+
+        for (uint32_t cpu = 0; cpu < params->num_cpus; cpu++) {
+            aff_cpu_t *c = &cpus[cpu];
+
+            // 选择下一个任务，本地队列为空时拉取
+            if (c->current == NO_TASK) {
+                uint32_t t = rq_pop(cpu);
+                if (t == NO_TASK) {
+                    t = pull_task(&pl, cpu, params, now);
+                    result->pulls += t != NO_TASK;
+                }
+                if (t == NO_TASK) {
+                    continue;
+                }
+
+                aff_task_t *task = &tasks[t];
+                pcb_cold_t *cold = task->pcb.cold;
+                if (cold->last_cpu != PCB_NO_CPU) {
+                    uint32_t cost = params->refill;
+                    uint32_t idle = now - cold->last_ran;
+                    if (cold->last_cpu != cpu) {
+                        result->migrations++;
+                    } else if (c->last_task == t) {
+                        cost = 0;
+                    } else if (idle < params->decay) {
+                        cost = (uint32_t)((uint64_t)params->refill * idle / params->decay);
+                    }
+                    task->remaining += cost;
+                    result->penalty += cost;
+                }
+                cold->last_cpu = (uint8_t)cpu;
+
+                if (task->waking) {
+                    if (num_wakeups == wakeup_capacity) {
+                        wakeup_capacity *= 2;
+                        wakeups = realloc(wakeups, wakeup_capacity * sizeof(uint32_t));
+                        if (!wakeups) {
+                            perror("realloc");
+                            exit(1);
+                        }
+                    }
+                    wakeups[num_wakeups++] = now - task->ready_since;
+                    task->waking = false;
+                }
+                c->current = t;
+                c->last_task = t;
+                c->slice_used = 0;
+            }
+
+            // 运行一个tick
+            aff_task_t *task = &tasks[c->current];
+            busy++;
+            task->remaining--;
+            c->slice_used++;
+
+            if (task->remaining == 0) {
+                task->pcb.cold->last_ran = now + 1;
+                nr_running[cpu]--;
+                c->current = NO_TASK;
+
+                task->phase += 2;
+                if (task->phase < task->spec->num_phases) {
+                    task->remaining = task->spec->phases[task->phase];
+                    heap_push(&heap, now + 1 + task->spec->phases[task->phase - 1],
+                              (uint32_t)(task - tasks));
+                } else {
+                    result->completed++;
+                    turnaround_sum += now + 1 - task->spec->arrival;
+                }
+            } else if (c->slice_used >= params->quantum && c->queued > 0) {
+                // 时间片用完，排到本CPU队尾
+                task->pcb.cold->last_ran = now + 1;
+                rq_push(cpu, c->current);
+                c->current = NO_TASK;
+            }
+        }
+        now++;
+    }
+
+    result->sim_ticks = now;
+    result->affine = pl.stats.affine;
+    uint64_t demand = workload_cpu_demand(wl);
+    result->penalty_pct = demand ? 100.0 * result->penalty / demand : 0.0;
+    result->avg_turnaround = result->completed ? (double)turnaround_sum / result->completed : 0.0;
+    result->utilization = now ? (double)busy / ((uint64_t)now * params->num_cpus) : 0.0;
+
+    if (num_wakeups > 0) {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < num_wakeups; i++) {
+            sum += wakeups[i];
+        }
+        result->avg_wakeup = (double)sum / num_wakeups;
+        qsort(wakeups, num_wakeups, sizeof(uint32_t), compare_u32);
+        uint32_t rank = (uint32_t)(0.99 * num_wakeups + 0.999999);
+        result->p99_wakeup = wakeups[(rank ? rank : 1) - 1];
+    }
+
+    free(heap.events);
+    free(wakeups);
+    free(colds);
+    free(tasks);
+    tasks = NULL;
+}
+
+/* ========== 命令行 ========== */
+
+static int parse_list(const char *arg, uint32_t *values, int max) {
+    int count = 0;
+    const char *p = arg;
+    while (*p && count < max) {
+        char *end;
+        values[count++] = (uint32_t)strtoul(p, &end, 10);
+        if (end == p) {
+            return -1;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -c LIST   migration cost thresholds to sweep, 0 = ignore affinity (default: 0,10,20,50,100,200)\n"
+        "  -N CPUS   number of simulated CPUs (default: 4, max %d)\n"
+        "  -r TICKS  cache refill penalty after a migration (default: 1)\n"
+        "  -d TICKS  time after which a CPU's cache is cold even without migrating (default: 100)\n"
+        "  -q TICKS  time slice (default: 10)\n"
+        "  -n N      number of synthetic tasks (default: 2000)\n"
+        "  -m MIX    task mix: mixed | cpu=W,io=W,interactive=W,bursty=W (default: mixed)\n"
+        "  -l LOAD   target load per CPU (default: 0.6)\n"
+        "  -s SEED   random seed (default: 1)\n"
+        "  -T TICKS  stop each run after TICKS simulated ticks (default: 20000000)\n",
+        prog, MAX_CPUS);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t costs[MAX_SWEEP_VALUES] = {0, 10, 20, 50, 100, 200};
+    int num_costs = 6;
+    aff_params_t params = { .num_cpus = 4, .quantum = 10, .refill = 1, .decay = 100,
+                            .max_ticks = 20000000 };
+    const char *mix = "mixed";
+    uint32_t num_tasks = 2000;
+    double load = 0.6;
+    uint64_t seed = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:N:r:d:q:n:m:l:s:T:h")) != -1) {
+        switch (opt) {
+            case 'c': num_costs = parse_list(optarg, costs, MAX_SWEEP_VALUES); break;
+            case 'N': params.num_cpus = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'r': params.refill = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'd': params.decay = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'q': params.quantum = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'n': num_tasks = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'm': mix = optarg; break;
+            case 'l': load = strtod(optarg, NULL); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'T': params.max_ticks = (uint32_t)strtoul(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (num_costs <= 0 || params.num_cpus == 0 || params.num_cpus > MAX_CPUS ||
+        params.quantum == 0 || params.decay == 0) {
+        fprintf(stderr, "Error: invalid arguments\n");
+        return 1;
+    }
+
+    // 负载按CPU数放大，使每个CPU的目标负载为load
+    sim_workload_t wl;
+    if (workload_generate(&wl, mix, num_tasks, load * params.num_cpus, seed) != 0 ||
+        wl.count == 0) {
+        fprintf(stderr, "Error: failed to build workload\n");
+        return 1;
+    }
+    fprintf(stderr, "Workload: %u tasks on %u CPUs, %llu CPU ticks demanded, refill %u, decay %u\n",
+            wl.count, params.num_cpus, (unsigned long long)workload_cpu_demand(&wl),
+            params.refill, params.decay);
+
+    printf("migration_cost,completed,sim_ticks,migrations,pulls,affine_wakeups,"
+           "refill_ticks,refill_pct,avg_wakeup_latency,p99_wakeup_latency,"
+           "avg_turnaround,utilization\n");
+    for (int i = 0; i < num_costs; i++) {
+        aff_result_t r;
+        sim_run(&wl, &params, costs[i], &r);
+        printf("%u,%u,%u,%u,%u,%u,%llu,%.2f,%.2f,%u,%.2f,%.3f\n", r.migration_cost,
+               r.completed, r.sim_ticks, r.migrations, r.pulls, r.affine,
+               (unsigned long long)r.penalty, r.penalty_pct, r.avg_wakeup, r.p99_wakeup,
+               r.avg_turnaround, r.utilization);
+        fflush(stdout);
+    }
+
+    workload_free(&wl);
+    return 0;
+}
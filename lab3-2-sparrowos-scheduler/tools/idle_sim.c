@@ -0,0 +1,278 @@
+/**
+ * idle_sim.c - 空闲状态调控器的模拟实验
+ *
+ * 模拟一个CPU反复进入空闲：每次忙碌 -b 微秒后空闲，直到下一份工作到达。
+ * 工作间隔按比例取短间隔（-s 微秒附近）或长间隔（-l 微秒附近）；其中
+ * -T 百分比的工作由定时器带来（对齐到时钟tick，事先可知），其余由设备
+ * 中断在任意时刻带来。hlt被时钟tick或设备中断唤醒，退出需要 -x 纳秒；
+ * 轮询在 POLL_DETECT_NS 内发现工作。时间单位为纳秒（即1GHz的周期）。
+ *
+ * 比较四种空闲策略：
+ *   tick   原先的空闲循环：只执行hlt，中断上下文的唤醒要等下一个tick
+ *          才被处理
+ *   halt   只执行hlt，但每次醒来都检查唤醒链表
+ *   poll   始终轮询
+ *   menu   内核的空闲调控器（kernel/core/idle.c）
+ * 对每个策略和短间隔比例输出一行CSV：唤醒延迟的均值与p99、轮询与hlt
+ * 占空闲时间的比例、每个空闲期进入hlt的次数和调控器的预测命中率。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "kernel/include/idle.h"
+
+#define MAX_SWEEP_VALUES    16
+#define POLL_DETECT_NS      50          // 轮询循环发现工作所需时间
+
+typedef enum {
+    GOV_TICK,
+    GOV_HALT,
+    GOV_POLL,
+    GOV_MENU,
+    GOV_NR_KINDS
+} gov_kind_t;
+
+static const char *gov_names[GOV_NR_KINDS] = { "tick", "halt", "poll", "menu" };
+
+typedef struct {
+    uint32_t periods;           // 模拟的空闲期数
+    uint64_t short_ns;
+    uint64_t long_ns;
+    uint32_t short_pct;
+    uint32_t timer_pct;         // 由定时器带来的工作比例
+    uint64_t busy_ns;
+    uint64_t tick_ns;
+    uint64_t exit_ns;           // hlt退出延迟
+    uint64_t poll_threshold;
+    uint64_t seed;
+} sim_params_t;
+
+typedef struct {
+    double avg_wake;
+    uint64_t p99_wake;
+    double poll_pct;
+    double halt_pct;
+    double halts_per_period;
+    double predicted_pct;
+} sim_result_t;
+
+static inline uint64_t xorshift(uint64_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static inline uint64_t next_tick(uint64_t now, uint64_t tick) {
+    return (now / tick + 1) * tick;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* ========== 一个空闲期 ========== */
+
+typedef struct {
+    uint64_t poll;              // 轮询时间
+    uint64_t halt;              // hlt时间（含退出延迟）
+    uint32_t halts;
+} idle_cost_t;
+
+/* 从now空闲到arrival出现工作，返回发现工作的时刻 */
+static uint64_t run_idle(gov_kind_t kind, idle_governor_t *gov, const sim_params_t *p,
+                         uint64_t now, uint64_t arrival, bool timer, idle_cost_t *cost) {
+    switch (kind) {
+        case GOV_POLL:
+            cost->poll += arrival + POLL_DETECT_NS - now;
+            return arrival + POLL_DETECT_NS;
+
+        case GOV_TICK: {
+            // 每个tick醒来一次；设备中断只入唤醒链表，工作在其后的第一个tick才被发现
+            uint64_t found = timer ? arrival : next_tick(arrival - 1, p->tick_ns);
+            cost->halts += (uint32_t)((found - now + p->tick_ns - 1) / p->tick_ns);
+            cost->halt += found + p->exit_ns - now;
+            return found + p->exit_ns;
+        }
+
+        case GOV_HALT:
+            // 退出hlt期间到达的工作，醒来后的检查同样能发现
+            for (;;) {
+                uint64_t wake = next_tick(now, p->tick_ns);
+                wake = arrival < wake ? arrival : wake;
+                cost->halts++;
+                cost->halt += wake + p->exit_ns - now;
+                now = wake + p->exit_ns;
+                if (arrival <= now) {
+                    return now;
+                }
+            }
+
+        default:
+            break;
+    }
+
+    // menu：定时器带来的工作事先可知，设备中断不可知
+    for (;;) {
+        if (idle_governor_select(gov, now, timer ? arrival : IDLE_NO_EVENT) == IDLE_POLL) {
+            uint64_t end = now + gov->config.poll_limit;
+            if (arrival < end) {
+                uint64_t found = (arrival > now ? arrival : now) + POLL_DETECT_NS;
+                idle_governor_note_wakeup(gov, arrival);
+                idle_governor_exit(gov, found, true);
+                cost->poll += found - now;
+                return found;
+            }
+            idle_governor_exit(gov, end, false);
+            cost->poll += end - now;
+            now = end;
+        } else {
+            uint64_t wake = next_tick(now, p->tick_ns);
+            wake = arrival < wake ? arrival : wake;
+            cost->halts++;
+            cost->halt += wake + p->exit_ns - now;
+            now = wake + p->exit_ns;
+            if (arrival <= now) {
+                idle_governor_note_wakeup(gov, arrival);
+                idle_governor_exit(gov, now, true);
+                return now;
+            }
+            idle_governor_exit(gov, now, false);
+        }
+    }
+}
+
+/* ========== 一次运行 ========== */
+
+static void run(gov_kind_t kind, const sim_params_t *p, sim_result_t *r) {
+    idle_governor_t gov;
+    idle_config_t config = {
+        .poll_threshold = p->poll_threshold,
+        .poll_limit = p->poll_threshold,
+        .cycles_per_tick = p->tick_ns
+    };
+    idle_governor_init(&gov, &config);
+
+    uint64_t *latency = malloc(sizeof(uint64_t) * p->periods);
+    uint64_t seed = p->seed * 0x9E3779B97F4A7C15ULL + 1;
+    idle_cost_t cost = { 0, 0, 0 };
+    uint64_t now = 0, idle_total = 0, latency_sum = 0;
+
+    for (uint32_t i = 0; i < p->periods; i++) {
+        now += p->busy_ns;
+
+        // 间隔在标称值的0.5~1.5倍之间均匀分布
+        uint64_t base = xorshift(&seed) % 100 < p->short_pct ? p->short_ns : p->long_ns;
+        uint64_t gap = base / 2 + xorshift(&seed) % (base + 1);
+        bool timer = xorshift(&seed) % 100 < p->timer_pct;
+        uint64_t arrival = now + (gap ? gap : 1);
+        if (timer) {
+            arrival = next_tick(arrival - 1, p->tick_ns);
+        }
+
+        uint64_t found = run_idle(kind, &gov, p, now, arrival, timer, &cost);
+        latency[i] = found - arrival;
+        latency_sum += latency[i];
+        idle_total += found - now;
+        now = found;
+    }
+
+    qsort(latency, p->periods, sizeof(uint64_t), cmp_u64);
+    r->avg_wake = (double)latency_sum / p->periods;
+    r->p99_wake = latency[(uint64_t)p->periods * 99 / 100];
+    r->poll_pct = 100.0 * cost.poll / idle_total;
+    r->halt_pct = 100.0 * cost.halt / idle_total;
+    r->halts_per_period = (double)cost.halts / p->periods;
+    r->predicted_pct = kind == GOV_MENU && gov.stats.periods ?
+                       100.0 * gov.stats.predicted_hits / gov.stats.periods : 0;
+    free(latency);
+}
+
+/* ========== 命令行 ========== */
+
+static int parse_list(const char *arg, uint32_t *values, int max) {
+    int count = 0;
+    const char *p = arg;
+    while (*p && count < max) {
+        char *end;
+        values[count++] = (uint32_t)strtoul(p, &end, 10);
+        if (end == p) {
+            return -1;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -n N      idle periods per run (default: 20000)\n"
+        "  -p LIST   percentages of short gaps to sweep (default: 0,50,90,100)\n"
+        "  -s US     nominal short gap in microseconds (default: 5)\n"
+        "  -l US     nominal long gap in microseconds (default: 2000)\n"
+        "  -T PCT    share of work brought by timers (default: 20)\n"
+        "  -b US     busy time between idle periods (default: 20)\n"
+        "  -t US     timer tick period (default: 1000)\n"
+        "  -x NS     hlt exit latency in nanoseconds (default: 2000)\n"
+        "  -P NS     governor poll threshold in nanoseconds (default: %d)\n"
+        "  -r SEED   random seed (default: 1)\n",
+        prog, IDLE_DEFAULT_POLL_THRESHOLD);
+}
+
+int main(int argc, char *argv[]) {
+    sim_params_t params = {
+        .periods = 20000,
+        .short_ns = 5000,
+        .long_ns = 2000000,
+        .timer_pct = 20,
+        .busy_ns = 20000,
+        .tick_ns = 1000000,
+        .exit_ns = 2000,
+        .poll_threshold = IDLE_DEFAULT_POLL_THRESHOLD,
+        .seed = 1
+    };
+    uint32_t short_pcts[MAX_SWEEP_VALUES] = { 0, 50, 90, 100 };
+    int num_pcts = 4;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:p:s:l:T:b:t:x:P:r:h")) != -1) {
+        switch (opt) {
+            case 'n': params.periods = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'p': num_pcts = parse_list(optarg, short_pcts, MAX_SWEEP_VALUES); break;
+            case 's': params.short_ns = strtoull(optarg, NULL, 10) * 1000; break;
+            case 'l': params.long_ns = strtoull(optarg, NULL, 10) * 1000; break;
+            case 'T': params.timer_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'b': params.busy_ns = strtoull(optarg, NULL, 10) * 1000; break;
+            case 't': params.tick_ns = strtoull(optarg, NULL, 10) * 1000; break;
+            case 'x': params.exit_ns = strtoull(optarg, NULL, 10); break;
+            case 'P': params.poll_threshold = strtoull(optarg, NULL, 10); break;
+            case 'r': params.seed = strtoull(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (params.periods == 0 || num_pcts <= 0 || params.tick_ns == 0 ||
+        params.poll_threshold == 0 || params.timer_pct > 100) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("governor,short_pct,avg_wake_ns,p99_wake_ns,poll_pct,halt_pct,halts_per_period,predicted_pct\n");
+    for (int i = 0; i < num_pcts; i++) {
+        params.short_pct = short_pcts[i];
+        for (int g = 0; g < GOV_NR_KINDS; g++) {
+            sim_result_t r;
+            run((gov_kind_t)g, &params, &r);
+            printf("%s,%u,%.0f,%llu,%.1f,%.1f,%.2f,%.1f\n", gov_names[g], short_pcts[i],
+                   r.avg_wake, (unsigned long long)r.p99_wake, r.poll_pct, r.halt_pct,
+                   r.halts_per_period, r.predicted_pct);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ * lock_bench.c - 自旋锁竞争基准测试
+ *
+ * 用主机线程模拟多个CPU争用同一把锁（kernel/include/spinlock.h）：每个线程
+ * 反复加锁、在临界区里更新共享计数器并空转 -c 次pause、解锁，再在锁外空转
+ * -o 次。读写锁按 -r 的比例执行只读临界区，其余为写。每种锁和线程数运行
+ * -d 毫秒，输出一行CSV：吞吐量、按线程获取次数计算的Jain公平性指数与
+ * 最少/最多之比、竞争比例和每次竞争的平均轮询次数。
+ *
+ * 线程数超过主机CPU数时，排队锁的下一个持有者可能正被主机调度器换出，
+ * 交接要等它重新运行，吞吐量会明显下降；这是预期行为。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "kernel/include/spinlock.h"
+
+#define MAX_THREADS         64
+#define MAX_SWEEP_VALUES    16
+
+typedef enum {
+    LOCK_TAS,
+    LOCK_TICKET,
+    LOCK_MCS,
+    LOCK_RW,
+    LOCK_NR_KINDS
+} lock_kind_t;
+
+static const char *lock_names[LOCK_NR_KINDS] = { "tas", "ticket", "mcs", "rwlock" };
+
+typedef struct {
+    lock_kind_t kind;
+    uint32_t threads;
+    uint32_t duration_ms;
+    uint32_t cs_work;           // 临界区内的pause次数
+    uint32_t out_work;          // 两次加锁之间的pause次数
+    uint32_t read_pct;          // 读写锁的只读比例
+} bench_params_t;
+
+/* 每线程计数，独占缓存行 */
+typedef struct {
+    pthread_t thread;
+    const bench_params_t *params;
+    uint64_t seed;
+    uint64_t acquisitions;
+    uint64_t writes;
+    uint64_t contended;
+    uint64_t spins;
+    uint64_t torn;              // 读临界区看到的不一致
+    mcs_node_t node;
+} __attribute__((aligned(SPINLOCK_CACHE_LINE))) worker_t;
+
+/* 被测的锁与它保护的数据，各占一个缓存行 */
+static struct {
+    tas_lock_t tas;
+    ticket_lock_t ticket;
+    mcs_lock_t mcs;
+    rwlock_t rw;
+} __attribute__((aligned(SPINLOCK_CACHE_LINE))) locks;
+
+static struct {
+    uint64_t counter;
+    uint64_t mirror;            // 临界区末尾才更新，读者据此检查互斥
+} __attribute__((aligned(SPINLOCK_CACHE_LINE))) shared;
+
+static worker_t workers[MAX_THREADS];
+static volatile int go;
+static volatile int stop;
+
+/* ========== 工作线程 ========== */
+
+static inline void burn(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        cpu_relax();
+    }
+}
+
+static inline uint64_t xorshift(uint64_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static inline uint32_t acquire(worker_t *w, lock_kind_t kind, bool write) {
+    switch (kind) {
+        case LOCK_TAS:      return tas_lock(&locks.tas);
+        case LOCK_TICKET:   return ticket_lock(&locks.ticket);
+        case LOCK_MCS:      return mcs_lock(&locks.mcs, &w->node);
+        default:            return write ? rwlock_write_lock(&locks.rw) : rwlock_read_lock(&locks.rw);
+    }
+}
+
+static inline void release(worker_t *w, lock_kind_t kind, bool write) {
+    switch (kind) {
+        case LOCK_TAS:      tas_unlock(&locks.tas); break;
+        case LOCK_TICKET:   ticket_unlock(&locks.ticket); break;
+        case LOCK_MCS:      mcs_unlock(&locks.mcs, &w->node); break;
+        default:
+            if (write) {
+                rwlock_write_unlock(&locks.rw);
+            } else {
+                rwlock_read_unlock(&locks.rw);
+            }
+            break;
+    }
+}
+
+static void* worker_main(void *arg) {
+    worker_t *w = arg;
+    const bench_params_t *p = w->params;
+
+    while (!go) {
+        cpu_relax();
+    }
+    while (!stop) {
+        bool write = p->kind != LOCK_RW || xorshift(&w->seed) % 100 >= p->read_pct;
+        uint32_t spins = acquire(w, p->kind, write);
+        if (write) {
+            shared.counter++;
+            burn(p->cs_work);
+            shared.mirror = shared.counter;
+            w->writes++;
+        } else {
+            uint64_t seen = shared.counter;
+            burn(p->cs_work);
+            w->torn += seen != shared.mirror;
+        }
+        release(w, p->kind, write);
+
+        w->acquisitions++;
+        if (spins) {
+            w->contended++;
+            w->spins += spins;
+        }
+        burn(p->out_work);
+    }
+    return NULL;
+}
+
+/* ========== 单次运行 ========== */
+
+typedef struct {
+    double acq_per_sec;
+    double jain;
+    double min_max;             // 获取次数最少与最多的线程之比
+    double contended_pct;
+    double avg_spins;           // 每次竞争的平均轮询次数
+    bool ok;
+} bench_result_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void run(const bench_params_t *p, uint64_t seed, bench_result_t *r) {
+    tas_lock_init(&locks.tas);
+    ticket_lock_init(&locks.ticket);
+    mcs_lock_init(&locks.mcs);
+    rwlock_init(&locks.rw);
+    shared.counter = 0;
+    shared.mirror = 0;
+    go = 0;
+    stop = 0;
+
+    for (uint32_t i = 0; i < p->threads; i++) {
+        memset(&workers[i], 0, sizeof(worker_t));
+        workers[i].params = p;
+        workers[i].seed = seed * 0x9E3779B97F4A7C15ULL + i + 1;
+        pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]);
+    }
+
+    double start = now_sec();
+    go = 1;
+    struct timespec ts = { p->duration_ms / 1000, (p->duration_ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+    stop = 1;
+    double elapsed = now_sec() - start;
+
+    uint64_t total = 0, writes = 0, contended = 0, spins = 0, torn = 0;
+    uint64_t min = UINT64_MAX, max = 0;
+    double sum_sq = 0;
+    for (uint32_t i = 0; i < p->threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        worker_t *w = &workers[i];
+        total += w->acquisitions;
+        writes += w->writes;
+        contended += w->contended;
+        spins += w->spins;
+        torn += w->torn;
+        sum_sq += (double)w->acquisitions * w->acquisitions;
+        min = w->acquisitions < min ? w->acquisitions : min;
+        max = w->acquisitions > max ? w->acquisitions : max;
+    }
+
+    r->acq_per_sec = total / elapsed;
+    r->jain = sum_sq > 0 ? (double)total * total / (p->threads * sum_sq) : 0;
+    r->min_max = max ? (double)min / max : 0;
+    r->contended_pct = total ? 100.0 * contended / total : 0;
+    r->avg_spins = contended ? (double)spins / contended : 0;
+    r->ok = shared.counter == writes && shared.mirror == writes && torn == 0;
+}
+
+/* ========== 命令行 ========== */
+
+static int parse_list(const char *arg, uint32_t *values, int max) {
+    int count = 0;
+    const char *p = arg;
+    while (*p && count < max) {
+        char *end;
+        values[count++] = (uint32_t)strtoul(p, &end, 10);
+        if (end == p) {
+            return -1;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+static int parse_locks(const char *arg, lock_kind_t *kinds, int max) {
+    int count = 0;
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", arg);
+    for (char *tok = strtok(buf, ","); tok && count < max; tok = strtok(NULL, ",")) {
+        int k;
+        for (k = 0; k < LOCK_NR_KINDS && strcmp(tok, lock_names[k]) != 0; k++) {
+        }
+        if (k == LOCK_NR_KINDS) {
+            return -1;
+        }
+        kinds[count++] = (lock_kind_t)k;
+    }
+    return count;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -l LIST   locks to compare: tas,ticket,mcs,rwlock (default: all)\n"
+        "  -t LIST   thread counts to sweep (default: 2,4,8,16,32,64, max %d)\n"
+        "  -d MS     duration of each run in milliseconds (default: 200)\n"
+        "  -c N      pause iterations inside the critical section (default: 20)\n"
+        "  -o N      pause iterations between acquisitions (default: 100)\n"
+        "  -r PCT    share of read-only critical sections for rwlock (default: 90)\n"
+        "  -s SEED   random seed (default: 1)\n",
+        prog, MAX_THREADS);
+}
+
+int main(int argc, char *argv[]) {
+    lock_kind_t kinds[LOCK_NR_KINDS] = { LOCK_TAS, LOCK_TICKET, LOCK_MCS, LOCK_RW };
+    int num_kinds = LOCK_NR_KINDS;
+    uint32_t threads[MAX_SWEEP_VALUES] = { 2, 4, 8, 16, 32, 64 };
+    int num_threads = 6;
+    bench_params_t params = { LOCK_TAS, 0, 200, 20, 100, 90 };
+    uint64_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l:t:d:c:o:r:s:h")) != -1) {
+        switch (opt) {
+            case 'l': num_kinds = parse_locks(optarg, kinds, LOCK_NR_KINDS); break;
+            case 't': num_threads = parse_list(optarg, threads, MAX_SWEEP_VALUES); break;
+            case 'd': params.duration_ms = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'c': params.cs_work = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'o': params.out_work = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'r': params.read_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (num_kinds <= 0 || num_threads <= 0 || params.duration_ms == 0 || params.read_pct > 100) {
+        usage(argv[0]);
+        return 1;
+    }
+    for (int i = 0; i < num_threads; i++) {
+        if (threads[i] == 0 || threads[i] > MAX_THREADS) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    fprintf(stderr, "Lock benchmark: %ld host CPUs, %u ms per run, critical section %u, outside %u\n",
+            cpus, params.duration_ms, params.cs_work, params.out_work);
+
+    printf("lock,threads,acq_per_sec,jain,min_max,contended_pct,avg_spins,ok\n");
+    int failed = 0;
+    for (int k = 0; k < num_kinds; k++) {
+        for (int t = 0; t < num_threads; t++) {
+            params.kind = kinds[k];
+            params.threads = threads[t];
+            bench_result_t r;
+            run(&params, seed, &r);
+            printf("%s,%u,%.0f,%.3f,%.3f,%.1f,%.1f,%s\n", lock_names[kinds[k]], threads[t],
+                   r.acq_per_sec, r.jain, r.min_max, r.contended_pct, r.avg_spins,
+                   r.ok ? "yes" : "NO");
+            fflush(stdout);
+            failed += !r.ok;
+        }
+    }
+    return failed ? 1 : 0;
+}
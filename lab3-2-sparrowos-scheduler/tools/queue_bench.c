@@ -0,0 +1,247 @@
+/**
+ * queue_bench.c - 就绪队列微基准测试
+ *
+ * 对比内核当前的侵入式就绪队列（PCB自带next/prev）与旧的节点式队列
+ * （每次入队从节点池取一个ready_queue_node包装PCB）的入队、出队、删除吞吐。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "kernel/include/pcb.h"
+
+#define DEFAULT_PROCS   MAX_PROCESSES
+#define DEFAULT_ROUNDS  200
+
+/* ========== 旧的节点式队列（仅用于对比） ========== */
+
+typedef struct node {
+    pcb_t *pcb;
+    struct node *next;
+    struct node *prev;
+    uint32_t enqueue_time;
+} node_t;
+
+typedef struct {
+    node_t *head;
+    node_t *tail;
+    uint32_t count;
+} node_queue_t;
+
+static node_t *node_pool;
+static node_t *node_free_list;
+
+static void node_pool_init(uint32_t n) {
+    node_free_list = NULL;
+    for (int i = (int)n - 1; i >= 0; i--) {
+        node_pool[i].next = node_free_list;
+        node_free_list = &node_pool[i];
+    }
+}
+
+static void node_enqueue(node_queue_t *q, pcb_t *pcb) {
+    node_t *node = node_free_list;
+    node_free_list = node->next;
+
+    node->pcb = pcb;
+    node->enqueue_time = 0;
+    node->next = NULL;
+    node->prev = q->tail;
+    if (q->tail) {
+        q->tail->next = node;
+    } else {
+        q->head = node;
+    }
+    q->tail = node;
+    q->count++;
+}
+
+static void node_unlink(node_queue_t *q, node_t *node) {
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        q->head = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        q->tail = node->prev;
+    }
+    q->count--;
+
+    node->pcb = NULL;
+    node->next = node_free_list;
+    node_free_list = node;
+}
+
+static pcb_t* node_dequeue(node_queue_t *q) {
+    node_t *node = q->head;
+    if (!node) {
+        return NULL;
+    }
+    pcb_t *pcb = node->pcb;
+    node_unlink(q, node);
+    return pcb;
+}
+
+static void node_remove(node_queue_t *q, pcb_t *pcb) {
+    // 节点与PCB分离，只能遍历查找
+    node_t *node = q->head;
+    while (node && node->pcb != pcb) {
+        node = node->next;
+    }
+    if (node) {
+        node_unlink(q, node);
+    }
+}
+
+/* ========== 计时 ========== */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* 防止编译器把出队结果优化掉 */
+static volatile uintptr_t sink;
+
+/* ========== 基准场景 ========== */
+
+typedef struct {
+    double enqueue;     // 每次入队耗时（ns）
+    double dequeue;     // 每次出队耗时（ns）
+    double rotate;      // 出队后立即入队（时间片轮转）耗时
+    double remove;      // 按PCB随机删除耗时
+} bench_result_t;
+
+static void bench_intrusive(pcb_t *pcbs, uint32_t n, uint32_t rounds,
+                            const uint32_t *order, bench_result_t *r) {
+    ready_queue_t q;
+    ready_queue_init(&q, 0, 0);
+    double t, enq = 0, deq = 0, rot = 0, rem = 0;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        t = now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            ready_queue_enqueue(&q, &pcbs[i]);
+        }
+        enq += now_ns() - t;
+
+        t = now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            ready_queue_enqueue(&q, ready_queue_dequeue(&q));
+        }
+        rot += now_ns() - t;
+
+        t = now_ns();
+        for (uint32_t i = 0; i < n / 2; i++) {
+            ready_queue_remove(&q, &pcbs[order[i]]);
+        }
+        rem += now_ns() - t;
+
+        t = now_ns();
+        pcb_t *pcb;
+        while ((pcb = ready_queue_dequeue(&q)) != NULL) {
+            sink += (uintptr_t)pcb;
+        }
+        deq += now_ns() - t;
+    }
+
+    uint64_t ops = (uint64_t)n * rounds;
+    r->enqueue = enq / ops;
+    r->rotate = rot / ops;
+    r->remove = rem / (ops / 2);
+    r->dequeue = deq / (ops - ops / 2);
+}
+
+static void bench_node(pcb_t *pcbs, uint32_t n, uint32_t rounds,
+                       const uint32_t *order, bench_result_t *r) {
+    node_queue_t q = {0};
+    double t, enq = 0, deq = 0, rot = 0, rem = 0;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        t = now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            node_enqueue(&q, &pcbs[i]);
+        }
+        enq += now_ns() - t;
+
+        t = now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            node_enqueue(&q, node_dequeue(&q));
+        }
+        rot += now_ns() - t;
+
+        t = now_ns();
+        for (uint32_t i = 0; i < n / 2; i++) {
+            node_remove(&q, &pcbs[order[i]]);
+        }
+        rem += now_ns() - t;
+
+        t = now_ns();
+        pcb_t *pcb;
+        while ((pcb = node_dequeue(&q)) != NULL) {
+            sink += (uintptr_t)pcb;
+        }
+        deq += now_ns() - t;
+    }
+
+    uint64_t ops = (uint64_t)n * rounds;
+    r->enqueue = enq / ops;
+    r->rotate = rot / ops;
+    r->remove = rem / (ops / 2);
+    r->dequeue = deq / (ops - ops / 2);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t n = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_PROCS;
+    uint32_t rounds = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : DEFAULT_ROUNDS;
+    if (n < 2 || rounds == 0) {
+        fprintf(stderr, "Usage: %s [processes] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    pcb_t *pcbs = calloc(n, sizeof(pcb_t));
+    node_pool = calloc(n, sizeof(node_t));
+    uint32_t *order = malloc(n * sizeof(uint32_t));
+    if (!pcbs || !node_pool || !order) {
+        perror("alloc");
+        return 1;
+    }
+
+    // 随机删除顺序（Fisher-Yates）
+    srand(1);
+    for (uint32_t i = 0; i < n; i++) {
+        order[i] = i;
+        pcbs[i].pid = i + 1;
+    }
+    for (uint32_t i = n - 1; i > 0; i--) {
+        uint32_t j = (uint32_t)rand() % (i + 1);
+        uint32_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    node_pool_init(n);
+
+    bench_result_t intrusive, node;
+    // 删除在节点式队列上是O(n)，缩减轮数以免运行过久
+    uint32_t node_rounds = rounds > 10 ? rounds / 10 : 1;
+    bench_node(pcbs, n, node_rounds, order, &node);
+    bench_intrusive(pcbs, n, rounds, order, &intrusive);
+
+    printf("Ready queue microbenchmark: %u PCBs (%zu bytes each), %u rounds\n",
+           n, sizeof(pcb_t), rounds);
+    printf("%-12s %12s %12s %12s %12s\n", "queue", "enqueue ns", "dequeue ns",
+           "rotate ns", "remove ns");
+    printf("%-12s %12.2f %12.2f %12.2f %12.2f\n", "node",
+           node.enqueue, node.dequeue, node.rotate, node.remove);
+    printf("%-12s %12.2f %12.2f %12.2f %12.2f\n", "intrusive",
+           intrusive.enqueue, intrusive.dequeue, intrusive.rotate, intrusive.remove);
+
+    free(order);
+    free(node_pool);
+    free(pcbs);
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * reap_bench.c - 批量退出与延迟回收基准测试
+ *
+ * 一个父进程一次创建 -n 个子进程（扁平的进程树，子进程链表很长），然后
+ * 全部子进程按创建顺序退出：每个子进程 scheduler_terminate_process +
+ * scheduler_reap_process。比较两种回收方式：
+ *   sync       每次回收后立即运行回收器（一批一个），相当于原先在reap里
+ *              同步释放：每个子进程都要从父进程的子进程链表摘除，最早创建
+ *              的位于链表尾，整轮是O(N^2)
+ *   deferred   reap只排入回收链表；之后由回收器按 REAPER_BATCH 一批释放
+ *              （CPU空闲时每个tick一批），同一父进程的子进程一次遍历摘除
+ * 输出列：mode,children,exit_ns（调用者看到的每次退出+回收耗时）,
+ * exit_max_ns（最慢的一次退出）,reap_ns（回收器释放每个进程的耗时）,
+ * stall_max_ns（单次调用占用调度器的最长时间：sync为最慢的一次退出，
+ * deferred为最慢的一批回收）
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "kernel/include/scheduler.h"
+#include "tools/sim_host.h"
+
+#define MAX_SWEEP_VALUES    16
+#define DEFAULT_ROUNDS      20
+
+/* ========== 计时 ========== */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ========== 基准场景 ========== */
+
+typedef struct {
+    double exit_ns;
+    double exit_max_ns;
+    double reap_ns;
+    double stall_max_ns;
+} bench_result_t;
+
+static pcb_t **children;
+
+static void setup(void) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_MLFQ,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+}
+
+static void bench(uint32_t n, uint32_t rounds, bool deferred, bench_result_t *r) {
+    setup();
+    memset(r, 0, sizeof(bench_result_t));
+
+    // 父进程成为当前进程，之后创建的进程都是它的子进程
+    scheduler_create_process("parent", PROCESS_TYPE_USER, 0, PROCESS_FLAG_NONE);
+    scheduler_schedule();
+
+    double exit_total = 0, reap_total = 0;
+    uint64_t processes = 0;
+    for (uint32_t round = 0; round < rounds; round++) {
+        for (uint32_t i = 0; i < n; i++) {
+            children[i] = scheduler_create_process("child", PROCESS_TYPE_USER, 1,
+                                                   PROCESS_FLAG_NONE);
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t pid = children[i]->pid;
+            double t = now_ns();
+            scheduler_terminate_process(pid, 0);
+            scheduler_reap_process(pid);
+            if (!deferred) {
+                scheduler_reap_deferred(1);
+            }
+            t = now_ns() - t;
+            exit_total += t;
+            if (t > r->exit_max_ns) {
+                r->exit_max_ns = t;
+            }
+        }
+
+        while (scheduler_reap_pending() > 0) {
+            double t = now_ns();
+            scheduler_reap_deferred(REAPER_BATCH);
+            t = now_ns() - t;
+            reap_total += t;
+            if (t > r->stall_max_ns) {
+                r->stall_max_ns = t;
+            }
+        }
+        processes += n;
+    }
+
+    r->exit_ns = exit_total / processes;
+    r->reap_ns = reap_total / processes;
+    if (r->exit_max_ns > r->stall_max_ns) {
+        r->stall_max_ns = r->exit_max_ns;
+    }
+}
+
+/* ========== 命令行 ========== */
+
+static int parse_list(const char *arg, uint32_t *values, int max) {
+    int count = 0;
+    const char *p = arg;
+    while (*p && count < max) {
+        char *end;
+        values[count++] = (uint32_t)strtoul(p, &end, 10);
+        if (end == p) {
+            return -1;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -n LIST   numbers of children to sweep (default: 64,256,1024; at most %d)\n"
+        "  -r N      rounds per setting (default: %d)\n",
+        prog, MAX_PROCESSES - 2, DEFAULT_ROUNDS);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t sizes[MAX_SWEEP_VALUES] = { 64, 256, 1024 };
+    int num_sizes = 3;
+    uint32_t rounds = DEFAULT_ROUNDS;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:h")) != -1) {
+        switch (opt) {
+            case 'n': num_sizes = parse_list(optarg, sizes, MAX_SWEEP_VALUES); break;
+            case 'r': rounds = (uint32_t)strtoul(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    // 空闲进程与父进程各占一个槽位
+    uint32_t max_size = 0;
+    for (int i = 0; i < num_sizes; i++) {
+        max_size = sizes[i] > max_size ? sizes[i] : max_size;
+        if (sizes[i] == 0) {
+            num_sizes = -1;
+        }
+    }
+    if (num_sizes <= 0 || rounds == 0 || max_size > MAX_PROCESSES - 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    children = calloc(max_size, sizeof(pcb_t *));
+    if (!children) {
+        perror("alloc");
+        return 1;
+    }
+
+    printf("mode,children,exit_ns,exit_max_ns,reap_ns,stall_max_ns\n");
+    for (int i = 0; i < num_sizes; i++) {
+        for (int mode = 0; mode < 2; mode++) {
+            bench_result_t r;
+            bench(sizes[i], rounds, mode == 1, &r);
+            printf("%s,%u,%.1f,%.0f,%.1f,%.0f\n", mode ? "deferred" : "sync", sizes[i],
+                   r.exit_ns, r.exit_max_ns, r.reap_ns, r.stall_max_ns);
+        }
+    }
+
+    free(children);
+    return 0;
+}
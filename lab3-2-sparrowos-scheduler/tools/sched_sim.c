@@ -0,0 +1,754 @@
+/**
+ * sched_sim.c - SparrowOS调度器主机端离散事件模拟器
+ *
+ * 直接链接内核调度器核心（kernel/core/ 下的 scheduler.c 与 pcb.c），用合成或录制的负载驱动它：
+ * 每个tick依次处理到达/IO完成事件、让当前进程运行一个tick、触发定时器中断。
+ * 每种策略/参数组合输出一行CSV，便于批量扫描 time_quantum 和 boost_interval。
+ *
+ * -R 把一次运行的全部调度输入与决策录制到文件；-P 读入录制文件，只把输入
+ * 喂给调度器核心并校验每次选择是否与录制时相同，不再模拟任务本身。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <time.h>
+#include "kernel/include/scheduler.h"
+#include "kernel/include/interrupt.h"
+#include "sim_host.h"
+#include "sim_workload.h"
+
+#define MAX_SWEEP_VALUES 32
+#define REPLAY_BUF_SIZE  (64u << 20)    // 录制缓冲区大小（字节）
+
+/* 录制文件头，其后是 length 字节的日志 */
+typedef struct {
+    char magic[4];              // "SPRL"
+    uint32_t version;
+    uint32_t max_processes;     // PID编码依赖MAX_PROCESSES，重放时必须相同
+    uint32_t scheduler_type;
+    uint32_t time_quantum;
+    uint32_t boost_interval;
+    uint32_t enable_preemption;
+    uint32_t adaptive_mlfq;
+    uint32_t wakeup_preemption;
+    uint32_t ticks;             // 录制的tick数
+    uint32_t picks;             // 录制的选择次数
+    uint32_t entries;
+    uint32_t length;
+    double wall_ms;             // 录制时模拟本身的耗时
+} replay_header_t;
+
+#define REPLAY_MAGIC    "SPRL"
+#define REPLAY_VERSION  2
+
+/* 任务的运行时状态 */
+typedef struct {
+    const sim_task_spec_t *spec;
+    pcb_t *pcb;
+    uint32_t phase;             // 当前阶段下标
+    uint32_t remaining;         // 当前CPU阶段剩余tick
+    uint32_t run_ticks;         // 累计运行时间
+    uint32_t blocked_ticks;     // 累计IO等待时间
+    uint32_t ready_since;       // 最近一次被唤醒的时刻
+    bool started;
+    bool waking;                // 已唤醒但尚未重新运行
+} sim_task_t;
+
+/* IO完成事件（按时间排序的二叉堆） */
+typedef struct {
+    uint32_t time;
+    uint32_t task;
+} sim_event_t;
+
+typedef struct {
+    sim_event_t *events;
+    uint32_t count;
+    uint32_t capacity;
+} event_heap_t;
+
+/* 样本集合，用于均值和百分位 */
+typedef struct {
+    uint32_t *values;
+    uint32_t count;
+    uint32_t capacity;
+} sample_set_t;
+
+/* 单次模拟结果 */
+typedef struct {
+    const char *policy;
+    uint32_t time_quantum;
+    uint32_t boost_interval;
+    uint32_t tasks;
+    uint32_t completed;
+    uint32_t sim_ticks;
+    double avg_turnaround;
+    uint32_t p99_turnaround;
+    double avg_response;
+    uint32_t p99_response;
+    double avg_wakeup;
+    uint32_t p99_wakeup;
+    double avg_interactive_wakeup;  // 只计交互型任务
+    uint32_t p99_interactive_wakeup;
+    double fairness;            // Jain公平性指数
+    uint32_t context_switches;
+    double wall_ms;
+} sim_result_t;
+
+/* 可选的调度策略（-p） */
+typedef struct {
+    const char *name;
+    uint32_t type;
+    bool adaptive;              // 自适应MLFQ
+    bool wakeup;                // 交互型任务唤醒抢占
+} sim_policy_t;
+
+/* ========== 事件堆 ========== */
+
+static void heap_push(event_heap_t *heap, uint32_t time, uint32_t task) {
+    if (heap->count == heap->capacity) {
+        heap->capacity = heap->capacity ? heap->capacity * 2 : 1024;
+        heap->events = realloc(heap->events, heap->capacity * sizeof(sim_event_t));
+        if (!heap->events) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+
+    uint32_t i = heap->count++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (heap->events[parent].time <= time) {
+            break;
+        }
+        heap->events[i] = heap->events[parent];
+        i = parent;
+    }
+    heap->events[i].time = time;
+    heap->events[i].task = task;
+}
+
+static sim_event_t heap_pop(event_heap_t *heap) {
+    sim_event_t top = heap->events[0];
+    sim_event_t last = heap->events[--heap->count];
+
+    uint32_t i = 0;
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && heap->events[child + 1].time < heap->events[child].time) {
+            child++;
+        }
+        if (last.time <= heap->events[child].time) {
+            break;
+        }
+        heap->events[i] = heap->events[child];
+        i = child;
+    }
+    if (heap->count > 0) {
+        heap->events[i] = last;
+    }
+    return top;
+}
+
+/* ========== 样本统计 ========== */
+
+static void sample_add(sample_set_t *set, uint32_t value) {
+    if (set->count == set->capacity) {
+        set->capacity = set->capacity ? set->capacity * 2 : 1024;
+        set->values = realloc(set->values, set->capacity * sizeof(uint32_t));
+        if (!set->values) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    set->values[set->count++] = value;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double sample_mean(const sample_set_t *set) {
+    if (set->count == 0) {
+        return 0.0;
+    }
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < set->count; i++) {
+        sum += set->values[i];
+    }
+    return (double)sum / set->count;
+}
+
+/* 百分位（会对样本原地排序） */
+static uint32_t sample_percentile(sample_set_t *set, double p) {
+    if (set->count == 0) {
+        return 0;
+    }
+    qsort(set->values, set->count, sizeof(uint32_t), compare_u32);
+    uint32_t rank = (uint32_t)(p * set->count + 0.999999);
+    if (rank == 0) {
+        rank = 1;
+    }
+    return set->values[rank - 1];
+}
+
+/* ========== 模拟主循环 ========== */
+
+static process_flags_t class_flags(task_class_t cls) {
+    switch (cls) {
+        case TASK_CLASS_CPU:         return PROCESS_FLAG_CPU_BOUND;
+        case TASK_CLASS_IO:          return PROCESS_FLAG_IO_BOUND;
+        case TASK_CLASS_INTERACTIVE: return PROCESS_FLAG_INTERACTIVE;
+        default:                     return PROCESS_FLAG_NONE;
+    }
+}
+
+/* -i：IO完成由模拟的磁盘中断经无锁唤醒链表投递，而不是直接同步唤醒 */
+static bool irq_wakeups = false;
+static pcb_t *disk_completions[MAX_PROCESSES];
+static uint32_t num_disk_completions;
+
+/* -R：录制本次运行 */
+static const char *record_path;
+static replay_t recorder;
+static uint8_t *record_buf;
+
+static int replay_save(const char *path, const scheduler_config_t *config, double wall_ms);
+
+static void sim_disk_irq(void) {
+    for (uint32_t i = 0; i < num_disk_completions; i++) {
+        scheduler_wakeup_from_irq(disk_completions[i]);
+    }
+    num_disk_completions = 0;
+}
+
+static void sim_run(const sim_workload_t *wl, const sim_policy_t *policy, uint32_t quantum,
+                    uint32_t boost, uint32_t max_ticks, sim_result_t *result) {
+    uint32_t type = policy->type;
+    struct timespec wall_start, wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = type,
+        .time_quantum = quantum,
+        .enable_preemption = (type != SCHEDULER_FIFO),
+        .enable_multicore = false,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = boost,
+        .load_balance_interval = 500,
+        .adaptive_mlfq = policy->adaptive,
+        .wakeup_preemption = policy->wakeup
+    };
+    scheduler_init(&config);
+    interrupt_register_handler(IRQ_DISK, sim_disk_irq);
+    pcb_t *idle = scheduler_get_current_process();
+    if (record_buf) {
+        replay_init_record(&recorder, record_buf, REPLAY_BUF_SIZE);
+        scheduler_set_recorder(&recorder);
+    }
+
+    sim_task_t *tasks = calloc(wl->count, sizeof(sim_task_t));
+    if (!tasks) {
+        perror("calloc");
+        exit(1);
+    }
+
+    event_heap_t heap = {0};
+    sample_set_t turnaround = {0}, response = {0}, wakeup = {0}, iwakeup = {0};
+    double fair_sum = 0.0, fair_sq_sum = 0.0;
+    uint32_t next_arrival = 0;
+    uint32_t completed = 0;
+    uint32_t now;
+
+    for (now = 0; completed < wl->count && now < max_ticks; now++) {
+        // 1. 新任务到达
+        while (next_arrival < wl->count && wl->tasks[next_arrival].arrival <= now) {
+            const sim_task_spec_t *spec = &wl->tasks[next_arrival];
+            char name[PROCESS_NAME_LEN];
+            snprintf(name, sizeof(name), "%s-%u", task_class_name(spec->cls), next_arrival);
+
+            pcb_t *pcb = scheduler_create_process(name, PROCESS_TYPE_USER,
+                                                  spec->priority, class_flags(spec->cls));
+            if (!pcb) {
+                break;  // 进程表已满，下个tick重试
+            }
+
+            sim_task_t *task = &tasks[next_arrival];
+            task->spec = spec;
+            task->pcb = pcb;
+            task->remaining = spec->phases[0];
+            pcb->cold->private_data = task;
+            next_arrival++;
+        }
+
+        // 2. IO完成，唤醒等待的任务
+        while (heap.count > 0 && heap.events[0].time <= now) {
+            sim_event_t ev = heap_pop(&heap);
+            sim_task_t *task = &tasks[ev.task];
+            task->ready_since = now;
+            task->waking = true;
+            if (irq_wakeups) {
+                disk_completions[num_disk_completions++] = task->pcb;
+            } else {
+                scheduler_wakeup_process(task->pcb->pid);
+            }
+        }
+        if (num_disk_completions > 0) {
+            sim_fire_irq(IRQ_DISK);
+        }
+
+        // 3. 空闲进程的循环：有进程就绪时立即调度
+        pcb_t *current = scheduler_get_current_process();
+        if (!current || current == idle) {
+            scheduler_schedule();
+            current = scheduler_get_current_process();
+        }
+
+        // 4. 当前进程运行一个tick
+        if (current && current != idle) {
+            sim_task_t *task = current->cold->private_data;
+            uint32_t index = (uint32_t)(task - tasks);
+
+            if (!task->started) {
+                task->started = true;
+                sample_add(&response, now - task->spec->arrival);
+            }
+            if (task->waking) {
+                task->waking = false;
+                sample_add(&wakeup, now - task->ready_since);
+                if (task->spec->cls == TASK_CLASS_INTERACTIVE) {
+                    sample_add(&iwakeup, now - task->ready_since);
+                }
+            }
+
+            task->run_ticks++;
+            if (--task->remaining == 0) {
+                task->phase++;
+
+                if (task->phase >= task->spec->num_phases) {
+                    // 任务结束：退出、回收并调度下一个
+                    uint32_t finish = now + 1;
+                    uint32_t tat = finish - task->spec->arrival;
+                    uint32_t active = tat - task->blocked_ticks;
+                    double share = active ? (double)task->run_ticks / active : 1.0;
+
+                    sample_add(&turnaround, tat);
+                    fair_sum += share;
+                    fair_sq_sum += share * share;
+                    completed++;
+
+                    uint32_t pid = task->pcb->pid;
+                    task->pcb = NULL;
+                    scheduler_terminate_process(pid, 0);
+                    scheduler_reap_process(pid);
+                    scheduler_schedule();
+                } else {
+                    // 进入IO阶段：阻塞，IO完成时由事件唤醒
+                    uint32_t io = task->spec->phases[task->phase++];
+                    task->remaining = task->spec->phases[task->phase];
+                    task->blocked_ticks += io;
+                    heap_push(&heap, now + 1 + io, index);
+                    scheduler_block_process(WAIT_REASON_IO);
+                }
+            }
+        }
+
+        // 5. 定时器中断
+        sim_fire_irq(IRQ_TIMER);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    if (record_buf) {
+        replay_finish(&recorder);
+        scheduler_set_recorder(NULL);
+    }
+
+    scheduler_stats_t stats = scheduler_get_stats();
+
+    result->policy = policy->name;
+    result->time_quantum = (type == SCHEDULER_FIFO) ? 0 : quantum;
+    result->boost_interval = (type == SCHEDULER_MLFQ) ? boost : 0;
+    result->tasks = wl->count;
+    result->completed = completed;
+    result->sim_ticks = now;
+    result->avg_turnaround = sample_mean(&turnaround);
+    result->p99_turnaround = sample_percentile(&turnaround, 0.99);
+    result->avg_response = sample_mean(&response);
+    result->p99_response = sample_percentile(&response, 0.99);
+    result->avg_wakeup = sample_mean(&wakeup);
+    result->p99_wakeup = sample_percentile(&wakeup, 0.99);
+    result->avg_interactive_wakeup = sample_mean(&iwakeup);
+    result->p99_interactive_wakeup = sample_percentile(&iwakeup, 0.99);
+    result->fairness = fair_sq_sum > 0.0 ? (fair_sum * fair_sum) / (completed * fair_sq_sum) : 0.0;
+    result->context_switches = stats.context_switches;
+    result->wall_ms = (wall_end.tv_sec - wall_start.tv_sec) * 1e3 +
+                      (wall_end.tv_nsec - wall_start.tv_nsec) / 1e6;
+    if (record_buf && replay_save(record_path, &config, result->wall_ms) != 0) {
+        exit(1);
+    }
+
+    free(heap.events);
+    free(turnaround.values);
+    free(response.values);
+    free(wakeup.values);
+    free(iwakeup.values);
+    free(tasks);
+}
+
+/* ========== 录制与重放 ========== */
+
+static int replay_save(const char *path, const scheduler_config_t *config, double wall_ms) {
+    if (recorder.overflow) {
+        fprintf(stderr, "Error: replay log exceeds %u bytes\n", REPLAY_BUF_SIZE);
+        return -1;
+    }
+
+    replay_header_t header = {
+        .magic = REPLAY_MAGIC,
+        .version = REPLAY_VERSION,
+        .max_processes = MAX_PROCESSES,
+        .scheduler_type = config->scheduler_type,
+        .time_quantum = config->time_quantum,
+        .boost_interval = config->boost_interval,
+        .enable_preemption = config->enable_preemption,
+        .adaptive_mlfq = config->adaptive_mlfq,
+        .wakeup_preemption = config->wakeup_preemption,
+        .ticks = recorder.now,
+        .picks = recorder.picks,
+        .entries = recorder.entries,
+        .length = recorder.len,
+        .wall_ms = wall_ms
+    };
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(record_buf, 1, recorder.len, f) == recorder.len;
+    ok &= fclose(f) == 0;
+    if (!ok) {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(stderr, "Recorded %u ticks, %u picks in %u entries (%u bytes, %.2f bytes/tick) to %s\n",
+            header.ticks, header.picks, header.entries, header.length,
+            header.ticks ? (double)header.length / header.ticks : 0.0, path);
+    return 0;
+}
+
+static void print_entry(const char *label, const replay_entry_t *e) {
+    fprintf(stderr, "  %s: %s", label, e->op ? replay_op_name(e->op) : "(none)");
+    for (int i = 0; i < REPLAY_MAX_ARGS && e->op; i++) {
+        fprintf(stderr, " %u", e->args[i]);
+    }
+    fprintf(stderr, "\n");
+}
+
+/* 按录制的输入驱动调度器核心，校验每次选择；一致返回0 */
+static int replay_run(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    replay_header_t header;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        memcmp(header.magic, REPLAY_MAGIC, 4) != 0 || header.version != REPLAY_VERSION) {
+        fprintf(stderr, "Error: %s is not a replay log\n", path);
+        fclose(f);
+        return 1;
+    }
+    if (header.max_processes != MAX_PROCESSES) {
+        fprintf(stderr, "Error: log recorded with MAX_PROCESSES=%u, this build uses %d\n",
+                header.max_processes, MAX_PROCESSES);
+        fclose(f);
+        return 1;
+    }
+    uint8_t *log = malloc(header.length ? header.length : 1);
+    if (!log || fread(log, 1, header.length, f) != header.length) {
+        fprintf(stderr, "Error: truncated replay log %s\n", path);
+        fclose(f);
+        free(log);
+        return 1;
+    }
+    fclose(f);
+
+    struct timespec wall_start, wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+    sim_host_reset();
+    scheduler_config_t config = {
+        .scheduler_type = header.scheduler_type,
+        .time_quantum = header.time_quantum,
+        .enable_preemption = header.enable_preemption,
+        .enable_multicore = false,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = header.boost_interval,
+        .load_balance_interval = 500,
+        .adaptive_mlfq = header.adaptive_mlfq,
+        .wakeup_preemption = header.wakeup_preemption
+    };
+    scheduler_init(&config);
+
+    replay_t rp;
+    replay_init_verify(&rp, log, header.length);
+    scheduler_set_recorder(&rp);
+
+    replay_entry_t e;
+    while (replay_next(&rp, &e)) {
+        uint32_t *a = e.args;
+        switch (e.op) {
+            case REPLAY_TICK:
+                for (uint32_t i = 0; i < a[0] && !rp.diverged; i++) {
+                    sim_fire_irq(IRQ_TIMER);
+                }
+                break;
+            case REPLAY_CREATE: {
+                pcb_t *pcb = scheduler_create_process("replay", (process_type_t)a[0], (uint8_t)a[1],
+                                                      (process_flags_t)a[2]);
+                uint32_t pid = pcb ? pcb->pid : 0;
+                if (pid != a[3]) {
+                    replay_mismatch(&rp, &e, pid);
+                }
+                break;
+            }
+            case REPLAY_EXIT:        scheduler_terminate_process(a[0], (int)a[1]); break;
+            case REPLAY_REAP:        scheduler_reap_process(a[0]); break;
+            case REPLAY_BLOCK:       scheduler_block_process(a[0]); break;
+            case REPLAY_WAKEUP:      scheduler_wakeup_process(a[0]); break;
+            case REPLAY_SLEEP:       scheduler_sleep_process(a[0]); break;
+            case REPLAY_YIELD:       scheduler_yield(); break;
+            case REPLAY_SCHEDULE:    scheduler_schedule(); break;
+            case REPLAY_PRIORITY:    scheduler_set_priority(a[0], (uint8_t)a[1]); break;
+            case REPLAY_REAPER:      scheduler_reap_deferred(a[0]); break;
+            default: break;
+        }
+    }
+    scheduler_set_recorder(NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    double wall_ms = (wall_end.tv_sec - wall_start.tv_sec) * 1e3 +
+                     (wall_end.tv_nsec - wall_start.tv_nsec) / 1e6;
+    scheduler_stats_t stats = scheduler_get_stats();
+
+    fprintf(stderr, "Replayed %u/%u entries, %u/%u ticks, %u/%u picks, %u context switches\n",
+            rp.entries, header.entries, rp.now, header.ticks, rp.picks, header.picks,
+            stats.context_switches);
+    fprintf(stderr, "Replay took %.1f ms (%.1f M ticks/s); recorded simulation took %.1f ms\n",
+            wall_ms, wall_ms > 0 ? rp.now / wall_ms / 1e3 : 0.0, header.wall_ms);
+    free(log);
+
+    if (rp.diverged) {
+        fprintf(stderr, "DIVERGED at tick %u (log offset %u):\n", rp.diverge_tick, rp.diverge_pos);
+        print_entry("recorded", &rp.expected);
+        print_entry("replayed", &rp.actual);
+        return 1;
+    }
+    if (rp.pos != header.length) {
+        fprintf(stderr, "DIVERGED: replay stopped at log offset %u of %u\n", rp.pos, header.length);
+        return 1;
+    }
+    fprintf(stderr, "Replay identical\n");
+    return 0;
+}
+
+/* ========== 命令行 ========== */
+
+static void print_csv_header(FILE *out) {
+    fprintf(out, "policy,time_quantum,boost_interval,tasks,completed,sim_ticks,"
+                 "avg_turnaround,p99_turnaround,avg_response,p99_response,"
+                 "avg_wakeup_latency,p99_wakeup_latency,fairness,context_switches,"
+                 "avg_interactive_wakeup,p99_interactive_wakeup,wall_ms\n");
+}
+
+static void print_csv_row(FILE *out, const sim_result_t *r) {
+    fprintf(out, "%s,%u,%u,%u,%u,%u,%.2f,%u,%.2f,%u,%.2f,%u,%.4f,%u,%.2f,%u,%.1f\n",
+            r->policy, r->time_quantum, r->boost_interval, r->tasks, r->completed,
+            r->sim_ticks, r->avg_turnaround, r->p99_turnaround, r->avg_response,
+            r->p99_response, r->avg_wakeup, r->p99_wakeup, r->fairness,
+            r->context_switches, r->avg_interactive_wakeup, r->p99_interactive_wakeup,
+            r->wall_ms);
+    fflush(out);
+}
+
+/* 解析逗号分隔的数值列表 */
+static int parse_list(const char *arg, uint32_t *values, int max) {
+    int count = 0;
+    const char *p = arg;
+    while (*p && count < max) {
+        char *end;
+        values[count++] = (uint32_t)strtoul(p, &end, 10);
+        if (end == p) {
+            return -1;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+/* 逗号分隔的列表中是否有与name完全相同的一项 */
+static bool list_contains(const char *list, const char *name) {
+    size_t len = strlen(name);
+    for (const char *p = list; *p; ) {
+        const char *end = strchr(p, ',');
+        size_t n = end ? (size_t)(end - p) : strlen(p);
+        if (n == len && strncmp(p, name, len) == 0) {
+            return true;
+        }
+        if (!end) {
+            break;
+        }
+        p = end + 1;
+    }
+    return false;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -p LIST   policies to run: fifo,rr,mlfq,amlfq (adaptive MLFQ); rr-wp,mlfq-wp,amlfq-wp\n"
+        "            add wake-up preemption of interactive tasks (default: fifo,rr,mlfq)\n"
+        "  -q LIST   time_quantum values to sweep (default: 10)\n"
+        "  -b LIST   boost_interval values to sweep, MLFQ only (default: 1000)\n"
+        "  -n N      number of synthetic tasks (default: 2000)\n"
+        "  -m MIX    task mix: mixed | cpu=W,io=W,interactive=W,bursty=W (default: mixed)\n"
+        "  -l LOAD   target CPU load of the synthetic workload (default: 0.9)\n"
+        "  -s SEED   random seed (default: 1)\n"
+        "  -w FILE   replay a recorded workload instead of generating one\n"
+        "  -W FILE   save the workload that is simulated\n"
+        "  -T TICKS  stop each run after TICKS simulated ticks (default: 20000000)\n"
+        "  -o FILE   write CSV to FILE instead of stdout\n"
+        "  -i        deliver IO completions from a disk IRQ via the lock-free wake list\n"
+        "  -R FILE   record every scheduling input and decision of a single run to FILE\n"
+        "  -P FILE   replay a recorded log and verify the scheduler makes identical decisions\n",
+        prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *policies = "fifo,rr,mlfq";
+    const char *mix = "mixed";
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    const char *out_path = NULL;
+    uint32_t quanta[MAX_SWEEP_VALUES] = {10};
+    uint32_t boosts[MAX_SWEEP_VALUES] = {1000};
+    int num_quanta = 1, num_boosts = 1;
+    uint32_t num_tasks = 2000;
+    uint32_t max_ticks = 20000000;
+    double load = 0.9;
+    uint64_t seed = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:q:b:n:m:l:s:w:W:T:o:iR:P:h")) != -1) {
+        switch (opt) {
+            case 'p': policies = optarg; break;
+            case 'q': num_quanta = parse_list(optarg, quanta, MAX_SWEEP_VALUES); break;
+            case 'b': num_boosts = parse_list(optarg, boosts, MAX_SWEEP_VALUES); break;
+            case 'n': num_tasks = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'm': mix = optarg; break;
+            case 'l': load = strtod(optarg, NULL); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'w': load_path = optarg; break;
+            case 'W': save_path = optarg; break;
+            case 'T': max_ticks = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'o': out_path = optarg; break;
+            case 'i': irq_wakeups = true; break;
+            case 'R': record_path = optarg; break;
+            case 'P': return replay_run(optarg);
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (num_quanta <= 0 || num_boosts <= 0) {
+        fprintf(stderr, "Error: invalid -q/-b list\n");
+        return 1;
+    }
+
+    sim_workload_t wl;
+    int rc = load_path ? workload_load(&wl, load_path)
+                       : workload_generate(&wl, mix, num_tasks, load, seed);
+    if (rc != 0 || wl.count == 0) {
+        fprintf(stderr, "Error: failed to build workload\n");
+        return 1;
+    }
+    if (save_path && workload_save(&wl, save_path) != 0) {
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            perror(out_path);
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "Workload: %u tasks, %llu CPU ticks demanded, MAX_PROCESSES=%d\n",
+            wl.count, (unsigned long long)workload_cpu_demand(&wl), MAX_PROCESSES);
+
+    static const sim_policy_t all_policies[] = {
+        {"fifo", SCHEDULER_FIFO, false, false}, {"rr", SCHEDULER_RR, false, false},
+        {"mlfq", SCHEDULER_MLFQ, false, false}, {"amlfq", SCHEDULER_MLFQ, true, false},
+        {"rr-wp", SCHEDULER_RR, false, true}, {"mlfq-wp", SCHEDULER_MLFQ, false, true},
+        {"amlfq-wp", SCHEDULER_MLFQ, true, true}
+    };
+
+    // 录制只针对单次运行：只能选一种策略和一组参数
+    if (record_path) {
+        int runs = 0;
+        for (size_t p = 0; p < sizeof(all_policies) / sizeof(all_policies[0]); p++) {
+            if (list_contains(policies, all_policies[p].name)) {
+                uint32_t type = all_policies[p].type;
+                runs += ((type == SCHEDULER_FIFO) ? 1 : num_quanta) *
+                        ((type == SCHEDULER_MLFQ) ? num_boosts : 1);
+            }
+        }
+        record_buf = malloc(REPLAY_BUF_SIZE);
+        if (runs != 1 || !record_buf) {
+            fprintf(stderr, "Error: -R records exactly one run (got %d)\n", runs);
+            return 1;
+        }
+    }
+
+    print_csv_header(out);
+
+    for (size_t p = 0; p < sizeof(all_policies) / sizeof(all_policies[0]); p++) {
+        if (!list_contains(policies, all_policies[p].name)) {
+            continue;
+        }
+        uint32_t type = all_policies[p].type;
+
+        // FIFO与参数无关，RR只扫描时间片，MLFQ扫描两者
+        int nq = (type == SCHEDULER_FIFO) ? 1 : num_quanta;
+        int nb = (type == SCHEDULER_MLFQ) ? num_boosts : 1;
+
+        for (int qi = 0; qi < nq; qi++) {
+            for (int bi = 0; bi < nb; bi++) {
+                sim_result_t result;
+                sim_run(&wl, &all_policies[p], quanta[qi], boosts[bi], max_ticks, &result);
+                print_csv_row(out, &result);
+            }
+        }
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    free(record_buf);
+    workload_free(&wl);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * sim_host.c - 主机模拟器平台层实现
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sim_host.h"
+
+uint32_t sim_current_cpu = 0;
+irqflags_t sim_irqflags[MAX_CPUS] = { [0 ... MAX_CPUS - 1] = IRQFLAGS_IF };
+
+static irq_handler_t irq_handlers[NUM_IRQS];
+static irq_handler_t exception_handlers[NUM_EXCEPTIONS];
+
+void interrupt_register_handler(uint8_t irq, irq_handler_t handler) {
+    if (irq < NUM_IRQS) {
+        irq_handlers[irq] = handler;
+    }
+}
+
+void interrupt_register_exception(uint8_t vector, irq_handler_t handler) {
+    if (vector < NUM_EXCEPTIONS) {
+        exception_handlers[vector] = handler;
+    }
+}
+
+void sim_fire_irq(uint8_t irq) {
+    if (irq < NUM_IRQS && irq_handlers[irq]) {
+        // 中断门：处理函数运行期间本CPU关中断，返回时恢复
+        irqflags_t flags = local_irq_save();
+        irq_handlers[irq]();
+        local_irq_restore(flags);
+    }
+}
+
+void sim_raise_exception(uint8_t vector) {
+    if (vector < NUM_EXCEPTIONS && exception_handlers[vector]) {
+        exception_handlers[vector]();
+    }
+}
+
+void sim_host_reset(void) {
+    for (int i = 0; i < NUM_IRQS; i++) {
+        irq_handlers[i] = NULL;
+    }
+    for (int i = 0; i < NUM_EXCEPTIONS; i++) {
+        exception_handlers[i] = NULL;
+    }
+    sim_current_cpu = 0;
+    for (int i = 0; i < MAX_CPUS; i++) {
+        sim_irqflags[i] = IRQFLAGS_IF;
+    }
+}
+
+/* ========== FPU模拟 ========== */
+
+/* 每个CPU一份模拟的CR0.TS和FXSAVE格式的寄存器区 */
+static bool fpu_ts[MAX_CPUS];
+static uint8_t fpu_regs[MAX_CPUS][512];
+
+void enable_sse(void) {
+}
+
+void fpu_set_ts(void) {
+    fpu_ts[sim_current_cpu] = true;
+}
+
+void fpu_clear_ts(void) {
+    fpu_ts[sim_current_cpu] = false;
+}
+
+void fpu_reset_state(void) {
+    memset(fpu_regs[sim_current_cpu], 0, sizeof(fpu_regs[0]));
+}
+
+void save_fpu_state(uint8_t *buffer) {
+    memcpy(buffer, fpu_regs[sim_current_cpu], sizeof(fpu_regs[0]));
+}
+
+void restore_fpu_state(const uint8_t *buffer) {
+    memcpy(fpu_regs[sim_current_cpu], buffer, sizeof(fpu_regs[0]));
+}
+
+uint8_t* sim_fpu_use(void) {
+    if (fpu_ts[sim_current_cpu]) {
+        sim_raise_exception(EXC_DEVICE_NOT_AVAILABLE);
+    }
+    return fpu_regs[sim_current_cpu];
+}
@@ -0,0 +1,30 @@
+/**
+ * sim_host.h - 主机模拟器平台层
+ *
+ * 在Linux主机上代替真实硬件：接管内核注册的IRQ处理函数，
+ * 由模拟器按需"触发"中断，从而驱动真实的调度器核心代码。
+ */
+
+#ifndef _SPARROW_SIM_HOST_H
+#define _SPARROW_SIM_HOST_H
+
+#include <stdint.h>
+#include "kernel/include/interrupt.h"
+
+#include "kernel/include/percpu.h"
+#include "kernel/include/irqflags.h"
+
+/* 触发一次IRQ（调用内核注册的处理函数） */
+void sim_fire_irq(uint8_t irq);
+
+/* 触发一次CPU异常 */
+void sim_raise_exception(uint8_t vector);
+
+/* 模拟当前CPU执行一条FPU/SSE指令：TS置位时先触发#NM，
+ * 返回该CPU的模拟FPU寄存器区，调用者可读写以检验状态是否被正确保存 */
+uint8_t* sim_fpu_use(void);
+
+/* 清除已注册的处理函数（每轮模拟前调用） */
+void sim_host_reset(void);
+
+#endif /* _SPARROW_SIM_HOST_H */
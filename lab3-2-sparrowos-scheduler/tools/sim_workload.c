@@ -0,0 +1,325 @@
+/**
+ * sim_workload.c - 合成负载生成与负载文件读写
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_workload.h"
+
+static const char *class_names[TASK_CLASS_COUNT] = {
+    "cpu", "io", "interactive", "bursty"
+};
+
+/* xorshift64* 伪随机数，保证同一种子得到同一负载 */
+static uint64_t rng_state;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+/* [lo, hi] 区间内均匀分布 */
+static uint32_t rng_range(uint32_t lo, uint32_t hi) {
+    return lo + (uint32_t)(rng_next() % (uint64_t)(hi - lo + 1));
+}
+
+const char* task_class_name(task_class_t cls) {
+    return cls < TASK_CLASS_COUNT ? class_names[cls] : "unknown";
+}
+
+static int class_from_name(const char *name, size_t len) {
+    for (int i = 0; i < TASK_CLASS_COUNT; i++) {
+        if (strlen(class_names[i]) == len && strncmp(class_names[i], name, len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static sim_task_spec_t* workload_append(sim_workload_t *wl) {
+    if (wl->count == wl->capacity) {
+        uint32_t cap = wl->capacity ? wl->capacity * 2 : 256;
+        sim_task_spec_t *tasks = realloc(wl->tasks, cap * sizeof(sim_task_spec_t));
+        if (!tasks) {
+            return NULL;
+        }
+        wl->tasks = tasks;
+        wl->capacity = cap;
+    }
+    sim_task_spec_t *task = &wl->tasks[wl->count++];
+    memset(task, 0, sizeof(*task));
+    return task;
+}
+
+/* 按类别生成阶段序列 */
+static int generate_phases(sim_task_spec_t *task) {
+    uint32_t cycles = 0;
+    uint32_t cpu_lo = 1, cpu_hi = 1, io_lo = 0, io_hi = 0;
+
+    switch (task->cls) {
+        case TASK_CLASS_CPU:
+            cycles = 1;
+            cpu_lo = 50;  cpu_hi = 500;
+            break;
+        case TASK_CLASS_IO:
+            cycles = rng_range(10, 30);
+            cpu_lo = 1;   cpu_hi = 4;
+            io_lo = 5;    io_hi = 30;
+            break;
+        case TASK_CLASS_INTERACTIVE:
+            cycles = rng_range(10, 40);
+            cpu_lo = 1;   cpu_hi = 3;
+            io_lo = 20;   io_hi = 200;
+            break;
+        case TASK_CLASS_BURSTY:
+            cycles = rng_range(1, 2);
+            cpu_lo = 5;   cpu_hi = 40;
+            io_lo = 2;    io_hi = 10;
+            break;
+        default:
+            return -1;
+    }
+
+    task->num_phases = 2 * cycles - 1;
+    task->phases = malloc(task->num_phases * sizeof(uint32_t));
+    if (!task->phases) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < task->num_phases; i++) {
+        task->phases[i] = (i % 2 == 0) ? rng_range(cpu_lo, cpu_hi) : rng_range(io_lo, io_hi);
+    }
+    return 0;
+}
+
+/* 解析类别权重串 */
+static int parse_mix(const char *mix, uint32_t weights[TASK_CLASS_COUNT]) {
+    memset(weights, 0, TASK_CLASS_COUNT * sizeof(uint32_t));
+
+    if (!mix || strcmp(mix, "mixed") == 0) {
+        weights[TASK_CLASS_CPU] = 2;
+        weights[TASK_CLASS_IO] = 3;
+        weights[TASK_CLASS_INTERACTIVE] = 3;
+        weights[TASK_CLASS_BURSTY] = 2;
+        return 0;
+    }
+
+    const char *p = mix;
+    while (*p) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        const char *eq = memchr(p, '=', len);
+        size_t name_len = eq ? (size_t)(eq - p) : len;
+
+        int cls = class_from_name(p, name_len);
+        if (cls < 0) {
+            fprintf(stderr, "Unknown task class in mix: %.*s\n", (int)name_len, p);
+            return -1;
+        }
+        weights[cls] = eq ? (uint32_t)strtoul(eq + 1, NULL, 10) : 1;
+
+        p += len;
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return 0;
+}
+
+static int compare_arrival(const void *a, const void *b) {
+    const sim_task_spec_t *ta = a;
+    const sim_task_spec_t *tb = b;
+    if (ta->arrival != tb->arrival) {
+        return ta->arrival < tb->arrival ? -1 : 1;
+    }
+    return 0;
+}
+
+int workload_generate(sim_workload_t *wl, const char *mix, uint32_t num_tasks,
+                      double load, uint64_t seed) {
+    uint32_t weights[TASK_CLASS_COUNT];
+    uint32_t total_weight = 0;
+
+    memset(wl, 0, sizeof(*wl));
+    if (num_tasks == 0 || load <= 0.0 || parse_mix(mix, weights) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < TASK_CLASS_COUNT; i++) {
+        total_weight += weights[i];
+    }
+    if (total_weight == 0) {
+        return -1;
+    }
+
+    rng_state = seed ? seed : 0x9E3779B97F4A7C15ULL;
+
+    // 先生成各任务的类别和阶段
+    for (uint32_t i = 0; i < num_tasks; i++) {
+        sim_task_spec_t *task = workload_append(wl);
+        if (!task) {
+            workload_free(wl);
+            return -1;
+        }
+
+        uint32_t pick = (uint32_t)(rng_next() % total_weight);
+        int cls = 0;
+        while (pick >= weights[cls]) {
+            pick -= weights[cls];
+            cls++;
+        }
+        task->cls = (task_class_t)cls;
+        task->priority = 0;
+
+        if (generate_phases(task) != 0) {
+            workload_free(wl);
+            return -1;
+        }
+    }
+
+    // 按目标负载确定到达窗口，再分配到达时刻
+    uint32_t window = (uint32_t)((double)workload_cpu_demand(wl) / load);
+    if (window == 0) {
+        window = 1;
+    }
+
+    uint32_t cluster_left = 0;
+    uint32_t cluster_time = 0;
+    for (uint32_t i = 0; i < wl->count; i++) {
+        sim_task_spec_t *task = &wl->tasks[i];
+        if (task->cls == TASK_CLASS_BURSTY) {
+            // 突发型任务成批到达
+            if (cluster_left == 0) {
+                cluster_left = rng_range(16, 64);
+                cluster_time = rng_range(0, window - 1);
+            }
+            task->arrival = cluster_time;
+            cluster_left--;
+        } else {
+            task->arrival = rng_range(0, window - 1);
+        }
+    }
+
+    qsort(wl->tasks, wl->count, sizeof(sim_task_spec_t), compare_arrival);
+    return 0;
+}
+
+int workload_load(sim_workload_t *wl, const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+
+    memset(wl, 0, sizeof(*wl));
+
+    char line[4096];
+    uint32_t lineno = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        lineno++;
+
+        char *p = line;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') {
+            continue;
+        }
+
+        // 格式: arrival priority class phase0 phase1 ...
+        char *save = NULL;
+        char *tok_arrival = strtok_r(p, " \t\r\n", &save);
+        char *tok_priority = strtok_r(NULL, " \t\r\n", &save);
+        char *tok_class = strtok_r(NULL, " \t\r\n", &save);
+        if (!tok_arrival || !tok_priority || !tok_class) {
+            fprintf(stderr, "%s:%u: malformed task line\n", path, lineno);
+            goto fail;
+        }
+
+        int cls = class_from_name(tok_class, strlen(tok_class));
+        if (cls < 0) {
+            fprintf(stderr, "%s:%u: unknown class '%s'\n", path, lineno, tok_class);
+            goto fail;
+        }
+
+        uint32_t phases[512];
+        uint32_t count = 0;
+        char *tok;
+        while ((tok = strtok_r(NULL, " \t\r\n", &save)) != NULL && count < 512) {
+            phases[count++] = (uint32_t)strtoul(tok, NULL, 10);
+        }
+        if (count == 0 || count % 2 == 0) {
+            fprintf(stderr, "%s:%u: phase list must be CPU,IO,...,CPU\n", path, lineno);
+            goto fail;
+        }
+
+        sim_task_spec_t *task = workload_append(wl);
+        if (!task) {
+            goto fail;
+        }
+        task->arrival = (uint32_t)strtoul(tok_arrival, NULL, 10);
+        task->priority = (uint8_t)strtoul(tok_priority, NULL, 10);
+        task->cls = (task_class_t)cls;
+        task->num_phases = count;
+        task->phases = malloc(count * sizeof(uint32_t));
+        if (!task->phases) {
+            goto fail;
+        }
+        memcpy(task->phases, phases, count * sizeof(uint32_t));
+        for (uint32_t i = 0; i < count; i += 2) {
+            if (task->phases[i] == 0) {
+                task->phases[i] = 1;    // CPU阶段至少1个tick
+            }
+        }
+    }
+
+    fclose(fp);
+    qsort(wl->tasks, wl->count, sizeof(sim_task_spec_t), compare_arrival);
+    return 0;
+
+fail:
+    fclose(fp);
+    workload_free(wl);
+    return -1;
+}
+
+int workload_save(const sim_workload_t *wl, const char *path) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(fp, "# SparrowOS scheduler simulator workload\n");
+    fprintf(fp, "# arrival priority class cpu [io cpu ...]\n");
+    for (uint32_t i = 0; i < wl->count; i++) {
+        const sim_task_spec_t *task = &wl->tasks[i];
+        fprintf(fp, "%u %u %s", task->arrival, task->priority, task_class_name(task->cls));
+        for (uint32_t j = 0; j < task->num_phases; j++) {
+            fprintf(fp, " %u", task->phases[j]);
+        }
+        fputc('\n', fp);
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+void workload_free(sim_workload_t *wl) {
+    for (uint32_t i = 0; i < wl->count; i++) {
+        free(wl->tasks[i].phases);
+    }
+    free(wl->tasks);
+    memset(wl, 0, sizeof(*wl));
+}
+
+uint64_t workload_cpu_demand(const sim_workload_t *wl) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < wl->count; i++) {
+        for (uint32_t j = 0; j < wl->tasks[i].num_phases; j += 2) {
+            total += wl->tasks[i].phases[j];
+        }
+    }
+    return total;
+}
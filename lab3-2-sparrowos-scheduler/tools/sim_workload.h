@@ -0,0 +1,57 @@
+/**
+ * sim_workload.h - 模拟器工作负载定义
+ *
+ * 每个任务由到达时刻、优先级、类别和一串阶段组成：
+ * 阶段按 CPU, IO, CPU, IO, ..., CPU 交替排列（长度为奇数），单位为tick。
+ */
+
+#ifndef _SPARROW_SIM_WORKLOAD_H
+#define _SPARROW_SIM_WORKLOAD_H
+
+#include <stdint.h>
+
+/* 任务类别 */
+typedef enum {
+    TASK_CLASS_CPU = 0,         // CPU密集型：长计算突发
+    TASK_CLASS_IO,              // IO密集型：短突发 + 设备等待
+    TASK_CLASS_INTERACTIVE,     // 交互式：极短突发 + 长思考时间
+    TASK_CLASS_BURSTY,          // 突发型：成批同时到达的短作业
+    TASK_CLASS_COUNT
+} task_class_t;
+
+/* 单个任务描述 */
+typedef struct {
+    uint32_t arrival;           // 到达时刻（tick）
+    uint8_t priority;           // 初始优先级
+    task_class_t cls;           // 类别
+    uint32_t num_phases;        // 阶段数（奇数）
+    uint32_t *phases;           // 阶段长度数组
+} sim_task_spec_t;
+
+/* 工作负载（任务按到达时刻升序排列） */
+typedef struct {
+    sim_task_spec_t *tasks;
+    uint32_t count;
+    uint32_t capacity;
+} sim_workload_t;
+
+/* 生成合成负载
+ * mix:  类别权重，如 "mixed" 或 "cpu=2,io=3,interactive=3,bursty=2"
+ * load: 目标CPU负载（总CPU需求 / 到达窗口长度）
+ * 返回0成功，-1参数错误
+ */
+int workload_generate(sim_workload_t *wl, const char *mix, uint32_t num_tasks,
+                      double load, uint64_t seed);
+
+/* 读取/保存录制的负载文件 */
+int workload_load(sim_workload_t *wl, const char *path);
+int workload_save(const sim_workload_t *wl, const char *path);
+
+void workload_free(sim_workload_t *wl);
+
+/* 总CPU需求（tick） */
+uint64_t workload_cpu_demand(const sim_workload_t *wl);
+
+const char* task_class_name(task_class_t cls);
+
+#endif /* _SPARROW_SIM_WORKLOAD_H */
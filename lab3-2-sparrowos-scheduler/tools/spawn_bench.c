@@ -0,0 +1,162 @@
+/**
+ * spawn_bench.c - 进程创建微基准测试
+ *
+ * 仿照 lab1-2 的 process_tree.c：按层生成一棵深度depth、每个节点branch个
+ * 子进程的进程树，每个父进程的子进程是一次突发创建。对比逐个调用
+ * scheduler_create_process() 与每个父进程一次 scheduler_create_processes()，
+ * 以及内核栈是否已在空闲时预先清零（两轮之间让CPU空闲若干tick）。
+ * 只计创建耗时；每轮结束后终止并回收全部进程。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "kernel/include/scheduler.h"
+#include "tools/sim_host.h"
+
+#define DEFAULT_DEPTH   5
+#define DEFAULT_BRANCH  4
+#define DEFAULT_ROUNDS  50
+#define MAX_BRANCH      64
+
+/* ========== 计时 ========== */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ========== 基准场景 ========== */
+
+typedef struct {
+    double per_process;     // 每个进程的创建耗时（ns）
+    uint32_t clean_hits;    // 取到已清零栈的次数
+    uint32_t zeroed_inline; // 在创建路径上清零栈的次数
+} bench_result_t;
+
+static pcb_t **created;
+
+static void setup(void) {
+    sim_host_reset();
+
+    scheduler_config_t config = {
+        .scheduler_type = SCHEDULER_MLFQ,
+        .time_quantum = 10,
+        .enable_preemption = true,
+        .num_priority_levels = MAX_PRIORITY_LEVELS,
+        .boost_interval = 1000,
+        .load_balance_interval = 500
+    };
+    scheduler_init(&config);
+}
+
+/* 创建一棵进程树，返回创建耗时 */
+static double spawn_tree(uint32_t depth, uint32_t branch, bool batch, uint32_t *total) {
+    process_spec_t specs[MAX_BRANCH];
+    for (uint32_t i = 0; i < branch; i++) {
+        specs[i] = (process_spec_t){ "worker", PROCESS_TYPE_USER, 1, PROCESS_FLAG_NONE };
+    }
+
+    uint32_t n = 0;
+    uint32_t parents = 1;
+    double t = now_ns();
+    for (uint32_t level = 0; level < depth; level++) {
+        for (uint32_t p = 0; p < parents; p++) {
+            if (batch) {
+                scheduler_create_processes(specs, branch, &created[n]);
+                n += branch;
+            } else {
+                for (uint32_t i = 0; i < branch; i++) {
+                    created[n++] = scheduler_create_process(specs[i].name, specs[i].type,
+                                                            specs[i].priority, specs[i].flags);
+                }
+            }
+        }
+        parents *= branch;
+    }
+    t = now_ns() - t;
+
+    *total = n;
+    return t;
+}
+
+static void bench(uint32_t depth, uint32_t branch, uint32_t rounds, bool batch,
+                  bool prezero, bench_result_t *r) {
+    setup();
+    double elapsed = 0;
+    uint64_t processes = 0;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        uint32_t n;
+        elapsed += spawn_tree(depth, branch, batch, &n);
+        processes += n;
+
+        for (uint32_t i = 0; i < n; i++) {
+            scheduler_terminate_process(created[i]->pid, 0);
+            scheduler_reap_process(created[i]->pid);
+        }
+        scheduler_reap_deferred(0);
+
+        // CPU空闲期间由时钟tick清零释放的栈
+        if (prezero) {
+            scheduler_schedule();
+            for (uint32_t t = 0; t <= n / KSTACK_REFILL_BATCH; t++) {
+                sim_fire_irq(IRQ_TIMER);
+            }
+        }
+    }
+
+    kstack_stats_t stats = scheduler_get_kstack_stats();
+    r->per_process = elapsed / processes;
+    r->clean_hits = stats.clean_hits;
+    r->zeroed_inline = stats.zeroed_inline;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t depth = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_DEPTH;
+    uint32_t branch = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : DEFAULT_BRANCH;
+    uint32_t rounds = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : DEFAULT_ROUNDS;
+
+    // 进程总数 branch + branch^2 + ... + branch^depth，留一个槽位给空闲进程
+    uint64_t total = 0, level = 1;
+    for (uint32_t i = 0; i < depth; i++) {
+        level *= branch;
+        total += level;
+    }
+    if (depth == 0 || branch == 0 || branch > MAX_BRANCH || rounds == 0 ||
+        total > MAX_PROCESSES - 1) {
+        fprintf(stderr, "Usage: %s [depth] [branch<=%d] [rounds]  (at most %d processes)\n",
+                argv[0], MAX_BRANCH, MAX_PROCESSES - 1);
+        return 1;
+    }
+
+    created = calloc(total, sizeof(pcb_t *));
+    if (!created) {
+        perror("alloc");
+        return 1;
+    }
+
+    printf("Process creation microbenchmark: depth %u, branch %u (%llu processes), %u rounds\n",
+           depth, branch, (unsigned long long)total, rounds);
+    printf("%-8s %-10s %14s %12s %14s\n", "create", "stacks", "ns/process", "pre-zeroed",
+           "zeroed inline");
+
+    static const struct { const char *create; const char *stacks; bool batch; bool prezero; }
+    modes[] = {
+        { "single", "on demand", false, false },
+        { "single", "pre-zeroed", false, true },
+        { "batch",  "on demand", true,  false },
+        { "batch",  "pre-zeroed", true,  true },
+    };
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        bench_result_t r;
+        bench(depth, branch, rounds, modes[i].batch, modes[i].prezero, &r);
+        printf("%-8s %-10s %14.1f %12u %14u\n", modes[i].create, modes[i].stacks,
+               r.per_process, r.clean_hits, r.zeroed_inline);
+    }
+
+    free(created);
+    return 0;
+}
@@ -0,0 +1,245 @@
+/**
+ * switch_bench.c - 上下文切换开销基准测试（rdtsc）
+ *
+ * 在主机上用两个协程乒乓切换，对比三种切换方式每次切换的周期数：
+ *   min        只保存被调用者保存寄存器与栈指针（对应 switch_stack）
+ *   full       保存全部通用寄存器、EFLAGS、段寄存器，并拷贝到PCB上下文
+ *              （对应原先的 context_switch 完整帧路径）
+ *   full+fxsave 在full基础上每次切换都执行FXSAVE/FXRSTOR（急切FPU切换）
+ *
+ * 内核为i386，本机没有32位运行环境，这里用x86-64的等价实现测量；
+ * 两者指令序列一一对应，差异只在寄存器数量。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(__x86_64__)
+#error "switch_bench requires an x86-64 host"
+#endif
+
+#define DEFAULT_ITERS   200000
+#define DEFAULT_TRIALS  15
+#define CO_STACK_SIZE   (64 * 1024)
+
+/* ========== 切换原语 ========== */
+
+/* 完整帧上下文：栈指针 + 15个通用寄存器与RFLAGS + 段寄存器 + FXSAVE区 */
+typedef struct {
+    uint64_t sp;                    // 0
+    uint64_t regs[16];              // 8
+    uint16_t segs[6];               // 136
+    uint8_t  pad[12];               // 148
+    uint8_t  fxsave[512];           // 160，16字节对齐
+} __attribute__((aligned(64))) full_ctx_t;
+
+void bench_switch_min(uint64_t *prev_sp, uint64_t next_sp);
+void bench_switch_full(full_ctx_t *prev, full_ctx_t *next);
+void bench_switch_full_fx(full_ctx_t *prev, full_ctx_t *next);
+
+#define FULL_SAVE                                       \
+    "    pushfq\n"                                      \
+    "    pushq %rax\n    pushq %rbx\n    pushq %rcx\n"  \
+    "    pushq %rdx\n    pushq %rsi\n    pushq %rdi\n"  \
+    "    pushq %rbp\n    pushq %r8\n     pushq %r9\n"   \
+    "    pushq %r10\n    pushq %r11\n    pushq %r12\n"  \
+    "    pushq %r13\n    pushq %r14\n    pushq %r15\n"  \
+    "    movq %rsp, 0(%rdi)\n"                          \
+    "    xorl %ecx, %ecx\n"                             \
+    "1:  movq (%rsp,%rcx,8), %rax\n"                    \
+    "    movq %rax, 8(%rdi,%rcx,8)\n"                   \
+    "    incl %ecx\n"                                   \
+    "    cmpl $16, %ecx\n"                              \
+    "    jne 1b\n"                                      \
+    "    movw %ds, 136(%rdi)\n    movw %es, 138(%rdi)\n" \
+    "    movw %fs, 140(%rdi)\n    movw %gs, 142(%rdi)\n" \
+    "    movw %ss, 144(%rdi)\n    movw %cs, 146(%rdi)\n"
+
+#define FULL_RESTORE                                    \
+    "    movq 0(%rsi), %rsp\n"                          \
+    "    movw 136(%rsi), %ds\n"                         \
+    "    movw 138(%rsi), %es\n"                         \
+    "    xorl %ecx, %ecx\n"                             \
+    "2:  movq 8(%rsi,%rcx,8), %rax\n"                   \
+    "    movq %rax, (%rsp,%rcx,8)\n"                    \
+    "    incl %ecx\n"                                   \
+    "    cmpl $16, %ecx\n"                              \
+    "    jne 2b\n"                                      \
+    "    popq %r15\n    popq %r14\n    popq %r13\n"     \
+    "    popq %r12\n    popq %r11\n    popq %r10\n"     \
+    "    popq %r9\n     popq %r8\n     popq %rbp\n"     \
+    "    popq %rdi\n    popq %rsi\n    popq %rdx\n"     \
+    "    popq %rcx\n    popq %rbx\n    popq %rax\n"     \
+    "    popfq\n"                                       \
+    "    ret\n"
+
+__asm__(
+    ".text\n"
+    ".globl bench_switch_min\n"
+    "bench_switch_min:\n"
+    "    pushq %rbp\n    pushq %rbx\n    pushq %r12\n"
+    "    pushq %r13\n    pushq %r14\n    pushq %r15\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    popq %r15\n    popq %r14\n    popq %r13\n"
+    "    popq %r12\n    popq %rbx\n    popq %rbp\n"
+    "    ret\n"
+
+    ".globl bench_switch_full\n"
+    "bench_switch_full:\n"
+    FULL_SAVE
+    FULL_RESTORE
+
+    ".globl bench_switch_full_fx\n"
+    "bench_switch_full_fx:\n"
+    FULL_SAVE
+    "    fxsave 160(%rdi)\n"
+    "    fxrstor 160(%rsi)\n"
+    FULL_RESTORE
+);
+
+/* ========== 乒乓协程 ========== */
+
+typedef enum { MODE_NOP, MODE_MIN, MODE_FULL, MODE_FULL_FX } bench_mode_t;
+
+static bench_mode_t mode;
+static uint64_t main_sp, co_sp;
+static full_ctx_t main_ctx, co_ctx;
+static uint8_t *co_stack;
+
+/* 空调用，作为测量开销基线 */
+__attribute__((noinline)) static void nop_call(void) {
+    __asm__ volatile("" ::: "memory");
+}
+
+static inline void switch_to_co(void) {
+    switch (mode) {
+        case MODE_MIN:     bench_switch_min(&main_sp, co_sp); break;
+        case MODE_FULL:    bench_switch_full(&main_ctx, &co_ctx); break;
+        case MODE_FULL_FX: bench_switch_full_fx(&main_ctx, &co_ctx); break;
+        default:           nop_call(); nop_call(); break;
+    }
+}
+
+static void co_entry(void) {
+    for (;;) {
+        switch (mode) {
+            case MODE_MIN:  bench_switch_min(&co_sp, main_sp); break;
+            case MODE_FULL: bench_switch_full(&co_ctx, &main_ctx); break;
+            default:        bench_switch_full_fx(&co_ctx, &main_ctx); break;
+        }
+    }
+}
+
+/* 在协程栈上构造初始帧，使首次切入时"返回"到co_entry */
+static void co_prepare(void) {
+    // 返回后RSP需满足 RSP+8 16字节对齐（与函数入口一致）
+    uint64_t *top = (uint64_t *)(((uintptr_t)(co_stack + CO_STACK_SIZE) & ~(uintptr_t)15) - 8);
+    uint64_t *sp = top;
+
+    *--sp = (uint64_t)(uintptr_t)co_entry;
+    if (mode == MODE_MIN) {
+        for (int i = 0; i < 6; i++) {
+            *--sp = 0;
+        }
+        co_sp = (uint64_t)(uintptr_t)sp;
+        return;
+    }
+
+    // 完整帧：15个通用寄存器 + RFLAGS，内容由FULL_RESTORE从co_ctx拷回
+    sp -= 16;
+    memset(&co_ctx, 0, sizeof(co_ctx));
+    co_ctx.sp = (uint64_t)(uintptr_t)sp;
+    co_ctx.regs[15] = 0x202;
+    __asm__ volatile("movw %%ds, %0\n movw %%es, %1" : "=m"(co_ctx.segs[0]), "=m"(co_ctx.segs[1]));
+    __asm__ volatile("fxsave %0" : "=m"(co_ctx.fxsave));
+}
+
+/* ========== 计时 ========== */
+
+static inline uint64_t tsc_begin(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("lfence\n rdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline uint64_t tsc_end(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtscp\n lfence" : "=a"(lo), "=d"(hi) :: "rcx", "memory");
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    double min;         // 每次切换最少周期
+    double median;      // 每次切换周期中位数
+} bench_result_t;
+
+/* 每个往返包含两次切换（main->co，co->main） */
+static void run_mode(bench_mode_t m, uint32_t iters, uint32_t trials, bench_result_t *r) {
+    double *samples = malloc(trials * sizeof(double));
+    mode = m;
+    if (m != MODE_NOP) {
+        co_prepare();
+    }
+
+    for (uint32_t i = 0; i < iters / 10; i++) {
+        switch_to_co();
+    }
+    for (uint32_t t = 0; t < trials; t++) {
+        uint64_t start = tsc_begin();
+        for (uint32_t i = 0; i < iters; i++) {
+            switch_to_co();
+        }
+        uint64_t end = tsc_end();
+        samples[t] = (double)(end - start) / (2.0 * iters);
+    }
+
+    qsort(samples, trials, sizeof(double), cmp_double);
+    r->min = samples[0];
+    r->median = samples[trials / 2];
+    free(samples);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iters = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_ITERS;
+    uint32_t trials = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : DEFAULT_TRIALS;
+    if (iters == 0 || trials == 0) {
+        fprintf(stderr, "Usage: %s [round_trips] [trials]\n", argv[0]);
+        return 1;
+    }
+
+    co_stack = aligned_alloc(64, CO_STACK_SIZE);
+    if (!co_stack) {
+        perror("alloc");
+        return 1;
+    }
+
+    static const struct { bench_mode_t mode; const char *name; } modes[] = {
+        { MODE_NOP,     "call (base)" },
+        { MODE_MIN,     "min" },
+        { MODE_FULL,    "full" },
+        { MODE_FULL_FX, "full+fxsave" },
+    };
+    bench_result_t results[4];
+    for (int i = 0; i < 4; i++) {
+        run_mode(modes[i].mode, iters, trials, &results[i]);
+    }
+
+    printf("Context switch microbenchmark: %u round trips x %u trials (TSC cycles per switch)\n",
+           iters, trials);
+    printf("%-14s %12s %12s %12s\n", "switch", "min", "median", "vs min");
+    for (int i = 0; i < 4; i++) {
+        printf("%-14s %12.1f %12.1f %11.2fx\n", modes[i].name,
+               results[i].min, results[i].median, results[i].median / results[1].median);
+    }
+
+    free(co_stack);
+    return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * uthread_bench.c - 绿色线程与内核线程对比基准测试
+ *
+ * 两项测量，每项输出绿色线程（uthread/）与pthread各一行CSV：
+ *   yield      两个线程轮流让出 -n 次。绿色线程为1个工作线程上的
+ *              uthread_yield；pthread为绑定到同一CPU的两个线程互相
+ *              sched_yield，每次让出都经过一次内核调度。
+ *   pingpong   两个线程经一对管道往返 -n 次。绿色线程用非阻塞fd加
+ *              epoll（-w 个工作线程）；pthread用阻塞读写，每次往返
+ *              两次内核睡眠与唤醒。
+ *
+ * 输出列：benchmark,impl,workers,ops,ns_per_op,switches
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include "uthread/include/uthread.h"
+
+#define DEFAULT_ITERS   200000
+
+static uint32_t iters = DEFAULT_ITERS;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *bench, const char *impl, uint32_t workers,
+                   uint64_t ops, double seconds, uint64_t switches) {
+    printf("%s,%s,%u,%llu,%.1f,%llu\n", bench, impl, workers, (unsigned long long)ops,
+           seconds * 1e9 / ops, (unsigned long long)switches);
+    fflush(stdout);
+}
+
+static int start_runtime(uint32_t workers) {
+    uthread_config_t config = { .policy = UTHREAD_RR, .workers = workers };
+    return uthread_init(&config);
+}
+
+/* ========== yield ========== */
+
+static void green_yielder(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < iters; i++) {
+        uthread_yield();
+    }
+}
+
+static void bench_green_yield(void) {
+    if (start_runtime(1) != 0) {
+        return;
+    }
+    uthread_create(green_yielder, NULL, 0);
+    uthread_create(green_yielder, NULL, 0);
+    double start = now_sec();
+    uthread_run();
+    double elapsed = now_sec() - start;
+    report("yield", "uthread", 1, 2ULL * iters, elapsed, uthread_get_stats().switches);
+}
+
+static void* pthread_yielder(void *arg) {
+    (void)arg;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(0, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+    for (uint32_t i = 0; i < iters; i++) {
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void bench_pthread_yield(void) {
+    pthread_t threads[2];
+    double start = now_sec();
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&threads[i], NULL, pthread_yielder, NULL);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    report("yield", "pthread", 1, 2ULL * iters, now_sec() - start, 0);
+}
+
+/* ========== pingpong ========== */
+
+static int ping[2], pong[2];
+
+static void green_pinger(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < iters; i++) {
+        uint32_t reply;
+        uthread_write(ping[1], &i, sizeof(i));
+        uthread_read(pong[0], &reply, sizeof(reply));
+    }
+}
+
+static void green_ponger(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < iters; i++) {
+        uint32_t value;
+        uthread_read(ping[0], &value, sizeof(value));
+        uthread_write(pong[1], &value, sizeof(value));
+    }
+}
+
+static void* pthread_pinger(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < iters; i++) {
+        uint32_t reply;
+        if (write(ping[1], &i, sizeof(i)) != sizeof(i) ||
+            read(pong[0], &reply, sizeof(reply)) != sizeof(reply)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void* pthread_ponger(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < iters; i++) {
+        uint32_t value;
+        if (read(ping[0], &value, sizeof(value)) != sizeof(value) ||
+            write(pong[1], &value, sizeof(value)) != sizeof(value)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static int open_pipes(bool nonblock) {
+    if (pipe(ping) != 0 || pipe(pong) != 0) {
+        perror("pipe");
+        return -1;
+    }
+    for (int i = 0; i < 2 && nonblock; i++) {
+        uthread_set_nonblock(ping[i]);
+        uthread_set_nonblock(pong[i]);
+    }
+    return 0;
+}
+
+static void close_pipes(void) {
+    for (int i = 0; i < 2; i++) {
+        close(ping[i]);
+        close(pong[i]);
+    }
+}
+
+static void bench_green_pingpong(uint32_t workers) {
+    if (start_runtime(workers) != 0 || open_pipes(true) != 0) {
+        return;
+    }
+    uthread_create(green_ponger, NULL, 0);
+    uthread_create(green_pinger, NULL, 0);
+    double start = now_sec();
+    uthread_run();
+    double elapsed = now_sec() - start;
+    close_pipes();
+    report("pingpong", "uthread", workers, iters, elapsed, uthread_get_stats().switches);
+}
+
+static void bench_pthread_pingpong(void) {
+    if (open_pipes(false) != 0) {
+        return;
+    }
+    pthread_t threads[2];
+    double start = now_sec();
+    pthread_create(&threads[0], NULL, pthread_ponger, NULL);
+    pthread_create(&threads[1], NULL, pthread_pinger, NULL);
+    for (int i = 0; i < 2; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_sec() - start;
+    close_pipes();
+    report("pingpong", "pthread", 2, iters, elapsed, 0);
+}
+
+/* ========== 主函数 ========== */
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -n N      yields per thread / round trips (default: %d)\n"
+        "  -w N      worker threads for the green ping-pong (default: 1, max %d)\n",
+        prog, DEFAULT_ITERS, UTHREAD_MAX_WORKERS);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t workers = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:w:h")) != -1) {
+        switch (opt) {
+            case 'n': iters = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'w': workers = (uint32_t)strtoul(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (iters == 0 || workers == 0 || workers > UTHREAD_MAX_WORKERS) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    fprintf(stderr, "Green thread benchmark: %ld host CPUs, %u iterations\n",
+            sysconf(_SC_NPROCESSORS_ONLN), iters);
+    printf("benchmark,impl,workers,ops,ns_per_op,switches\n");
+    bench_green_yield();
+    bench_pthread_yield();
+    bench_green_pingpong(workers);
+    bench_pthread_pingpong();
+    return 0;
+}
@@ -0,0 +1,582 @@
+/**
+ * uthread.c - 用户态绿色线程运行时实现
+ * 位于: uthread/core/uthread.c
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "uthread/include/uthread.h"
+#include "kernel/include/pcb.h"
+#include "kernel/include/spinlock.h"
+
+#if !defined(__x86_64__)
+#error "uthread requires an x86-64 host"
+#endif
+
+#define UTHREAD_MXCSR_DEFAULT   0x1F80      // 屏蔽全部SSE异常，就近舍入
+#define UTHREAD_FPUCW_DEFAULT   0x037F      // x87默认控制字
+#define UTHREAD_LOCK_SPINS      64          // 让出主机CPU前的轮询次数
+
+/* 汇编实现，见 uthread/arch_x86_64/uthread_switch.S */
+extern void uthread_switch(uint64_t *prev_sp, uint64_t next_sp);
+
+struct uthread {
+    pcb_t pcb;                      // 必须是第一个成员：队列中链的是&pcb
+    pcb_cold_t cold;
+    uint64_t sp;                    // 换出时的栈指针
+    void *stack;                    // mmap区域，最低一页为保护页
+    size_t stack_len;
+    void (*fn)(void *);
+    void *arg;
+    uint32_t run_start;             // 本次开始运行的时刻（ms）
+    wait_queue_t joiners;           // 等待本线程退出的线程
+    struct uthread *all_next;       // 全部线程链表，uthread_run结束时统一释放
+};
+
+typedef struct {
+    uint64_t idle_sp;               // 空闲循环（工作线程自己的栈）
+    uthread_t *current;             // 正在运行的绿色线程，NULL表示在空闲循环
+    uint32_t id;
+    pthread_t thread;
+} worker_t;
+
+/* 运行时状态，除配置外都由lock保护 */
+static struct {
+    uthread_config_t config;
+    tas_lock_t lock;                // 切换期间一直持有，由切入方释放
+    ready_queue_t runq;             // FIFO/RR
+    mlfq_t mlfq;                    // MLFQ
+    wait_queue_t sleepers;          // 按唤醒时刻（pcb.deadline）排序
+    uint32_t live;                  // 尚未退出的绿色线程
+    uint32_t idle;                  // 在epoll_wait中的工作线程
+    bool wake_pending;              // eventfd已写入、尚未被读走
+    uint32_t next_id;
+    uthread_t *all;
+    int epfd;
+    int wakefd;                     // eventfd：唤醒空闲的工作线程
+    struct timespec start;
+    uthread_stats_t stats;
+    worker_t workers[UTHREAD_MAX_WORKERS];
+} rt = { .epfd = -1, .wakefd = -1 };
+
+static __thread worker_t *this_worker;
+
+static void uthread_bootstrap(void);
+
+/* ========== 辅助函数 ========== */
+
+/* 绿色线程可能在另一个工作线程上恢复运行：每次都重新读取TLS，
+ * 不能让编译器把线程局部变量的地址缓存在切换前后 */
+static __attribute__((noinline)) worker_t* current_worker(void) {
+    __asm__ volatile("" ::: "memory");
+    return this_worker;
+}
+
+static uint32_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((ts.tv_sec - rt.start.tv_sec) * 1000 +
+                      (ts.tv_nsec - rt.start.tv_nsec) / 1000000);
+}
+
+/* 用户态不能关中断，持锁的工作线程随时可能被主机调度器换出。票号锁
+ * 按序交接，排在前面的等待者被换出时后面的全部空转一个主机时间片；
+ * 这里改为测试并设置加有限自旋，之后sched_yield把CPU让给持锁者 */
+static void rt_lock(void) {
+    uint32_t polls = 0;
+    while (!tas_trylock(&rt.lock)) {
+        if (++polls % UTHREAD_LOCK_SPINS == 0) {
+            sched_yield();
+        } else {
+            cpu_relax();
+        }
+    }
+}
+
+static inline void rt_unlock(void) {
+    tas_unlock(&rt.lock);
+}
+
+static inline uthread_t* to_uthread(pcb_t *pcb) {
+    return (uthread_t *)pcb;
+}
+
+static void wake_idle_worker_locked(void) {
+    if (rt.idle > 0 && !rt.wake_pending) {
+        uint64_t one = 1;
+        rt.wake_pending = true;
+        if (write(rt.wakefd, &one, sizeof(one)) < 0) {
+            rt.wake_pending = false;
+        }
+    }
+}
+
+/* ========== 就绪队列 ========== */
+
+static void make_ready_locked(uthread_t *t) {
+    t->pcb.state = PROCESS_READY;
+    if (rt.config.policy == UTHREAD_MLFQ) {
+        mlfq_enqueue(&rt.mlfq, &t->pcb, t->pcb.queue_level);
+    } else {
+        ready_queue_enqueue(&rt.runq, &t->pcb);
+    }
+}
+
+static inline uint32_t ready_count_locked(void) {
+    return rt.config.policy == UTHREAD_MLFQ ? rt.mlfq.total_processes : rt.runq.count;
+}
+
+static void expire_sleepers_locked(uint32_t now) {
+    pcb_t *head;
+    while ((head = rt.sleepers.head) && (int32_t)(now - head->deadline) >= 0) {
+        wait_queue_dequeue(&rt.sleepers);
+        make_ready_locked(to_uthread(head));
+    }
+}
+
+static uthread_t* pick_next_locked(uint32_t now) {
+    expire_sleepers_locked(now);
+
+    pcb_t *pcb;
+    if (rt.config.policy == UTHREAD_MLFQ) {
+        mlfq_boost_priorities(&rt.mlfq, now);
+        pcb = mlfq_dequeue(&rt.mlfq);
+    } else {
+        pcb = ready_queue_dequeue(&rt.runq);
+    }
+    if (!pcb) {
+        return NULL;
+    }
+    // 选走一个后还有剩余才叫醒一个空闲工作线程，由它继续往下传；
+    // 每次就绪都唤醒会让所有空闲工作线程涌上来抢锁
+    if (ready_count_locked() > 0) {
+        wake_idle_worker_locked();
+    }
+
+    pcb->state = PROCESS_RUNNING;
+    pcb->time_slice_used = 0;
+    to_uthread(pcb)->run_start = now;
+    return to_uthread(pcb);
+}
+
+/* 空闲的工作线程最多等到最早的睡眠者到期 */
+static int next_timeout_locked(uint32_t now) {
+    pcb_t *head = rt.sleepers.head;
+    if (!head) {
+        return -1;
+    }
+    int32_t left = (int32_t)(head->deadline - now);
+    return left > 0 ? left : 0;
+}
+
+/* MLFQ：用完时间片降一级，阻塞或睡眠升一级 */
+static void adjust_level_locked(uthread_t *t, bool used_full_slice) {
+    if (rt.config.policy == UTHREAD_MLFQ) {
+        mlfq_adjust_priority(&rt.mlfq, &t->pcb, used_full_slice);
+    }
+}
+
+/* ========== 切换 ========== */
+
+/* 持锁调用：prev已放入合适的队列（或已退出），切到下一个就绪线程，
+ * 没有就回到本工作线程的空闲循环；恢复运行后释放锁 */
+static void switch_away(uthread_t *prev) {
+    worker_t *w = current_worker();
+    uint32_t now = now_ms();
+    prev->pcb.time_slice_used += now - prev->run_start;
+    prev->cold.stats.user_time += now - prev->run_start;
+    prev->cold.stats.context_switches++;
+
+    uthread_t *next = pick_next_locked(now);
+    w->current = next;
+    if (next != prev) {
+        rt.stats.switches++;
+        uthread_switch(&prev->sp, next ? next->sp : w->idle_sp);
+    }
+    rt_unlock();
+}
+
+/* 新线程首次被切入时从这里开始执行（栈帧由uthread_create构造） */
+static void uthread_bootstrap(void) {
+    // 切换发生在持锁期间，锁由切入方释放
+    rt_unlock();
+
+    uthread_t *self = current_worker()->current;
+    self->fn(self->arg);
+    uthread_exit();
+}
+
+/* ========== 工作线程 ========== */
+
+static void worker_loop(worker_t *w) {
+    struct epoll_event events[UTHREAD_EPOLL_BATCH];
+    this_worker = w;
+
+    rt_lock();
+    while (rt.live > 0) {
+        uint32_t now = now_ms();
+        uthread_t *next = pick_next_locked(now);
+        if (next) {
+            w->current = next;
+            uthread_switch(&w->idle_sp, next->sp);
+            // 某个绿色线程没有可切换的对象，回到这里，锁仍持有
+            w->current = NULL;
+            continue;
+        }
+
+        int timeout = next_timeout_locked(now);
+        rt.idle++;
+        rt.stats.idle_waits++;
+        rt_unlock();
+
+        int n = epoll_wait(rt.epfd, events, UTHREAD_EPOLL_BATCH, timeout);
+
+        rt_lock();
+        rt.idle--;
+        for (int i = 0; i < n; i++) {
+            uthread_t *t = events[i].data.ptr;
+            if (t) {
+                make_ready_locked(t);
+            } else if (rt.live > 0) {
+                // 全部退出后保留eventfd的可读状态，让其余空闲工作线程也醒来
+                uint64_t value;
+                if (read(rt.wakefd, &value, sizeof(value)) > 0) {
+                    rt.wake_pending = false;
+                }
+            }
+        }
+    }
+    rt_unlock();
+}
+
+static void* worker_main(void *arg) {
+    worker_loop(arg);
+    return NULL;
+}
+
+/* ========== 生命周期 ========== */
+
+int uthread_init(const uthread_config_t *config) {
+    if (rt.epfd >= 0) {
+        close(rt.epfd);
+    }
+    if (rt.wakefd >= 0) {
+        close(rt.wakefd);
+    }
+    memset(&rt, 0, sizeof(rt));
+    rt.epfd = rt.wakefd = -1;
+
+    if (config) {
+        rt.config = *config;
+    } else {
+        rt.config.policy = UTHREAD_RR;
+    }
+    if (rt.config.workers == 0) {
+        rt.config.workers = 1;
+    }
+    if (rt.config.workers > UTHREAD_MAX_WORKERS || rt.config.policy > UTHREAD_MLFQ) {
+        return -1;
+    }
+    if (rt.config.quantum_ms == 0) {
+        rt.config.quantum_ms = TIME_SLICE_BASE;
+    }
+    if (rt.config.stack_size == 0) {
+        rt.config.stack_size = UTHREAD_STACK_SIZE;
+    }
+
+    tas_lock_init(&rt.lock);
+    ready_queue_init(&rt.runq, 0, rt.config.quantum_ms);
+    mlfq_init(&rt.mlfq, MAX_PRIORITY_LEVELS, rt.config.boost_ms);
+    for (int i = 0; i < MAX_PRIORITY_LEVELS; i++) {
+        rt.mlfq.queues[i].max_count = 0;     // 绿色线程数不受MAX_PROCESSES限制
+    }
+    wait_queue_init(&rt.sleepers, 0);
+    clock_gettime(CLOCK_MONOTONIC, &rt.start);
+
+    rt.epfd = epoll_create1(EPOLL_CLOEXEC);
+    rt.wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    if (rt.epfd < 0 || rt.wakefd < 0 || epoll_ctl(rt.epfd, EPOLL_CTL_ADD, rt.wakefd, &ev) < 0) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < rt.config.workers; i++) {
+        rt.workers[i].id = i;
+    }
+    return 0;
+}
+
+uthread_t* uthread_create(void (*fn)(void *), void *arg, uint8_t priority) {
+    if (!fn || rt.epfd < 0) {
+        return NULL;
+    }
+
+    uthread_t *t;
+    if (posix_memalign((void **)&t, CACHE_LINE_SIZE, sizeof(uthread_t)) != 0) {
+        return NULL;
+    }
+    memset(t, 0, sizeof(uthread_t));
+
+    // 栈底留一个不可访问的保护页，栈溢出时立即段错误而不是破坏相邻内存
+    long page = sysconf(_SC_PAGESIZE);
+    t->stack_len = rt.config.stack_size + page;
+    t->stack = mmap(NULL, t->stack_len, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (t->stack == MAP_FAILED) {
+        free(t);
+        return NULL;
+    }
+    mprotect(t->stack, page, PROT_NONE);
+
+    // 初始帧与uthread_switch保存的布局一致，首次切入时"返回"到uthread_bootstrap；
+    // 返回后栈指针模16余8，与正常的函数入口相同
+    uint64_t *sp = (uint64_t *)((char *)t->stack + t->stack_len);
+    *--sp = 0;                                      // bootstrap不会返回
+    *--sp = (uint64_t)(uintptr_t)uthread_bootstrap; // 返回地址
+    for (int i = 0; i < 6; i++) {
+        *--sp = 0;                                  // rbp, rbx, r12-r15
+    }
+    *--sp = UTHREAD_MXCSR_DEFAULT | ((uint64_t)UTHREAD_FPUCW_DEFAULT << 32);
+    t->sp = (uint64_t)(uintptr_t)sp;
+    t->fn = fn;
+    t->arg = arg;
+    t->pcb.cold = &t->cold;
+    wait_queue_init(&t->joiners, 0);
+
+    rt_lock();
+    pcb_init(&t->pcb, ++rt.next_id, "uthread", PROCESS_TYPE_USER, priority);
+    t->pcb.time_slice = rt.config.quantum_ms;
+    t->all_next = rt.all;
+    rt.all = t;
+    rt.live++;
+    rt.stats.created++;
+    make_ready_locked(t);
+    wake_idle_worker_locked();
+    rt_unlock();
+    return t;
+}
+
+int uthread_run(void) {
+    if (rt.epfd < 0) {
+        return -1;
+    }
+
+    uint32_t started = 1;
+    for (; started < rt.config.workers; started++) {
+        if (pthread_create(&rt.workers[started].thread, NULL, worker_main,
+                           &rt.workers[started]) != 0) {
+            break;
+        }
+    }
+    worker_loop(&rt.workers[0]);
+    for (uint32_t i = 1; i < started; i++) {
+        pthread_join(rt.workers[i].thread, NULL);
+    }
+    this_worker = NULL;
+
+    while (rt.all) {
+        uthread_t *t = rt.all;
+        rt.all = t->all_next;
+        munmap(t->stack, t->stack_len);
+        free(t);
+    }
+    close(rt.epfd);
+    close(rt.wakefd);
+    rt.epfd = rt.wakefd = -1;
+    return 0;
+}
+
+/* ========== 绿色线程接口 ========== */
+
+uthread_t* uthread_self(void) {
+    worker_t *w = current_worker();
+    return w ? w->current : NULL;
+}
+
+uint32_t uthread_id(const uthread_t *thread) {
+    return thread ? thread->pcb.pid : 0;
+}
+
+uint8_t uthread_level(const uthread_t *thread) {
+    return thread ? thread->pcb.queue_level : 0;
+}
+
+uint32_t uthread_worker_id(void) {
+    worker_t *w = current_worker();
+    return w ? w->id : 0;
+}
+
+static void yield_locked(uthread_t *self, bool used_full_slice) {
+    rt.stats.yields++;
+    adjust_level_locked(self, used_full_slice);
+    make_ready_locked(self);
+    switch_away(self);
+}
+
+void uthread_yield(void) {
+    uthread_t *self = uthread_self();
+    if (!self) {
+        return;
+    }
+
+    rt_lock();
+    uint32_t used = self->pcb.time_slice_used + (now_ms() - self->run_start);
+    yield_locked(self, used >= self->pcb.time_slice);
+}
+
+void uthread_preempt_point(void) {
+    uthread_t *self = uthread_self();
+    if (!self || rt.config.policy == UTHREAD_FIFO) {
+        return;
+    }
+    if (self->pcb.time_slice_used + (now_ms() - self->run_start) < self->pcb.time_slice) {
+        return;
+    }
+
+    rt_lock();
+    yield_locked(self, true);
+}
+
+void uthread_sleep(uint32_t ms) {
+    uthread_t *self = uthread_self();
+    if (!self) {
+        return;
+    }
+    if (ms == 0) {
+        uthread_yield();
+        return;
+    }
+
+    rt_lock();
+    rt.stats.sleeps++;
+    adjust_level_locked(self, false);
+    self->pcb.state = PROCESS_SLEEPING;
+    self->pcb.deadline = now_ms() + ms;
+    wait_queue_enqueue_by_deadline(&rt.sleepers, &self->pcb);
+    if (rt.sleepers.head == &self->pcb) {
+        wake_idle_worker_locked();      // 空闲工作线程的epoll_wait超时需要缩短
+    }
+    switch_away(self);
+}
+
+void uthread_exit(void) {
+    uthread_t *self = uthread_self();
+    if (!self) {
+        abort();
+    }
+
+    rt_lock();
+    self->pcb.state = PROCESS_ZOMBIE;
+    pcb_t *joiner;
+    while ((joiner = wait_queue_dequeue(&self->joiners))) {
+        make_ready_locked(to_uthread(joiner));
+    }
+    rt.live--;
+    rt.stats.exited++;
+    if (rt.live == 0) {
+        wake_idle_worker_locked();
+    }
+    switch_away(self);
+    __builtin_unreachable();
+}
+
+int uthread_join(uthread_t *thread) {
+    uthread_t *self = uthread_self();
+    if (!self || !thread || thread == self) {
+        return -1;
+    }
+
+    rt_lock();
+    if (thread->pcb.state == PROCESS_ZOMBIE) {
+        rt_unlock();
+        return 0;
+    }
+    self->pcb.state = PROCESS_BLOCKED;
+    adjust_level_locked(self, false);
+    wait_queue_enqueue(&thread->joiners, &self->pcb);
+    switch_away(self);
+    return 0;
+}
+
+/* ========== epoll集成的I/O ========== */
+
+int uthread_set_nonblock(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+int uthread_wait_fd(int fd, uint32_t events) {
+    uthread_t *self = uthread_self();
+    if (!self) {
+        errno = EPERM;
+        return -1;
+    }
+
+    // 持锁登记：事件即使立刻到来，处理它的工作线程也要等本线程换出后才能拿到锁
+    struct epoll_event ev = { .events = events | EPOLLONESHOT, .data.ptr = self };
+    rt_lock();
+    if (epoll_ctl(rt.epfd, EPOLL_CTL_MOD, fd, &ev) < 0 &&
+        (errno != ENOENT || epoll_ctl(rt.epfd, EPOLL_CTL_ADD, fd, &ev) < 0)) {
+        rt_unlock();
+        return -1;
+    }
+    rt.stats.io_waits++;
+    self->pcb.state = PROCESS_BLOCKED;
+    adjust_level_locked(self, false);
+    switch_away(self);
+    return 0;
+}
+
+ssize_t uthread_read(int fd, void *buf, size_t len) {
+    for (;;) {
+        ssize_t n = read(fd, buf, len);
+        if (n >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            return n;
+        }
+        if (uthread_wait_fd(fd, EPOLLIN) < 0) {
+            return -1;
+        }
+    }
+}
+
+ssize_t uthread_write(int fd, const void *buf, size_t len) {
+    for (;;) {
+        ssize_t n = write(fd, buf, len);
+        if (n >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            return n;
+        }
+        if (uthread_wait_fd(fd, EPOLLOUT) < 0) {
+            return -1;
+        }
+    }
+}
+
+int uthread_accept(int fd, struct sockaddr *addr, socklen_t *addrlen) {
+    for (;;) {
+        int conn = accept4(fd, addr, addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (conn >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            return conn;
+        }
+        if (uthread_wait_fd(fd, EPOLLIN) < 0) {
+            return -1;
+        }
+    }
+}
+
+uthread_stats_t uthread_get_stats(void) {
+    rt_lock();
+    uthread_stats_t stats = rt.stats;
+    rt_unlock();
+    return stats;
+}
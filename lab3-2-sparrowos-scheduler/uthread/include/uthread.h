@@ -0,0 +1,94 @@
+/**
+ * uthread.h - 用户态绿色线程运行时
+ * 位于: uthread/include/uthread.h
+ *
+ * M:N线程：任意多个绿色线程由N个工作线程（pthread）执行。绿色线程内嵌
+ * 内核调度器核心的 pcb_t，就绪队列与MLFQ直接复用 kernel/core/pcb.c，
+ * 按FIFO、RR或MLFQ选出下一个；切换用手写的x86-64汇编（uthread_switch），
+ * 与内核 switch_stack 一样只保存被调用者保存寄存器和栈指针，不用ucontext。
+ *
+ * 调度是协作式的：绿色线程在 uthread_yield()、uthread_sleep()、等待I/O、
+ * 等待其他线程退出或自己退出时交出工作线程。RR与MLFQ下计算循环应定期调用
+ * uthread_preempt_point()，时间片用完时让出（MLFQ同时降级）；FIFO下它什么
+ * 也不做，线程一直运行到阻塞为止。
+ *
+ * I/O经epoll：fd须为非阻塞（uthread_set_nonblock），uthread_read/write/
+ * accept 遇到EAGAIN时以EPOLLONESHOT登记并挂起当前绿色线程。没有就绪线程
+ * 的工作线程在 epoll_wait 中等待I/O、最早的睡眠到期和新就绪的线程。
+ *
+ * 全局就绪队列由一把测试并设置锁（kernel/include/spinlock.h）保护，自旋
+ * 若干次后sched_yield。与内核一样，切换期间一直持锁，由切入的一方释放，
+ * 被换出的线程在栈真正空出来之前不会被其他工作线程取走。
+ */
+
+#ifndef _SPARROW_UTHREAD_H
+#define _SPARROW_UTHREAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#define UTHREAD_MAX_WORKERS     64
+#define UTHREAD_STACK_SIZE      (64 * 1024)     // 默认栈大小（另加一个保护页）
+#define UTHREAD_EPOLL_BATCH     64
+
+/* 选择下一个绿色线程的策略 */
+typedef enum {
+    UTHREAD_FIFO = 0,           // 运行到阻塞，preempt_point不让出
+    UTHREAD_RR   = 1,           // 时间片轮转
+    UTHREAD_MLFQ = 2            // 多级反馈队列（kernel/core/pcb.c 的 mlfq_t）
+} uthread_policy_t;
+
+typedef struct {
+    uthread_policy_t policy;
+    uint32_t workers;           // 工作线程数，0取1
+    uint32_t quantum_ms;        // RR时间片，0取 TIME_SLICE_BASE
+    uint32_t boost_ms;          // MLFQ优先级提升间隔，0表示不提升
+    uint32_t stack_size;        // 每个绿色线程的栈大小，0取 UTHREAD_STACK_SIZE
+} uthread_config_t;
+
+typedef struct uthread uthread_t;
+
+/* 运行时统计 */
+typedef struct {
+    uint64_t switches;          // 绿色线程换出次数（含换到空闲循环）
+    uint64_t yields;            // uthread_yield 与时间片到期的让出
+    uint64_t sleeps;
+    uint64_t io_waits;          // 因EAGAIN挂起等待fd的次数
+    uint64_t idle_waits;        // 工作线程进入epoll_wait的次数
+    uint32_t created;
+    uint32_t exited;
+} uthread_stats_t;
+
+/* 初始化运行时（config可为NULL，取默认值RR、1个工作线程）；失败返回-1 */
+int uthread_init(const uthread_config_t *config);
+
+/* 创建绿色线程并放入就绪队列；可在 uthread_run 之前或绿色线程内调用 */
+uthread_t* uthread_create(void (*fn)(void *), void *arg, uint8_t priority);
+
+/* 当前线程成为0号工作线程，另起N-1个；全部绿色线程退出后返回并释放它们 */
+int uthread_run(void);
+
+/* 以下只能在绿色线程内调用 */
+void uthread_yield(void);
+void uthread_preempt_point(void);
+void uthread_sleep(uint32_t ms);
+void uthread_exit(void) __attribute__((noreturn));
+int uthread_join(uthread_t *thread);
+
+uthread_t* uthread_self(void);
+uint32_t uthread_id(const uthread_t *thread);
+uint8_t uthread_level(const uthread_t *thread);     // 当前MLFQ级别
+uint32_t uthread_worker_id(void);
+
+/* epoll集成的阻塞I/O */
+int uthread_set_nonblock(int fd);
+int uthread_wait_fd(int fd, uint32_t events);
+ssize_t uthread_read(int fd, void *buf, size_t len);
+ssize_t uthread_write(int fd, const void *buf, size_t len);
+int uthread_accept(int fd, struct sockaddr *addr, socklen_t *addrlen);
+
+uthread_stats_t uthread_get_stats(void);
+
+#endif /* _SPARROW_UTHREAD_H */
@@ -2,8 +2,14 @@
  * rpc_framework.c - 基于UINTR的简单RPC框架
  * 
  * 展示如何将UINTR集成到RPC框架中
+ * 每个客户端有自己的一对SPSC队列（提交队列与完成队列，即uintr_common.h中的
+ * spsc_ring_t），连接时分配给N个worker线程之一，由该worker独占消费；方法在
+ * 运行时注册。请求路径上没有锁，只有各队列自己的生产者/消费者下标。
+ * 客户端与worker都用自适应等待：先自旋一段标定过的时间，对端仍未响应再
+ * futex睡眠；对端正在睡眠时才需要进内核唤醒它。
  */
 
+#define _GNU_SOURCE                     // uintr_common.h中的sched_setaffinity
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,49 +17,113 @@
 #include <pthread.h>
 #include <sys/mman.h>
 #include <sys/syscall.h>
+#include "uintr_common.h"
 
 /* RPC框架定义 */
-#define MAX_RPC_METHODS 10
-#define SHARED_BUFFER_SIZE 4096
+#define RPC_METHOD_CHUNK    64          // 方法表每块的表项数
+#define RPC_METHOD_CHUNKS   1024        // 最多 RPC_METHOD_CHUNK * RPC_METHOD_CHUNKS 个方法
+#define RPC_WORKER_CLIENTS  64          // 每个worker最多服务的客户端数
+#define RPC_MAX_WORKERS     64
+
+/* 响应消息的op字段是状态 */
+#define RPC_OK              0
+#define RPC_NO_METHOD       (-1)
+
+typedef int (*rpc_handler_t)(int, int);
 
 typedef struct {
-    int method_id;
-    int param1;
-    int param2;
-    int result;
-    volatile int ready;
-    volatile int processed;
-} rpc_request_t;
+    const char *name;
+    rpc_handler_t handler;
+} rpc_method_t;
 
+/*
+ * 方法表分块分配，已发布的表项从不移动，因此worker查表不加锁：
+ * 注册方先写表项再以release递增count，worker以acquire读count。
+ */
 typedef struct {
-    rpc_request_t *requests;
-    int request_count;
-    pthread_mutex_t lock;
-    volatile int interrupt_pending;
-} rpc_server_t;
+    rpc_method_t *chunks[RPC_METHOD_CHUNKS];
+    atomic_int count;
+    pthread_mutex_t lock;           // 只在注册时使用
+} rpc_registry_t;
 
-typedef int (*rpc_handler_t)(int, int);
+typedef struct rpc_worker rpc_worker_t;
+typedef struct rpc_runtime rpc_runtime_t;
 
-/* 简化的UINTR支持 */
-#ifdef UINTR_SUPPORT
-#include "uintr_common.h"
-static int uipi_index = -1;
-#endif
+/* 一个客户端（进程内的普通内存，含指向worker的指针）；两个队列各自只有一个生产者和一个消费者 */
+typedef struct {
+    spsc_ring_t sq;                 // 提交队列：客户端 -> worker
+    spsc_ring_t cq;                 // 完成队列：worker -> 客户端
+    wait_word_t done;               // worker每发布一批完成加一，客户端在此等待
+    rpc_worker_t *worker;           // 负责本客户端的worker
+    adaptive_wait_t wait;           // 客户端的自旋预算
+    uint64_t next_seq;
+    uint32_t inflight;              // 已提交未取回的请求数，不超过 RING_SIZE
+    unsigned long long wakeups;     // 唤醒睡眠中worker的次数
+} rpc_client_t;
+
+struct rpc_worker {
+    rpc_runtime_t *rt;
+    pthread_t thread;
+    int id;
+    rpc_client_t *clients[RPC_WORKER_CLIENTS];
+    atomic_int nclients;            // 连接方先写clients再以release递增
+    wait_word_t doorbell;           // 客户端每发布一批请求加一，worker在此等待
+    adaptive_wait_t wait;           // worker的自旋预算
+    unsigned long long handled;
+    unsigned long long wakeups;     // 唤醒睡眠中客户端的次数
+} __attribute__((aligned(CACHE_LINE_SIZE)));
 
-/* RPC方法实现 */
-static int add(int a, int b) { return a + b; }
-static int sub(int a, int b) { return a - b; }
-static int mul(int a, int b) { return a * b; }
-static int div_safe(int a, int b) { return b != 0 ? a / b : 0; }
-
-static rpc_handler_t rpc_methods[] = {
-    add,        // method_id = 0
-    sub,        // method_id = 1
-    mul,        // method_id = 2
-    div_safe,   // method_id = 3
-    NULL
+struct rpc_runtime {
+    rpc_registry_t methods;
+    rpc_worker_t *workers;
+    int nworkers;
+    int next_worker;                // 下一个客户端分配给哪个worker
+    pthread_mutex_t connect_lock;   // 只在连接时使用
+    atomic_int stop;
+    volatile int verbose;           // worker打印每个请求（性能测试时关闭）
 };
 
+/* RPC方法实现：参数来自客户端，按无符号回绕计算，避免有符号溢出 */
+static int add(int a, int b) { return (int)((unsigned int)a + (unsigned int)b); }
+static int sub(int a, int b) { return (int)((unsigned int)a - (unsigned int)b); }
+static int mul(int a, int b) { return (int)((unsigned int)a * (unsigned int)b); }
+static int div_safe(int a, int b) { return b != 0 && !(a == INT32_MIN && b == -1) ? a / b : 0; }
+static int max_int(int a, int b) { return a > b ? a : b; }
+
+/* 注册方法，返回方法号；表满或内存不足时返回-1 */
+static int rpc_register(rpc_runtime_t *rt, const char *name, rpc_handler_t handler)
+{
+    rpc_registry_t *reg = &rt->methods;
+    
+    pthread_mutex_lock(&reg->lock);
+    int id = atomic_load_explicit(&reg->count, memory_order_relaxed);
+    if (id == RPC_METHOD_CHUNK * RPC_METHOD_CHUNKS) {
+        pthread_mutex_unlock(&reg->lock);
+        return -1;
+    }
+    
+    rpc_method_t **chunk = &reg->chunks[id / RPC_METHOD_CHUNK];
+    if (!*chunk && !(*chunk = calloc(RPC_METHOD_CHUNK, sizeof(rpc_method_t)))) {
+        pthread_mutex_unlock(&reg->lock);
+        return -1;
+    }
+    
+    (*chunk)[id % RPC_METHOD_CHUNK] = (rpc_method_t){ name, handler };
+    atomic_store_explicit(&reg->count, id + 1, memory_order_release);
+    pthread_mutex_unlock(&reg->lock);
+    return id;
+}
+
+static const rpc_method_t *rpc_lookup(rpc_runtime_t *rt, int id)
+{
+    rpc_registry_t *reg = &rt->methods;
+    
+    if (id < 0 || id >= atomic_load_explicit(&reg->count, memory_order_acquire)) {
+        return NULL;
+    }
+    return &reg->chunks[id / RPC_METHOD_CHUNK][id % RPC_METHOD_CHUNK];
+}
+
 /* UINTR中断处理函数 */
 #ifdef UINTR_SUPPORT
 static void __attribute__((interrupt)) rpc_interrupt_handler(void)
@@ -63,157 +133,443 @@ static void __attribute__((interrupt)) rpc_interrupt_handler(void)
 }
 #endif
 
-/* RPC服务器线程 */
-static void *rpc_server_thread(void *arg)
+/* 处理一个客户端提交队列中的请求（最多 RING_BATCH 个），返回处理数 */
+static int rpc_serve_client(rpc_worker_t *w, rpc_client_t *c)
+{
+    ipc_msg_t msg;
+    int handled = 0;
+    
+    while (handled < RING_BATCH && spsc_ring_pop(&c->sq, &msg)) {
+        const rpc_method_t *m = rpc_lookup(w->rt, msg.op);
+        if (w->rt->verbose) {
+            printf("[RPC Worker %d] %s(%d, %d)\n", w->id, m ? m->name : "?",
+                   msg.args[0], msg.args[1]);
+        }
+        
+        msg.value = m ? m->handler(msg.args[0], msg.args[1]) : 0;
+        msg.op = m ? RPC_OK : RPC_NO_METHOD;
+        // 客户端的未完成请求数不超过RING_SIZE，完成队列不会一直满
+        while (!spsc_ring_push(&c->cq, &msg)) {
+            cpu_relax();
+        }
+        handled++;
+    }
+    
+    if (handled > 0) {
+        spsc_ring_publish(&c->cq);
+        if (wait_word_bump(&c->done)) {
+            w->wakeups++;
+        }
+    }
+    return handled;
+}
+
+/* RPC worker线程：轮流服务分配给自己的客户端 */
+static void *rpc_worker_thread(void *arg)
 {
-    rpc_server_t *server = (rpc_server_t *)arg;
+    rpc_worker_t *w = (rpc_worker_t *)arg;
     
 #ifdef UINTR_SUPPORT
     // 注册UINTR处理函数
     if (uintr_register_handler((unsigned long)rpc_interrupt_handler, 0) < 0) {
-        printf("[RPC Server] UINTR not available, using polling\n");
+        printf("[RPC Worker %d] UINTR not available, using polling\n", w->id);
     }
 #endif
     
-    printf("[RPC Server] Started (PID: %d)\n", getpid());
-    
-    while (1) {
-        for (int i = 0; i < server->request_count; i++) {
-            rpc_request_t *req = &server->requests[i];
-            
-            if (req->ready && !req->processed) {
-                pthread_mutex_lock(&server->lock);
-                
-                // 处理RPC请求
-                if (req->method_id >= 0 && req->method_id < 4) {
-                    req->result = rpc_methods[req->method_id](req->param1, req->param2);
-                    printf("[RPC Server] Processed request %d: %d %c %d = %d\n",
-                           i, req->param1, 
-                           req->method_id == 0 ? '+' : 
-                           req->method_id == 1 ? '-' : 
-                           req->method_id == 2 ? '*' : '/',
-                           req->param2, req->result);
-                }
-                
-                req->processed = 1;
-                pthread_mutex_unlock(&server->lock);
-                
-#ifdef UINTR_SUPPORT
-                // 如果有中断挂起，清除标志
-                if (server->interrupt_pending) {
-                    server->interrupt_pending = 0;
-                }
-#endif
-            }
+    while (!atomic_load(&w->rt->stop)) {
+        // 先读门铃再扫描队列，扫描之后发布的请求一定会让门铃变化
+        uint32_t doorbell = atomic_load(&w->doorbell.count);
+        int nclients = atomic_load_explicit(&w->nclients, memory_order_acquire);
+        int handled = 0;
+        
+        for (int i = 0; i < nclients; i++) {
+            handled += rpc_serve_client(w, w->clients[i]);
         }
+        w->handled += handled;
         
-        usleep(1000); // 避免忙等待
+        // 所有队列都空：预算内自旋，之后futex睡眠
+        if (handled == 0) {
+            adaptive_wait(&w->wait, &w->doorbell, doorbell);
+        }
     }
     
     return NULL;
 }
 
-/* RPC客户端函数 */
-static int rpc_call(rpc_request_t *req, int method_id, int param1, int param2)
+/* 创建运行时并启动nworkers个worker */
+static rpc_runtime_t *rpc_runtime_create(int nworkers)
 {
-    req->method_id = method_id;
-    req->param1 = param1;
-    req->param2 = param2;
-    req->result = 0;
-    req->processed = 0;
-    req->ready = 1;
+    if (nworkers < 1 || nworkers > RPC_MAX_WORKERS) {
+        return NULL;
+    }
     
-#ifdef UINTR_SUPPORT
-    // 发送UINTR通知服务器
-    if (uipi_index >= 0) {
-        senduipi(uipi_index);
+    rpc_runtime_t *rt = calloc(1, sizeof(rpc_runtime_t));
+    if (!rt) {
+        return NULL;
+    }
+    rt->workers = aligned_alloc(CACHE_LINE_SIZE, sizeof(rpc_worker_t) * nworkers);
+    if (!rt->workers) {
+        free(rt);
+        return NULL;
+    }
+    
+    memset(rt->workers, 0, sizeof(rpc_worker_t) * nworkers);
+    pthread_mutex_init(&rt->methods.lock, NULL);
+    pthread_mutex_init(&rt->connect_lock, NULL);
+    
+    for (int i = 0; i < nworkers; i++) {
+        rpc_worker_t *w = &rt->workers[i];
+        w->rt = rt;
+        w->id = i;
+        adaptive_wait_init(&w->wait, WAIT_SPIN_NS);
+        if (pthread_create(&w->thread, NULL, rpc_worker_thread, w) != 0) {
+            perror("pthread_create failed");
+            break;
+        }
+        rt->nworkers++;
+    }
+    return rt;
+}
+
+/* 停止worker并释放所有客户端 */
+static void rpc_runtime_destroy(rpc_runtime_t *rt)
+{
+    // worker可能在futex上睡眠（不是取消点），置停止标志后按门铃
+    atomic_store(&rt->stop, 1);
+    for (int i = 0; i < rt->nworkers; i++) {
+        wait_word_bump(&rt->workers[i].doorbell);
+        pthread_join(rt->workers[i].thread, NULL);
     }
-#endif
     
-    // 等待响应
-    while (!req->processed) {
-        usleep(10);
+    for (int i = 0; i < rt->nworkers; i++) {
+        rpc_worker_t *w = &rt->workers[i];
+        for (int j = 0; j < atomic_load(&w->nclients); j++) {
+            free(w->clients[j]);
+        }
+    }
+    for (int i = 0; i < RPC_METHOD_CHUNKS; i++) {
+        free(rt->methods.chunks[i]);
     }
     
-    req->ready = 0;
-    return req->result;
+    pthread_mutex_destroy(&rt->methods.lock);
+    pthread_mutex_destroy(&rt->connect_lock);
+    free(rt->workers);
+    free(rt);
 }
 
-int main(void)
+/* 连接：创建客户端的队列，轮流分配给worker */
+static rpc_client_t *rpc_connect(rpc_runtime_t *rt)
 {
-    printf("=== Simple RPC Framework with UINTR ===\n");
+    rpc_client_t *c = aligned_alloc(CACHE_LINE_SIZE, sizeof(rpc_client_t));
+    if (!c) {
+        return NULL;
+    }
     
-    // 创建共享内存
-    rpc_request_t *shared_reqs = mmap(NULL, sizeof(rpc_request_t) * 10,
-                                     PROT_READ | PROT_WRITE,
-                                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    memset(c, 0, sizeof(rpc_client_t));
+    spsc_ring_init(&c->sq);
+    spsc_ring_init(&c->cq);
+    adaptive_wait_init(&c->wait, WAIT_SPIN_NS);
     
-    if (shared_reqs == MAP_FAILED) {
-        perror("mmap failed");
-        return 1;
+    pthread_mutex_lock(&rt->connect_lock);
+    for (int tries = 0; tries < rt->nworkers && !c->worker; tries++) {
+        rpc_worker_t *w = &rt->workers[rt->next_worker];
+        rt->next_worker = (rt->next_worker + 1) % rt->nworkers;
+        
+        int n = atomic_load_explicit(&w->nclients, memory_order_relaxed);
+        if (n < RPC_WORKER_CLIENTS) {
+            c->worker = w;
+            w->clients[n] = c;
+            atomic_store_explicit(&w->nclients, n + 1, memory_order_release);
+        }
     }
+    pthread_mutex_unlock(&rt->connect_lock);
     
-    memset(shared_reqs, 0, sizeof(rpc_request_t) * 10);
+    if (!c->worker) {
+        free(c);
+        return NULL;
+    }
+    return c;
+}
+
+/* 把请求写入提交队列（尚未发布），未完成的请求已满时返回-1 */
+static int rpc_submit(rpc_client_t *c, int method_id, int param1, int param2)
+{
+    ipc_msg_t msg = { .seq = c->next_seq, .op = method_id, .args = { param1, param2 } };
     
-    rpc_server_t server = {
-        .requests = shared_reqs,
-        .request_count = 10,
-        .interrupt_pending = 0
-    };
-    pthread_mutex_init(&server.lock, NULL);
+    if (c->inflight == RING_SIZE || !spsc_ring_push(&c->sq, &msg)) {
+        return -1;
+    }
+    c->next_seq++;
+    c->inflight++;
+    return 0;
+}
+
+/* 发布已写入的请求并按worker的门铃；worker在睡眠时才需要FUTEX_WAKE */
+static void rpc_flush(rpc_client_t *c)
+{
+    spsc_ring_publish(&c->sq);
+    if (wait_word_bump(&c->worker->doorbell)) {
+        c->wakeups++;
+    }
+}
+
+/* 取回一个响应；block为真时没有响应就等待（先自旋，超过预算再睡眠） */
+static bool rpc_reap(rpc_client_t *c, ipc_msg_t *msg, bool block)
+{
+    uint32_t done = atomic_load(&c->done.count);
+    
+    while (!spsc_ring_pop(&c->cq, msg)) {
+        if (!block) {
+            return false;
+        }
+        done = adaptive_wait(&c->wait, &c->done, done);
+    }
+    c->inflight--;
+    return true;
+}
+
+/* 同步调用（调用前不能有未取回的请求），成功返回0 */
+static int rpc_call(rpc_client_t *c, int method_id, int param1, int param2, int *result)
+{
+    ipc_msg_t msg;
+    
+    if (c->inflight > 0 || rpc_submit(c, method_id, param1, param2) < 0) {
+        return -1;
+    }
+    rpc_flush(c);
+    rpc_reap(c, &msg, true);
+    
+    *result = msg.value;
+    return msg.op == RPC_OK ? 0 : -1;
+}
+
+/* ========== 吞吐量测试 ========== */
+
+typedef struct {
+    rpc_runtime_t *rt;
+    int method;
+    long calls;
+    uint32_t window;
+    pthread_barrier_t *start;
+    long errors;
+} bench_client_t;
+
+/* 保持最多window个未完成的请求，并检查每个结果 */
+static void *bench_client_thread(void *arg)
+{
+    bench_client_t *b = (bench_client_t *)arg;
+    rpc_client_t *c = rpc_connect(b->rt);
+    
+    pthread_barrier_wait(b->start);
+    if (!c) {
+        b->errors = b->calls;
+        return NULL;
+    }
+    
+    long submitted = 0, completed = 0;
+    ipc_msg_t msg;
+    while (completed < b->calls) {
+        int batch = 0;
+        while (submitted < b->calls && c->inflight < b->window &&
+               rpc_submit(c, b->method, (int)c->next_seq, 1) == 0) {
+            submitted++;
+            batch++;
+        }
+        if (batch > 0) {
+            rpc_flush(c);
+        }
+        
+        // 至少等到一个响应，再把已到达的都取走
+        bool block = true;
+        while (rpc_reap(c, &msg, block)) {
+            b->errors += msg.op != RPC_OK || msg.value != (int)msg.seq + 1;
+            completed++;
+            block = false;
+        }
+    }
+    return NULL;
+}
+
+/* nclients个客户端线程各完成calls次add调用，返回每秒百万次调用数 */
+static double bench_throughput(int nworkers, int nclients, long calls, uint32_t window,
+                               long *errors)
+{
+    rpc_runtime_t *rt = rpc_runtime_create(nworkers);
+    pthread_t threads[nclients];
+    bench_client_t clients[nclients];
+    pthread_barrier_t start;
+    
+    *errors = calls * nclients;
+    if (!rt) {
+        return 0;
+    }
     
-    // 创建服务器线程
-    pthread_t server_thread;
-    if (pthread_create(&server_thread, NULL, rpc_server_thread, &server) != 0) {
-        perror("pthread_create failed");
+    int method = rpc_register(rt, "add", add);
+    pthread_barrier_init(&start, NULL, nclients + 1);
+    for (int i = 0; i < nclients; i++) {
+        clients[i] = (bench_client_t){ rt, method, calls, window, &start, 0 };
+        pthread_create(&threads[i], NULL, bench_client_thread, &clients[i]);
+    }
+    
+    pthread_barrier_wait(&start);
+    uint64_t elapsed = now_ns();
+    *errors = 0;
+    for (int i = 0; i < nclients; i++) {
+        pthread_join(threads[i], NULL);
+        *errors += clients[i].errors;
+    }
+    elapsed = now_ns() - elapsed;
+    
+    pthread_barrier_destroy(&start);
+    rpc_runtime_destroy(rt);
+    return (double)calls * nclients * 1000.0 / elapsed;
+}
+
+/* ========== 命令行 ========== */
+
+#define MAX_SWEEP_VALUES    16
+
+static int parse_list(const char *arg, int *values, int max)
+{
+    int count = 0;
+    const char *p = arg;
+    while (*p && count < max) {
+        char *end;
+        values[count++] = (int)strtol(p, &end, 10);
+        if (end == p || values[count - 1] <= 0) {
+            return -1;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -w LIST   numbers of workers to sweep (default: 1,2,4; at most %d)\n"
+        "  -c LIST   numbers of clients to sweep (default: 1,2,4,8)\n"
+        "  -n N      calls per client (default: 100000)\n"
+        "  -d N      outstanding calls per client (default: 64; at most %d)\n",
+        prog, RPC_MAX_WORKERS, RING_SIZE);
+}
+
+int main(int argc, char *argv[])
+{
+    int workers[MAX_SWEEP_VALUES] = { 1, 2, 4 };
+    int num_workers = 3;
+    int clients[MAX_SWEEP_VALUES] = { 1, 2, 4, 8 };
+    int num_clients = 4;
+    long calls = 100000;
+    long window = 64;
+    
+    int opt;
+    while ((opt = getopt(argc, argv, "w:c:n:d:h")) != -1) {
+        switch (opt) {
+            case 'w': num_workers = parse_list(optarg, workers, MAX_SWEEP_VALUES); break;
+            case 'c': num_clients = parse_list(optarg, clients, MAX_SWEEP_VALUES); break;
+            case 'n': calls = strtol(optarg, NULL, 10); break;
+            case 'd': window = strtol(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    bool valid = num_workers > 0 && num_clients > 0 && calls > 0 &&
+                 window > 0 && window <= RING_SIZE;
+    for (int i = 0; valid && i < num_workers; i++) {
+        valid = workers[i] <= RPC_MAX_WORKERS;
+    }
+    if (!valid) {
+        usage(argv[0]);
         return 1;
     }
     
-    sleep(1); // 给服务器时间初始化
+    printf("=== Simple RPC Framework with UINTR ===\n");
+    
+    // 创建运行时并注册方法
+    rpc_runtime_t *rt = rpc_runtime_create(2);
+    if (!rt) {
+        perror("rpc_runtime_create failed");
+        return 1;
+    }
+    
+    int ops[4] = {
+        rpc_register(rt, "add", add),
+        rpc_register(rt, "sub", sub),
+        rpc_register(rt, "mul", mul),
+        rpc_register(rt, "div", div_safe)
+    };
+    rpc_client_t *client = rpc_connect(rt);
+    if (!client) {
+        perror("rpc_connect failed");
+        rpc_runtime_destroy(rt);
+        return 1;
+    }
+    printf("Workers: %d, spin budget: %u pauses (%d ns)\n", rt->nworkers,
+           client->wait.max_spin, WAIT_SPIN_NS);
     
     // 客户端测试
     printf("\n=== RPC Client Tests ===\n");
+    rt->verbose = 1;
     
     // 测试1: 加法
-    int result = rpc_call(&shared_reqs[0], 0, 10, 5);
+    int result = 0;
+    rpc_call(client, ops[0], 10, 5, &result);
     printf("Test 1: 10 + 5 = %d\n", result);
     
     // 测试2: 减法
-    result = rpc_call(&shared_reqs[1], 1, 20, 7);
+    rpc_call(client, ops[1], 20, 7, &result);
     printf("Test 2: 20 - 7 = %d\n", result);
     
     // 测试3: 乘法
-    result = rpc_call(&shared_reqs[2], 2, 6, 8);
+    rpc_call(client, ops[2], 6, 8, &result);
     printf("Test 3: 6 * 8 = %d\n", result);
     
     // 测试4: 除法
-    result = rpc_call(&shared_reqs[3], 3, 100, 4);
+    rpc_call(client, ops[3], 100, 4, &result);
     printf("Test 4: 100 / 4 = %d\n", result);
     
+    // 测试5: worker运行时注册的方法
+    int m_max = rpc_register(rt, "max", max_int);
+    rpc_call(client, m_max, 3, 9, &result);
+    printf("Test 5: max(3, 9) = %d\n", result);
+    
+    // 测试6: 未注册的方法
+    int status = rpc_call(client, m_max + 1, 1, 2, &result);
+    printf("Test 6: unregistered method -> %s\n", status < 0 ? "error" : "ok");
+    
     // 性能测试
     printf("\n=== Performance Test ===\n");
     
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
+    rt->verbose = 0;
+    uint64_t start = now_ns();
     
-    int iterations = 100;
+    int iterations = 100000;
     for (int i = 0; i < iterations; i++) {
-        rpc_call(&shared_reqs[i % 10], i % 4, i, i + 1);
+        rpc_call(client, ops[i % 4], i % 1000, i % 1000 + 1, &result);
     }
     
-    gettimeofday(&end, NULL);
-    
-    long long elapsed = (end.tv_sec - start.tv_sec) * 1000000LL + 
-                       (end.tv_usec - start.tv_usec);
+    uint64_t elapsed = now_ns() - start;
     
-    printf("Completed %d RPC calls in %lld us\n", iterations, elapsed);
-    printf("Average latency: %.2f us per call\n", (double)elapsed / iterations);
+    printf("Completed %d RPC calls in %.0f us\n", iterations, elapsed / 1000.0);
+    printf("Average latency: %.3f us per call\n", elapsed / 1000.0 / iterations);
+    printf("Client: %llu replies while spinning, slept %llu times, woke the worker %llu times\n",
+           client->wait.spun, client->wait.sleeps, client->wakeups);
+    rpc_runtime_destroy(rt);
     
-    // 清理
-    pthread_cancel(server_thread);
-    pthread_join(server_thread, NULL);
-    pthread_mutex_destroy(&server.lock);
-    munmap(shared_reqs, sizeof(rpc_request_t) * 10);
+    // 吞吐量测试：每个客户端保持window个未完成的请求
+    printf("\n=== Throughput Test ===\n");
+    printf("workers,clients,calls,window,mcalls_per_sec,errors\n");
+    for (int i = 0; i < num_workers; i++) {
+        for (int j = 0; j < num_clients; j++) {
+            long errors;
+            double mcalls = bench_throughput(workers[i], clients[j], calls, window, &errors);
+            printf("%d,%d,%ld,%ld,%.2f,%ld\n", workers[i], clients[j], calls * clients[j],
+                   window, mcalls, errors);
+        }
+    }
     
     printf("\n=== RPC Framework Example Completed ===\n");
     return 0;
@@ -5,11 +5,26 @@
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 LOG_DIR="$SCRIPT_DIR/../logs"
 RESULTS_DIR="$SCRIPT_DIR/../results"
-ITERATIONS=100  # 更多迭代以获得准确结果
+export ITERATIONS=${ITERATIONS:-10000}  # 预热之后记录的往返次数
+NOTIFIERS="poll futex eventfd spin uintr"
+
+# 多核机器上服务器与客户端分别绑定到CPU 0和1
+if [ "$(nproc)" -ge 2 ]; then
+    export SERVER_CPU=${SERVER_CPU:-0}
+    export CLIENT_CPU=${CLIENT_CPU:-1}
+fi
+
+# 从客户端日志提取一行CSV：方法,平均延迟,p50,p99,p99.9,max,吞吐量
+latency_row() {
+    local name="$1" log="$2" throughput="$3"
+    local avg=$(grep "Average latency:" "$log" | awk '{print $3}')
+    grep "Latency (ns):" "$log" | awk -F'[ ,]+' -v n="$name" -v a="$avg" -v t="$throughput" \
+        '{ printf "%s,%s,%s,%s,%s,%s,%s\n", n, a, $7, $9, $11, $13, t }'
+}
 
 echo "=== Performance Benchmark Script ==="
 echo "Iterations per test: $ITERATIONS"
-echo "This will compare UINTR vs Pipe IPC performance"
+echo "This will compare UINTR, other notifiers and Pipe IPC performance"
 
 # 创建目录
 mkdir -p "$LOG_DIR" "$RESULTS_DIR"
@@ -20,13 +35,31 @@ echo "Cleaning up..."
 "$SCRIPT_DIR/run_pipe_test.sh" 2>&1 | grep -q "cleaning" || true
 sleep 2
 
-# 运行UINTR测试
-echo -e "\n=== Running UINTR Benchmark ==="
-"$SCRIPT_DIR/run_uintr_test.sh" > "$LOG_DIR/uintr_bench.log" 2>&1
-UINTR_EXIT=$?
-
-# 提取UINTR性能数据
-UINTR_LATENCY=$(grep "Average latency:" "$LOG_DIR/client.log" 2>/dev/null | awk '{print $3}' || echo "0")
+# 对每种通知后端运行共享内存队列测试（不支持的后端记为N/A）
+declare -A NOTIFY_LATENCY NOTIFY_THROUGHPUT NOTIFY_STATUS
+LATENCY_CSV="$RESULTS_DIR/latency_$(date +%Y%m%d_%H%M%S).csv"
+echo "method,avg_us,p50_ns,p99_ns,p999_ns,max_ns,mmsgs_per_sec" > "$LATENCY_CSV"
+for n in $NOTIFIERS; do
+    echo -e "\n=== Running $n Notifier Benchmark ==="
+    rm -f "$LOG_DIR/client.log"
+    "$SCRIPT_DIR/run_uintr_test.sh" $n > "$LOG_DIR/uintr_bench_$n.log" 2>&1
+    if [ -f "$LOG_DIR/client.log" ] && grep -q "Test completed" "$LOG_DIR/client.log"; then
+        cp "$LOG_DIR/client.log" "$LOG_DIR/client_$n.log"
+        NOTIFY_LATENCY[$n]=$(grep "Average latency:" "$LOG_DIR/client_$n.log" | awk '{print $3}')
+        NOTIFY_THROUGHPUT[$n]=$(grep "Pipelined throughput:" "$LOG_DIR/client_$n.log" | awk '{print $3}')
+        NOTIFY_STATUS[$n]="PASSED"
+        latency_row "$n" "$LOG_DIR/client_$n.log" "${NOTIFY_THROUGHPUT[$n]}" >> "$LATENCY_CSV"
+    elif grep -q "not supported" "$LOG_DIR/server.log" 2>/dev/null; then
+        NOTIFY_LATENCY[$n]="N/A"
+        NOTIFY_THROUGHPUT[$n]="N/A"
+        NOTIFY_STATUS[$n]="UNSUPPORTED"
+    else
+        NOTIFY_LATENCY[$n]="N/A"
+        NOTIFY_THROUGHPUT[$n]="N/A"
+        NOTIFY_STATUS[$n]="FAILED"
+    fi
+    echo "  $n: ${NOTIFY_STATUS[$n]}"
+done
 
 # 运行Pipe测试
 echo -e "\n=== Running Pipe Benchmark ==="
@@ -34,7 +67,8 @@ echo -e "\n=== Running Pipe Benchmark ==="
 PIPE_EXIT=$?
 
 # 提取Pipe性能数据
-PIPE_LATENCY=$(grep "Average RTT latency:" "$LOG_DIR/pipe_client.log" 2>/dev/null | awk '{print $4}' || echo "0")
+PIPE_LATENCY=$(grep "Average latency:" "$LOG_DIR/pipe_client.log" 2>/dev/null | awk '{print $3}' || echo "0")
+[ $PIPE_EXIT -eq 0 ] && latency_row "pipe" "$LOG_DIR/pipe_client.log" "N/A" >> "$LATENCY_CSV"
 
 # 生成对比报告
 REPORT_FILE="$RESULTS_DIR/benchmark_report_$(date +%Y%m%d_%H%M%S).txt"
@@ -44,13 +78,17 @@ cat > "$REPORT_FILE" << EOF
 Test Date: $(date)
 Iterations: $ITERATIONS
 System: $(uname -a)
+CPU pinning: server ${SERVER_CPU:-none}, client ${CLIENT_CPU:-none}
 
 --- Results ---
-UINTR Average Latency: $UINTR_LATENCY us
-Pipe Average Latency:  $PIPE_LATENCY us
+$(for n in $NOTIFIERS; do printf "%-8s Average Latency: %8s us, Pipelined Throughput: %8s M msgs/sec\n" "$n" "${NOTIFY_LATENCY[$n]}" "${NOTIFY_THROUGHPUT[$n]}"; done)
+Pipe     Average Latency: $PIPE_LATENCY us
+
+--- Latency Percentiles (ns) ---
+$(cat "$LATENCY_CSV")
 
 --- Performance Improvement ---
-UINTR is $(echo "scale=2; $PIPE_LATENCY / $UINTR_LATENCY" | bc)x faster than Pipe
+$(for n in $NOTIFIERS; do [ "${NOTIFY_LATENCY[$n]}" != "N/A" ] && echo "$n is $(awk "BEGIN { printf \"%.2f\", $PIPE_LATENCY / ${NOTIFY_LATENCY[$n]} }")x faster than Pipe"; done)
 
 --- Analysis ---
 The performance difference demonstrates the advantage of user-level interrupts:
@@ -60,8 +98,8 @@ The performance difference demonstrates the advantage of user-level interrupts:
 4. Lower cache pollution
 
 --- Test Status ---
-UINTR Test: $( [ $UINTR_EXIT -eq 0 ] && echo "PASSED" || echo "FAILED" )
-Pipe Test:  $( [ $PIPE_EXIT -eq 0 ] && echo "PASSED" || echo "FAILED" )
+$(for n in $NOTIFIERS; do printf "%-8s Test: %s\n" "$n" "${NOTIFY_STATUS[$n]}"; done)
+Pipe     Test: $( [ $PIPE_EXIT -eq 0 ] && echo "PASSED" || echo "FAILED" )
 EOF
 
 # 显示报告
@@ -71,14 +109,16 @@ cat "$REPORT_FILE"
 # 可视化数据
 echo -e "\n=== Performance Comparison ==="
 echo "Latency (lower is better):"
-echo "┌────────────────────┬─────────────┐"
-echo "│ Method            │ Latency (us)│"
-echo "├────────────────────┼─────────────┤"
-printf "│ UINTR             │ %11s │\n" $UINTR_LATENCY
-printf "│ Pipe IPC          │ %11s │\n" $PIPE_LATENCY
-echo "└────────────────────┴─────────────┘"
+echo "┌────────────────────┬─────────────┬───────────┬───────────┬────────────┬──────────────┐"
+echo "│ Method            │ Latency (us)│ p50 (ns)  │ p99 (ns)  │ p99.9 (ns) │ Mmsgs/sec    │"
+echo "├────────────────────┼─────────────┼───────────┼───────────┼────────────┼──────────────┤"
+tail -n +2 "$LATENCY_CSV" | while IFS=, read -r name avg p50 p99 p999 max tput; do
+    printf "│ %-18s│ %11s │ %9s │ %9s │ %10s │ %12s │\n" "$name" "$avg" "$p50" "$p99" "$p999" "$tput"
+done
+echo "└────────────────────┴─────────────┴───────────┴───────────┴────────────┴──────────────┘"
 
 echo -e "\nDetailed reports saved in:"
 echo "  Logs: $LOG_DIR/"
 echo "  Results: $RESULTS_DIR/"
-echo "  Full report: $REPORT_FILE"
\ No newline at end of file
+echo "  Full report: $REPORT_FILE"
+echo "  Latency CSV: $LATENCY_CSV"
\ No newline at end of file
@@ -5,7 +5,7 @@
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 BUILD_DIR="$SCRIPT_DIR/../build"
 LOG_DIR="$SCRIPT_DIR/../logs"
-ITERATIONS=10
+ITERATIONS=${ITERATIONS:-10000}
 
 echo "=== Pipe Test Script ==="
 echo "Iterations: $ITERATIONS"
@@ -25,7 +25,7 @@ rm -f /tmp/pipe_server_* 2>/dev/null || true
 
 # 启动服务器
 echo "Starting Pipe server..."
-"$BUILD_DIR/pipe_server" $ITERATIONS > "$LOG_DIR/pipe_server.log" 2>&1 &
+"$BUILD_DIR/pipe_server" > "$LOG_DIR/pipe_server.log" 2>&1 &
 SERVER_PID=$!
 
 echo "Server PID: $SERVER_PID"
@@ -40,7 +40,7 @@ fi
 
 # 启动客户端
 echo "Starting Pipe client..."
-"$BUILD_DIR/pipe_client" $SERVER_PID $ITERATIONS > "$LOG_DIR/pipe_client.log" 2>&1
+"$BUILD_DIR/pipe_client" ${CLIENT_CPU:+-c $CLIENT_CPU} $SERVER_PID $ITERATIONS > "$LOG_DIR/pipe_client.log" 2>&1
 CLIENT_EXIT=$?
 
 # 等待客户端完成
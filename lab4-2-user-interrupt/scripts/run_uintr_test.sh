@@ -1,14 +1,19 @@
 #!/bin/bash
 
 # UINTR测试脚本
+# 用法: run_uintr_test.sh [poll|futex|eventfd|spin|uintr]
+# 不指定通知后端时由服务器选择（支持UINTR时用uintr，否则futex）
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 BUILD_DIR="$SCRIPT_DIR/../build"
 LOG_DIR="$SCRIPT_DIR/../logs"
-ITERATIONS=10
+ITERATIONS=${ITERATIONS:-10000}
+MESSAGES=${MESSAGES:-1000000}
+NOTIFIER=$1
 
 echo "=== UINTR Test Script ==="
 echo "Iterations: $ITERATIONS"
+echo "Notifier: ${NOTIFIER:-default}"
 
 # 创建日志目录
 mkdir -p "$LOG_DIR"
@@ -25,7 +30,7 @@ ipcs -m | grep $(whoami) | awk '{print $2}' | xargs -I {} ipcrm -m {} 2>/dev/nul
 
 # 启动服务器
 echo "Starting UINTR server..."
-"$BUILD_DIR/uintr_server" > "$LOG_DIR/server.log" 2>&1 &
+"$BUILD_DIR/uintr_server" ${SERVER_CPU:+-c $SERVER_CPU} $NOTIFIER > "$LOG_DIR/server.log" 2>&1 &
 SERVER_PID=$!
 
 echo "Server PID: $SERVER_PID"
@@ -40,7 +45,7 @@ fi
 
 # 启动客户端
 echo "Starting UINTR client..."
-"$BUILD_DIR/uintr_client" $SERVER_PID $ITERATIONS > "$LOG_DIR/client.log" 2>&1
+"$BUILD_DIR/uintr_client" ${CLIENT_CPU:+-c $CLIENT_CPU} $SERVER_PID $ITERATIONS $MESSAGES > "$LOG_DIR/client.log" 2>&1
 CLIENT_EXIT=$?
 
 # 等待客户端完成
@@ -60,7 +65,7 @@ if [ $CLIENT_EXIT -eq 0 ]; then
     
     # 显示性能数据
     echo -e "\nPerformance summary:"
-    grep -A 5 "Test Results:" "$LOG_DIR/client.log" || true
+    grep -A 8 "Test Results:" "$LOG_DIR/client.log" || true
 else
     echo "✗ UINTR test failed"
     echo -e "\nServer log:"
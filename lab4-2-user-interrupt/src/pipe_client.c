@@ -1,50 +1,82 @@
 /**
  * pipe_client.c - 传统管道客户端
  * 
- * 用于与UINTR进行性能对比
+ * 用于与UINTR进行性能对比；往返延迟的测量方式与uintr_client相同
  */
 
 #include "uintr_common.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#define DEFAULT_WARMUP  1000
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [options] <server_pid> [iterations]\n"
+           "  -w N      warm-up round trips before recording (default: %d)\n"
+           "  -c CPU    pin the client to CPU\n"
+           "  -t CLOCK  tsc (rdtscp) or raw (CLOCK_MONOTONIC_RAW) (default: tsc)\n"
+           "  -o FMT    result format: text, csv or json (default: text)\n",
+           prog, DEFAULT_WARMUP);
+}
+
 int main(int argc, char *argv[])
 {
     int read_fd, write_fd;
     char pipe_name_read[64];
     char pipe_name_write[64];
     int server_pid;
-    int iterations = 10;
-    benchmark_t bench;
+    int iterations = 10000;
+    int warmup = DEFAULT_WARMUP;
+    int cpu = -1;
+    int format = OUTPUT_TEXT;
+    clock_src_t clock_src = CLOCK_SRC_TSC;
     
-    if (argc < 2) {
-        printf("Usage: %s <server_pid> [iterations]\n", argv[0]);
+    int opt;
+    while ((opt = getopt(argc, argv, "w:c:t:o:h")) != -1) {
+        switch (opt) {
+            case 'w': warmup = atoi(optarg); break;
+            case 'c': cpu = atoi(optarg); break;
+            case 't': clock_src = strcmp(optarg, "raw") == 0 ? CLOCK_SRC_RAW : CLOCK_SRC_TSC; break;
+            case 'o': format = output_parse(optarg); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc || format < 0 || warmup < 0) {
+        usage(argv[0]);
         return 1;
     }
     
-    server_pid = atoi(argv[1]);
-    if (argc >= 3) {
-        iterations = atoi(argv[2]);
+    server_pid = atoi(argv[optind]);
+    if (argc > optind + 1) {
+        iterations = atoi(argv[optind + 1]);
+    }
+    if (pin_cpu(cpu) < 0) {
+        perror("sched_setaffinity failed");
+        return 1;
     }
     
     printf("=== Pipe Client Process ===\n");
     printf("Server PID: %d\n", server_pid);
-    printf("Iterations: %d\n", iterations);
+    printf("Iterations: %d (warm-up %d)\n", iterations, warmup);
     
     // 构建管道名称
     snprintf(pipe_name_read, sizeof(pipe_name_read), "/tmp/pipe_server_read_%d", server_pid);
     snprintf(pipe_name_write, sizeof(pipe_name_write), "/tmp/pipe_server_write_%d", server_pid);
     
-    // 打开管道（注意：客户端打开的顺序与服务器相反）
+    // 打开管道：服务器读的管道由客户端写，反之亦然；打开顺序与服务器一致，
+    // 否则两边都阻塞在open上
     printf("[Pipe Client] Connecting to server...\n");
     
-    write_fd = open(pipe_name_write, O_WRONLY);
+    write_fd = open(pipe_name_read, O_WRONLY);
     if (write_fd < 0) {
         perror("open write pipe failed");
         return 1;
     }
     
-    read_fd = open(pipe_name_read, O_RDONLY);
+    read_fd = open(pipe_name_write, O_RDONLY);
     if (read_fd < 0) {
         perror("open read pipe failed");
         close(write_fd);
@@ -53,24 +85,37 @@ int main(int argc, char *argv[])
     
     printf("[Pipe Client] Connected to server\n");
     
+    // 直方图约30KB，连接成功后再分配，之前的错误路径不必释放它
+    lat_hist_t *hist = malloc(sizeof(lat_hist_t));
+    if (!hist) {
+        perror("malloc histogram failed");
+        close(read_fd);
+        close(write_fd);
+        return 1;
+    }
+    
     // 性能测试
-    bench.total_latency = 0;
-    bench.iterations = 0;
+    lat_clock_t clk;
+    lat_clock_init(&clk, clock_src);
+    hist_init(hist);
     
     printf("\n[Pipe Client] Starting Pipe latency test...\n");
     printf("========================================\n");
     
-    for (int i = 1; i <= iterations; i++) {
-        int request = i;
+    // 计时区间内只有一次往返，不打印也不休眠
+    int failed = 0;
+    for (int i = -warmup; i < iterations; i++) {
+        int request = i & 0xffff;
         int response;
         
         // 测量往返延迟
-        start_timing(&bench);
+        uint64_t start = lat_now(&clk);
         
         // 发送请求
         ssize_t bytes = write(write_fd, &request, sizeof(request));
         if (bytes != sizeof(request)) {
             printf("[Pipe Client] Write error\n");
+            failed = 1;
             break;
         }
         
@@ -78,34 +123,29 @@ int main(int argc, char *argv[])
         bytes = read(read_fd, &response, sizeof(response));
         if (bytes != sizeof(response)) {
             printf("[Pipe Client] Read error\n");
+            failed = 1;
             break;
         }
         
-        stop_timing(&bench);
-        
-        long long latency = get_latency_us(&bench);
-        bench.total_latency += latency;
-        bench.iterations++;
-        
-        printf("[Pipe Client] Request %d: %d -> %d, Latency: %lld us\n",
-               i, request, response, latency);
-        
-        usleep(50000); // 50ms间隔
+        uint64_t end = lat_now(&clk);
+        if (i >= 0) {
+            hist_record(hist, lat_to_ns(&clk, end - start));
+        }
     }
     
     // 输出统计信息
     printf("\n========================================\n");
     printf("[Pipe Client] Pipe Test Results:\n");
-    printf("  Total iterations: %d\n", bench.iterations);
-    printf("  Total latency: %lld us\n", bench.total_latency);
-    printf("  Average latency: %.2f us\n", get_average_latency_us(&bench));
-    printf("  Average RTT latency: %.2f us\n", 
-           (double)bench.total_latency / bench.iterations);
+    hist_report(hist, "pipe", clock_src_name(clk.src), format);
+    free(hist);
     
     // 清理
     close(read_fd);
     close(write_fd);
     
+    if (failed) {
+        return 1;
+    }
     printf("[Pipe Client] Test completed\n");
     return 0;
 }
\ No newline at end of file
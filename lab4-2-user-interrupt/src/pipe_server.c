@@ -14,16 +14,10 @@ int main(int argc, char *argv[])
     char pipe_name_read[64];
     char pipe_name_write[64];
     char buffer[256];
-    int iterations = 10;
-    benchmark_t bench;
     
     printf("=== Pipe Server Process ===\n");
     printf("Process ID: %d\n", getpid());
     
-    if (argc >= 2) {
-        iterations = atoi(argv[1]);
-    }
-    
     // 创建命名管道
     snprintf(pipe_name_read, sizeof(pipe_name_read), "/tmp/pipe_server_read_%d", getpid());
     snprintf(pipe_name_write, sizeof(pipe_name_write), "/tmp/pipe_server_write_%d", getpid());
@@ -69,23 +63,38 @@ int main(int argc, char *argv[])
     
     printf("[Pipe Server] Client connected\n");
     
-    // 性能测试
-    bench.total_latency = 0;
-    bench.iterations = 0;
+    // 直方图约30KB，连接成功后再分配，之前的错误路径不必释放它
+    lat_hist_t *hist = malloc(sizeof(lat_hist_t));
+    if (!hist) {
+        perror("malloc histogram failed");
+        close(read_fd);
+        close(write_fd);
+        unlink(pipe_name_read);
+        unlink(pipe_name_write);
+        return 1;
+    }
+    
+    // 客户端的请求数包含预热，一直服务到客户端关闭管道；
+    // 这里只记录处理时间（不含等待请求的时间）
+    lat_clock_t clk;
+    lat_clock_init(&clk, CLOCK_SRC_RAW);
+    hist_init(hist);
     
-    for (int i = 1; i <= iterations; i++) {
+    while (1) {
         int request, response;
         
-        // 测量处理延迟
-        start_timing(&bench);
-        
         // 读取请求
         ssize_t bytes = read(read_fd, &request, sizeof(request));
+        if (bytes == 0) {
+            break;
+        }
         if (bytes != sizeof(request)) {
             printf("[Pipe Server] Read error\n");
             break;
         }
         
+        uint64_t start = lat_now(&clk);
+        
         // 处理请求
         response = request * 100;
         
@@ -96,21 +105,13 @@ int main(int argc, char *argv[])
             break;
         }
         
-        stop_timing(&bench);
-        
-        long long latency = get_latency_us(&bench);
-        bench.total_latency += latency;
-        bench.iterations++;
-        
-        printf("[Pipe Server] Request %d: %d -> %d, Latency: %lld us\n",
-               i, request, response, latency);
+        hist_record(hist, lat_to_ns(&clk, lat_now(&clk) - start));
     }
     
     // 输出统计信息
     printf("\n[Pipe Server] Pipe Test Results:\n");
-    printf("  Total iterations: %d\n", bench.iterations);
-    printf("  Total latency: %lld us\n", bench.total_latency);
-    printf("  Average latency: %.2f us\n", get_average_latency_us(&bench));
+    hist_report(hist, "pipe_server", clock_src_name(clk.src), OUTPUT_TEXT);
+    free(hist);
     
     // 清理
     close(read_fd);
@@ -1,45 +1,159 @@
 /**
  * uintr_client.c - UINTR客户端进程
  * 
- * 演示如何获取UINTR向量并发送用户态中断
+ * 演示如何获取UINTR向量并发送用户态中断。
+ * 先逐个发送请求测量往返延迟（预热后记录到HDR直方图），再保持最多
+ * window个未完成请求流水线发送，测量吞吐量。唤醒服务器的方式（通知
+ * 后端）由服务器选择。
  */
 
 #include "uintr_common.h"
 #include <sys/ipc.h>
 #include <sys/shm.h>
 
+#define DEFAULT_WARMUP  1000
+
+static uint64_t next_seq = 1;
+static notifier_t to_server, to_client;
+
+/* 一次往返：发送请求并等待响应 */
+static void round_trip(ipc_channel_t *ch, ipc_msg_t *msg, ipc_msg_t *resp)
+{
+    // 写入请求队列并发布，然后唤醒服务器（uintr后端即senduipi）
+    spsc_ring_push(&ch->request, msg);
+    spsc_ring_publish(&ch->request);
+    notifier_signal(&to_server);
+    
+    // 等待响应
+    while (!spsc_ring_pop(&ch->response, resp)) {
+        notifier_wait(&to_client, &ch->response);
+    }
+}
+
+/* 流水线发送messages个请求，未完成的请求不超过window个，返回校验失败的响应数 */
+static unsigned long long run_pipelined(ipc_channel_t *ch, unsigned long long messages,
+                                        uint32_t window)
+{
+    unsigned long long sent = 0, received = 0, errors = 0;
+    uint64_t first_seq = next_seq;
+    ipc_msg_t msg, resp;
+    
+    memset(&msg, 0, sizeof(msg));
+    msg.op = IPC_OP_REQUEST;
+    
+    while (received < messages) {
+        unsigned long long pushed = 0;
+        int progress = 0;
+        
+        while (sent < messages && sent - received < window) {
+            msg.seq = first_seq + sent;
+            msg.value = (int32_t)(sent & 0xffff);
+            if (!spsc_ring_push(&ch->request, &msg)) {
+                break;
+            }
+            sent++;
+            pushed++;
+        }
+        if (pushed > 0) {
+            spsc_ring_publish(&ch->request);
+            notifier_signal(&to_server);
+        }
+        
+        // 响应按请求顺序返回
+        while (spsc_ring_pop(&ch->response, &resp)) {
+            if (resp.seq != first_seq + received ||
+                resp.value != (int32_t)(received & 0xffff) * 100) {
+                errors++;
+            }
+            received++;
+            progress = 1;
+        }
+        
+        // 既不能发送也没有收到响应：等待服务器的通知
+        if (!pushed && !progress) {
+            notifier_wait(&to_client, &ch->response);
+        }
+    }
+    
+    next_seq += messages;
+    return errors;
+}
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [options] <server_pid> [iterations] [messages] [window]\n"
+           "  -w N      warm-up round trips before recording (default: %d)\n"
+           "  -c CPU    pin the client to CPU\n"
+           "  -t CLOCK  tsc (rdtscp) or raw (CLOCK_MONOTONIC_RAW) (default: tsc)\n"
+           "  -o FMT    result format: text, csv or json (default: text)\n",
+           prog, DEFAULT_WARMUP);
+}
+
 int main(int argc, char *argv[])
 {
     int server_pid = 0;
-    int iterations = 10;
-    benchmark_t bench;
-    shared_data_t *shared_mem = NULL;
+    int iterations = 10000;
+    int warmup = DEFAULT_WARMUP;
+    int cpu = -1;
+    int format = OUTPUT_TEXT;
+    clock_src_t clock_src = CLOCK_SRC_TSC;
+    unsigned long long messages = 1000000;
+    uint32_t window = 256;
+    ipc_channel_t *shared_mem = NULL;
     int shm_id = -1;
     
     printf("=== UINTR Client Process ===\n");
     
-    if (argc < 2) {
-        printf("Usage: %s <server_pid> [iterations]\n", argv[0]);
+    int opt;
+    while ((opt = getopt(argc, argv, "w:c:t:o:h")) != -1) {
+        switch (opt) {
+            case 'w': warmup = atoi(optarg); break;
+            case 'c': cpu = atoi(optarg); break;
+            case 't': clock_src = strcmp(optarg, "raw") == 0 ? CLOCK_SRC_RAW : CLOCK_SRC_TSC; break;
+            case 'o': format = output_parse(optarg); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc || format < 0 || warmup < 0) {
+        usage(argv[0]);
         return 1;
     }
     
-    server_pid = atoi(argv[1]);
-    if (argc >= 3) {
-        iterations = atoi(argv[2]);
+    server_pid = atoi(argv[optind]);
+    if (argc > optind + 1) {
+        iterations = atoi(argv[optind + 1]);
+    }
+    if (argc > optind + 2) {
+        messages = strtoull(argv[optind + 2], NULL, 10);
+    }
+    if (argc > optind + 3) {
+        window = (uint32_t)atoi(argv[optind + 3]);
+    }
+    // 服务器处理完一个请求后才能腾出响应槽位，未完成请求不能超过队列容量
+    if (window == 0 || window > RING_SIZE) {
+        printf("Window must be between 1 and %d\n", RING_SIZE);
+        return 1;
+    }
+    if (pin_cpu(cpu) < 0) {
+        perror("sched_setaffinity failed");
+        return 1;
     }
     
     printf("Server PID: %d\n", server_pid);
-    printf("Iterations: %d\n", iterations);
+    printf("Iterations: %d (warm-up %d)\n", iterations, warmup);
+    printf("Pipelined messages: %llu (window %u)\n", messages, window);
     
     // 连接到共享内存
     key_t key = ftok("/tmp", 'U');
-    shm_id = shmget(key, sizeof(shared_data_t), 0666);
+    shm_id = shmget(key, sizeof(ipc_channel_t), 0666);
     if (shm_id < 0) {
         perror("shmget failed");
         return 1;
     }
     
-    shared_mem = (shared_data_t *)shmat(shm_id, NULL, 0);
+    shared_mem = (ipc_channel_t *)shmat(shm_id, NULL, 0);
     if (shared_mem == (void *)-1) {
         perror("shmat failed");
         return 1;
@@ -47,73 +161,124 @@ int main(int argc, char *argv[])
     
     // 等待服务器准备好
     printf("[Client] Waiting for server to initialize...\n");
-    while (shared_mem->vector == 0) {
+    while (atomic_load(&shared_mem->ready) == 0) {
         usleep(100000); // 100ms
     }
     
-    int uipi_index = shared_mem->vector;
-    printf("[Client] Got UINTR vector: %d\n", uipi_index);
+    // 队列是单生产者单消费者的，同一时间只允许一个客户端
+    if (atomic_fetch_add(&shared_mem->attached, 1) != 0) {
+        printf("[Client] Server already has a client\n");
+        atomic_fetch_sub(&shared_mem->attached, 1);
+        shmdt(shared_mem);
+        return 1;
+    }
+    
+    // 连接服务器选择的通知后端
+    notify_kind_t kind = shared_mem->notify_kind;
+    notify_kind_t back = kind == NOTIFY_UINTR ? NOTIFY_POLL : kind;
+    if (notifier_attach(&to_server, &shared_mem->to_server, kind, server_pid) < 0 ||
+        notifier_attach(&to_client, &shared_mem->to_client, back, server_pid) < 0) {
+        perror("notifier_attach failed");
+        atomic_fetch_sub(&shared_mem->attached, 1);
+        shmdt(shared_mem);
+        return 1;
+    }
+    printf("[Client] Notifier: %s\n", notify_name(kind));
+    
+    // 直方图约30KB，连接成功后再分配，之前的错误路径不必释放它
+    lat_hist_t *hist = malloc(sizeof(lat_hist_t));
+    if (!hist) {
+        perror("malloc histogram failed");
+        notifier_destroy(&to_server);
+        notifier_destroy(&to_client);
+        atomic_fetch_sub(&shared_mem->attached, 1);
+        shmdt(shared_mem);
+        return 1;
+    }
     
     // 性能测试
-    bench.total_latency = 0;
-    bench.iterations = 0;
+    lat_clock_t clk;
+    lat_clock_init(&clk, clock_src);
+    hist_init(hist);
     
     printf("\n[Client] Starting UINTR latency test...\n");
     printf("========================================\n");
     
-    for (int i = 1; i <= iterations; i++) {
-        // 准备消息
-        snprintf(shared_mem->message, sizeof(shared_mem->message), 
-                "Request #%d from client %d", i, getpid());
-        shared_mem->response = 0;
+    // 计时区间内只有一次往返，不打印也不休眠
+    unsigned long long errors = 0;
+    for (int i = -warmup; i < iterations; i++) {
+        ipc_msg_t msg, resp;
         
-        // 设置就绪标志
-        shared_mem->ready = 1;
+        memset(&msg, 0, sizeof(msg));
+        msg.seq = next_seq++;
+        msg.op = IPC_OP_REQUEST;
+        msg.value = i & 0xffff;
         
-        // 测量发送延迟
-        start_timing(&bench);
+        uint64_t start = lat_now(&clk);
+        round_trip(shared_mem, &msg, &resp);
+        uint64_t end = lat_now(&clk);
         
-        // 发送用户态中断
-        int ret = senduipi(uipi_index);
-        if (ret < 0) {
-            perror("senduipi failed");
-            break;
+        if (resp.seq != msg.seq || resp.value != (i & 0xffff) * 100) {
+            errors++;
         }
-        
-        // 等待响应
-        while (shared_mem->response == 0) {
-            usleep(10); // 微秒级等待
+        if (i >= 0) {
+            hist_record(hist, lat_to_ns(&clk, end - start));
         }
-        
-        stop_timing(&bench);
-        
-        long long latency = get_latency_us(&bench);
-        bench.total_latency += latency;
-        bench.iterations++;
-        
-        printf("[Client] Request %d sent. Response: %d, Latency: %lld us\n",
-               i, shared_mem->response, latency);
-        
-        // 清除就绪标志
-        shared_mem->ready = 0;
-        
-        usleep(50000); // 50ms间隔
     }
     
+    // 流水线吞吐量测试
+    uint64_t pipelined_ns = 0;
+    if (messages > 0) {
+        printf("\n[Client] Starting pipelined throughput test...\n");
+        uint64_t start = now_ns();
+        errors += run_pipelined(shared_mem, messages, window);
+        pipelined_ns = now_ns() - start;
+    }
+    double mmsgs = pipelined_ns > 0 ? messages * 1000.0 / pipelined_ns : 0.0;
+    
+    // 通知服务器退出
+    ipc_msg_t bye = { .seq = next_seq++, .op = IPC_OP_EXIT };
+    while (!spsc_ring_push(&shared_mem->request, &bye)) {
+        cpu_relax();
+    }
+    spsc_ring_publish(&shared_mem->request);
+    notifier_signal(&to_server);
+    
     // 输出统计信息
     printf("\n========================================\n");
     printf("[Client] UINTR Test Results:\n");
-    printf("  Total iterations: %d\n", bench.iterations);
-    printf("  Total latency: %lld us\n", bench.total_latency);
-    printf("  Average latency: %.2f us\n", get_average_latency_us(&bench));
-    printf("  Average latency per iteration: %.2f us\n", 
-           (double)bench.total_latency / bench.iterations);
+    hist_report(hist, notify_name(kind), clock_src_name(clk.src), format);
+    if (format == OUTPUT_CSV) {
+        printf("name,messages,window,errors,mmsgs_per_sec\n");
+        printf("%s_pipelined,%llu,%u,%llu,%.2f\n", notify_name(kind), messages, window,
+               errors, mmsgs);
+    } else if (format == OUTPUT_JSON) {
+        printf("{\"name\": \"%s_pipelined\", \"messages\": %llu, \"window\": %u, "
+               "\"errors\": %llu, \"mmsgs_per_sec\": %.2f}\n", notify_name(kind),
+               messages, window, errors, mmsgs);
+    } else if (messages > 0) {
+        printf("  Pipelined messages: %llu in %.3f ms (window %u, %llu errors)\n",
+               messages, pipelined_ns / 1e6, window, errors);
+        printf("  Pipelined throughput: %.2f M msgs/sec\n", mmsgs);
+    }
+    if (format == OUTPUT_TEXT) {
+        printf("  Notifier: %s (%llu signals, %llu wakeups, slept %llu times)\n",
+               notify_name(kind), to_server.signals, to_server.wakes, to_client.sleeps);
+    }
     
     // 清理
+    free(hist);
+    notifier_destroy(&to_server);
+    notifier_destroy(&to_client);
+    atomic_fetch_sub(&shared_mem->attached, 1);
     if (shared_mem) {
         shmdt(shared_mem);
     }
     
+    if (errors > 0) {
+        printf("[Client] Test failed: %llu bad responses\n", errors);
+        return 1;
+    }
     printf("[Client] Test completed\n");
     return 0;
 }
\ No newline at end of file
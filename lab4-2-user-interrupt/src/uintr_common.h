@@ -7,6 +7,10 @@
 #ifndef _UINTR_COMMON_H
 #define _UINTR_COMMON_H
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             // sched_setaffinity
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,8 +21,18 @@
 #include <sys/wait.h>
 #include <sys/time.h>
 #include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/futex.h>
+#include <sched.h>
 #include <errno.h>
 #include <time.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifdef __UINTR__
+#include <x86gprintrin.h>       // struct __uintr_frame
+#endif
 
 /* UINTR 相关的系统调用号 */
 #ifndef __NR_uintr_register_handler
@@ -45,13 +59,22 @@
 #define __NR_senduipi 465
 #endif
 
+/* 从另一个进程复制文件描述符（Linux 5.6+） */
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+#ifndef SYS_pidfd_getfd
+#define SYS_pidfd_getfd 438
+#endif
+
 /* 系统调用包装函数 */
-static inline int uintr_register_handler(unsigned int handler, unsigned int flags)
+static inline int uintr_register_handler(unsigned long handler, unsigned int flags)
 {
     return syscall(__NR_uintr_register_handler, handler, flags);
 }
 
-static inline int uintr_unregister_handler(unsigned int handler, unsigned int flags)
+static inline int uintr_unregister_handler(unsigned long handler, unsigned int flags)
 {
     return syscall(__NR_uintr_unregister_handler, handler, flags);
 }
@@ -76,44 +99,714 @@ static inline int senduipi(int uipi_index)
     return syscall(__NR_senduipi, uipi_index);
 }
 
+/* 复制进程pid中编号为fd的文件描述符，失败返回-1 */
+static inline int dup_peer_fd(pid_t pid, int fd)
+{
+    int pidfd = syscall(SYS_pidfd_open, pid, 0);
+    if (pidfd < 0) {
+        return -1;
+    }
+    int ret = syscall(SYS_pidfd_getfd, pidfd, fd, 0);
+    close(pidfd);
+    return ret;
+}
+
 /* 性能测量相关 */
+
+/*
+ * 延迟测量：计时源为 rdtscp（x86，按 CLOCK_MONOTONIC_RAW 校准为纳秒）或
+ * 直接读 CLOCK_MONOTONIC_RAW；不受NTP调整影响，分辨率为纳秒级。
+ * 样本记录在HDR（对数-线性）直方图中：每个2的幂区间再等分 HIST_SUB_COUNT
+ * 格，任意量级的相对误差都不超过 1/HIST_SUB_COUNT，内存固定且记录为O(1)。
+ */
+#define HIST_SUB_BITS   7
+#define HIST_SUB_COUNT  (1 << (HIST_SUB_BITS - 1))      // 每个2的幂区间的格数
+#define HIST_BUCKETS    ((64 - HIST_SUB_BITS + 2) * HIST_SUB_COUNT)
+
+typedef enum {
+    CLOCK_SRC_RAW,              // clock_gettime(CLOCK_MONOTONIC_RAW)
+    CLOCK_SRC_TSC               // rdtscp
+} clock_src_t;
+
+typedef struct {
+    clock_src_t src;
+    double ns_per_tick;         // tsc: 每个时钟周期的纳秒数
+} lat_clock_t;
+
 typedef struct {
-    struct timeval start_time;
-    struct timeval end_time;
-    long long total_latency;
-    int iterations;
-} benchmark_t;
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+} lat_hist_t;
+
+typedef enum {
+    OUTPUT_TEXT,
+    OUTPUT_CSV,
+    OUTPUT_JSON
+} output_format_t;
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
 
-static inline void start_timing(benchmark_t *bench)
+static inline uint64_t read_tsc(void)
 {
-    gettimeofday(&bench->start_time, NULL);
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int aux;
+    return __builtin_ia32_rdtscp(&aux);
+#else
+    return now_ns();
+#endif
+}
+
+/* 初始化计时源；tsc先用CLOCK_MONOTONIC_RAW校准约20ms */
+static inline void lat_clock_init(lat_clock_t *clk, clock_src_t src)
+{
+    clk->src = src;
+    clk->ns_per_tick = 1.0;
+#if defined(__x86_64__) || defined(__i386__)
+    if (src == CLOCK_SRC_TSC) {
+        uint64_t t0 = now_ns(), c0 = read_tsc(), t1, c1;
+        do {
+            t1 = now_ns();
+            c1 = read_tsc();
+        } while (t1 - t0 < 20000000ULL);
+        clk->ns_per_tick = (double)(t1 - t0) / (double)(c1 - c0);
+    }
+#else
+    clk->src = CLOCK_SRC_RAW;
+#endif
+}
+
+static inline uint64_t lat_now(const lat_clock_t *clk)
+{
+    return clk->src == CLOCK_SRC_TSC ? read_tsc() : now_ns();
+}
+
+static inline uint64_t lat_to_ns(const lat_clock_t *clk, uint64_t ticks)
+{
+    return clk->src == CLOCK_SRC_TSC ? (uint64_t)(ticks * clk->ns_per_tick + 0.5) : ticks;
 }
 
-static inline void stop_timing(benchmark_t *bench)
+static inline const char *clock_src_name(clock_src_t src)
 {
-    gettimeofday(&bench->end_time, NULL);
+    return src == CLOCK_SRC_TSC ? "rdtscp" : "monotonic_raw";
 }
 
-static inline long long get_latency_us(benchmark_t *bench)
+static inline void hist_init(lat_hist_t *h)
 {
-    long long start_us = bench->start_time.tv_sec * 1000000LL + bench->start_time.tv_usec;
-    long long end_us = bench->end_time.tv_sec * 1000000LL + bench->end_time.tv_usec;
-    return end_us - start_us;
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
 }
 
-static inline double get_average_latency_us(benchmark_t *bench)
+static inline uint32_t hist_index(uint64_t v)
 {
-    return (double)bench->total_latency / bench->iterations;
+    if (v < (1ULL << HIST_SUB_BITS)) {
+        return (uint32_t)v;
+    }
+    // v = sub << shift，sub落在[HIST_SUB_COUNT, 2*HIST_SUB_COUNT)
+    uint32_t shift = 63 - __builtin_clzll(v) - HIST_SUB_BITS + 1;
+    return shift * HIST_SUB_COUNT + (uint32_t)(v >> shift);
+}
+
+/* 格index中的最大值（与HDR一样按同一格内的最高值报告） */
+static inline uint64_t hist_value(uint32_t index)
+{
+    if (index < (1U << HIST_SUB_BITS)) {
+        return index;
+    }
+    uint32_t shift = index / HIST_SUB_COUNT - 1;
+    uint64_t sub = index - shift * HIST_SUB_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+static inline void hist_record(lat_hist_t *h, uint64_t ns)
+{
+    h->counts[hist_index(ns)]++;
+    h->total++;
+    h->sum += ns;
+    if (ns < h->min) {
+        h->min = ns;
+    }
+    if (ns > h->max) {
+        h->max = ns;
+    }
+}
+
+/* 百分位数（0~100），不超过实际的最大值 */
+static inline uint64_t hist_percentile(const lat_hist_t *h, double pct)
+{
+    if (h->total == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(pct / 100.0 * h->total + 0.5);
+    uint64_t seen = 0;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t v = hist_value(i);
+            return v < h->max ? v : h->max;
+        }
+    }
+    return h->max;
+}
+
+static inline double hist_mean(const lat_hist_t *h)
+{
+    return h->total ? h->sum / h->total : 0.0;
+}
+
+static inline int output_parse(const char *name)
+{
+    if (strcmp(name, "text") == 0) {
+        return OUTPUT_TEXT;
+    }
+    if (strcmp(name, "csv") == 0) {
+        return OUTPUT_CSV;
+    }
+    if (strcmp(name, "json") == 0) {
+        return OUTPUT_JSON;
+    }
+    return -1;
+}
+
+/* 输出一个直方图的统计；text格式保留"Average latency"行供脚本解析 */
+static inline void hist_report(const lat_hist_t *h, const char *name, const char *clock,
+                               output_format_t format)
+{
+    uint64_t p50 = hist_percentile(h, 50), p99 = hist_percentile(h, 99);
+    uint64_t p999 = hist_percentile(h, 99.9);
+    uint64_t min = h->total ? h->min : 0;
+
+    switch (format) {
+        case OUTPUT_CSV:
+            printf("name,clock,samples,mean_ns,min_ns,p50_ns,p99_ns,p999_ns,max_ns\n");
+            printf("%s,%s,%llu,%.1f,%llu,%llu,%llu,%llu,%llu\n", name, clock,
+                   (unsigned long long)h->total, hist_mean(h), (unsigned long long)min,
+                   (unsigned long long)p50, (unsigned long long)p99,
+                   (unsigned long long)p999, (unsigned long long)h->max);
+            break;
+
+        case OUTPUT_JSON:
+            printf("{\"name\": \"%s\", \"clock\": \"%s\", \"samples\": %llu, "
+                   "\"mean_ns\": %.1f, \"min_ns\": %llu, \"p50_ns\": %llu, "
+                   "\"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu}\n",
+                   name, clock, (unsigned long long)h->total, hist_mean(h),
+                   (unsigned long long)min, (unsigned long long)p50,
+                   (unsigned long long)p99, (unsigned long long)p999,
+                   (unsigned long long)h->max);
+            break;
+
+        default:
+            printf("  Samples: %llu (clock: %s)\n", (unsigned long long)h->total, clock);
+            printf("  Average latency: %.3f us\n", hist_mean(h) / 1000.0);
+            printf("  Latency (ns): min %llu, p50 %llu, p99 %llu, p99.9 %llu, max %llu\n",
+                   (unsigned long long)min, (unsigned long long)p50,
+                   (unsigned long long)p99, (unsigned long long)p999,
+                   (unsigned long long)h->max);
+            break;
+    }
+}
+
+/* 把当前线程绑定到一个CPU，cpu为负时不绑定 */
+static inline int pin_cpu(int cpu)
+{
+    if (cpu < 0) {
+        return 0;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
 }
 
 /* 共享内存相关 */
+
+/*
+ * 请求/响应都放在单生产者单消费者（SPSC）环形队列中，客户端可以连续
+ * 提交多个请求而不必等待上一个响应。
+ *
+ * 每个队列的生产者与消费者各占一个缓存行：生产者写 tail，消费者写
+ * head，互不干扰。写入的位置先记在本地（local_tail/local_head），攒满
+ * RING_BATCH 条或调用 spsc_ring_publish/spsc_ring_release 时才用 release
+ * 写入共享的下标，对端用 acquire 读取，从而保证看到下标时槽位内容已可见。
+ * 对端下标缓存在 cached_head/cached_tail 中，只有缓存显示队列满/空时才
+ * 重新读取对端的缓存行。
+ */
+#define CACHE_LINE_SIZE 64
+#define RING_SIZE       1024            // 槽位数，必须是2的幂
+#define RING_MASK       (RING_SIZE - 1)
+#define RING_BATCH      32              // 每攒多少条发布一次下标
+
 typedef struct {
-    int vector;        // UINTR向量号
-    int ready;         // 就绪标志
-    char message[256]; // 通信消息
-    int response;      // 响应值
-} shared_data_t;
+    uint64_t seq;           // 请求序号，响应原样带回
+    int32_t op;             // 请求类型
+    int32_t value;          // 请求参数 / 响应值
+    union {
+        char message[48];   // 通信消息
+        int32_t args[12];   // RPC参数
+    };
+} ipc_msg_t;                // 正好一个缓存行
+
+#define IPC_OP_REQUEST  0
+#define IPC_OP_EXIT     1   // 客户端结束，服务器退出
 
-#define SHARED_SIZE 4096
+typedef struct {
+    struct {
+        atomic_uint tail;           // 已发布的写位置
+        uint32_t local_tail;        // 已写入但可能未发布
+        uint32_t cached_head;       // 上次读到的消费者位置
+    } prod __attribute__((aligned(CACHE_LINE_SIZE)));
+    struct {
+        atomic_uint head;           // 已释放的读位置
+        uint32_t local_head;        // 已读出但可能未释放
+        uint32_t cached_tail;       // 上次读到的生产者位置
+    } cons __attribute__((aligned(CACHE_LINE_SIZE)));
+    ipc_msg_t slots[RING_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+} spsc_ring_t;
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/* 等待对端时的退避：先pause自旋，超过 IPC_SPIN_LIMIT 次后让出CPU */
+#define IPC_SPIN_LIMIT  1024
+
+static inline void ipc_backoff(uint32_t *spins)
+{
+    if (++*spins < IPC_SPIN_LIMIT) {
+        cpu_relax();
+    } else {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+static inline void spsc_ring_init(spsc_ring_t *ring)
+{
+    memset(ring, 0, sizeof(*ring));
+}
+
+/* 生产者：发布已写入的槽位 */
+static inline void spsc_ring_publish(spsc_ring_t *ring)
+{
+    atomic_store_explicit(&ring->prod.tail, ring->prod.local_tail, memory_order_release);
+}
+
+/* 生产者：写入一条消息，队列满时返回false（并先发布已写入的消息） */
+static inline bool spsc_ring_push(spsc_ring_t *ring, const ipc_msg_t *msg)
+{
+    uint32_t tail = ring->prod.local_tail;
+
+    if (tail - ring->prod.cached_head == RING_SIZE) {
+        ring->prod.cached_head = atomic_load_explicit(&ring->cons.head, memory_order_acquire);
+        if (tail - ring->prod.cached_head == RING_SIZE) {
+            spsc_ring_publish(ring);
+            return false;
+        }
+    }
+
+    ring->slots[tail & RING_MASK] = *msg;
+    ring->prod.local_tail = tail + 1;
+    if (((tail + 1) & (RING_BATCH - 1)) == 0) {
+        spsc_ring_publish(ring);
+    }
+    return true;
+}
+
+/* 消费者：释放已读出的槽位 */
+static inline void spsc_ring_release(spsc_ring_t *ring)
+{
+    atomic_store_explicit(&ring->cons.head, ring->cons.local_head, memory_order_release);
+}
+
+/* 消费者：读出一条消息，队列空时返回false（并先释放已读出的槽位） */
+static inline bool spsc_ring_pop(spsc_ring_t *ring, ipc_msg_t *msg)
+{
+    uint32_t head = ring->cons.local_head;
+
+    if (head == ring->cons.cached_tail) {
+        ring->cons.cached_tail = atomic_load_explicit(&ring->prod.tail, memory_order_acquire);
+        if (head == ring->cons.cached_tail) {
+            spsc_ring_release(ring);
+            return false;
+        }
+    }
+
+    *msg = ring->slots[head & RING_MASK];
+    ring->cons.local_head = head + 1;
+    if (((head + 1) & (RING_BATCH - 1)) == 0) {
+        spsc_ring_release(ring);
+    }
+    return true;
+}
+
+/* 消费者：队列中是否有可读的消息（不取出） */
+static inline bool spsc_ring_readable(spsc_ring_t *ring)
+{
+    return ring->cons.local_head != atomic_load_explicit(&ring->prod.tail, memory_order_acquire);
+}
+
+/* 通知机制 */
+
+/*
+ * 生产者发布消息后"唤醒对端"这一步由notifier完成，后端在运行时选择：
+ *   poll     忙等：接收方只自旋检查队列（自旋太久时sched_yield），发送方什么也不做
+ *   futex    接收方阻塞在futex上，发送方只在接收方阻塞时FUTEX_WAKE
+ *   eventfd  接收方阻塞在read(eventfd)上，发送方只在接收方阻塞时write
+ *   spin     先自旋 NOTIFY_SPIN_LIMIT 次，仍没有消息再按futex阻塞；单CPU上
+ *            自旋期间对端无法运行，直接阻塞
+ *   uintr    发送方senduipi，接收方的中断处理函数立即运行；接收方仍自旋
+ *            检查队列（没有阻塞等待用户态中断的系统调用），需要UINTR硬件
+ * 阻塞类后端先置 sleeping 再复查队列，发送方先发布队列再读 sleeping，
+ * 两边之间各有一个全屏障，因此不会丢失唤醒；对方没有阻塞时不进内核。
+ */
+#define NOTIFY_SPIN_LIMIT   2000
+
+typedef enum {
+    NOTIFY_POLL,
+    NOTIFY_FUTEX,
+    NOTIFY_EVENTFD,
+    NOTIFY_SPIN,
+    NOTIFY_UINTR,
+    NOTIFY_NR_KINDS
+} notify_kind_t;
+
+static inline const char *notify_name(int kind)
+{
+    static const char *names[NOTIFY_NR_KINDS] = { "poll", "futex", "eventfd", "spin", "uintr" };
+    return kind >= 0 && kind < NOTIFY_NR_KINDS ? names[kind] : "unknown";
+}
+
+/* 一个方向的通知状态，位于共享内存 */
+typedef struct {
+    atomic_uint seq;            // 通知计数，同时是futex字
+    atomic_int sleeping;        // 接收方已经或即将阻塞
+    int efd;                    // eventfd在服务器进程中的编号
+    int uintr_fd;               // UINTR fd在服务器进程中的编号
+} __attribute__((aligned(CACHE_LINE_SIZE))) notify_shared_t;
+
+/* 每个进程自己的通知句柄 */
+typedef struct {
+    notify_kind_t kind;
+    notify_shared_t *shared;
+    int efd;                    // 本进程中的eventfd
+    int uipi_index;             // 本进程的senduipi索引
+    uint32_t spin_limit;        // spin后端阻塞前的自旋次数，单CPU上为0
+    unsigned long long signals; // 发送通知的次数
+    unsigned long long wakes;   // 其中需要进内核唤醒对方的次数
+    unsigned long long sleeps;  // 接收方阻塞的次数
+} notifier_t;
+
+static inline int notify_parse(const char *name)
+{
+    for (int i = 0; i < NOTIFY_NR_KINDS; i++) {
+        if (strcmp(name, notify_name(i)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* uintr后端需要编译器支持（-muintr）并且CPU有uintr标志 */
+static inline bool notify_supported(notify_kind_t kind)
+{
+    if (kind != NOTIFY_UINTR) {
+        return true;
+    }
+#ifdef __UINTR__
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    char line[4096];
+    bool found = false;
+    while (fp && !found && fgets(line, sizeof(line), fp)) {
+        found = strncmp(line, "flags", 5) == 0 && strstr(line, " uintr") != NULL;
+    }
+    if (fp) {
+        fclose(fp);
+    }
+    return found;
+#else
+    return false;
+#endif
+}
+
+static inline long futex(atomic_uint *addr, int op, uint32_t val)
+{
+    return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+/* spin后端的自旋次数：与adaptive_wait_init相同，单CPU上不自旋 */
+static inline uint32_t notify_spin_limit(notify_kind_t kind)
+{
+    if (kind != NOTIFY_SPIN || sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+        return 0;
+    }
+    return NOTIFY_SPIN_LIMIT;
+}
+
+/* 服务器：初始化一个方向的通知状态 */
+static inline int notifier_create(notifier_t *n, notify_shared_t *shared, notify_kind_t kind)
+{
+    memset(n, 0, sizeof(*n));
+    n->kind = kind;
+    n->shared = shared;
+    n->efd = -1;
+    n->uipi_index = -1;
+    n->spin_limit = notify_spin_limit(kind);
+    atomic_store(&shared->seq, 0);
+    atomic_store(&shared->sleeping, 0);
+    shared->efd = -1;
+    shared->uintr_fd = -1;
+
+    if (kind == NOTIFY_EVENTFD) {
+        n->efd = eventfd(0, 0);
+        if (n->efd < 0) {
+            return -1;
+        }
+        shared->efd = n->efd;
+    }
+    return 0;
+}
+
+/* 客户端：连接服务器创建的通知状态，eventfd与UINTR fd从服务器进程复制 */
+static inline int notifier_attach(notifier_t *n, notify_shared_t *shared, notify_kind_t kind,
+                                  pid_t server_pid)
+{
+    memset(n, 0, sizeof(*n));
+    n->kind = kind;
+    n->shared = shared;
+    n->efd = -1;
+    n->uipi_index = -1;
+    n->spin_limit = notify_spin_limit(kind);
+
+    if (kind == NOTIFY_EVENTFD) {
+        n->efd = dup_peer_fd(server_pid, shared->efd);
+        return n->efd < 0 ? -1 : 0;
+    }
+    if (kind == NOTIFY_UINTR && shared->uintr_fd >= 0) {
+        int fd = dup_peer_fd(server_pid, shared->uintr_fd);
+        if (fd < 0) {
+            return -1;
+        }
+        n->uipi_index = uintr_register_sender(fd, 0);
+        close(fd);
+        return n->uipi_index < 0 ? -1 : 0;
+    }
+    return 0;
+}
+
+static inline void notifier_destroy(notifier_t *n)
+{
+    if (n->uipi_index >= 0) {
+        uintr_unregister_sender(n->uipi_index, 0);
+    }
+    if (n->efd >= 0) {
+        close(n->efd);
+    }
+    n->efd = -1;
+    n->uipi_index = -1;
+}
+
+/* 发送方：消息已发布到队列后调用 */
+static inline void notifier_signal(notifier_t *n)
+{
+    notify_shared_t *s = n->shared;
+
+    n->signals++;
+    switch (n->kind) {
+        case NOTIFY_POLL:
+            return;
+
+        case NOTIFY_UINTR:
+            if (n->uipi_index >= 0) {
+                senduipi(n->uipi_index);
+                n->wakes++;
+            }
+            return;
+
+        default:
+            break;
+    }
+
+    // 与接收方的 sleeping 写入配对的全屏障
+    atomic_fetch_add(&s->seq, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&s->sleeping, memory_order_relaxed)) {
+        n->wakes++;
+        if (n->kind == NOTIFY_EVENTFD) {
+            uint64_t one = 1;
+            if (write(n->efd, &one, sizeof(one)) < 0) {
+                perror("eventfd write");
+            }
+        } else {
+            futex(&s->seq, FUTEX_WAKE, 1);
+        }
+    }
+}
+
+/* 接收方：阻塞直到队列可读或被唤醒（可能是虚假唤醒） */
+static inline void notifier_block(notifier_t *n, spsc_ring_t *ring)
+{
+    notify_shared_t *s = n->shared;
+    uint32_t seq = atomic_load(&s->seq);
+
+    atomic_store_explicit(&s->sleeping, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!spsc_ring_readable(ring)) {
+        n->sleeps++;
+        if (n->kind == NOTIFY_EVENTFD) {
+            uint64_t value;
+            if (read(n->efd, &value, sizeof(value)) < 0 && errno != EINTR) {
+                perror("eventfd read");
+            }
+        } else {
+            // seq在读取后变化说明已有通知，FUTEX_WAIT立即返回
+            futex(&s->seq, FUTEX_WAIT, seq);
+        }
+    }
+    atomic_store_explicit(&s->sleeping, 0, memory_order_relaxed);
+}
+
+/* 接收方：等待队列中出现消息 */
+static inline void notifier_wait(notifier_t *n, spsc_ring_t *ring)
+{
+    uint32_t spins = 0;
+
+    while (!spsc_ring_readable(ring)) {
+        switch (n->kind) {
+            case NOTIFY_FUTEX:
+            case NOTIFY_EVENTFD:
+                notifier_block(n, ring);
+                break;
+
+            case NOTIFY_SPIN:
+                if (spins < n->spin_limit) {
+                    spins++;
+                    cpu_relax();
+                } else {
+                    notifier_block(n, ring);
+                }
+                break;
+
+            default:
+                ipc_backoff(&spins);
+                break;
+        }
+    }
+}
+
+/* 自适应等待 */
+
+/*
+ * 等待一个32位计数离开旧值：先pause自旋，计数仍未变化再FUTEX_WAIT。
+ * 自旋预算以纳秒给出，启动时按pause的实测耗时换算成次数：
+ *   - 睡眠比预算还短（对端只是稍慢）时预算加倍，睡得更久时减半，
+ *     对端长时间空闲时不再白白占用CPU；
+ *   - 单CPU上自旋期间对端无法运行，不自旋。
+ * 唤醒方先改计数再读 sleeping，等待方先增 sleeping 再读计数，
+ * 对端没有睡眠时唤醒方不进内核。
+ */
+#define WAIT_SPIN_NS        10000       // 默认自旋预算，约为一次futex睡眠加唤醒的开销
+#define WAIT_SPIN_MIN       16          // 自旋次数下限
+#define WAIT_CALIBRATE      10000       // 标定时执行的pause次数
+
+typedef struct {
+    atomic_uint count;          // 等待的计数，同时是futex字
+    atomic_int sleeping;        // 已经或即将FUTEX_WAIT的等待者数
+} __attribute__((aligned(CACHE_LINE_SIZE))) wait_word_t;
+
+/* 每个等待者自己的自旋预算与统计 */
+typedef struct {
+    uint32_t spin;              // 当前自旋预算（pause次数）
+    uint32_t max_spin;          // 预算上限，单CPU上为0
+    uint64_t budget_ns;
+    unsigned long long spun;    // 在自旋中等到的次数
+    unsigned long long sleeps;  // FUTEX_WAIT的次数
+} adaptive_wait_t;
+
+static inline void adaptive_wait_init(adaptive_wait_t *a, uint64_t budget_ns)
+{
+    memset(a, 0, sizeof(*a));
+    a->budget_ns = budget_ns;
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+        return;
+    }
+
+    // 标定：budget_ns内能执行多少次pause
+    uint64_t start = now_ns();
+    for (int i = 0; i < WAIT_CALIBRATE; i++) {
+        cpu_relax();
+    }
+    uint64_t elapsed = now_ns() - start;
+    uint64_t spins = budget_ns * WAIT_CALIBRATE / (elapsed ? elapsed : 1);
+    a->max_spin = spins > UINT32_MAX ? UINT32_MAX : (spins < WAIT_SPIN_MIN ? WAIT_SPIN_MIN : spins);
+    a->spin = a->max_spin;
+}
+
+/* 唤醒方：计数加一，只在有等待者睡眠时FUTEX_WAKE，返回是否进了内核 */
+static inline bool wait_word_bump(wait_word_t *w)
+{
+    atomic_fetch_add(&w->count, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&w->sleeping, memory_order_relaxed) == 0) {
+        return false;
+    }
+    futex(&w->count, FUTEX_WAKE, INT32_MAX);
+    return true;
+}
+
+/* 等待方：等到计数不等于old，返回新的计数 */
+static inline uint32_t adaptive_wait(adaptive_wait_t *a, wait_word_t *w, uint32_t old)
+{
+    uint32_t count;
+
+    for (uint32_t i = 0; i < a->spin; i++) {
+        count = atomic_load_explicit(&w->count, memory_order_acquire);
+        if (count != old) {
+            a->spun++;
+            return count;
+        }
+        cpu_relax();
+    }
+
+    uint64_t start = now_ns();
+    atomic_fetch_add(&w->sleeping, 1);
+    while ((count = atomic_load(&w->count)) == old) {
+        a->sleeps++;
+        // 计数在读取后变化说明已有唤醒，FUTEX_WAIT立即返回
+        futex(&w->count, FUTEX_WAIT, old);
+    }
+    atomic_fetch_sub(&w->sleeping, 1);
+
+    if (now_ns() - start < a->budget_ns) {
+        a->spin = a->spin * 2 < WAIT_SPIN_MIN ? WAIT_SPIN_MIN : a->spin * 2;
+        a->spin = a->spin > a->max_spin ? a->max_spin : a->spin;
+    } else {
+        a->spin /= 2;
+    }
+    return count;
+}
+
+/* 服务器与客户端之间的共享内存：请求队列与响应队列各一个 */
+typedef struct {
+    atomic_int ready;           // 服务器初始化完成
+    atomic_int attached;        // 已连接的客户端数（SPSC只允许一个）
+    int notify_kind;            // 服务器选择的通知后端
+    notify_shared_t to_server;  // 请求到达
+    notify_shared_t to_client;  // 响应到达
+    spsc_ring_t request;        // 客户端 -> 服务器
+    spsc_ring_t response;       // 服务器 -> 客户端
+} ipc_channel_t;
 
 #endif /* _UINTR_COMMON_H */
\ No newline at end of file
@@ -1,7 +1,10 @@
 /**
  * uintr_server.c - UINTR服务器进程
  * 
- * 演示如何注册用户态中断处理函数并响应中断
+ * 演示如何注册用户态中断处理函数并响应中断。
+ * 请求从共享内存的请求队列中批量取出，响应写入响应队列。
+ * 唤醒对端的方式由命令行选择（poll/futex/eventfd/spin/uintr），
+ * 不支持UINTR的机器上默认退回futex。
  */
 
 #include "uintr_common.h"
@@ -12,23 +15,84 @@
 
 /* 全局变量 */
 static volatile atomic_int interrupt_count = 0;
-static shared_data_t *shared_mem = NULL;
+static ipc_channel_t *shared_mem = NULL;
 static int shm_id = -1;
 static int uipi_fd = -1;
-static int uipi_index = -1;
+static notifier_t to_server, to_client;
 
 /* 用户态中断处理函数 */
-static void __attribute__((interrupt)) uintr_handler(struct __uintr_frame *ui_frame, unsigned long long vector)
+#ifdef __UINTR__
+static int handler_registered = 0;
+
+static void __attribute__((interrupt, target("general-regs-only")))
+uintr_handler(struct __uintr_frame *ui_frame, unsigned long long vector)
 {
+    // 只记录中断；请求由主循环从请求队列中取出处理
     interrupt_count++;
+}
+#endif
+
+/* 注册UINTR处理函数，并把UINTR fd留给客户端复制 */
+static int setup_uintr(void)
+{
+#ifdef __UINTR__
+    printf("[Server] Registering UINTR handler...\n");
+    if (uintr_register_handler((unsigned long)uintr_handler, 0) < 0) {
+        perror("uintr_register_handler failed");
+        return -1;
+    }
+    handler_registered = 1;
     
-    if (shared_mem) {
-        printf("[Server] UINTR received! Count: %d, Message: %s\n", 
-               interrupt_count, shared_mem->message);
+    // 创建UINTR文件描述符
+    uipi_fd = uintr_create_fd();
+    if (uipi_fd < 0) {
+        perror("uintr_create_fd failed");
+        return -1;
+    }
+    
+    shared_mem->to_server.uintr_fd = uipi_fd;
+    printf("[Server] UINTR fd: %d\n", uipi_fd);
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+/* 处理请求队列直到客户端发来退出消息，返回处理的请求数 */
+static unsigned long long serve_requests(ipc_channel_t *ch)
+{
+    unsigned long long handled = 0;
+    unsigned long long unsignaled = 0;
+    ipc_msg_t msg;
+    
+    while (1) {
+        if (!spsc_ring_pop(&ch->request, &msg)) {
+            // 请求队列已空：把攒下的响应发布出去，通知客户端，再等待
+            if (unsignaled > 0) {
+                spsc_ring_publish(&ch->response);
+                notifier_signal(&to_client);
+                unsignaled = 0;
+            }
+            notifier_wait(&to_server, &ch->request);
+            continue;
+        }
+        
+        if (msg.op == IPC_OP_EXIT) {
+            break;
+        }
         
-        // 处理请求并设置响应
-        shared_mem->response = interrupt_count * 100;
+        // 处理请求并设置响应；客户端的未完成请求数不超过RING_SIZE，响应队列不会一直满
+        msg.value *= 100;
+        while (!spsc_ring_push(&ch->response, &msg)) {
+            cpu_relax();
+        }
+        handled++;
+        unsignaled++;
     }
+    
+    spsc_ring_publish(&ch->response);
+    notifier_signal(&to_client);
+    return handled;
 }
 
 /* 清理函数 */
@@ -36,9 +100,8 @@ static void cleanup(void)
 {
     printf("[Server] Cleaning up...\n");
     
-    if (uipi_index >= 0) {
-        uintr_unregister_sender(uipi_index, 0);
-    }
+    notifier_destroy(&to_server);
+    notifier_destroy(&to_client);
     
     if (uipi_fd >= 0) {
         close(uipi_fd);
@@ -52,7 +115,11 @@ static void cleanup(void)
         shmctl(shm_id, IPC_RMID, NULL);
     }
     
-    uintr_unregister_handler((unsigned int)uintr_handler, 0);
+#ifdef __UINTR__
+    if (handler_registered) {
+        uintr_unregister_handler((unsigned long)uintr_handler, 0);
+    }
+#endif
 }
 
 /* 信号处理函数 */
@@ -65,11 +132,43 @@ static void signal_handler(int sig)
 
 int main(int argc, char *argv[])
 {
-    int iterations = 10;
-    benchmark_t bench;
+    int kind = NOTIFY_UINTR;
+    int cpu = -1;
+    
+    int opt;
+    while ((opt = getopt(argc, argv, "c:")) != -1) {
+        if (opt != 'c') {
+            printf("Usage: %s [-c cpu] [poll|futex|eventfd|spin|uintr]\n", argv[0]);
+            return 1;
+        }
+        cpu = atoi(optarg);
+    }
+    
+    // 未指定后端时优先UINTR，不支持则退回futex；显式指定uintr时不退回
+    if (optind < argc) {
+        kind = notify_parse(argv[optind]);
+        if (kind < 0) {
+            printf("Usage: %s [-c cpu] [poll|futex|eventfd|spin|uintr]\n", argv[0]);
+            return 1;
+        }
+        if (!notify_supported(kind)) {
+            printf("[Server] Notifier %s is not supported on this machine\n", argv[optind]);
+            return 1;
+        }
+    } else if (!notify_supported(kind)) {
+        printf("[Server] UINTR not supported, falling back to futex\n");
+        kind = NOTIFY_FUTEX;
+    }
     
     printf("=== UINTR Server Process ===\n");
     printf("Process ID: %d\n", getpid());
+    printf("Notifier: %s\n", notify_name(kind));
+    
+    // 绑定CPU，使测得的延迟不受迁移影响
+    if (pin_cpu(cpu) < 0) {
+        perror("sched_setaffinity failed");
+        return 1;
+    }
     
     // 设置信号处理
     signal(SIGINT, signal_handler);
@@ -77,81 +176,50 @@ int main(int argc, char *argv[])
     
     // 创建共享内存
     key_t key = ftok("/tmp", 'U');
-    shm_id = shmget(key, sizeof(shared_data_t), IPC_CREAT | 0666);
+    shm_id = shmget(key, sizeof(ipc_channel_t), IPC_CREAT | 0666);
     if (shm_id < 0) {
         perror("shmget failed");
         return 1;
     }
     
-    shared_mem = (shared_data_t *)shmat(shm_id, NULL, 0);
+    shared_mem = (ipc_channel_t *)shmat(shm_id, NULL, 0);
     if (shared_mem == (void *)-1) {
         perror("shmat failed");
         return 1;
     }
     
-    memset(shared_mem, 0, sizeof(shared_data_t));
+    memset(shared_mem, 0, sizeof(ipc_channel_t));
+    spsc_ring_init(&shared_mem->request);
+    spsc_ring_init(&shared_mem->response);
     
-    // 注册UINTR处理函数
-    printf("[Server] Registering UINTR handler...\n");
-    int ret = uintr_register_handler((unsigned int)uintr_handler, 0);
-    if (ret < 0) {
-        perror("uintr_register_handler failed");
+    // UINTR只用于客户端到服务器方向；响应方向客户端轮询
+    notify_kind_t back = kind == NOTIFY_UINTR ? NOTIFY_POLL : kind;
+    if (notifier_create(&to_server, &shared_mem->to_server, kind) < 0 ||
+        notifier_create(&to_client, &shared_mem->to_client, back) < 0) {
+        perror("notifier_create failed");
         cleanup();
         return 1;
     }
     
-    // 创建UINTR文件描述符
-    uipi_fd = uintr_create_fd();
-    if (uipi_fd < 0) {
-        perror("uintr_create_fd failed");
+    if (kind == NOTIFY_UINTR && setup_uintr() < 0) {
         cleanup();
         return 1;
     }
     
-    // 注册发送者（自己）
-    uipi_index = uintr_register_sender(uipi_fd, 0);
-    if (uipi_index < 0) {
-        perror("uintr_register_sender failed");
-        cleanup();
-        return 1;
-    }
-    
-    // 将向量号写入共享内存
-    shared_mem->vector = uipi_index;
-    printf("[Server] UINTR vector: %d\n", uipi_index);
+    // 通知客户端可以连接
+    shared_mem->notify_kind = kind;
+    atomic_store(&shared_mem->ready, 1);
     
     // 等待客户端连接
     printf("[Server] Waiting for client to connect...\n");
     printf("[Server] Shared memory ID: %d\n", shm_id);
     printf("[Server] Press Ctrl+C to exit\n\n");
     
-    // 等待中断
-    bench.total_latency = 0;
-    bench.iterations = 0;
-    
-    while (1) {
-        // 重置就绪标志
-        shared_mem->ready = 0;
-        
-        // 等待客户端设置消息
-        while (shared_mem->ready == 0) {
-            usleep(1000); // 短暂休眠避免忙等待
-        }
-        
-        // 测量延迟
-        if (interrupt_count > 0 && bench.iterations < iterations) {
-            bench.iterations++;
-            printf("[Server] Request %d processed. Response: %d\n", 
-                   bench.iterations, shared_mem->response);
-        }
-        
-        if (bench.iterations >= iterations) {
-            printf("[Server] Completed %d iterations\n", iterations);
-            break;
-        }
-        
-        sleep(1); // 给客户端时间发送下一个请求
-    }
+    unsigned long long handled = serve_requests(shared_mem);
+    printf("[Server] Completed %llu requests (%d interrupts received)\n",
+           handled, interrupt_count);
+    printf("[Server] Slept %llu times, woke the client %llu times\n",
+           to_server.sleeps, to_client.wakes);
     
     cleanup();
     printf("[Server] Exiting normally\n");